@@ -444,6 +444,10 @@ with csbuild.Project(LibHarlequinRuntime.projectName, HarlequinCommon.libRootPat
 	with csbuild.Scope(csbuild.ScopeDef.All):
 		csbuild.AddDefines("HQ_LIB_RUNTIME")
 
+	if os.getenv("HQ_DISABLE_COMPUTED_GOTO"):
+		# Detecting the environment override will force the runtime to use the portable opcode dispatch loop.
+		csbuild.AddDefines("HQ_VM_DISABLE_COMPUTED_GOTO")
+
 	with csbuild.Toolchain("msvc", "gcc", "clang"):
 		csbuild.AddDefines("HQ_BUILD_MAIN_LIB_EXPORT")
 
@@ -585,6 +589,24 @@ with csbuild.Project(HarlequinFunctionalTest.projectName, HarlequinCommon.testRo
 
 ###################################################################################################
 
+class HarlequinBenchmark(object):
+	projectName = "HqTest_Benchmark"
+	outputName = "hq_benchmark"
+	dependencies = [
+		LibHarlequinDevelop.projectName,
+		LibHarlequinRuntime.projectName,
+	]
+
+with csbuild.Project(HarlequinBenchmark.projectName, HarlequinCommon.testRootPath, HarlequinBenchmark.dependencies, autoDiscoverSourceFiles=False):
+	_setTestAppOptions(HarlequinBenchmark.outputName)
+
+	csbuild.AddSourceDirectories(
+		f"{HarlequinCommon.testRootPath}/common",
+		f"{HarlequinCommon.testRootPath}/benchmark",
+	)
+
+###################################################################################################
+
 class HarlequinTest_OpCodesNative(object):
 	projectName = "HqTest_NativeImpl_OpCodes"
 	outputName = "libTestOpCodes"
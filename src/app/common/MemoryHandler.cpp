@@ -90,6 +90,16 @@ void MemoryHandler::PrintStats(FILE* const pOutputStream) const
 
 //----------------------------------------------------------------------------------------------------------------------
 
+void MemoryHandler::ResetPeakSize()
+{
+	// Restart peak tracking from whatever is currently allocated.
+	HqMutex::Lock(m_mutex);
+	m_peakMemUsage = m_currentTotalSize;
+	HqMutex::Unlock(m_mutex);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 inline void* MemoryHandler::_malloc(const size_t memSize)
 {
 	assert(memSize > 0);
@@ -37,9 +37,11 @@ public:
 
 	bool HasActiveAllocations() const;
 	void PrintStats(FILE* pOutputStream) const;
+	void ResetPeakSize();
 
 	size_t GetActiveCount() const;
 	size_t GetCurrentSize() const;
+	size_t GetPeakSize() const;
 
 private:
 
@@ -99,3 +101,10 @@ inline size_t MemoryHandler::GetCurrentSize() const
 }
 
 //----------------------------------------------------------------------------------------------------------------------
+
+inline size_t MemoryHandler::GetPeakSize() const
+{
+	return m_peakMemUsage;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
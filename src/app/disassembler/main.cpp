@@ -316,7 +316,11 @@ int main(int argc, char* argv[])
 	vmInit.gcThreadStackSize = HQ_VM_THREAD_DEFAULT_STACK_SIZE;
 	vmInit.gcTimeSliceMs = HQ_VM_GC_DEFAULT_TIME_SLICE_MS;
 	vmInit.gcTimeWaitMs = HQ_VM_GC_DEFAULT_TIME_WAIT_MS;
+	vmInit.gcMarkThreadCount = 0;
+	vmInit.gcHeapGrowthPercent = HQ_VM_GC_DEFAULT_HEAP_GROWTH_PERCENT;
+	vmInit.gcMinTriggerHeapSize = HQ_VM_GC_DEFAULT_MIN_TRIGGER_HEAP_SIZE;
 	vmInit.gcEnableThread = false;
+	vmInit.useSlabAllocator = false;
 
 	// Create the VM context.
 	{
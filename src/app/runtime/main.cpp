@@ -47,6 +47,7 @@
 	#include <locale.h>
 #endif
 
+#include <algorithm>
 #include <deque>
 #include <map>
 #include <vector>
@@ -94,6 +95,16 @@ inline void _HqAppShutdown()
 // Disabling the GC thread requires user code to manually call the API function for invoking the GC.
 #define _GC_THREAD_ENABLED 1
 
+// Enabling the profiler will run scripts through the slower, instrumented dispatch loop and print a per-opcode
+// and per-function breakdown of where the time went once the script has finished.
+#define _PROFILING_ENABLED 0
+
+// Setting the sample interval to anything above 0 will sample the script call stacks at that rate in milliseconds and
+// write them out as folded stacks that can be turned into a flamegraph. This requires the GC thread to be enabled.
+#define _SAMPLE_PROFILER_INTERVAL_MS 0
+#define _SAMPLE_PROFILER_ENABLED     (_GC_THREAD_ENABLED && (_SAMPLE_PROFILER_INTERVAL_MS > 0))
+#define _SAMPLE_PROFILER_OUTPUT_PATH "hq-samples.folded"
+
 // Setting the test iterations to anything above 1 will do special logic to add an iteration loop and remove some log prints.
 #define _STRESS_TEST_ITERATIONS 1
 #define _STRESS_TEST_ENABLED    (_STRESS_TEST_ITERATIONS > 1)
@@ -173,6 +184,171 @@ void OnDependencyRequested(void* const pUserData, const char* const moduleName)
 
 //----------------------------------------------------------------------------------------------------------------------
 
+void PrintGcStats(FILE* const pOutputStream, const HqGcStats& stats, const double convertTimeToMs)
+{
+	static const char* const phaseNames[HQ_GC_PHASE__COUNT] =
+	{
+		"Link pending:    ",
+		"Auto mark:       ",
+		"Global mark:     ",
+		"Remembered mark: ",
+		"Discovery:       ",
+		"Remark:          ",
+		"Dispose:         ",
+		"Promote:         ",
+	};
+
+	const double averagePauseTime = (stats.pauseCount > 0)
+		? double(stats.totalPauseTime) * convertTimeToMs / double(stats.pauseCount)
+		: 0.0;
+
+	// Output garbage collector stats.
+	fprintf(
+		pOutputStream,
+		"\nGC Stats:\n"
+		"  [Cycles]\n"
+		"    Total: %" PRIu64 "\n"
+		"    Major: %" PRIu64 "\n"
+		"  [Objects]\n"
+		"    Linked:   %" PRIu64 " (%" PRIu64 " bytes)\n"
+		"    Marked:   %" PRIu64 " (%" PRIu64 " bytes)\n"
+		"    Disposed: %" PRIu64 " (%" PRIu64 " bytes)\n"
+		"    Pending:  %" PRIu64 "\n"
+		"    Heap:     %" PRIu64 " (%" PRIu64 " bytes)\n"
+		"  [Pauses]\n"
+		"    Count:   %" PRIu64 "\n"
+		"    Total:   %f ms\n"
+		"    Average: %f ms\n"
+		"    Max:     %f ms\n"
+		"  [Locking]\n"
+		"    Safepoint wait: %f ms\n"
+		"    Script park:    %f ms\n"
+		"  [Phases]\n",
+		stats.cycleCount,
+		stats.majorCycleCount,
+		stats.linkedObjectCount,
+		stats.linkedSize,
+		stats.markedObjectCount,
+		stats.markedSize,
+		stats.disposedObjectCount,
+		stats.disposedSize,
+		stats.pendingObjectCount,
+		stats.heapObjectCount,
+		stats.heapSize,
+		stats.pauseCount,
+		double(stats.totalPauseTime) * convertTimeToMs,
+		averagePauseTime,
+		double(stats.maxPauseTime) * convertTimeToMs,
+		double(stats.safepointWaitTime) * convertTimeToMs,
+		double(stats.scriptParkTime) * convertTimeToMs
+	);
+
+	for(size_t i = 0; i < HQ_GC_PHASE__COUNT; ++i)
+	{
+		fprintf(pOutputStream, "    %s%f ms\n", phaseNames[i], double(stats.phaseTime[i]) * convertTimeToMs);
+	}
+
+	fflush(pOutputStream);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void PrintProfile(FILE* const pOutputStream, HqExecutionHandle hExec, const double convertTimeToMs)
+{
+	typedef std::pair<const char*, HqProfileCounter> ProfileEntry;
+	typedef std::vector<ProfileEntry> ProfileEntryArray;
+
+	struct ProfileData
+	{
+		ProfileEntryArray opCodes;
+		ProfileEntryArray functions;
+	};
+
+	auto onOpCode = [](void* const pUserData, const char* const name, const HqProfileCounter* const pCounter) -> bool
+	{
+		ProfileData* const pData = reinterpret_cast<ProfileData*>(pUserData);
+		pData->opCodes.push_back(ProfileEntry(name, *pCounter));
+		return true;
+	};
+
+	auto onFunction = [](void* const pUserData, HqFunctionHandle hFunction, const HqProfileCounter* const pCounter) -> bool
+	{
+		const char* signature = nullptr;
+		HqFunctionGetSignature(hFunction, &signature);
+
+		ProfileData* const pData = reinterpret_cast<ProfileData*>(pUserData);
+		pData->functions.push_back(ProfileEntry(signature, *pCounter));
+		return true;
+	};
+
+	auto printEntries = [&pOutputStream, &convertTimeToMs](ProfileEntryArray& entries)
+	{
+		uint64_t totalTime = 0;
+
+		for(const ProfileEntry& entry : entries)
+		{
+			totalTime += entry.second.time;
+		}
+
+		// Show the most expensive entries first.
+		std::sort(
+			entries.begin(),
+			entries.end(),
+			[](const ProfileEntry& left, const ProfileEntry& right) { return left.second.time > right.second.time; }
+		);
+
+		for(const ProfileEntry& entry : entries)
+		{
+			fprintf(
+				pOutputStream,
+				"    %6.2f%% %12f ms %12" PRIu64 "  %s\n",
+				(totalTime > 0) ? double(entry.second.time) * 100.0 / double(totalTime) : 0.0,
+				double(entry.second.time) * convertTimeToMs,
+				entry.second.count,
+				entry.first
+			);
+		}
+	};
+
+	ProfileData data;
+
+	HqExecutionGetProfile(hExec, onOpCode, onFunction, &data);
+
+	fprintf(pOutputStream, "\nProfile:\n  [OpCodes]\n");
+	printEntries(data.opCodes);
+
+	fprintf(pOutputStream, "  [Functions]\n");
+	printEntries(data.functions);
+
+	fflush(pOutputStream);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void WriteSampleProfile(HqVmHandle hVm, const char* const outputFilePath)
+{
+	FILE* const pOutputFile = fopen(outputFilePath, "w");
+	if(!pOutputFile)
+	{
+		char msg[256];
+		snprintf(msg, sizeof(msg), "Failed to open sample profile output file: \"%s\"", outputFilePath);
+		OnMessageReported(nullptr, HQ_MESSAGE_TYPE_WARNING, msg);
+		return;
+	}
+
+	auto onLine = [](void* const pUserData, const char* const line) -> bool
+	{
+		fprintf(reinterpret_cast<FILE*>(pUserData), "%s\n", line);
+		return true;
+	};
+
+	HqVmWriteSampleProfile(hVm, onLine, pOutputFile);
+
+	fclose(pOutputFile);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 int main(int argc, char* argv[])
 {
 #if !defined(HQ_PLATFORM_PSVITA)
@@ -250,7 +426,11 @@ int main(int argc, char* argv[])
 	vmInit.gcThreadStackSize = HQ_VM_THREAD_DEFAULT_STACK_SIZE;
 	vmInit.gcTimeSliceMs = HQ_VM_GC_DEFAULT_TIME_SLICE_MS;
 	vmInit.gcTimeWaitMs = HQ_VM_GC_DEFAULT_TIME_WAIT_MS;
+	vmInit.gcMarkThreadCount = 0;
+	vmInit.gcHeapGrowthPercent = HQ_VM_GC_DEFAULT_HEAP_GROWTH_PERCENT;
+	vmInit.gcMinTriggerHeapSize = HQ_VM_GC_DEFAULT_MIN_TRIGGER_HEAP_SIZE;
 	vmInit.gcEnableThread = _GC_THREAD_ENABLED;
+	vmInit.useSlabAllocator = false;
 
 	const uint64_t timerFrequency = HqClockGetFrequency();
 	const uint64_t overallTimeStart = HqClockGetTimestamp();
@@ -271,6 +451,9 @@ int main(int argc, char* argv[])
 	uint64_t totalManualGcTime = 0;
 #endif
 
+	HqGcStats gcStats;
+	memset(&gcStats, 0, sizeof(gcStats));
+
 	// Create the VM context.
 	{
 		const uint64_t timeStart = HqClockGetTimestamp();
@@ -486,6 +669,14 @@ int main(int argc, char* argv[])
 		createExecTimeSlice = timeEnd - timeStart;
 	}
 
+#if _PROFILING_ENABLED
+	HqExecutionSetProfilingEnabled(hExec, true);
+#endif
+
+#if _SAMPLE_PROFILER_ENABLED
+	HqVmStartSampleProfiler(hVm, _SAMPLE_PROFILER_INTERVAL_MS, false);
+#endif
+
 	// Find the script entry point function.
 	const int getEntryPointResult = HqVmGetFunction(hVm, &hEntryFunc, entryPointFuncName);
 	if(getEntryPointResult != HQ_SUCCESS)
@@ -635,6 +826,16 @@ int main(int argc, char* argv[])
 #endif
 	}
 
+#if _SAMPLE_PROFILER_ENABLED
+	HqVmStopSampleProfiler(hVm);
+	WriteSampleProfile(hVm, _SAMPLE_PROFILER_OUTPUT_PATH);
+#endif
+
+#if _PROFILING_ENABLED
+	// The profile belongs to the execution context, so it needs to be printed before the context is disposed.
+	PrintProfile(stdout, hExec, 1000.0 / double(timerFrequency));
+#endif
+
 	// Dispose of the execution context now that we're finished running scripts.
 	{
 		const uint64_t timeStart = HqClockGetTimestamp();
@@ -654,6 +855,9 @@ int main(int argc, char* argv[])
 		disposeExecTimeSlice = timeEnd - timeStart;
 	}
 
+	// Grab the final GC stats before the VM is gone.
+	HqVmGetGcStats(hVm, &gcStats);
+
 	// Dispose of the VM context.
 	{
 		const uint64_t timeStart = HqClockGetTimestamp();
@@ -739,6 +943,9 @@ int main(int argc, char* argv[])
 #endif
 	);
 
+	// Dump the GC stats.
+	PrintGcStats(stdout, gcStats, convertTimeToMs);
+
 	// Shutdown the platform-specific, internal systems.
 	_HqAppShutdown();
 
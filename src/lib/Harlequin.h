@@ -52,6 +52,9 @@ extern "C" {
 #define HQ_VM_GC_DEFAULT_TIME_SLICE_MS 8
 #define HQ_VM_GC_DEFAULT_TIME_WAIT_MS  3
 
+#define HQ_VM_GC_DEFAULT_HEAP_GROWTH_PERCENT   100
+#define HQ_VM_GC_DEFAULT_MIN_TRIGGER_HEAP_SIZE 1048576
+
 /*---------------------------------------------------------------------------------------------------------------------*/
 
 enum HqErrorCodeEnum
@@ -99,6 +102,22 @@ enum HqEndianOrderEnum
 	HQ_ENDIAN_ORDER_BIG,
 };
 
+enum HqBytecodeEncodingEnum
+{
+	HQ_BYTECODE_ENCODING_STANDARD,
+	HQ_BYTECODE_ENCODING_COMPACT,
+
+	HQ_BYTECODE_ENCODING__COUNT,
+};
+
+enum HqCallingConventionEnum
+{
+	HQ_CALLING_CONVENTION_IO_REGISTER,
+	HQ_CALLING_CONVENTION_REGISTER_WINDOW,
+
+	HQ_CALLING_CONVENTION__COUNT,
+};
+
 /*---------------------------------------------------------------------------------------------------------------------*/
 
 enum HqValueTypeEnum
@@ -151,6 +170,14 @@ typedef struct
 	HqCallbackMemFree freeFn;
 } HqMemAllocator;
 
+typedef struct
+{
+	size_t blockSize;
+	size_t slabCount;
+	size_t blockCapacity;
+	size_t blocksInUse;
+} HqMemSlabStats;
+
 /*---------------------------------------------------------------------------------------------------------------------*/
 
 enum HqMessageTypeEnum
@@ -196,6 +223,10 @@ HQ_BASE_API void* HqMemRealloc(void* pMem, size_t size);
 
 HQ_BASE_API int HqMemFree(void* pMem);
 
+HQ_BASE_API size_t HqMemGetSlabSizeClassCount();
+
+HQ_BASE_API int HqMemGetSlabStats(size_t sizeClass, HqMemSlabStats* pOutStats);
+
 /*---------------------------------------------------------------------------------------------------------------------*/
 
 HQ_BASE_API int HqReportMessage(HqReportHandle hReport, int messageType, const char* fmt, ...);
@@ -419,6 +450,20 @@ enum HqExceptionSeverity
 	HQ_EXCEPTION_SEVERITY__COUNT,
 };
 
+enum HqGcPhaseEnum
+{
+	HQ_GC_PHASE_LINK_PENDING,
+	HQ_GC_PHASE_AUTO_MARK,
+	HQ_GC_PHASE_GLOBAL_MARK,
+	HQ_GC_PHASE_REMEMBERED_MARK,
+	HQ_GC_PHASE_DISCOVERY,
+	HQ_GC_PHASE_REMARK,
+	HQ_GC_PHASE_DISPOSE,
+	HQ_GC_PHASE_PROMOTE,
+
+	HQ_GC_PHASE__COUNT,
+};
+
 typedef struct
 {
 	HqCommonInit common;
@@ -426,10 +471,49 @@ typedef struct
 	uint32_t gcThreadStackSize;
 	uint32_t gcTimeSliceMs;
 	uint32_t gcTimeWaitMs;
+	uint32_t gcMarkThreadCount;
+	uint32_t gcHeapGrowthPercent;
+	uint32_t gcMinTriggerHeapSize;
 
 	bool gcEnableThread;
+	bool useSlabAllocator;
 } HqVmInit;
 
+/* All times are in clock ticks; divide by HqClockGetFrequency() to convert to seconds. */
+typedef struct
+{
+	uint64_t cycleCount;
+	uint64_t majorCycleCount;
+
+	uint64_t phaseTime[HQ_GC_PHASE__COUNT];
+
+	/* Sizes include the element storage owned by arrays, grids, and objects. */
+	uint64_t linkedObjectCount;
+	uint64_t linkedSize;
+	uint64_t markedObjectCount;
+	uint64_t markedSize;
+	uint64_t disposedObjectCount;
+	uint64_t disposedSize;
+
+	uint64_t pendingObjectCount;
+	uint64_t heapObjectCount;
+	uint64_t heapSize;
+
+	uint64_t pauseCount;
+	uint64_t totalPauseTime;
+	uint64_t maxPauseTime;
+
+	uint64_t safepointWaitTime;
+	uint64_t scriptParkTime;
+} HqGcStats;
+
+/* Times are in clock ticks, the same as HqGcStats. */
+typedef struct
+{
+	uint64_t count;
+	uint64_t time;
+} HqProfileCounter;
+
 typedef struct
 {
 	HqSysVersion version;
@@ -458,6 +542,8 @@ typedef bool (*HqCallbackIterateVariable)(void*, const char*, HqValueHandle);
 typedef bool (*HqCallbackIterateString)(void*, const char*);
 typedef bool (*HqCallbackIterateStringWithIndex)(void*, const char*, size_t);
 typedef bool (*HqCallbackIterateObjectMember)(void*, const char*, int);
+typedef bool (*HqCallbackIterateOpCodeProfile)(void*, const char*, const HqProfileCounter*);
+typedef bool (*HqCallbackIterateFunctionProfile)(void*, HqFunctionHandle, const HqProfileCounter*);
 
 #define HQ_VM_HANDLE_NULL        ((HqVmHandle)0)
 #define HQ_MODULE_HANDLE_NULL    ((HqModuleHandle)0)
@@ -474,6 +560,16 @@ HQ_MAIN_API int HqVmDispose(HqVmHandle* phVm);
 
 HQ_MAIN_API int HqVmRunGarbageCollector(HqVmHandle hVm, int runMode);
 
+HQ_MAIN_API int HqVmGetGcStats(HqVmHandle hVm, HqGcStats* pOutStats);
+
+HQ_MAIN_API int HqVmStartSampleProfiler(HqVmHandle hVm, uint32_t intervalMs, bool includeOffsets);
+
+HQ_MAIN_API int HqVmStopSampleProfiler(HqVmHandle hVm);
+
+HQ_MAIN_API int HqVmClearSampleProfile(HqVmHandle hVm);
+
+HQ_MAIN_API int HqVmWriteSampleProfile(HqVmHandle hVm, HqCallbackIterateString onLineFn, void* pUserData);
+
 HQ_MAIN_API int HqVmGetReportHandle(HqVmHandle hVm, HqReportHandle* phOutReport);
 
 HQ_MAIN_API int HqVmGetModule(HqVmHandle hVm, HqModuleHandle* phOutModule, const char* moduleName);
@@ -615,6 +711,16 @@ HQ_MAIN_API int HqExecutionSetIoRegister(HqExecutionHandle hExec, HqValueHandle
 
 HQ_MAIN_API int HqExecutionGetIoRegister(HqExecutionHandle hExec, HqValueHandle* phOutValue, uint32_t registerIndex);
 
+HQ_MAIN_API int HqExecutionSetProfilingEnabled(HqExecutionHandle hExec, bool enabled);
+
+HQ_MAIN_API int HqExecutionResetProfile(HqExecutionHandle hExec);
+
+HQ_MAIN_API int HqExecutionGetProfile(
+	HqExecutionHandle hExec,
+	HqCallbackIterateOpCodeProfile onOpCodeFn,
+	HqCallbackIterateFunctionProfile onFunctionFn,
+	void* pUserData);
+
 /*---------------------------------------------------------------------------------------------------------------------*/
 
 HQ_MAIN_API int HqFrameGetFunction(HqFrameHandle hFrame, HqFunctionHandle* phOutFunction);
@@ -907,12 +1013,22 @@ HQ_MAIN_API int HqModuleWriterAddExceptionHandler(
 	int handledType,
 	const char* className);
 
+HQ_MAIN_API int HqModuleWriterSetBytecodeEncoding(HqModuleWriterHandle hModuleWriter, int encoding);
+
+HQ_MAIN_API int HqModuleWriterSetCallingConvention(HqModuleWriterHandle hModuleWriter, int convention);
+
 HQ_MAIN_API int HqModuleWriterSerialize(
 	HqModuleWriterHandle hModuleWriter,
 	HqSerializerHandle hSerializer);
 
 /*---------------------------------------------------------------------------------------------------------------------*/
 
+HQ_MAIN_API int HqBytecodeSetEncoding(HqSerializerHandle hSerializer, int encoding);
+
+HQ_MAIN_API int HqBytecodeGetEncoding(HqSerializerHandle hSerializer);
+
+/*---------------------------------------------------------------------------------------------------------------------*/
+
 HQ_MAIN_API int HqBytecodeEmitNop(HqSerializerHandle hSerializer);
 
 HQ_MAIN_API int HqBytecodeEmitAbort(HqSerializerHandle hSerializer);
@@ -925,6 +1041,12 @@ HQ_MAIN_API int HqBytecodeEmitCall(HqSerializerHandle hSerializer, uint32_t stri
 
 HQ_MAIN_API int HqBytecodeEmitCallValue(HqSerializerHandle hSerializer, uint32_t gpRegIndex);
 
+HQ_MAIN_API int HqBytecodeEmitCallWindow(HqSerializerHandle hSerializer, uint32_t stringIndex, uint32_t gpWindowRegIndex);
+
+HQ_MAIN_API int HqBytecodeEmitTailCall(HqSerializerHandle hSerializer, uint32_t stringIndex);
+
+HQ_MAIN_API int HqBytecodeEmitTailCallValue(HqSerializerHandle hSerializer, uint32_t gpRegIndex);
+
 HQ_MAIN_API int HqBytecodeEmitRaise(HqSerializerHandle hSerializer, uint32_t gpRegIndex);
 
 HQ_MAIN_API int HqBytecodeEmitLoadImmNull(HqSerializerHandle hSerializer,uint32_t gpRegIndex);
@@ -64,7 +64,7 @@ struct HqFiberConfig
 
 extern "C"
 {
-	void _HqFiberImplCreate(HqInternalFiber&, const HqFiberConfig&);
+	bool _HqFiberImplCreate(HqInternalFiber&, const HqFiberConfig&);
 	void _HqFiberImplDispose(HqInternalFiber&);
 	bool _HqFiberImplRun(HqInternalFiber&);
 	bool _HqFiberImplWait(HqInternalFiber&);
@@ -76,9 +76,10 @@ extern "C"
 
 struct HQ_BASE_API HqFiber
 {
-	static void Create(HqFiber& fiber, const HqFiberConfig& fiberConfig)
+	// A fiber that fails to be created is left default-initialized, so it reports as neither running nor complete.
+	static bool Create(HqFiber& fiber, const HqFiberConfig& fiberConfig)
 	{
-		_HqFiberImplCreate(fiber.obj, fiberConfig);
+		return _HqFiberImplCreate(fiber.obj, fiberConfig);
 	}
 
 	static void Dispose(HqFiber& fiber)
@@ -22,6 +22,7 @@
 
 #include "Clock.hpp"
 #include "Serializer.hpp"
+#include "SlabAllocator.hpp"
 #include "String.hpp"
 #include "System.hpp"
 
@@ -218,6 +219,25 @@ int HqMemFree(void* const pMem)
 
 //----------------------------------------------------------------------------------------------------------------------
 
+size_t HqMemGetSlabSizeClassCount()
+{
+	return HQ_SLAB_SIZE_CLASS_COUNT;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int HqMemGetSlabStats(const size_t sizeClass, HqMemSlabStats* const pOutStats)
+{
+	if(!pOutStats)
+	{
+		return HQ_ERROR_INVALID_ARG;
+	}
+
+	return HqSlabAllocator::GetStats(sizeClass, *pOutStats);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 int HqReportMessage(HqReportHandle hReport, const int messageType, const char* const fmt, ...)
 {
 	if(!hReport)
@@ -22,6 +22,8 @@
 #include <string.h>
 #include <inttypes.h>
 
+#include <algorithm>
+
 //----------------------------------------------------------------------------------------------------------------------
 
 bool HqModuleLoader::Load(HqModuleLoader& output, HqReportHandle hReport, const char* const filePath, const uint32_t flags)
@@ -160,6 +162,8 @@ void HqModuleLoader::Dispose(HqModuleLoader& output)
 		}
 
 		Function::GuardedBlockArray::Dispose(func.guardedBlocks);
+		Function::ExceptionRangeArray::Dispose(func.exceptionRanges);
+		Function::GuardedBlock::ExceptionHandlerArray::Dispose(func.exceptionHandlers);
 	}
 
 	// Dispose of all module resources.
@@ -284,6 +288,100 @@ inline bool HqModuleLoader::_loadFileHeader(HqModuleLoader& output, HqReportHand
 		return false;
 	}
 	
+	// Read the bytecode encoding version.
+	if(!_readBuffer(hSerializer, sizeof(output.fileHeader.bytecodeEncoding), &output.fileHeader.bytecodeEncoding, result, streamOffset))
+	{
+		HqReportMessage(
+			hReport,
+			HQ_MESSAGE_TYPE_ERROR,
+			"Failed to read module bytecode encoding"
+				": error='%s'"
+				", streamOffset=%zu",
+			HqGetErrorCodeString(result),
+			streamOffset
+		);
+		return false;
+	}
+
+	// Verify the bytecode encoding is one we know how to decode.
+	if(output.fileHeader.bytecodeEncoding >= HQ_BYTECODE_ENCODING__COUNT)
+	{
+		HqReportMessage(
+			hReport,
+			HQ_MESSAGE_TYPE_ERROR,
+			"Unsupported module bytecode encoding"
+				": bytecodeEncoding=%" PRIu8
+				", maxSupported=%d",
+			output.fileHeader.bytecodeEncoding,
+			HQ_BYTECODE_ENCODING__COUNT - 1
+		);
+		return false;
+	}
+
+	output.bytecodeEncoding = output.fileHeader.bytecodeEncoding;
+
+	// Read the calling convention.
+	if(!_readBuffer(hSerializer, sizeof(output.fileHeader.callingConvention), &output.fileHeader.callingConvention, result, streamOffset))
+	{
+		HqReportMessage(
+			hReport,
+			HQ_MESSAGE_TYPE_ERROR,
+			"Failed to read module calling convention"
+				": error='%s'"
+				", streamOffset=%zu",
+			HqGetErrorCodeString(result),
+			streamOffset
+		);
+		return false;
+	}
+
+	// Verify the calling convention is one we know how to call into.
+	if(output.fileHeader.callingConvention >= HQ_CALLING_CONVENTION__COUNT)
+	{
+		HqReportMessage(
+			hReport,
+			HQ_MESSAGE_TYPE_ERROR,
+			"Unsupported module calling convention"
+				": callingConvention=%" PRIu8
+				", maxSupported=%d",
+			output.fileHeader.callingConvention,
+			HQ_CALLING_CONVENTION__COUNT - 1
+		);
+		return false;
+	}
+
+	output.callingConvention = output.fileHeader.callingConvention;
+
+	// Read the module format flags.
+	if(!_readBuffer(hSerializer, sizeof(output.fileHeader.formatFlags), &output.fileHeader.formatFlags, result, streamOffset))
+	{
+		HqReportMessage(
+			hReport,
+			HQ_MESSAGE_TYPE_ERROR,
+			"Failed to read module format flags"
+				": error='%s'"
+				", streamOffset=%zu",
+			HqGetErrorCodeString(result),
+			streamOffset
+		);
+		return false;
+	}
+
+	// Verify there are no format flags set that we don't know about.
+	if((output.fileHeader.formatFlags & ~HQ_MODULE_FORMAT_FLAG__ALL) != 0)
+	{
+		HqReportMessage(
+			hReport,
+			HQ_MESSAGE_TYPE_ERROR,
+			"Unsupported module format flags"
+				": formatFlags=0x%" PRIX8
+				", supported=0x%X",
+			output.fileHeader.formatFlags,
+			HQ_MODULE_FORMAT_FLAG__ALL
+		);
+		return false;
+	}
+
 	// Read the reserved section of the file header.
 	if(!_readBuffer(hSerializer, sizeof(output.fileHeader.reserved), output.fileHeader.reserved, result, streamOffset))
 	{
@@ -916,8 +1014,15 @@ inline bool HqModuleLoader::_loadFunctions(HqModuleLoader& output, HqReportHandl
 	{
 		Function& func = output.functions.pData[output.functions.count];
 
-		// Initialize the function's guarded block array.
+		// Initialize the function's guarded block array and exception handler table.
 		Function::GuardedBlockArray::Initialize(func.guardedBlocks);
+		Function::ExceptionRangeArray::Initialize(func.exceptionRanges);
+		Function::GuardedBlock::ExceptionHandlerArray::Initialize(func.exceptionHandlers);
+
+		// Native functions have no frame requirements.
+		func.gpRegisterCount = 0;
+		func.vrRegisterCount = 0;
+		func.stackSize = 0;
 
 		// Read the function signature string.
 		if(!_readStringFromIndex(output, hSerializer, &func.pSignature, result, streamOffset))
@@ -1023,6 +1128,63 @@ inline bool HqModuleLoader::_loadFunctions(HqModuleLoader& output, HqReportHandl
 				return false;
 			}
 
+			if(output.fileHeader.formatFlags & HQ_MODULE_FORMAT_FLAG_FRAME_SIZES)
+			{
+				uint16_t* const pFrameSizes[] =
+				{
+					&func.gpRegisterCount,
+					&func.vrRegisterCount,
+					&func.stackSize,
+				};
+
+				// Read the function's frame requirements.
+				for(uint16_t* const pFrameSize : pFrameSizes)
+				{
+					if(!_readUint16(hSerializer, pFrameSize, result, streamOffset))
+					{
+						HqReportMessage(
+							hReport,
+							HQ_MESSAGE_TYPE_ERROR,
+							"Failed to read the module function frame size"
+								": error='%s'"
+								", streamOffset=%zu"
+								", funcIndex=%zu",
+							HqGetErrorCodeString(result),
+							streamOffset,
+							output.functions.count
+						);
+						return false;
+					}
+				}
+			}
+			else
+			{
+				// Modules written before frame sizes were recorded run their functions with a full frame.
+				func.gpRegisterCount = HQ_VM_GP_REGISTER_COUNT;
+				func.vrRegisterCount = HQ_VM_VR_REGISTER_COUNT;
+				func.stackSize = HQ_VM_VALUE_STACK_SIZE;
+			}
+
+			if(func.gpRegisterCount > HQ_VM_GP_REGISTER_COUNT
+				|| func.vrRegisterCount > HQ_VM_VR_REGISTER_COUNT
+				|| func.stackSize > HQ_VM_VALUE_STACK_SIZE)
+			{
+				HqReportMessage(
+					hReport,
+					HQ_MESSAGE_TYPE_ERROR,
+					"Module function frame size is out of range"
+						": funcIndex=%zu"
+						", gpRegisterCount=%" PRIu16
+						", vrRegisterCount=%" PRIu16
+						", stackSize=%" PRIu16,
+					output.functions.count,
+					func.gpRegisterCount,
+					func.vrRegisterCount,
+					func.stackSize
+				);
+				return false;
+			}
+
 			// Read the number of guarded blocks belonging to the function.
 			uint32_t numGuardedBlocks = 0;
 			if(!_readUint32(hSerializer, &numGuardedBlocks, result, streamOffset))
@@ -1186,6 +1348,9 @@ inline bool HqModuleLoader::_loadFunctions(HqModuleLoader& output, HqReportHandl
 					}
 				}
 			}
+
+			// Flatten the guarded blocks into a table that can be searched by bytecode offset at runtime.
+			_buildExceptionTable(func);
 		}
 	}
 
@@ -1305,6 +1470,9 @@ inline void HqModuleLoader::_initialize(HqModuleLoader& output)
 	memset(&output.fileHeader, 0, sizeof(output.fileHeader));
 	memset(&output.contents, 0, sizeof(output.contents));
 
+	output.bytecodeEncoding = HQ_BYTECODE_ENCODING_STANDARD;
+	output.callingConvention = HQ_CALLING_CONVENTION_IO_REGISTER;
+
 	StringArray::Initialize(output.strings);
 	StringArray::Initialize(output.dependencies);
 	StringArray::Initialize(output.globals);
@@ -1316,6 +1484,111 @@ inline void HqModuleLoader::_initialize(HqModuleLoader& output)
 
 //----------------------------------------------------------------------------------------------------------------------
 
+inline void HqModuleLoader::_buildExceptionTable(Function& func)
+{
+	typedef HqArray<uint64_t> BoundaryArray;
+	typedef HqArray<const Function::GuardedBlock*> BlockPtrArray;
+
+	const size_t blockCount = func.guardedBlocks.count;
+	if(blockCount == 0)
+	{
+		return;
+	}
+
+	// The end offset of a guarded block is inclusive, so each block changes the set of
+	// covering blocks at its start offset and at the offset just past its end.
+	BoundaryArray boundaries;
+	BoundaryArray::Initialize(boundaries);
+	BoundaryArray::Reserve(boundaries, blockCount * 2);
+
+	for(size_t blockIndex = 0; blockIndex < blockCount; ++blockIndex)
+	{
+		const Function::GuardedBlock& block = func.guardedBlocks.pData[blockIndex];
+
+		boundaries.pData[boundaries.count++] = uint64_t(block.offset);
+		boundaries.pData[boundaries.count++] = uint64_t(block.offset) + uint64_t(block.length) + 1;
+	}
+
+	std::sort(boundaries.pData, boundaries.pData + boundaries.count);
+	boundaries.count = size_t(std::unique(boundaries.pData, boundaries.pData + boundaries.count) - boundaries.pData);
+
+	BlockPtrArray coveringBlocks;
+	BlockPtrArray::Initialize(coveringBlocks);
+	BlockPtrArray::Reserve(coveringBlocks, blockCount);
+
+	// Innermost blocks come first. Blocks starting later are nested inside the blocks that contain them, and
+	// of the blocks sharing a start offset, the shortest is the innermost.
+	auto innerBlockSortFunc = [](
+		const Function::GuardedBlock* const pLeft,
+		const Function::GuardedBlock* const pRight
+	) -> bool
+	{
+		if(pLeft->offset != pRight->offset)
+		{
+			return pLeft->offset > pRight->offset;
+		}
+
+		return pLeft->length < pRight->length;
+	};
+
+	for(size_t boundaryIndex = 0; boundaryIndex + 1 < boundaries.count; ++boundaryIndex)
+	{
+		const uint64_t rangeStart = boundaries.pData[boundaryIndex];
+		const uint64_t rangeEnd = boundaries.pData[boundaryIndex + 1] - 1;
+
+		coveringBlocks.count = 0;
+
+		// Every offset in the range is covered by the same blocks, so testing the first one is enough.
+		for(size_t blockIndex = 0; blockIndex < blockCount; ++blockIndex)
+		{
+			const Function::GuardedBlock& block = func.guardedBlocks.pData[blockIndex];
+
+			if(rangeStart >= uint64_t(block.offset)
+				&& rangeStart <= uint64_t(block.offset) + uint64_t(block.length))
+			{
+				coveringBlocks.pData[coveringBlocks.count++] = &block;
+			}
+		}
+
+		std::sort(coveringBlocks.pData, coveringBlocks.pData + coveringBlocks.count, innerBlockSortFunc);
+
+		Function::ExceptionRange range;
+		range.offsetStart = uint32_t(rangeStart);
+		range.offsetEnd = (rangeEnd > uint64_t(UINT32_MAX)) ? UINT32_MAX : uint32_t(rangeEnd);
+		range.firstHandler = uint32_t(func.exceptionHandlers.count);
+
+		// Append the handlers of each covering block in the order they need to be tested.
+		for(size_t coveringIndex = 0; coveringIndex < coveringBlocks.count; ++coveringIndex)
+		{
+			const Function::GuardedBlock& block = *coveringBlocks.pData[coveringIndex];
+
+			Function::GuardedBlock::ExceptionHandlerArray::Reserve(
+				func.exceptionHandlers,
+				func.exceptionHandlers.count + block.exceptionHandlers.count
+			);
+
+			for(size_t handlerIndex = 0; handlerIndex < block.exceptionHandlers.count; ++handlerIndex)
+			{
+				func.exceptionHandlers.pData[func.exceptionHandlers.count++] = block.exceptionHandlers.pData[handlerIndex];
+			}
+		}
+
+		range.handlerCount = uint32_t(func.exceptionHandlers.count) - range.firstHandler;
+
+		// Ranges without any handlers can never catch anything, so there's no reason to search them.
+		if(range.handlerCount > 0)
+		{
+			Function::ExceptionRangeArray::Reserve(func.exceptionRanges, func.exceptionRanges.count + 1);
+			func.exceptionRanges.pData[func.exceptionRanges.count++] = range;
+		}
+	}
+
+	BlockPtrArray::Dispose(coveringBlocks);
+	BoundaryArray::Dispose(boundaries);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 inline bool HqModuleLoader::_readBuffer(
 	HqSerializerHandle hSerializer,
 	const size_t bufferLength,
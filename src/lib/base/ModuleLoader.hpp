@@ -74,10 +74,25 @@ struct HQ_BASE_API HqModuleLoader
 			uint32_t length;
 		};
 
+		// Span of bytecode covered by the same set of guarded blocks. Its handlers are stored contiguously
+		// in the function's flattened handler array, starting with the handlers of the innermost block.
+		struct ExceptionRange
+		{
+			uint32_t offsetStart;
+			uint32_t offsetEnd;
+			uint32_t firstHandler;
+			uint32_t handlerCount;
+		};
+
 		typedef HqArray<GuardedBlock> GuardedBlockArray;
+		typedef HqArray<ExceptionRange> ExceptionRangeArray;
 
 		GuardedBlockArray guardedBlocks;
 
+		// Exception handler table built from the guarded blocks; the ranges are disjoint and sorted by offset.
+		ExceptionRangeArray exceptionRanges;
+		GuardedBlock::ExceptionHandlerArray exceptionHandlers;
+
 		HqString* pSignature;
 
 		uint32_t offset;
@@ -86,6 +101,10 @@ struct HQ_BASE_API HqModuleLoader
 		uint16_t numInputs;
 		uint16_t numOutputs;
 
+		uint16_t gpRegisterCount;
+		uint16_t vrRegisterCount;
+		uint16_t stackSize;
+
 		bool isNative;
 	};
 
@@ -110,6 +129,7 @@ struct HQ_BASE_API HqModuleLoader
 	static bool _loadBytecode(HqModuleLoader&, HqReportHandle, HqSerializerHandle);
 
 	static void _initialize(HqModuleLoader&);
+	static void _buildExceptionTable(Function&);
 
 	static bool _readStringFromIndex(const HqModuleLoader&, HqSerializerHandle, HqString**, int&, size_t&);
 	static bool _readBuffer(HqSerializerHandle, size_t, void*, int&, size_t&);
@@ -132,6 +152,8 @@ struct HQ_BASE_API HqModuleLoader
 	ByteArray bytecode;
 
 	int endianness;
+	int bytecodeEncoding;
+	int callingConvention;
 };
 
 //----------------------------------------------------------------------------------------------------------------------
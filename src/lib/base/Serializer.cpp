@@ -81,6 +81,7 @@ HqSerializerHandle HqSerializer::Create(int mode)
 	pOutput->position = 0;
 	pOutput->mode = mode;
 	pOutput->endianness = HQ_ENDIAN_ORDER_NATIVE;
+	pOutput->bytecodeEncoding = HQ_BYTECODE_ENCODING_STANDARD;
 
 	return pOutput;
 }
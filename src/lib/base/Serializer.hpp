@@ -48,6 +48,7 @@ struct HQ_BASE_API HqSerializer
 
 	int mode;
 	int endianness;
+	int bytecodeEncoding;
 };
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,655 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+#include "SlabAllocator.hpp"
+
+#include "../common/Atomic.hpp"
+
+#include <assert.h>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct _HqSlab
+{
+	_HqSlab* pPrev;
+	_HqSlab* pNext;
+
+	void* pFreeHead;
+
+	uint32_t usedCount;
+	uint32_t carvedCount;
+};
+
+#define _HQ_SLAB_HEADER_SIZE \
+	((sizeof(_HqSlab) + HQ_SLAB_SIZE_CLASS_GRANULARITY - 1) & ~size_t(HQ_SLAB_SIZE_CLASS_GRANULARITY - 1))
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct _HqSlabRegistry
+{
+	_HqSlabRegistry()
+		: pHead(nullptr)
+	{
+		HqMutex::Create(lock);
+	}
+
+	~_HqSlabRegistry()
+	{
+		HqMutex::Dispose(lock);
+	}
+
+	HqMutex lock;
+
+	// Every allocator that still owns slabs, used only for gathering stats.
+	HqSlabAllocator* pHead;
+};
+
+static _HqSlabRegistry slabRegistry;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// Cache that allocations on the current thread are served from. This is only ever set while a script or the garbage
+// collector is running on this thread, so blocks can be handed out and taken back without touching the shared lock.
+static thread_local HqSlabCache* _activeCache = nullptr;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static inline size_t _HqSlabGetSizeClassIndex(const size_t sizeInBytes)
+{
+	if(sizeInBytes == 0 || sizeInBytes > HQ_SLAB_MAX_BLOCK_SIZE)
+	{
+		return size_t(-1);
+	}
+
+	return (sizeInBytes - 1) / HQ_SLAB_SIZE_CLASS_GRANULARITY;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static _HqSlab* _HqSlabFindOwner(HqSlabAllocator::SizeClass& sizeClass, const void* const pBlock)
+{
+	const uintptr_t address = uintptr_t(pBlock);
+	const uintptr_t key = address / HQ_SLAB_SIZE;
+
+	_HqSlab* pSlab = nullptr;
+
+	// A slab can only ever start in the same slab-sized window as the block or the one just before it.
+	if(HqSlabAllocator::SizeClass::SlabMap::Get(sizeClass.slabs, key, pSlab) && address >= uintptr_t(pSlab))
+	{
+		return pSlab;
+	}
+
+	if(key > 0
+		&& HqSlabAllocator::SizeClass::SlabMap::Get(sizeClass.slabs, key - 1, pSlab)
+		&& address < uintptr_t(pSlab) + HQ_SLAB_SIZE)
+	{
+		return pSlab;
+	}
+
+	return nullptr;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static void _HqSlabLinkPartial(HqSlabAllocator::SizeClass& sizeClass, _HqSlab* const pSlab)
+{
+	pSlab->pPrev = nullptr;
+	pSlab->pNext = sizeClass.pPartialHead;
+
+	if(sizeClass.pPartialHead)
+	{
+		sizeClass.pPartialHead->pPrev = pSlab;
+	}
+
+	sizeClass.pPartialHead = pSlab;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static void _HqSlabUnlinkPartial(HqSlabAllocator::SizeClass& sizeClass, _HqSlab* const pSlab)
+{
+	if(pSlab->pPrev)
+	{
+		pSlab->pPrev->pNext = pSlab->pNext;
+	}
+	else
+	{
+		assert(sizeClass.pPartialHead == pSlab);
+		sizeClass.pPartialHead = pSlab->pNext;
+	}
+
+	if(pSlab->pNext)
+	{
+		pSlab->pNext->pPrev = pSlab->pPrev;
+	}
+
+	pSlab->pPrev = nullptr;
+	pSlab->pNext = nullptr;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static _HqSlab* _HqSlabCreate(HqSlabAllocator* const pAllocator, HqSlabAllocator::SizeClass& sizeClass)
+{
+	_HqSlab* const pSlab = reinterpret_cast<_HqSlab*>(HqMemAlloc(HQ_SLAB_SIZE));
+	if(!pSlab)
+	{
+		return nullptr;
+	}
+
+	pSlab->pFreeHead = nullptr;
+	pSlab->usedCount = 0;
+	pSlab->carvedCount = 0;
+
+	HqSlabAllocator::SizeClass::SlabMap::Insert(sizeClass.slabs, uintptr_t(pSlab) / HQ_SLAB_SIZE, pSlab);
+
+	_HqSlabLinkPartial(sizeClass, pSlab);
+
+	++sizeClass.slabCount;
+
+	// Each slab keeps the allocator alive until it's been destroyed.
+	HqAtomic::FetchAdd(&pAllocator->refCount, 1);
+
+	return pSlab;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static void _HqSlabDestroy(HqSlabAllocator::SizeClass& sizeClass, _HqSlab* const pSlab)
+{
+	assert(pSlab->usedCount == 0);
+
+	// Empty slabs always have room in them, so they will be in the partial list.
+	_HqSlabUnlinkPartial(sizeClass, pSlab);
+
+	HqSlabAllocator::SizeClass::SlabMap::Remove(sizeClass.slabs, uintptr_t(pSlab) / HQ_SLAB_SIZE);
+
+	HqMemFree(pSlab);
+
+	--sizeClass.slabCount;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+HqSlabAllocator* HqSlabAllocator::Create()
+{
+	HqSlabAllocator* const pOutput = new HqSlabAllocator();
+	assert(pOutput != nullptr);
+
+	for(size_t i = 0; i < HQ_SLAB_SIZE_CLASS_COUNT; ++i)
+	{
+		SizeClass& sizeClass = pOutput->sizeClasses[i];
+
+		HqMutex::Create(sizeClass.lock);
+		SizeClass::SlabMap::Allocate(sizeClass.slabs);
+
+		sizeClass.pPartialHead = nullptr;
+		sizeClass.blockSize = (i + 1) * HQ_SLAB_SIZE_CLASS_GRANULARITY;
+		sizeClass.slabCount = 0;
+		sizeClass.blocksInUse = 0;
+		sizeClass.blocksPerSlab = uint32_t((HQ_SLAB_SIZE - _HQ_SLAB_HEADER_SIZE) / sizeClass.blockSize);
+	}
+
+	pOutput->pPrev = nullptr;
+	pOutput->pNext = nullptr;
+	pOutput->refCount = 1;
+	pOutput->isRetired = false;
+
+	// Register the allocator so its slabs can be included in the memory stats.
+	{
+		HqScopedMutex lock(slabRegistry.lock);
+
+		pOutput->pNext = slabRegistry.pHead;
+
+		if(slabRegistry.pHead)
+		{
+			slabRegistry.pHead->pPrev = pOutput;
+		}
+
+		slabRegistry.pHead = pOutput;
+	}
+
+	return pOutput;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqSlabAllocator::Release(HqSlabAllocator* const pAllocator)
+{
+	assert(pAllocator != nullptr);
+	assert(!pAllocator->isRetired);
+
+	// Once retired, slabs are destroyed as soon as their last block is freed.
+	HqAtomic::Store(&pAllocator->isRetired, true);
+
+	size_t destroyedCount = 0;
+
+	// Hand any slabs that are already empty back to the main allocator.
+	for(size_t i = 0; i < HQ_SLAB_SIZE_CLASS_COUNT; ++i)
+	{
+		SizeClass& sizeClass = pAllocator->sizeClasses[i];
+
+		HqScopedMutex lock(sizeClass.lock);
+
+		_HqSlab* pSlab = sizeClass.pPartialHead;
+		while(pSlab)
+		{
+			_HqSlab* const pNext = pSlab->pNext;
+
+			if(pSlab->usedCount == 0)
+			{
+				_HqSlabDestroy(sizeClass, pSlab);
+				++destroyedCount;
+			}
+
+			pSlab = pNext;
+		}
+	}
+
+	for(size_t i = 0; i < destroyedCount; ++i)
+	{
+		_releaseRef(pAllocator);
+	}
+
+	// Drop the owner's reference last so the allocator can't go away while it's being swept.
+	_releaseRef(pAllocator);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void* HqSlabAllocator::Alloc(HqSlabAllocator* const pAllocator, const size_t sizeInBytes)
+{
+	const size_t sizeClassIndex = _HqSlabGetSizeClassIndex(sizeInBytes);
+
+	if(!pAllocator || sizeClassIndex >= HQ_SLAB_SIZE_CLASS_COUNT)
+	{
+		return HqMemAlloc(sizeInBytes);
+	}
+
+	SizeClass& sizeClass = pAllocator->sizeClasses[sizeClassIndex];
+
+	HqSlabCache* const pCache = _activeCache;
+
+	if(pCache && pCache->pAllocator == pAllocator)
+	{
+		// The active cache is only ever used by this thread, so it can be popped without taking the lock.
+		HqSlabCache::Bin& bin = pCache->bins[sizeClassIndex];
+
+		if(!bin.pHead)
+		{
+			_refillBin(pAllocator, sizeClass, bin);
+
+			if(!bin.pHead)
+			{
+				return nullptr;
+			}
+		}
+
+		void* const pBlock = bin.pHead;
+
+		bin.pHead = *reinterpret_cast<void**>(pBlock);
+		--bin.count;
+
+		return pBlock;
+	}
+
+	HqScopedMutex lock(sizeClass.lock);
+
+	return _takeBlock(pAllocator, sizeClass);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqSlabAllocator::Free(HqSlabAllocator* const pAllocator, void* const pMem, const size_t sizeInBytes)
+{
+	if(!pMem)
+	{
+		return;
+	}
+
+	const size_t sizeClassIndex = _HqSlabGetSizeClassIndex(sizeInBytes);
+
+	if(!pAllocator || sizeClassIndex >= HQ_SLAB_SIZE_CLASS_COUNT)
+	{
+		HqMemFree(pMem);
+		return;
+	}
+
+	SizeClass& sizeClass = pAllocator->sizeClasses[sizeClassIndex];
+
+	HqSlabCache* const pCache = _activeCache;
+
+	size_t destroyedCount = 0;
+
+	if(pCache && pCache->pAllocator == pAllocator)
+	{
+		HqSlabCache::Bin& bin = pCache->bins[sizeClassIndex];
+
+		*reinterpret_cast<void**>(pMem) = bin.pHead;
+
+		bin.pHead = pMem;
+		++bin.count;
+
+		if(bin.count >= HQ_SLAB_CACHE_BATCH_SIZE * 2)
+		{
+			// Don't let a thread that mostly frees sit on blocks the other threads could be using.
+			destroyedCount = _flushBin(pAllocator, sizeClass, bin, HQ_SLAB_CACHE_BATCH_SIZE);
+		}
+	}
+	else
+	{
+		HqScopedMutex lock(sizeClass.lock);
+
+		if(_returnBlock(pAllocator, sizeClass, pMem))
+		{
+			destroyedCount = 1;
+		}
+	}
+
+	// Slab references can only be dropped after the size class lock has been released
+	// since dropping the last one will dispose of the allocator.
+	for(size_t i = 0; i < destroyedCount; ++i)
+	{
+		_releaseRef(pAllocator);
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqSlabAllocator::InitializeCache(HqSlabCache& output, HqSlabAllocator* const pAllocator)
+{
+	output.pAllocator = pAllocator;
+
+	for(size_t i = 0; i < HQ_SLAB_SIZE_CLASS_COUNT; ++i)
+	{
+		output.bins[i].pHead = nullptr;
+		output.bins[i].count = 0;
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+HqSlabCache* HqSlabAllocator::SwapCache(HqSlabCache* const pCache)
+{
+	HqSlabCache* const pPrevCache = _activeCache;
+
+	_activeCache = pCache;
+
+	return pPrevCache;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqSlabAllocator::FlushCache(HqSlabCache* const pCache)
+{
+	if(!pCache || !pCache->pAllocator)
+	{
+		return;
+	}
+
+	HqSlabAllocator* const pAllocator = pCache->pAllocator;
+
+	size_t destroyedCount = 0;
+
+	for(size_t i = 0; i < HQ_SLAB_SIZE_CLASS_COUNT; ++i)
+	{
+		HqSlabCache::Bin& bin = pCache->bins[i];
+
+		if(bin.count > 0)
+		{
+			destroyedCount += _flushBin(pAllocator, pAllocator->sizeClasses[i], bin, bin.count);
+		}
+	}
+
+	for(size_t i = 0; i < destroyedCount; ++i)
+	{
+		_releaseRef(pAllocator);
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+HqSlabAllocator* HqSlabAllocator::GetActive()
+{
+	return _activeCache
+		? _activeCache->pAllocator
+		: nullptr;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int HqSlabAllocator::GetStats(const size_t sizeClassIndex, HqMemSlabStats& outStats)
+{
+	if(sizeClassIndex >= HQ_SLAB_SIZE_CLASS_COUNT)
+	{
+		return HQ_ERROR_INDEX_OUT_OF_RANGE;
+	}
+
+	outStats.blockSize = (sizeClassIndex + 1) * HQ_SLAB_SIZE_CLASS_GRANULARITY;
+	outStats.slabCount = 0;
+	outStats.blockCapacity = 0;
+	outStats.blocksInUse = 0;
+
+	HqScopedMutex registryLock(slabRegistry.lock);
+
+	// Blocks held in a cache are counted as in use since they can't be handed out to anyone else.
+	for(HqSlabAllocator* pAllocator = slabRegistry.pHead; pAllocator; pAllocator = pAllocator->pNext)
+	{
+		SizeClass& sizeClass = pAllocator->sizeClasses[sizeClassIndex];
+
+		HqScopedMutex lock(sizeClass.lock);
+
+		outStats.slabCount += sizeClass.slabCount;
+		outStats.blockCapacity += sizeClass.slabCount * sizeClass.blocksPerSlab;
+		outStats.blocksInUse += sizeClass.blocksInUse;
+	}
+
+	return HQ_SUCCESS;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqSlabAllocator::_dispose(HqSlabAllocator* const pAllocator)
+{
+	assert(pAllocator != nullptr);
+
+	{
+		HqScopedMutex lock(slabRegistry.lock);
+
+		if(pAllocator->pPrev)
+		{
+			pAllocator->pPrev->pNext = pAllocator->pNext;
+		}
+		else
+		{
+			slabRegistry.pHead = pAllocator->pNext;
+		}
+
+		if(pAllocator->pNext)
+		{
+			pAllocator->pNext->pPrev = pAllocator->pPrev;
+		}
+	}
+
+	for(size_t i = 0; i < HQ_SLAB_SIZE_CLASS_COUNT; ++i)
+	{
+		SizeClass& sizeClass = pAllocator->sizeClasses[i];
+
+		assert(sizeClass.slabCount == 0);
+		assert(sizeClass.blocksInUse == 0);
+
+		SizeClass::SlabMap::Dispose(sizeClass.slabs);
+		HqMutex::Dispose(sizeClass.lock);
+	}
+
+	delete pAllocator;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqSlabAllocator::_releaseRef(HqSlabAllocator* const pAllocator)
+{
+	const int32_t lastRefCount = HqAtomic::FetchAdd(&pAllocator->refCount, -1);
+	assert(lastRefCount > 0);
+
+	if(lastRefCount == 1)
+	{
+		_dispose(pAllocator);
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void* HqSlabAllocator::_takeBlock(HqSlabAllocator* const pAllocator, SizeClass& sizeClass)
+{
+	_HqSlab* pSlab = sizeClass.pPartialHead;
+
+	if(!pSlab)
+	{
+		pSlab = _HqSlabCreate(pAllocator, sizeClass);
+		if(!pSlab)
+		{
+			return nullptr;
+		}
+	}
+
+	void* pBlock = nullptr;
+
+	if(pSlab->pFreeHead)
+	{
+		// Reuse the most recently freed block.
+		pBlock = pSlab->pFreeHead;
+		pSlab->pFreeHead = *reinterpret_cast<void**>(pBlock);
+	}
+	else
+	{
+		// Carve a new block off the untouched end of the slab.
+		assert(pSlab->carvedCount < sizeClass.blocksPerSlab);
+
+		pBlock = reinterpret_cast<uint8_t*>(pSlab) + _HQ_SLAB_HEADER_SIZE + (pSlab->carvedCount * sizeClass.blockSize);
+		++pSlab->carvedCount;
+	}
+
+	++pSlab->usedCount;
+	++sizeClass.blocksInUse;
+
+	if(pSlab->usedCount == sizeClass.blocksPerSlab)
+	{
+		// Full slabs are dropped from the partial list so finding room never has to skip over them.
+		_HqSlabUnlinkPartial(sizeClass, pSlab);
+	}
+
+	return pBlock;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+bool HqSlabAllocator::_returnBlock(HqSlabAllocator* const pAllocator, SizeClass& sizeClass, void* const pBlock)
+{
+	_HqSlab* const pSlab = _HqSlabFindOwner(sizeClass, pBlock);
+	assert(pSlab != nullptr);
+	assert(pSlab->usedCount > 0);
+
+	if(pSlab->usedCount == sizeClass.blocksPerSlab)
+	{
+		// The slab is about to have room again.
+		_HqSlabLinkPartial(sizeClass, pSlab);
+	}
+
+	*reinterpret_cast<void**>(pBlock) = pSlab->pFreeHead;
+
+	pSlab->pFreeHead = pBlock;
+
+	--pSlab->usedCount;
+	--sizeClass.blocksInUse;
+
+	if(pSlab->usedCount == 0 && pAllocator->isRetired)
+	{
+		_HqSlabDestroy(sizeClass, pSlab);
+		return true;
+	}
+
+	return false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqSlabAllocator::_refillBin(HqSlabAllocator* const pAllocator, SizeClass& sizeClass, HqSlabCache::Bin& bin)
+{
+	HqScopedMutex lock(sizeClass.lock);
+
+	for(uint32_t i = 0; i < HQ_SLAB_CACHE_BATCH_SIZE; ++i)
+	{
+		void* const pBlock = _takeBlock(pAllocator, sizeClass);
+		if(!pBlock)
+		{
+			break;
+		}
+
+		*reinterpret_cast<void**>(pBlock) = bin.pHead;
+
+		bin.pHead = pBlock;
+		++bin.count;
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+size_t HqSlabAllocator::_flushBin(
+	HqSlabAllocator* const pAllocator,
+	SizeClass& sizeClass,
+	HqSlabCache::Bin& bin,
+	const uint32_t count
+)
+{
+	assert(count <= bin.count);
+
+	size_t destroyedCount = 0;
+
+	HqScopedMutex lock(sizeClass.lock);
+
+	for(uint32_t i = 0; i < count; ++i)
+	{
+		void* const pBlock = bin.pHead;
+
+		bin.pHead = *reinterpret_cast<void**>(pBlock);
+		--bin.count;
+
+		if(_returnBlock(pAllocator, sizeClass, pBlock))
+		{
+			++destroyedCount;
+		}
+	}
+
+	return destroyedCount;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void* HqSlabAllocator::operator new(const size_t sizeInBytes)
+{
+	return HqMemAlloc(sizeInBytes);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqSlabAllocator::operator delete(void* const pObject)
+{
+	HqMemFree(pObject);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,143 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+#pragma once
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#include "../Harlequin.h"
+
+#include "Mutex.hpp"
+
+#include "../common/HashMap.hpp"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#define HQ_SLAB_SIZE_CLASS_GRANULARITY 16
+#define HQ_SLAB_SIZE_CLASS_COUNT       16
+#define HQ_SLAB_MAX_BLOCK_SIZE         (HQ_SLAB_SIZE_CLASS_GRANULARITY * HQ_SLAB_SIZE_CLASS_COUNT)
+#define HQ_SLAB_SIZE                   16384
+#define HQ_SLAB_CACHE_BATCH_SIZE       32
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct HqSlabAllocator;
+struct _HqSlab;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct HqSlabCache
+{
+	struct Bin
+	{
+		void* pHead;
+
+		uint32_t count;
+	};
+
+	HqSlabAllocator* pAllocator;
+
+	Bin bins[HQ_SLAB_SIZE_CLASS_COUNT];
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct HQ_BASE_API HqSlabAllocator
+{
+	struct SizeClass
+	{
+		typedef HqHashMap<uintptr_t, _HqSlab*> SlabMap;
+
+		HqMutex lock;
+
+		// Every slab is keyed by its start address divided by the slab size, so the owner of any block
+		// can be found by checking the key for the block address and the key just before it.
+		SlabMap slabs;
+
+		// Slabs that have at least one block available.
+		_HqSlab* pPartialHead;
+
+		size_t blockSize;
+		size_t slabCount;
+		size_t blocksInUse;
+
+		uint32_t blocksPerSlab;
+	};
+
+	static HqSlabAllocator* Create();
+	static void Release(HqSlabAllocator* pAllocator);
+
+	static void* Alloc(HqSlabAllocator* pAllocator, const size_t sizeInBytes);
+	static void Free(HqSlabAllocator* pAllocator, void* const pMem, const size_t sizeInBytes);
+
+	static void InitializeCache(HqSlabCache& output, HqSlabAllocator* pAllocator);
+	static HqSlabCache* SwapCache(HqSlabCache* const pCache);
+	static void FlushCache(HqSlabCache* const pCache);
+
+	static HqSlabAllocator* GetActive();
+
+	static int GetStats(const size_t sizeClass, HqMemSlabStats& outStats);
+
+	static void _dispose(HqSlabAllocator*);
+	static void _releaseRef(HqSlabAllocator*);
+	static void* _takeBlock(HqSlabAllocator*, SizeClass&);
+	static bool _returnBlock(HqSlabAllocator*, SizeClass&, void*);
+	static void _refillBin(HqSlabAllocator*, SizeClass&, HqSlabCache::Bin&);
+	static size_t _flushBin(HqSlabAllocator*, SizeClass&, HqSlabCache::Bin&, uint32_t);
+
+	void* operator new(const size_t sizeInBytes);
+	void operator delete(void* const pObject);
+
+	SizeClass sizeClasses[HQ_SLAB_SIZE_CLASS_COUNT];
+
+	HqSlabAllocator* pPrev;
+	HqSlabAllocator* pNext;
+
+	// One reference is held by the owner of the allocator and one more by each live slab, so a retired
+	// allocator stays around until the last block allocated from it has been freed.
+	volatile int32_t refCount;
+
+	volatile bool isRetired;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class HqScopedSlabCache
+{
+public:
+
+	HqScopedSlabCache() = delete;
+	HqScopedSlabCache(const HqScopedSlabCache&) = delete;
+	HqScopedSlabCache(HqScopedSlabCache&&) = delete;
+
+	explicit HqScopedSlabCache(HqSlabCache* const pCache)
+		: m_pPrevCache(HqSlabAllocator::SwapCache(pCache))
+	{
+	}
+
+	~HqScopedSlabCache()
+	{
+		HqSlabAllocator::SwapCache(m_pPrevCache);
+	}
+
+
+private:
+
+	HqSlabCache* m_pPrevCache;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
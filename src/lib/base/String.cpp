@@ -16,6 +16,7 @@
 // IN THE SOFTWARE.
 //
 
+#include "SlabAllocator.hpp"
 #include "String.hpp"
 #include "System.hpp"
 
@@ -471,11 +472,15 @@ inline void _HqStringStrictCaseOperation(HqString* const pString, size_t (*FullC
 
 HqString* HqString::Create(const char* const stringData)
 {
-	HqString* const pOutput = new HqString();
+	// Strings have no owner, so they come from the slabs of whichever VM is running on this thread (if any).
+	HqSlabAllocator* const pAllocator = HqSlabAllocator::GetActive();
+
+	HqString* const pOutput = new(pAllocator) HqString();
 	assert(pOutput != nullptr);
 
 	const size_t length = (stringData) ? strlen(stringData) : 0;
 
+	pOutput->pAllocator = pAllocator;
 	pOutput->length = length;
 	pOutput->hash = RawHash(stringData ? stringData : "");
 	pOutput->data = reinterpret_cast<char*>(HqMemAlloc(length + 1));
@@ -500,7 +505,9 @@ HqString* HqString::CreateFmt(const char* const fmt, ...)
 		return Create("");
 	}
 
-	HqString* const pOutput = new HqString();
+	HqSlabAllocator* const pAllocator = HqSlabAllocator::GetActive();
+
+	HqString* const pOutput = new(pAllocator) HqString();
 	assert(pOutput != nullptr);
 
 	va_list vl;
@@ -513,6 +520,7 @@ HqString* HqString::CreateFmt(const char* const fmt, ...)
 
 	const size_t length = strlen(stringData);
 
+	pOutput->pAllocator = pAllocator;
 	pOutput->length = length;
 	pOutput->hash = RawHash(stringData);
 	pOutput->data = stringData;
@@ -694,21 +702,22 @@ void HqString::_onDestruct(void* const pOpaque)
 		HqMemFree(pString->data);
 	}
 
-	delete pString;
+	// Strings have nothing to destruct, so they can be handed straight back to whatever allocated them.
+	HqString::operator delete(pString, pString->pAllocator);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
-void* HqString::operator new(const size_t sizeInBytes)
+void* HqString::operator new(const size_t sizeInBytes, HqSlabAllocator* const pAllocator)
 {
-	return HqMemAlloc(sizeInBytes);
+	return HqSlabAllocator::Alloc(pAllocator, sizeInBytes);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
-void HqString::operator delete(void* const pObject)
+void HqString::operator delete(void* const pObject, HqSlabAllocator* const pAllocator)
 {
-	HqMemFree(pObject);
+	HqSlabAllocator::Free(pAllocator, pObject, sizeof(HqString));
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -26,6 +26,10 @@
 
 //----------------------------------------------------------------------------------------------------------------------
 
+struct HqSlabAllocator;
+
+//----------------------------------------------------------------------------------------------------------------------
+
 struct HQ_BASE_API HqString
 {
 	struct HQ_BASE_API StlCompare
@@ -61,11 +65,13 @@ struct HQ_BASE_API HqString
 
 	static void _onDestruct(void*);
 
-	void* operator new(const size_t sizeInBytes);
-	void operator delete(void* const pObject);
+	void* operator new(const size_t sizeInBytes, HqSlabAllocator* const pAllocator);
+	void operator delete(void* const pObject, HqSlabAllocator* const pAllocator);
 
 	HqReference ref;
 
+	HqSlabAllocator* pAllocator;
+
 	size_t length;
 	size_t hash;
 
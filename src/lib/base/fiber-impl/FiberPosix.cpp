@@ -17,6 +17,7 @@
 //
 
 #include "../Fiber.hpp"
+#include "../Mutex.hpp"
 
 #include <assert.h>
 #include <memory.h>
@@ -36,6 +37,24 @@
 	#endif
 #endif
 
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+	#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+#ifndef MAP_NORESERVE
+	#define MAP_NORESERVE 0
+#endif
+
+#ifndef MAP_STACK
+	#define MAP_STACK 0
+#endif
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// Maximum number of released fiber stacks kept around for reuse. Pooled stacks have their pages given
+// back to the OS, so the cap only limits how much address space is held by stacks that aren't in use.
+#define HQ_FIBER_STACK_POOL_CAPACITY 64
+
 //----------------------------------------------------------------------------------------------------------------------
 
 struct _HqInternalFiberConfig
@@ -44,6 +63,116 @@ struct _HqInternalFiberConfig
 	HqFiberConfig data;
 };
 
+struct _HqFiberStack
+{
+	void* pMemory;
+	size_t totalSize;
+};
+
+struct _HqFiberStackPool
+{
+	_HqFiberStackPool()
+		: count(0)
+	{
+		HqMutex::Create(lock);
+	}
+
+	~_HqFiberStackPool()
+	{
+		for(size_t i = 0; i < count; ++i)
+		{
+			munmap(stacks[i].pMemory, stacks[i].totalSize);
+		}
+
+		HqMutex::Dispose(lock);
+	}
+
+	HqMutex lock;
+
+	_HqFiberStack stacks[HQ_FIBER_STACK_POOL_CAPACITY];
+	size_t count;
+};
+
+static _HqFiberStackPool fiberStackPool;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static void* _HqFiberAcquireStack(const size_t totalStackSize, const size_t pageSize)
+{
+	{
+		HqScopedMutex lock(fiberStackPool.lock);
+
+		// Reuse a previously released stack of the same size.
+		for(size_t i = fiberStackPool.count; i > 0; --i)
+		{
+			_HqFiberStack& stack = fiberStackPool.stacks[i - 1];
+
+			if(stack.totalSize == totalStackSize)
+			{
+				void* const pMemory = stack.pMemory;
+
+				stack = fiberStackPool.stacks[fiberStackPool.count - 1];
+				--fiberStackPool.count;
+
+				return pMemory;
+			}
+		}
+	}
+
+	// Reserve the stack without committing it; the OS will only back the pages the fiber actually touches.
+	void* const pMemory = mmap(
+		nullptr,
+		totalStackSize,
+		PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_STACK,
+		-1,
+		0
+	);
+	if(pMemory == MAP_FAILED)
+	{
+		return nullptr;
+	}
+
+	// Disable access to the page just prior to the beginning of stack memory
+	// and to the page after the end of stack memory.
+	if(mprotect(pMemory, pageSize, PROT_NONE) != 0
+		|| mprotect(reinterpret_cast<uint8_t*>(pMemory) + totalStackSize - pageSize, pageSize, PROT_NONE) != 0)
+	{
+		munmap(pMemory, totalStackSize);
+		return nullptr;
+	}
+
+	return pMemory;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static void _HqFiberReleaseStack(void* const pMemory, const size_t totalStackSize, const size_t pageSize)
+{
+	// Give the physical pages back to the OS while keeping the address range (and its guard pages) reserved. This
+	// is done before taking the pool lock since it can take a while for large stacks that have been mostly touched.
+	const int adviseResult = madvise(reinterpret_cast<uint8_t*>(pMemory) + pageSize, totalStackSize - (pageSize * 2), MADV_DONTNEED);
+	assert(adviseResult == 0); (void) adviseResult;
+
+	{
+		HqScopedMutex lock(fiberStackPool.lock);
+
+		if(fiberStackPool.count < HQ_FIBER_STACK_POOL_CAPACITY)
+		{
+			_HqFiberStack& stack = fiberStackPool.stacks[fiberStackPool.count];
+			stack.pMemory = pMemory;
+			stack.totalSize = totalStackSize;
+
+			++fiberStackPool.count;
+			return;
+		}
+	}
+
+	// The pool is full, so unmap the stack entirely.
+	const int unmapResult = munmap(pMemory, totalStackSize);
+	assert(unmapResult == 0); (void) unmapResult;
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 
 extern "C" void __attribute__((noreturn)) _HqFiberEntryPoint(const uint32_t argLsb, const uint32_t argMsb)
@@ -79,7 +208,7 @@ extern "C" void __attribute__((noreturn)) _HqFiberEntryPoint(const uint32_t argL
 
 //----------------------------------------------------------------------------------------------------------------------
 
-extern "C" void _HqFiberImplCreate(HqInternalFiber& obj, const HqFiberConfig& fiberConfig)
+extern "C" bool _HqFiberImplCreate(HqInternalFiber& obj, const HqFiberConfig& fiberConfig)
 {
 	assert(obj.pStack == nullptr);
 
@@ -106,17 +235,14 @@ extern "C" void _HqFiberImplCreate(HqInternalFiber& obj, const HqFiberConfig& fi
 	internalConfig.data = fiberConfig;
 	internalConfig.data.stackSize = usableStackSize;
 
-	// Allocate the fiber's stack.
-	const int stackAllocResult = posix_memalign(&obj.pStack, pageSize, totalStackSize);
-	assert(stackAllocResult == 0); (void) stackAllocResult;
-
-	// Disable access to the page just prior to the beginning of stack memory.
-	const int stackHeadProtectResult = mprotect(obj.pStack, pageSize, PROT_NONE);
-	assert(stackHeadProtectResult == 0); (void) stackHeadProtectResult;
+	// Get the fiber's stack from the pool.
+	void* const pStack = _HqFiberAcquireStack(totalStackSize, pageSize);
+	if(!pStack)
+	{
+		return false;
+	}
 
-	// Disable access to the page after the end of stack memory.
-	const int stackTailProtectResult = mprotect(reinterpret_cast<uint8_t*>(obj.pStack) + pageSize + usableStackSize, pageSize, PROT_NONE);
-	assert(stackTailProtectResult == 0); (void) stackTailProtectResult;
+	obj.pStack = pStack;
 
 	obj.pUsableStack = reinterpret_cast<uint8_t*>(obj.pStack) + pageSize;
 	obj.usableStackSize = usableStackSize;
@@ -162,6 +288,8 @@ extern "C" void _HqFiberImplCreate(HqInternalFiber& obj, const HqFiberConfig& fi
 #ifdef _HQ_ENABLE_VALGRIND
 	obj.valgrindStackId = VALGRIND_STACK_REGISTER(obj.pUsableStack, reinterpret_cast<uint8_t*>(obj.pUsableStack) + usableStackSize);
 #endif
+
+	return true;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -174,11 +302,8 @@ extern "C" void _HqFiberImplDispose(HqInternalFiber& obj)
 	VALGRIND_STACK_DEREGISTER(obj.valgrindStackId);
 #endif
 
-	// Make the entire contents of the stack allocation accessible again.
-	const int unprotectStackResult = mprotect(obj.pStack, obj.totalStackSize, PROT_WRITE | PROT_READ);
-	assert(unprotectStackResult == 0); (void) unprotectStackResult;
-
-	free(obj.pStack);
+	// Return the stack to the pool so the next fiber can reuse it.
+	_HqFiberReleaseStack(obj.pStack, obj.totalStackSize, getpagesize());
 
 	obj = HqInternalFiber();
 }
@@ -233,8 +358,6 @@ extern "C" bool _HqFiberImplWait(HqInternalFiber& obj)
 
 extern "C" bool _HqFiberImplIsRunning(HqInternalFiber& obj)
 {
-	assert(obj.pStack != nullptr);
-
 	return obj.running;
 }
 
@@ -242,8 +365,6 @@ extern "C" bool _HqFiberImplIsRunning(HqInternalFiber& obj)
 
 extern "C" bool _HqFiberImplIsComplete(HqInternalFiber& obj)
 {
-	assert(obj.pStack != nullptr);
-
 	return obj.completed;
 }
 
@@ -80,7 +80,7 @@ extern "C" __declspec(noreturn) void WINAPI _HqWin32FiberEntryPoint(void* const
 
 //----------------------------------------------------------------------------------------------------------------------
 
-extern "C" void _HqFiberImplCreate(HqInternalFiber& obj, const HqFiberConfig& fiberConfig)
+extern "C" bool _HqFiberImplCreate(HqInternalFiber& obj, const HqFiberConfig& fiberConfig)
 {
 	assert(obj.pFiberContext == nullptr);
 
@@ -110,13 +110,18 @@ extern "C" void _HqFiberImplCreate(HqInternalFiber& obj, const HqFiberConfig& fi
 
 	// Create the native fiber.
 	obj.pFiberContext = CreateFiber(usableStackSize, _HqWin32FiberEntryPoint, &internalConfig);
-	assert(obj.pFiberContext != nullptr);
+	if(!obj.pFiberContext)
+	{
+		return false;
+	}
 
 	// Bootstrap the fiber by running the first few lines of its entry point function.
 	obj.pReturnContext = _HqWin32FiberGetSelf();
 	SwitchToFiber(obj.pFiberContext);
 
 	obj.pReturnContext = nullptr;
+
+	return true;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -183,8 +188,6 @@ extern "C" bool _HqFiberImplWait(HqInternalFiber& obj)
 
 extern "C" bool _HqFiberImplIsRunning(HqInternalFiber& obj)
 {
-	assert(obj.pFiberContext != nullptr);
-
 	return obj.running;
 }
 
@@ -192,8 +195,6 @@ extern "C" bool _HqFiberImplIsRunning(HqInternalFiber& obj)
 
 extern "C" bool _HqFiberImplIsComplete(HqInternalFiber& obj)
 {
-	assert(obj.pFiberContext != nullptr);
-
 	return obj.completed;
 }
 
@@ -113,6 +113,10 @@ enum HqOpCodeEnum
 	HQ_OP_CODE_MOVE,
 	HQ_OP_CODE_COPY,
 
+	HQ_OP_CODE_CALL_WINDOW,
+	HQ_OP_CODE_TAIL_CALL,
+	HQ_OP_CODE_TAIL_CALL_VALUE,
+
 	HQ_OP_CODE__TOTAL_COUNT,
 };
 
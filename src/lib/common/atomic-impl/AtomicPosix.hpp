@@ -45,6 +45,35 @@ struct HqAtomic
 	{
 		return __atomic_fetch_add(ptr, value, __ATOMIC_SEQ_CST);
 	}
+
+	static inline __attribute__((always_inline)) bool CompareExchange(volatile int32_t* const ptr, int32_t expected, const int32_t desired)
+	{
+		return __atomic_compare_exchange_n(ptr, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+	}
+
+	template<typename T>
+	static inline __attribute__((always_inline)) T Load(const volatile T* const ptr)
+	{
+		return __atomic_load_n(ptr, __ATOMIC_RELAXED);
+	}
+
+	template<typename T>
+	static inline __attribute__((always_inline)) T LoadAcquire(const volatile T* const ptr)
+	{
+		return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+	}
+
+	template<typename T>
+	static inline __attribute__((always_inline)) void Store(volatile T* const ptr, const T value)
+	{
+		__atomic_store_n(ptr, value, __ATOMIC_RELAXED);
+	}
+
+	template<typename T>
+	static inline __attribute__((always_inline)) void StoreRelease(volatile T* const ptr, const T value)
+	{
+		__atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+	}
 };
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -71,6 +71,41 @@ struct HqAtomic
 
 #endif
 	}
+
+	static __forceinline bool CompareExchange(volatile int32_t* const ptr, const int32_t expected, const int32_t desired)
+	{
+		return _InterlockedCompareExchange((volatile long*) ptr, long(desired), long(expected)) == long(expected);
+	}
+
+	// Aligned loads and stores up to the native word size are already atomic, and volatile accesses have acquire
+	// and release semantics with MSVC's default /volatile:ms behavior, so these only need to keep the compiler
+	// from reordering the surrounding code.
+	template<typename T>
+	static __forceinline T Load(const volatile T* const ptr)
+	{
+		return (*ptr);
+	}
+
+	template<typename T>
+	static __forceinline T LoadAcquire(const volatile T* const ptr)
+	{
+		const T value = (*ptr);
+		_ReadWriteBarrier();
+		return value;
+	}
+
+	template<typename T>
+	static __forceinline void Store(volatile T* const ptr, const T value)
+	{
+		(*ptr) = value;
+	}
+
+	template<typename T>
+	static __forceinline void StoreRelease(volatile T* const ptr, const T value)
+	{
+		_ReadWriteBarrier();
+		(*ptr) = value;
+	}
 };
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -20,11 +20,21 @@
 
 //----------------------------------------------------------------------------------------------------------------------
 
+#include "../../Harlequin.h"
+
 #include <string.h>
 #include <stdint.h>
 
 //----------------------------------------------------------------------------------------------------------------------
 
+// Each function table entry includes the function's frame size. Modules without this flag were written
+// before frame sizes were recorded, so their functions are loaded with the largest possible frame.
+#define HQ_MODULE_FORMAT_FLAG_FRAME_SIZES 0x01
+
+#define HQ_MODULE_FORMAT_FLAG__ALL (HQ_MODULE_FORMAT_FLAG_FRAME_SIZES)
+
+//----------------------------------------------------------------------------------------------------------------------
+
 struct HqModuleFileHeader
 {
 	static void Initialize(HqModuleFileHeader& output)
@@ -36,6 +46,10 @@ struct HqModuleFileHeader
 		output.magicNumber[2] = 'M';
 		output.magicNumber[3] = '\0';
 
+		output.bytecodeEncoding = HQ_BYTECODE_ENCODING_STANDARD;
+		output.callingConvention = HQ_CALLING_CONVENTION_IO_REGISTER;
+		output.formatFlags = HQ_MODULE_FORMAT_FLAG__ALL;
+
 #ifdef HQ_CPU_ENDIAN_LITTLE
 		output.isBigEndian = false;
 #else
@@ -44,7 +58,10 @@ struct HqModuleFileHeader
 	}
 
 	uint8_t magicNumber[4];
-	uint8_t reserved[11];
+	uint8_t bytecodeEncoding;
+	uint8_t callingConvention;
+	uint8_t formatFlags;
+	uint8_t reserved[8];
 
 	bool isBigEndian;
 };
@@ -68,6 +68,11 @@ struct HqFunctionData
 	uint16_t numParameters;
 	uint16_t numReturnValues;
 
+	// Frame requirements of script functions, calculated from the bytecode when the module is serialized.
+	uint16_t gpRegisterCount;
+	uint16_t vrRegisterCount;
+	uint16_t stackSize;
+
 	bool isNative;
 };
 
@@ -549,6 +549,9 @@ int HqModuleWriterAddFunction(
 	function.bytecode = std::move(bytecode);
 	function.numParameters = numParameters;
 	function.numReturnValues = numReturnValues;
+	function.gpRegisterCount = 0;
+	function.vrRegisterCount = 0;
+	function.stackSize = 0;
 	function.isNative = false;
 
 	hModuleWriter->functions.emplace(pSignature, function);
@@ -593,6 +596,9 @@ int HqModuleWriterAddNativeFunction(
 
 	function.numParameters = numParameters;
 	function.numReturnValues = numReturnValues;
+	function.gpRegisterCount = 0;
+	function.vrRegisterCount = 0;
+	function.stackSize = 0;
 	function.isNative = true;
 
 	hModuleWriter->functions.emplace(pSignature, function);
@@ -736,6 +742,38 @@ int HqModuleWriterAddExceptionHandler(
 
 //----------------------------------------------------------------------------------------------------------------------
 
+int HqModuleWriterSetBytecodeEncoding(HqModuleWriterHandle hModuleWriter, const int encoding)
+{
+	if(!hModuleWriter
+		|| encoding < 0
+		|| encoding >= HQ_BYTECODE_ENCODING__COUNT)
+	{
+		return HQ_ERROR_INVALID_ARG;
+	}
+
+	hModuleWriter->bytecodeEncoding = encoding;
+
+	return HQ_SUCCESS;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int HqModuleWriterSetCallingConvention(HqModuleWriterHandle hModuleWriter, const int convention)
+{
+	if(!hModuleWriter
+		|| convention < 0
+		|| convention >= HQ_CALLING_CONVENTION__COUNT)
+	{
+		return HQ_ERROR_INVALID_ARG;
+	}
+
+	hModuleWriter->callingConvention = convention;
+
+	return HQ_SUCCESS;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 int HqModuleWriterSerialize(
 	HqModuleWriterHandle hModuleWriter,
 	HqSerializerHandle hSerializer)
@@ -753,6 +791,7 @@ int HqModuleWriterSerialize(
 		HqSerializerHandle hInitSerializer = HQ_SERIALIZER_HANDLE_NULL;
 		HqSerializerCreate(&hInitSerializer, HQ_SERIALIZER_MODE_WRITER);
 		HqSerializerSetEndianness(hInitSerializer, hSerializer->endianness);
+		HqBytecodeSetEncoding(hInitSerializer, hModuleWriter->bytecodeEncoding);
 
 		// The default init function just returns.
 		HqBytecodeEmitReturn(hInitSerializer);
@@ -779,55 +818,142 @@ int HqModuleWriterSerialize(
 
 //----------------------------------------------------------------------------------------------------------------------
 
-#define _HQ_WRITE_OP_BOOL(x) \
-	if(HqSerializerWriteUint32(hSerializer, (x) ? 1 : 0) != HQ_SUCCESS) { \
-		return HQ_ERROR_NO_WRITE; \
+int HqBytecodeSetEncoding(HqSerializerHandle hSerializer, const int encoding)
+{
+	if(!hSerializer
+		|| encoding < 0
+		|| encoding >= HQ_BYTECODE_ENCODING__COUNT)
+	{
+		return HQ_ERROR_INVALID_ARG;
 	}
 
-#define _HQ_EMIT_UBYTE(x) \
-	if(HqSerializerWriteUint32(hSerializer, uint32_t(x)) != HQ_SUCCESS) { \
-		return HQ_ERROR_NO_WRITE; \
+	hSerializer->bytecodeEncoding = encoding;
+
+	return HQ_SUCCESS;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int HqBytecodeGetEncoding(HqSerializerHandle hSerializer)
+{
+	if(!hSerializer)
+	{
+		return HQ_BYTECODE_ENCODING_STANDARD;
 	}
-#define _HQ_EMIT_SBYTE(x) \
-	if(HqSerializerWriteInt32(hSerializer, int32_t(x)) != HQ_SUCCESS) { \
+
+	return hSerializer->bytecodeEncoding;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _HqEmitVarUint(HqSerializerHandle hSerializer, uint64_t value)
+{
+	// Variable-width values are written 7 bits at a time, low bits first,
+	// with the high bit of each byte set when more bytes follow.
+	uint8_t bytes[10];
+	size_t length = 0;
+
+	do
+	{
+		uint8_t byte = uint8_t(value & 0x7F);
+		value >>= 7;
+
+		if(value != 0)
+		{
+			byte |= 0x80;
+		}
+
+		bytes[length] = byte;
+		++length;
+	} while(value != 0);
+
+	// Write the encoded value all at once so a failure can't leave a partial value in the stream.
+	return HqSerializerWriteBuffer(hSerializer, length, bytes);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _HqEmitVarInt(HqSerializerHandle hSerializer, const int64_t value)
+{
+	// Zigzag encode signed values so small negative numbers stay small.
+	return _HqEmitVarUint(hSerializer, (uint64_t(value) << 1) ^ uint64_t(value >> 63));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#define _HQ_IS_COMPACT() (hSerializer->bytecodeEncoding == HQ_BYTECODE_ENCODING_COMPACT)
+
+#define _HQ_EMIT_CHECKED(x) \
+	if((x) != HQ_SUCCESS) { \
 		return HQ_ERROR_NO_WRITE; \
 	}
 
+#define _HQ_WRITE_OP_BOOL(x) \
+	_HQ_EMIT_CHECKED(_HQ_IS_COMPACT() \
+		? HqSerializerWriteUint8(hSerializer, (x) ? 1 : 0) \
+		: HqSerializerWriteUint32(hSerializer, (x) ? 1 : 0))
+
+#define _HQ_EMIT_OPCODE(x) \
+	_HQ_EMIT_CHECKED(_HQ_IS_COMPACT() \
+		? HqSerializerWriteUint8(hSerializer, uint8_t(x)) \
+		: HqSerializerWriteUint32(hSerializer, uint32_t(x)))
+
+#define _HQ_IS_VALID_REGISTER(x) (!_HQ_IS_COMPACT() || (x) <= UINT8_MAX)
+
+#define _HQ_EMIT_REGISTER(x) \
+	assert(_HQ_IS_VALID_REGISTER(x)); \
+	_HQ_EMIT_CHECKED(_HQ_IS_COMPACT() \
+		? HqSerializerWriteUint8(hSerializer, uint8_t(x)) \
+		: HqSerializerWriteUint32(hSerializer, uint32_t(x)))
+
+#define _HQ_EMIT_INDEX(x) \
+	_HQ_EMIT_CHECKED(_HQ_IS_COMPACT() \
+		? _HqEmitVarUint(hSerializer, uint64_t(x)) \
+		: HqSerializerWriteUint32(hSerializer, uint32_t(x)))
+
+#define _HQ_EMIT_OFFSET(x) \
+	_HQ_EMIT_CHECKED(HqSerializerWriteInt32(hSerializer, int32_t(x)))
+
+#define _HQ_EMIT_UBYTE(x) \
+	_HQ_EMIT_CHECKED(_HQ_IS_COMPACT() \
+		? HqSerializerWriteUint8(hSerializer, uint8_t(x)) \
+		: HqSerializerWriteUint32(hSerializer, uint32_t(x)))
+#define _HQ_EMIT_SBYTE(x) \
+	_HQ_EMIT_CHECKED(_HQ_IS_COMPACT() \
+		? HqSerializerWriteInt8(hSerializer, int8_t(x)) \
+		: HqSerializerWriteInt32(hSerializer, int32_t(x)))
+
 #define _HQ_EMIT_UWORD(x) \
-	if(HqSerializerWriteUint32(hSerializer, uint32_t(x)) != HQ_SUCCESS) { \
-		return HQ_ERROR_NO_WRITE; \
-	}
+	_HQ_EMIT_CHECKED(_HQ_IS_COMPACT() \
+		? HqSerializerWriteUint16(hSerializer, uint16_t(x)) \
+		: HqSerializerWriteUint32(hSerializer, uint32_t(x)))
 #define _HQ_EMIT_SWORD(x) \
-	if(HqSerializerWriteInt32(hSerializer, int32_t(x)) != HQ_SUCCESS) { \
-		return HQ_ERROR_NO_WRITE; \
-	}
+	_HQ_EMIT_CHECKED(_HQ_IS_COMPACT() \
+		? HqSerializerWriteInt16(hSerializer, int16_t(x)) \
+		: HqSerializerWriteInt32(hSerializer, int32_t(x)))
 
 #define _HQ_EMIT_UDWORD(x) \
-	if(HqSerializerWriteUint32(hSerializer, (x)) != HQ_SUCCESS) { \
-		return HQ_ERROR_NO_WRITE; \
-	}
+	_HQ_EMIT_CHECKED(_HQ_IS_COMPACT() \
+		? _HqEmitVarUint(hSerializer, uint64_t(x)) \
+		: HqSerializerWriteUint32(hSerializer, (x)))
 #define _HQ_EMIT_SDWORD(x) \
-	if(HqSerializerWriteInt32(hSerializer, (x)) != HQ_SUCCESS) { \
-		return HQ_ERROR_NO_WRITE; \
-	}
+	_HQ_EMIT_CHECKED(_HQ_IS_COMPACT() \
+		? _HqEmitVarInt(hSerializer, int64_t(x)) \
+		: HqSerializerWriteInt32(hSerializer, (x)))
 
 #define _HQ_EMIT_UQWORD(x) \
-	if(HqSerializerWriteUint64(hSerializer, (x)) != HQ_SUCCESS) { \
-		return HQ_ERROR_NO_WRITE; \
-	}
+	_HQ_EMIT_CHECKED(_HQ_IS_COMPACT() \
+		? _HqEmitVarUint(hSerializer, (x)) \
+		: HqSerializerWriteUint64(hSerializer, (x)))
 #define _HQ_EMIT_SQWORD(x) \
-	if(HqSerializerWriteInt64(hSerializer, (x)) != HQ_SUCCESS) { \
-		return HQ_ERROR_NO_WRITE; \
-	}
+	_HQ_EMIT_CHECKED(_HQ_IS_COMPACT() \
+		? _HqEmitVarInt(hSerializer, (x)) \
+		: HqSerializerWriteInt64(hSerializer, (x)))
 
 #define _HQ_EMIT_FLOAT(x) \
-	if(HqSerializerWriteFloat32(hSerializer, (x)) != HQ_SUCCESS) { \
-		return HQ_ERROR_NO_WRITE; \
-	}
+	_HQ_EMIT_CHECKED(HqSerializerWriteFloat32(hSerializer, (x)))
 #define _HQ_EMIT_DOUBLE(x) \
-	if(HqSerializerWriteFloat64(hSerializer, (x)) != HQ_SUCCESS) { \
-		return HQ_ERROR_NO_WRITE; \
-	}
+	_HQ_EMIT_CHECKED(HqSerializerWriteFloat64(hSerializer, (x)))
 
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -838,7 +964,7 @@ int HqBytecodeEmitNop(HqSerializerHandle hSerializer)
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_NOP);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_NOP);
 
 	return HQ_SUCCESS;
 }
@@ -852,7 +978,7 @@ int HqBytecodeEmitAbort(HqSerializerHandle hSerializer)
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_ABORT);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_ABORT);
 
 	return HQ_SUCCESS;
 }
@@ -866,7 +992,7 @@ int HqBytecodeEmitReturn(HqSerializerHandle hSerializer)
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_RETURN);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_RETURN);
 
 	return HQ_SUCCESS;
 }
@@ -880,7 +1006,7 @@ int HqBytecodeEmitYield(HqSerializerHandle hSerializer)
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_YIELD);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_YIELD);
 
 	return HQ_SUCCESS;
 }
@@ -894,8 +1020,8 @@ int HqBytecodeEmitCall(HqSerializerHandle hSerializer, const uint32_t stringInde
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_CALL);
-	_HQ_EMIT_UDWORD(stringIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_CALL);
+	_HQ_EMIT_INDEX(stringIndex);
 
 	return HQ_SUCCESS;
 }
@@ -903,14 +1029,63 @@ int HqBytecodeEmitCall(HqSerializerHandle hSerializer, const uint32_t stringInde
 //----------------------------------------------------------------------------------------------------------------------
 
 int HqBytecodeEmitCallValue(HqSerializerHandle hSerializer, const uint32_t gpRegIndex)
+{
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpRegIndex))
+	{
+		return HQ_ERROR_INVALID_ARG;
+	}
+
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_CALL_VALUE);
+	_HQ_EMIT_REGISTER(gpRegIndex);
+
+	return HQ_SUCCESS;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int HqBytecodeEmitCallWindow(HqSerializerHandle hSerializer, const uint32_t stringIndex, const uint32_t gpWindowRegIndex)
+{
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpWindowRegIndex))
+	{
+		return HQ_ERROR_INVALID_ARG;
+	}
+
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_CALL_WINDOW);
+	_HQ_EMIT_INDEX(stringIndex);
+	_HQ_EMIT_REGISTER(gpWindowRegIndex);
+
+	return HQ_SUCCESS;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int HqBytecodeEmitTailCall(HqSerializerHandle hSerializer, const uint32_t stringIndex)
 {
 	if(!hSerializer)
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_CALL_VALUE);
-	_HQ_EMIT_UDWORD(gpRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_TAIL_CALL);
+	_HQ_EMIT_INDEX(stringIndex);
+
+	return HQ_SUCCESS;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int HqBytecodeEmitTailCallValue(HqSerializerHandle hSerializer, const uint32_t gpRegIndex)
+{
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpRegIndex))
+	{
+		return HQ_ERROR_INVALID_ARG;
+	}
+
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_TAIL_CALL_VALUE);
+	_HQ_EMIT_REGISTER(gpRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -919,13 +1094,14 @@ int HqBytecodeEmitCallValue(HqSerializerHandle hSerializer, const uint32_t gpReg
 
 int HqBytecodeEmitRaise(HqSerializerHandle hSerializer, const uint32_t gpRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_RAISE);
-	_HQ_EMIT_UDWORD(gpRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_RAISE);
+	_HQ_EMIT_REGISTER(gpRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -934,13 +1110,14 @@ int HqBytecodeEmitRaise(HqSerializerHandle hSerializer, const uint32_t gpRegInde
 
 int HqBytecodeEmitLoadImmNull(HqSerializerHandle hSerializer, const uint32_t gpRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_LOAD_IMM_NULL);
-	_HQ_EMIT_UDWORD(gpRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_LOAD_IMM_NULL);
+	_HQ_EMIT_REGISTER(gpRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -952,13 +1129,14 @@ int HqBytecodeEmitLoadImmBool(
 	const uint32_t gpRegIndex,
 	const bool value)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_LOAD_IMM_BOOL);
-	_HQ_EMIT_UDWORD(gpRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_LOAD_IMM_BOOL);
+	_HQ_EMIT_REGISTER(gpRegIndex);
 	_HQ_WRITE_OP_BOOL(value);
 
 	return HQ_SUCCESS;
@@ -971,13 +1149,14 @@ int HqBytecodeEmitLoadImmI8(
 	const uint32_t gpRegIndex,
 	const int8_t value)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_LOAD_IMM_I8);
-	_HQ_EMIT_UDWORD(gpRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_LOAD_IMM_I8);
+	_HQ_EMIT_REGISTER(gpRegIndex);
 	_HQ_EMIT_SBYTE(value);
 
 	return HQ_SUCCESS;
@@ -990,13 +1169,14 @@ int HqBytecodeEmitLoadImmI16(
 	const uint32_t gpRegIndex,
 	const int16_t value)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_LOAD_IMM_I16);
-	_HQ_EMIT_UDWORD(gpRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_LOAD_IMM_I16);
+	_HQ_EMIT_REGISTER(gpRegIndex);
 	_HQ_EMIT_SWORD(value);
 
 	return HQ_SUCCESS;
@@ -1009,13 +1189,14 @@ int HqBytecodeEmitLoadImmI32(
 	const uint32_t gpRegIndex,
 	const int32_t value)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_LOAD_IMM_I32);
-	_HQ_EMIT_UDWORD(gpRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_LOAD_IMM_I32);
+	_HQ_EMIT_REGISTER(gpRegIndex);
 	_HQ_EMIT_SDWORD(value);
 
 	return HQ_SUCCESS;
@@ -1028,13 +1209,14 @@ int HqBytecodeEmitLoadImmI64(
 	const uint32_t gpRegIndex,
 	const int64_t value)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_LOAD_IMM_I64);
-	_HQ_EMIT_UDWORD(gpRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_LOAD_IMM_I64);
+	_HQ_EMIT_REGISTER(gpRegIndex);
 	_HQ_EMIT_SQWORD(value);
 
 	return HQ_SUCCESS;
@@ -1047,13 +1229,14 @@ int HqBytecodeEmitLoadImmU8(
 	const uint32_t gpRegIndex,
 	const uint8_t value)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_LOAD_IMM_U8);
-	_HQ_EMIT_UDWORD(gpRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_LOAD_IMM_U8);
+	_HQ_EMIT_REGISTER(gpRegIndex);
 	_HQ_EMIT_UBYTE(value);
 
 	return HQ_SUCCESS;
@@ -1066,13 +1249,14 @@ int HqBytecodeEmitLoadImmU16(
 	const uint32_t gpRegIndex,
 	const uint16_t value)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_LOAD_IMM_U16);
-	_HQ_EMIT_UDWORD(gpRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_LOAD_IMM_U16);
+	_HQ_EMIT_REGISTER(gpRegIndex);
 	_HQ_EMIT_UWORD(value);
 
 	return HQ_SUCCESS;
@@ -1085,13 +1269,14 @@ int HqBytecodeEmitLoadImmU32(
 	const uint32_t gpRegIndex,
 	const uint32_t value)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_LOAD_IMM_U32);
-	_HQ_EMIT_UDWORD(gpRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_LOAD_IMM_U32);
+	_HQ_EMIT_REGISTER(gpRegIndex);
 	_HQ_EMIT_UDWORD(value);
 
 	return HQ_SUCCESS;
@@ -1104,13 +1289,14 @@ int HqBytecodeEmitLoadImmU64(
 	const uint32_t gpRegIndex,
 	const uint64_t value)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_LOAD_IMM_U64);
-	_HQ_EMIT_UDWORD(gpRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_LOAD_IMM_U64);
+	_HQ_EMIT_REGISTER(gpRegIndex);
 	_HQ_EMIT_UQWORD(value);
 
 	return HQ_SUCCESS;
@@ -1123,13 +1309,14 @@ int HqBytecodeEmitLoadImmF32(
 	const uint32_t gpRegIndex,
 	const float value)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_LOAD_IMM_F32);
-	_HQ_EMIT_UDWORD(gpRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_LOAD_IMM_F32);
+	_HQ_EMIT_REGISTER(gpRegIndex);
 	_HQ_EMIT_FLOAT(value);
 
 	return HQ_SUCCESS;
@@ -1142,13 +1329,14 @@ int HqBytecodeEmitLoadImmF64(
 	const uint32_t gpRegIndex,
 	const double value)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_LOAD_IMM_F64);
-	_HQ_EMIT_UDWORD(gpRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_LOAD_IMM_F64);
+	_HQ_EMIT_REGISTER(gpRegIndex);
 	_HQ_EMIT_DOUBLE(value);
 
 	return HQ_SUCCESS;
@@ -1161,14 +1349,15 @@ int HqBytecodeEmitLoadImmStr(
 	const uint32_t gpRegIndex,
 	const uint32_t stringIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_LOAD_IMM_STR);
-	_HQ_EMIT_UDWORD(gpRegIndex);
-	_HQ_EMIT_UDWORD(stringIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_LOAD_IMM_STR);
+	_HQ_EMIT_REGISTER(gpRegIndex);
+	_HQ_EMIT_INDEX(stringIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1180,14 +1369,15 @@ int HqBytecodeEmitLoadGlobal(
 	const uint32_t gpRegIndex,
 	const uint32_t stringIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_LOAD_GLOBAL);
-	_HQ_EMIT_UDWORD(gpRegIndex);
-	_HQ_EMIT_UDWORD(stringIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_LOAD_GLOBAL);
+	_HQ_EMIT_REGISTER(gpRegIndex);
+	_HQ_EMIT_INDEX(stringIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1199,14 +1389,16 @@ int HqBytecodeEmitLoadParam(
 	const uint32_t gpRegIndex,
 	const uint32_t ioRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(ioRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_LOAD_PARAM);
-	_HQ_EMIT_UDWORD(gpRegIndex);
-	_HQ_EMIT_UDWORD(ioRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_LOAD_PARAM);
+	_HQ_EMIT_REGISTER(gpRegIndex);
+	_HQ_EMIT_REGISTER(ioRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1218,14 +1410,16 @@ int HqBytecodeEmitLoadVariable(
 	const uint32_t gpRegIndex,
 	const uint32_t vrRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(vrRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_LOAD_VAR);
-	_HQ_EMIT_UDWORD(gpRegIndex);
-	_HQ_EMIT_UDWORD(vrRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_LOAD_VAR);
+	_HQ_EMIT_REGISTER(gpRegIndex);
+	_HQ_EMIT_REGISTER(vrRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1238,15 +1432,17 @@ int HqBytecodeEmitLoadObject(
 	const uint32_t gpSrcRegIndex,
 	const uint32_t memberIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_LOAD_OBJECT);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRegIndex);
-	_HQ_EMIT_UDWORD(memberIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_LOAD_OBJECT);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRegIndex);
+	_HQ_EMIT_INDEX(memberIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1259,15 +1455,18 @@ int HqBytecodeEmitLoadArray(
 	const uint32_t gpSrcRegIndex,
 	const uint32_t gpArrIdxRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpArrIdxRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_LOAD_ARRAY);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRegIndex);
-	_HQ_EMIT_UDWORD(gpArrIdxRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_LOAD_ARRAY);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRegIndex);
+	_HQ_EMIT_REGISTER(gpArrIdxRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1282,17 +1481,22 @@ int HqBytecodeEmitLoadGrid(
 	const uint32_t gpGridIdxYRegIndex,
 	const uint32_t gpGridIdxZRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpGridIdxXRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpGridIdxYRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpGridIdxZRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_LOAD_GRID);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRegIndex);
-	_HQ_EMIT_UDWORD(gpGridIdxXRegIndex);
-	_HQ_EMIT_UDWORD(gpGridIdxYRegIndex);
-	_HQ_EMIT_UDWORD(gpGridIdxZRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_LOAD_GRID);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRegIndex);
+	_HQ_EMIT_REGISTER(gpGridIdxXRegIndex);
+	_HQ_EMIT_REGISTER(gpGridIdxYRegIndex);
+	_HQ_EMIT_REGISTER(gpGridIdxZRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1304,14 +1508,15 @@ int HqBytecodeEmitStoreGlobal(
 	const uint32_t stringIndex,
 	const uint32_t gpRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_STORE_GLOBAL);
-	_HQ_EMIT_UDWORD(stringIndex);
-	_HQ_EMIT_UDWORD(gpRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_STORE_GLOBAL);
+	_HQ_EMIT_INDEX(stringIndex);
+	_HQ_EMIT_REGISTER(gpRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1323,14 +1528,16 @@ int HqBytecodeEmitStoreParam(
 	const uint32_t ioRegIndex,
 	const uint32_t gpRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(ioRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_STORE_PARAM);
-	_HQ_EMIT_UDWORD(ioRegIndex);
-	_HQ_EMIT_UDWORD(gpRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_STORE_PARAM);
+	_HQ_EMIT_REGISTER(ioRegIndex);
+	_HQ_EMIT_REGISTER(gpRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1342,14 +1549,16 @@ int HqBytecodeEmitStoreVariable(
 	const uint32_t vrRegIndex,
 	const uint32_t gpRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(vrRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_STORE_VAR);
-	_HQ_EMIT_UDWORD(vrRegIndex);
-	_HQ_EMIT_UDWORD(gpRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_STORE_VAR);
+	_HQ_EMIT_REGISTER(vrRegIndex);
+	_HQ_EMIT_REGISTER(gpRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1362,15 +1571,17 @@ int HqBytecodeEmitStoreObject(
 	const uint32_t gpSrcRegIndex,
 	const uint32_t memberIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_STORE_OBJECT);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRegIndex);
-	_HQ_EMIT_UDWORD(memberIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_STORE_OBJECT);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRegIndex);
+	_HQ_EMIT_INDEX(memberIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1383,15 +1594,18 @@ int HqBytecodeEmitStoreArray(
 	const uint32_t gpSrcRegIndex,
 	const uint32_t gpArrIdxRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpArrIdxRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_STORE_ARRAY);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRegIndex);
-	_HQ_EMIT_UDWORD(gpArrIdxRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_STORE_ARRAY);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRegIndex);
+	_HQ_EMIT_REGISTER(gpArrIdxRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1406,17 +1620,22 @@ int HqBytecodeEmitStoreGrid(
 	const uint32_t gpGridIdxYRegIndex,
 	const uint32_t gpGridIdxZRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpGridIdxXRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpGridIdxYRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpGridIdxZRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_STORE_GRID);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRegIndex);
-	_HQ_EMIT_UDWORD(gpGridIdxXRegIndex);
-	_HQ_EMIT_UDWORD(gpGridIdxYRegIndex);
-	_HQ_EMIT_UDWORD(gpGridIdxZRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_STORE_GRID);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRegIndex);
+	_HQ_EMIT_REGISTER(gpGridIdxXRegIndex);
+	_HQ_EMIT_REGISTER(gpGridIdxYRegIndex);
+	_HQ_EMIT_REGISTER(gpGridIdxZRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1425,13 +1644,14 @@ int HqBytecodeEmitStoreGrid(
 
 int HqBytecodeEmitPush(HqSerializerHandle hSerializer, const uint32_t gpRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_PUSH);
-	_HQ_EMIT_UDWORD(gpRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_PUSH);
+	_HQ_EMIT_REGISTER(gpRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1440,13 +1660,14 @@ int HqBytecodeEmitPush(HqSerializerHandle hSerializer, const uint32_t gpRegIndex
 
 int HqBytecodeEmitPop(HqSerializerHandle hSerializer, const uint32_t gpRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_POP);
-	_HQ_EMIT_UDWORD(gpRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_POP);
+	_HQ_EMIT_REGISTER(gpRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1458,14 +1679,15 @@ int HqBytecodeEmitInitObject(
 	const uint32_t gpRegIndex,
 	const uint32_t stringIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_INIT_OBJECT);
-	_HQ_EMIT_UDWORD(gpRegIndex);
-	_HQ_EMIT_UDWORD(stringIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_INIT_OBJECT);
+	_HQ_EMIT_REGISTER(gpRegIndex);
+	_HQ_EMIT_INDEX(stringIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1477,14 +1699,15 @@ int HqBytecodeEmitInitArray(
 	const uint32_t gpRegIndex,
 	const uint32_t initialCount)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_INIT_ARRAY);
-	_HQ_EMIT_UDWORD(gpRegIndex);
-	_HQ_EMIT_UDWORD(initialCount);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_INIT_ARRAY);
+	_HQ_EMIT_REGISTER(gpRegIndex);
+	_HQ_EMIT_INDEX(initialCount);
 
 	return HQ_SUCCESS;
 }
@@ -1498,16 +1721,17 @@ int HqBytecodeEmitInitGrid(
 	const uint32_t lengthY,
 	const uint32_t lengthZ)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_INIT_GRID);
-	_HQ_EMIT_UDWORD(gpRegIndex);
-	_HQ_EMIT_UDWORD(lengthX);
-	_HQ_EMIT_UDWORD(lengthY);
-	_HQ_EMIT_UDWORD(lengthZ);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_INIT_GRID);
+	_HQ_EMIT_REGISTER(gpRegIndex);
+	_HQ_EMIT_INDEX(lengthX);
+	_HQ_EMIT_INDEX(lengthY);
+	_HQ_EMIT_INDEX(lengthZ);
 
 	return HQ_SUCCESS;
 }
@@ -1519,14 +1743,15 @@ int HqBytecodeEmitInitFunction(
 	const uint32_t gpRegIndex,
 	const uint32_t stringIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_INIT_FUNC);
-	_HQ_EMIT_UDWORD(gpRegIndex);
-	_HQ_EMIT_UDWORD(stringIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_INIT_FUNC);
+	_HQ_EMIT_REGISTER(gpRegIndex);
+	_HQ_EMIT_INDEX(stringIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1540,8 +1765,8 @@ int HqBytecodeEmitJump(HqSerializerHandle hSerializer, const int32_t offset)
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_JMP);
-	_HQ_EMIT_SDWORD(offset);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_JMP);
+	_HQ_EMIT_OFFSET(offset);
 
 	return HQ_SUCCESS;
 }
@@ -1553,14 +1778,15 @@ int HqBytecodeEmitJumpIfTrue(
 	const uint32_t gpRegIndex,
 	const int32_t offset)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_JMP_TRUE);
-	_HQ_EMIT_UDWORD(gpRegIndex);
-	_HQ_EMIT_SDWORD(offset);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_JMP_TRUE);
+	_HQ_EMIT_REGISTER(gpRegIndex);
+	_HQ_EMIT_OFFSET(offset);
 
 	return HQ_SUCCESS;
 }
@@ -1572,14 +1798,15 @@ int HqBytecodeEmitJumpIfFalse(
 	const uint32_t gpRegIndex,
 	const int32_t offset)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_JMP_FALSE);
-	_HQ_EMIT_UDWORD(gpRegIndex);
-	_HQ_EMIT_SDWORD(offset);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_JMP_FALSE);
+	_HQ_EMIT_REGISTER(gpRegIndex);
+	_HQ_EMIT_OFFSET(offset);
 
 	return HQ_SUCCESS;
 }
@@ -1591,14 +1818,16 @@ int HqBytecodeEmitLength(
 	uint32_t gpDstRegIndex,
 	uint32_t gpSrcRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_LENGTH);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_LENGTH);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1611,15 +1840,18 @@ int HqBytecodeEmitAdd(
 	uint32_t gpSrcLeftRegIndex,
 	uint32_t gpSrcRightRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcLeftRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRightRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_ADD);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcLeftRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRightRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_ADD);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcLeftRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRightRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1632,15 +1864,18 @@ int HqBytecodeEmitSub(
 	uint32_t gpSrcLeftRegIndex,
 	uint32_t gpSrcRightRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcLeftRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRightRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_SUB);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcLeftRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRightRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_SUB);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcLeftRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRightRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1653,15 +1888,18 @@ int HqBytecodeEmitMul(
 	uint32_t gpSrcLeftRegIndex,
 	uint32_t gpSrcRightRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcLeftRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRightRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_MUL);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcLeftRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRightRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_MUL);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcLeftRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRightRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1674,15 +1912,18 @@ int HqBytecodeEmitDiv(
 	uint32_t gpSrcLeftRegIndex,
 	uint32_t gpSrcRightRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcLeftRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRightRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_DIV);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcLeftRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRightRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_DIV);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcLeftRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRightRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1695,15 +1936,18 @@ int HqBytecodeEmitMod(
 	uint32_t gpSrcLeftRegIndex,
 	uint32_t gpSrcRightRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcLeftRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRightRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_MOD);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcLeftRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRightRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_MOD);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcLeftRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRightRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1716,15 +1960,18 @@ int HqBytecodeEmitExp(
 	uint32_t gpSrcLeftRegIndex,
 	uint32_t gpSrcRightRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcLeftRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRightRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_EXP);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcLeftRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRightRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_EXP);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcLeftRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRightRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1737,15 +1984,18 @@ int HqBytecodeEmitBitAnd(
 	uint32_t gpSrcLeftRegIndex,
 	uint32_t gpSrcRightRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcLeftRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRightRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_AND);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcLeftRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRightRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_AND);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcLeftRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRightRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1758,15 +2008,18 @@ int HqBytecodeEmitBitOr(
 	uint32_t gpSrcLeftRegIndex,
 	uint32_t gpSrcRightRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcLeftRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRightRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_OR);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcLeftRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRightRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_OR);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcLeftRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRightRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1779,15 +2032,18 @@ int HqBytecodeEmitBitXor(
 	uint32_t gpSrcLeftRegIndex,
 	uint32_t gpSrcRightRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcLeftRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRightRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_XOR);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcLeftRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRightRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_XOR);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcLeftRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRightRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1799,14 +2055,16 @@ int HqBytecodeEmitBitNot(
 	uint32_t gpDstRegIndex,
 	uint32_t gpSrcRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_NOT);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_NOT);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1819,15 +2077,18 @@ int HqBytecodeEmitLeftShift(
 	uint32_t gpSrcLeftRegIndex,
 	uint32_t gpSrcRightRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcLeftRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRightRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_LSH);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcLeftRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRightRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_LSH);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcLeftRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRightRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1840,15 +2101,18 @@ int HqBytecodeEmitRightShift(
 	uint32_t gpSrcLeftRegIndex,
 	uint32_t gpSrcRightRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcLeftRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRightRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_RSH);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcLeftRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRightRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_RSH);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcLeftRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRightRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1861,15 +2125,18 @@ int HqBytecodeEmitLeftRotate(
 	uint32_t gpSrcLeftRegIndex,
 	uint32_t gpSrcRightRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcLeftRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRightRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_LROT);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcLeftRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRightRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_LROT);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcLeftRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRightRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1882,15 +2149,18 @@ int HqBytecodeEmitRightRotate(
 	uint32_t gpSrcLeftRegIndex,
 	uint32_t gpSrcRightRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcLeftRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRightRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_RROT);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcLeftRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRightRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_RROT);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcLeftRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRightRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1902,14 +2172,16 @@ int HqBytecodeEmitCastInt8(
 	uint32_t gpDstRegIndex,
 	uint32_t gpSrcRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_CAST_I8);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_CAST_I8);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1921,14 +2193,16 @@ int HqBytecodeEmitCastInt16(
 	uint32_t gpDstRegIndex,
 	uint32_t gpSrcRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_CAST_I16);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_CAST_I16);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1940,14 +2214,16 @@ int HqBytecodeEmitCastInt32(
 	uint32_t gpDstRegIndex,
 	uint32_t gpSrcRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_CAST_I32);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_CAST_I32);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1959,14 +2235,16 @@ int HqBytecodeEmitCastInt64(
 	uint32_t gpDstRegIndex,
 	uint32_t gpSrcRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_CAST_I64);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_CAST_I64);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1978,14 +2256,16 @@ int HqBytecodeEmitCastUint8(
 	uint32_t gpDstRegIndex,
 	uint32_t gpSrcRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_CAST_U8);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_CAST_U8);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -1997,14 +2277,16 @@ int HqBytecodeEmitCastUint16(
 	uint32_t gpDstRegIndex,
 	uint32_t gpSrcRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_CAST_U16);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_CAST_U16);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -2016,14 +2298,16 @@ int HqBytecodeEmitCastUint32(
 	uint32_t gpDstRegIndex,
 	uint32_t gpSrcRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_CAST_U32);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_CAST_U32);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -2035,14 +2319,16 @@ int HqBytecodeEmitCastUint64(
 	uint32_t gpDstRegIndex,
 	uint32_t gpSrcRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_CAST_U64);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_CAST_U64);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -2054,14 +2340,16 @@ int HqBytecodeEmitCastFloat32(
 	uint32_t gpDstRegIndex,
 	uint32_t gpSrcRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_CAST_F32);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_CAST_F32);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -2073,14 +2361,16 @@ int HqBytecodeEmitCastFloat64(
 	uint32_t gpDstRegIndex,
 	uint32_t gpSrcRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_CAST_F64);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_CAST_F64);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -2092,14 +2382,16 @@ int HqBytecodeEmitCastBool(
 	uint32_t gpDstRegIndex,
 	uint32_t gpSrcRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_CAST_BOOL);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_CAST_BOOL);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -2111,14 +2403,16 @@ int HqBytecodeEmitCastString(
 	uint32_t gpDstRegIndex,
 	uint32_t gpSrcRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_CAST_STR);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_CAST_STR);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -2131,15 +2425,18 @@ int HqBytecodeEmitCompareEqual(
 	uint32_t gpSrcLeftRegIndex,
 	uint32_t gpSrcRightRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcLeftRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRightRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_CMP_EQ);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcLeftRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRightRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_CMP_EQ);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcLeftRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRightRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -2152,15 +2449,18 @@ int HqBytecodeEmitCompareNotEqual(
 	uint32_t gpSrcLeftRegIndex,
 	uint32_t gpSrcRightRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcLeftRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRightRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_CMP_NE);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcLeftRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRightRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_CMP_NE);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcLeftRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRightRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -2173,15 +2473,18 @@ int HqBytecodeEmitCompareLess(
 	uint32_t gpSrcLeftRegIndex,
 	uint32_t gpSrcRightRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcLeftRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRightRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_CMP_LT);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcLeftRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRightRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_CMP_LT);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcLeftRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRightRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -2194,15 +2497,18 @@ int HqBytecodeEmitCompareLessEqual(
 	uint32_t gpSrcLeftRegIndex,
 	uint32_t gpSrcRightRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcLeftRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRightRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_CMP_LE);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcLeftRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRightRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_CMP_LE);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcLeftRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRightRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -2215,15 +2521,18 @@ int HqBytecodeEmitCompareGreater(
 	uint32_t gpSrcLeftRegIndex,
 	uint32_t gpSrcRightRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcLeftRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRightRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_CMP_GT);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcLeftRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRightRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_CMP_GT);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcLeftRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRightRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -2236,15 +2545,18 @@ int HqBytecodeEmitCompareGreaterEqual(
 	uint32_t gpSrcLeftRegIndex,
 	uint32_t gpSrcRightRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcLeftRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRightRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_CMP_GE);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcLeftRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRightRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_CMP_GE);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcLeftRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRightRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -2256,14 +2568,16 @@ int HqBytecodeEmitTest(
 	uint32_t gpDstRegIndex,
 	uint32_t gpSrcRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_TEST);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_TEST);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -2275,14 +2589,16 @@ int HqBytecodeEmitMove(
 	uint32_t gpDstRegIndex,
 	uint32_t gpSrcRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_MOVE);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_MOVE);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -2294,14 +2610,16 @@ int HqBytecodeEmitCopy(
 	uint32_t gpDstRegIndex,
 	uint32_t gpSrcRegIndex)
 {
-	if(!hSerializer)
+	if(!hSerializer
+		|| !_HQ_IS_VALID_REGISTER(gpDstRegIndex)
+		|| !_HQ_IS_VALID_REGISTER(gpSrcRegIndex))
 	{
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	_HQ_EMIT_UBYTE(HQ_OP_CODE_COPY);
-	_HQ_EMIT_UDWORD(gpDstRegIndex);
-	_HQ_EMIT_UDWORD(gpSrcRegIndex);
+	_HQ_EMIT_OPCODE(HQ_OP_CODE_COPY);
+	_HQ_EMIT_REGISTER(gpDstRegIndex);
+	_HQ_EMIT_REGISTER(gpSrcRegIndex);
 
 	return HQ_SUCCESS;
 }
@@ -19,6 +19,8 @@
 #include "ModuleWriter.hpp"
 #include "DevContext.hpp"
 
+#include "../common/OpCodeEnum.hpp"
+
 #include <algorithm>
 #include <assert.h>
 #include <inttypes.h>
@@ -34,6 +36,8 @@ HqModuleWriterHandle HqModuleWriter::Create(HqDevContextHandle hCtx)
 	assert(pOutput != nullptr);
 
 	pOutput->hCtx = hCtx;
+	pOutput->bytecodeEncoding = HQ_BYTECODE_ENCODING_STANDARD;
+	pOutput->callingConvention = HQ_CALLING_CONVENTION_IO_REGISTER;
 
 	return pOutput;
 }
@@ -141,10 +145,18 @@ bool HqModuleWriter::Serialize(HqModuleWriterHandle hModuleWriter, HqSerializerH
 		return left.offset < right.offset;
 	};
 
-	// Sort the guarded blocks for each function.
+	const int outputEndianness = HqSerializerGetEndianness(hSerializer);
+	const int platformEndianness = HqGetPlatformEndianness();
+
+	// Function bytecode has already been written in the output byte order,
+	// so it needs to be swapped back to be scanned on this platform.
+	const bool swapBytecode = (outputEndianness == HQ_ENDIAN_ORDER_LITTLE || outputEndianness == HQ_ENDIAN_ORDER_BIG)
+		&& outputEndianness != platformEndianness;
+
+	// Sort the guarded blocks and calculate the frame size for each function.
 	for(auto& kv : hModuleWriter->functions)
 	{
-		// Native functions don't use guarded blocks.
+		// Native functions don't use guarded blocks or frame memory.
 		if(!kv.second.isNative)
 		{
 			std::sort(
@@ -152,6 +164,17 @@ bool HqModuleWriter::Serialize(HqModuleWriterHandle hModuleWriter, HqSerializerH
 				kv.second.guardedBlocks.end(),
 				guardedBlockSortFunc
 			);
+
+			if(!_calculateFrameSize(
+				kv.second,
+				hReport,
+				kv.first,
+				hModuleWriter->bytecodeEncoding,
+				hModuleWriter->callingConvention,
+				swapBytecode))
+			{
+				return false;
+			}
 		}
 	}
 
@@ -252,6 +275,9 @@ bool HqModuleWriter::Serialize(HqModuleWriterHandle hModuleWriter, HqSerializerH
 	// Initialize the module file header to set its properties to their default values.
 	HqModuleFileHeader::Initialize(fileHeader);
 
+	fileHeader.bytecodeEncoding = uint8_t(hModuleWriter->bytecodeEncoding);
+	fileHeader.callingConvention = uint8_t(hModuleWriter->callingConvention);
+
 	const int endianness = HqSerializerGetEndianness(hSerializer);
 
 	// Set the big endian flag if endianness is being forced.
@@ -644,6 +670,39 @@ bool HqModuleWriter::Serialize(HqModuleWriterHandle hModuleWriter, HqSerializerH
 					return false;
 				}
 
+				const uint16_t frameSizes[] =
+				{
+					funcKv.second.gpRegisterCount,
+					funcKv.second.vrRegisterCount,
+					funcKv.second.stackSize,
+				};
+
+				// Write the function's frame requirements.
+				for(const uint16_t frameSize : frameSizes)
+				{
+					if(!_writeUint16(hSerializer, frameSize, result, streamOffset))
+					{
+						HqReportMessage(
+							hReport,
+							HQ_MESSAGE_TYPE_ERROR,
+							"Failed to write function's frame size"
+								": error='%s'"
+								", streamOffset=%zu"
+								", signature='%s'"
+								", gpRegisterCount=%" PRIu16
+								", vrRegisterCount=%" PRIu16
+								", stackSize=%" PRIu16,
+							HqGetErrorCodeString(result),
+							streamOffset,
+							pFuncSig->data,
+							frameSizes[0],
+							frameSizes[1],
+							frameSizes[2]
+						);
+						return false;
+					}
+				}
+
 				// Write the function's number of guarded blocks.
 				if(!_writeUint32(hSerializer, uint32_t(numGuardedBlocks), result, streamOffset))
 				{
@@ -1037,6 +1096,234 @@ uint32_t HqModuleWriter::AddString(HqModuleWriterHandle hWriter, HqString* const
 
 //----------------------------------------------------------------------------------------------------------------------
 
+bool HqModuleWriter::_calculateFrameSize(
+	HqFunctionData& function,
+	HqReportHandle hReport,
+	HqString* const pSignature,
+	const int encoding,
+	const int callingConvention,
+	const bool swapBytes
+)
+{
+	// Operand layout of each opcode, matching the order they're written by the HqBytecodeEmit*() functions:
+	//
+	//   r = General-purpose register
+	//   v = Variable register
+	//   p = I/O register
+	//   i = Index
+	//   o = Jump offset
+	//   b = Boolean
+	//   1, 2, 4, 8 = Integer immediate of the given byte width
+	//   f, d = 32-bit and 64-bit float immediate
+	static const char* const operandLayouts[] =
+	{
+		"", "", "", "",                                     // NOP, ABORT, RETURN, YIELD
+		"i", "r", "r",                                      // CALL, CALL_VALUE, RAISE
+		"r", "rb",                                          // LOAD_IMM_NULL, LOAD_IMM_BOOL
+		"r1", "r2", "r4", "r8", "r1", "r2", "r4", "r8",     // LOAD_IMM_I*, LOAD_IMM_U*
+		"rf", "rd", "ri",                                   // LOAD_IMM_F32, LOAD_IMM_F64, LOAD_IMM_STR
+		"ri", "rp", "rv", "rri", "rrr", "rrrrr",            // LOAD_*
+		"ir", "pr", "vr", "rri", "rrr", "rrrrr",            // STORE_*
+		"r", "r",                                           // PUSH, POP
+		"ri", "ri", "riii", "ri",                           // INIT_*
+		"o", "ro", "ro",                                    // JMP, JMP_TRUE, JMP_FALSE
+		"rr",                                               // LENGTH
+		"rrr", "rrr", "rrr", "rrr", "rrr", "rrr",           // ADD, SUB, MUL, DIV, MOD, EXP
+		"rrr", "rrr", "rrr", "rr",                          // AND, OR, XOR, NOT
+		"rrr", "rrr", "rrr", "rrr",                         // LSH, RSH, LROT, RROT
+		"rr", "rr", "rr", "rr", "rr", "rr",                 // CAST_I*, CAST_U8, CAST_U16
+		"rr", "rr", "rr", "rr", "rr", "rr",                 // CAST_U32, CAST_U64, CAST_F*, CAST_BOOL, CAST_STR
+		"rrr", "rrr", "rrr", "rrr", "rrr", "rrr",           // CMP_*
+		"rr", "rr", "rr",                                   // TEST, MOVE, COPY
+		"ir", "i", "r",                                     // CALL_WINDOW, TAIL_CALL, TAIL_CALL_VALUE
+	};
+
+	static_assert(
+		sizeof(operandLayouts) / sizeof(operandLayouts[0]) == HQ_OP_CODE__TOTAL_COUNT,
+		"Operand layout table is out of sync with the opcode list"
+	);
+
+	const bool isCompact = (encoding == HQ_BYTECODE_ENCODING_COMPACT);
+
+	const uint8_t* const pStart = function.bytecode.data();
+	const uint8_t* const pEnd = pStart + function.bytecode.size();
+	const uint8_t* ip = pStart;
+
+	bool valid = true;
+
+	auto readFixed = [&ip, &pEnd, &valid, &swapBytes](const size_t size) -> uint64_t
+	{
+		if(size_t(pEnd - ip) < size)
+		{
+			valid = false;
+			return 0;
+		}
+
+		uint64_t output = 0;
+
+		switch(size)
+		{
+			case 1: output = *ip; break;
+			case 2: { uint16_t value; memcpy(&value, ip, size); output = swapBytes ? HqEndianSwapUint16(value) : value; break; }
+			case 4: { uint32_t value; memcpy(&value, ip, size); output = swapBytes ? HqEndianSwapUint32(value) : value; break; }
+			default: break;
+		}
+
+		ip += size;
+		return output;
+	};
+
+	auto skipVarInt = [&ip, &pEnd, &valid]()
+	{
+		while(ip < pEnd && (*ip & 0x80) != 0)
+		{
+			++ip;
+		}
+
+		if(ip == pEnd)
+		{
+			valid = false;
+			return;
+		}
+
+		++ip;
+	};
+
+	uint64_t gpRegisterCount = 0;
+	uint64_t vrRegisterCount = 0;
+	uint64_t pushCount = 0;
+
+	bool hasBackwardJump = false;
+
+	while(valid && ip < pEnd)
+	{
+		const uint32_t opCode = uint32_t(readFixed(isCompact ? 1 : 4));
+		if(!valid || opCode >= HQ_OP_CODE__TOTAL_COUNT)
+		{
+			valid = false;
+			break;
+		}
+
+		if(opCode == HQ_OP_CODE_PUSH)
+		{
+			++pushCount;
+		}
+
+		for(const char* pOperand = operandLayouts[opCode]; valid && *pOperand != '\0'; ++pOperand)
+		{
+			switch(*pOperand)
+			{
+				case 'r':
+					gpRegisterCount = std::max(gpRegisterCount, readFixed(isCompact ? 1 : 4) + 1);
+					break;
+
+				case 'v':
+					vrRegisterCount = std::max(vrRegisterCount, readFixed(isCompact ? 1 : 4) + 1);
+					break;
+
+				case 'o':
+					// Jump offsets are always 32-bit, regardless of the encoding.
+					hasBackwardJump |= (int32_t(uint32_t(readFixed(4))) < 0);
+					break;
+
+				case 'i':
+				case '4':
+				case '8':
+					if(isCompact)
+					{
+						skipVarInt();
+					}
+					else
+					{
+						readFixed((*pOperand == '8') ? 8 : 4);
+					}
+					break;
+
+				case 'p':
+				case 'b':
+				case '1':
+					readFixed(isCompact ? 1 : 4);
+					break;
+
+				case '2':
+					readFixed(isCompact ? 2 : 4);
+					break;
+
+				case 'f':
+					readFixed(4);
+					break;
+
+				case 'd':
+					readFixed(8);
+					break;
+
+				default:
+					assert(false);
+					break;
+			}
+		}
+	}
+
+	if(callingConvention == HQ_CALLING_CONVENTION_REGISTER_WINDOW)
+	{
+		// Parameters arrive in, and return values leave from, the leading general-purpose registers.
+		gpRegisterCount = std::max<uint64_t>(gpRegisterCount, std::max(function.numParameters, function.numReturnValues));
+	}
+
+	if(!valid || gpRegisterCount > HQ_VM_GP_REGISTER_COUNT || vrRegisterCount > HQ_VM_VR_REGISTER_COUNT)
+	{
+		// The bytecode couldn't be fully scanned, so fall back to the largest possible frame.
+		// The runtime will report the actual problem when it decodes the function.
+		function.gpRegisterCount = HQ_VM_GP_REGISTER_COUNT;
+		function.vrRegisterCount = HQ_VM_VR_REGISTER_COUNT;
+		function.stackSize = HQ_VM_VALUE_STACK_SIZE;
+		return true;
+	}
+
+	// An exception handler that starts at or before an instruction in its guarded block
+	// can re-enter earlier code without a backward jump, so it's treated as one.
+	for(const HqFunctionData::GuardedBlock& guardedBlock : function.guardedBlocks)
+	{
+		for(const auto& handlerKv : guardedBlock.handlers)
+		{
+			if(handlerKv.second.offset < guardedBlock.offset + guardedBlock.length)
+			{
+				hasBackwardJump = true;
+			}
+		}
+	}
+
+	// Any value stack usage inside a loop can't be bounded by counting PUSH instructions,
+	// so those functions get the full value stack.
+	const uint64_t stackSize = (hasBackwardJump && pushCount > 0)
+		? HQ_VM_VALUE_STACK_SIZE
+		: pushCount;
+
+	if(stackSize > HQ_VM_VALUE_STACK_SIZE)
+	{
+		HqReportMessage(
+			hReport,
+			HQ_MESSAGE_TYPE_ERROR,
+			"Function pushes more values than fit on the value stack"
+				": signature='%s'"
+				", pushCount=%" PRIu64
+				", maxStackSize=%d",
+			pSignature->data,
+			pushCount,
+			HQ_VM_VALUE_STACK_SIZE
+		);
+		return false;
+	}
+
+	function.gpRegisterCount = uint16_t(gpRegisterCount);
+	function.vrRegisterCount = uint16_t(vrRegisterCount);
+	function.stackSize = uint16_t(stackSize);
+
+	return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 inline bool HqModuleWriter::_writeFileHeader(
 	HqSerializerHandle hSerializer,
 	const HqModuleFileHeader& fileHeader,
@@ -1050,6 +1337,9 @@ inline bool HqModuleWriter::_writeFileHeader(
 	if(outResult == HQ_SUCCESS) { _writeUint8(hSerializer, fileHeader.magicNumber[1], outResult, outStreamOffset); }
 	if(outResult == HQ_SUCCESS) { _writeUint8(hSerializer, fileHeader.magicNumber[2], outResult, outStreamOffset); }
 	if(outResult == HQ_SUCCESS) { _writeUint8(hSerializer, fileHeader.magicNumber[3], outResult, outStreamOffset); }
+	if(outResult == HQ_SUCCESS) { _writeUint8(hSerializer, fileHeader.bytecodeEncoding, outResult, outStreamOffset); }
+	if(outResult == HQ_SUCCESS) { _writeUint8(hSerializer, fileHeader.callingConvention, outResult, outStreamOffset); }
+	if(outResult == HQ_SUCCESS) { _writeUint8(hSerializer, fileHeader.formatFlags, outResult, outStreamOffset); }
 	if(outResult == HQ_SUCCESS) { _writeUint8(hSerializer, fileHeader.reserved[0], outResult, outStreamOffset); }
 	if(outResult == HQ_SUCCESS) { _writeUint8(hSerializer, fileHeader.reserved[1], outResult, outStreamOffset); }
 	if(outResult == HQ_SUCCESS) { _writeUint8(hSerializer, fileHeader.reserved[2], outResult, outStreamOffset); }
@@ -1058,9 +1348,6 @@ inline bool HqModuleWriter::_writeFileHeader(
 	if(outResult == HQ_SUCCESS) { _writeUint8(hSerializer, fileHeader.reserved[5], outResult, outStreamOffset); }
 	if(outResult == HQ_SUCCESS) { _writeUint8(hSerializer, fileHeader.reserved[6], outResult, outStreamOffset); }
 	if(outResult == HQ_SUCCESS) { _writeUint8(hSerializer, fileHeader.reserved[7], outResult, outStreamOffset); }
-	if(outResult == HQ_SUCCESS) { _writeUint8(hSerializer, fileHeader.reserved[8], outResult, outStreamOffset); }
-	if(outResult == HQ_SUCCESS) { _writeUint8(hSerializer, fileHeader.reserved[9], outResult, outStreamOffset); }
-	if(outResult == HQ_SUCCESS) { _writeUint8(hSerializer, fileHeader.reserved[10], outResult, outStreamOffset); }
 	if(outResult == HQ_SUCCESS) { _writeBool8(hSerializer, fileHeader.isBigEndian, outResult, outStreamOffset); }
 
 	return (outResult == HQ_SUCCESS);
@@ -49,6 +49,8 @@ struct HqModuleWriter
 
 	static uint32_t AddString(HqModuleWriterHandle hWriter, HqString* const pString);
 
+	static bool _calculateFrameSize(HqFunctionData&, HqReportHandle, HqString*, int, int, bool);
+
 	static bool _writeFileHeader(HqSerializerHandle, const HqModuleFileHeader&, int&, size_t&);
 	static bool _writeTableOfContents(HqSerializerHandle, const HqModuleTableOfContents&, int&, size_t&);
 
@@ -84,6 +86,9 @@ struct HqModuleWriter
 
 	HqDevContextHandle hCtx;
 
+	int bytecodeEncoding;
+	int callingConvention;
+
 	DependencySet dependencies;
 	GlobalValueSet globals;
 	HqFunctionData::StringToFunctionMap functions;
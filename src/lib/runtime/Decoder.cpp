@@ -20,6 +20,7 @@
 
 #include <assert.h>
 #include <limits.h>
+#include <string.h>
 
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -37,14 +38,191 @@
 		: (x) \
 )
 
+// Maximum number of bytes in a variable-width value for each operand size.
+#define _HQ_VAR_UINT32_MAX_BYTE_COUNT 5
+#define _HQ_VAR_UINT64_MAX_BYTE_COUNT 10
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static inline bool _CanRead(HqDecoder& decoder, const size_t size)
+{
+	if(decoder.invalid || size > size_t(decoder.pEnd - decoder.ip))
+	{
+		decoder.invalid = true;
+		return false;
+	}
+
+	return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+template <typename T>
+static inline T _ReadFixed(HqDecoder& decoder)
+{
+	if(!_CanRead(decoder, sizeof(T)))
+	{
+		return T(0);
+	}
+
+	// Compact bytecode does not guarantee operand alignment, so fixed-width values are always copied out.
+	T output;
+	memcpy(&output, decoder.ip, sizeof(T));
+
+	decoder.ip += sizeof(T);
+
+	return output;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+template <typename T>
+static inline T _EndianSwapFixed(HqDecoder& decoder, T (*swapFn)(T))
+{
+	if(!_CanRead(decoder, sizeof(T)))
+	{
+		return T(0);
+	}
+
+	T output;
+	memcpy(&output, decoder.ip, sizeof(T));
+
+	// Endian swap the current bytecode data and store it back to the bytecode.
+	output = swapFn(output);
+	memcpy(decoder.ip, &output, sizeof(T));
+
+	decoder.ip += sizeof(T);
+
+	return output;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static inline uint64_t _ReadVarUint(HqDecoder& decoder, const uint32_t maxByteCount)
+{
+	uint64_t output = 0;
+
+	// Variable-width values are stored 7 bits at a time, low bits first,
+	// with the high bit of each byte set when more bytes follow.
+	for(uint32_t byteIndex = 0; byteIndex < maxByteCount; ++byteIndex)
+	{
+		if(!_CanRead(decoder, 1))
+		{
+			return 0;
+		}
+
+		const uint8_t byte = *decoder.ip;
+		++decoder.ip;
+
+		output |= uint64_t(byte & 0x7F) << (byteIndex * 7);
+
+		if((byte & 0x80) == 0)
+		{
+			return output;
+		}
+	}
+
+	// The value has more bytes than its type can hold.
+	decoder.invalid = true;
+
+	return 0;
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 
-void HqDecoder::Initialize(HqDecoder& output, uint8_t* const pBytecode, uint32_t offset)
+static inline int64_t _ReadVarInt(HqDecoder& decoder, const uint32_t maxByteCount)
+{
+	const uint64_t value = _ReadVarUint(decoder, maxByteCount);
+
+	// Signed values are zigzag encoded so small negative numbers stay small.
+	return int64_t(value >> 1) ^ -int64_t(value & 1);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int16_t _SwapInt16(const int16_t value) { return HqEndianSwapInt16(value); }
+static int32_t _SwapInt32(const int32_t value) { return HqEndianSwapInt32(value); }
+static uint16_t _SwapUint16(const uint16_t value) { return HqEndianSwapUint16(value); }
+static float _SwapFloat32(const float value) { return HqEndianSwapFloat32(value); }
+static double _SwapFloat64(const double value) { return HqEndianSwapFloat64(value); }
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqDecoder::Initialize(
+	HqDecoder& output,
+	uint8_t* const pBytecode,
+	const uint32_t offsetStart,
+	const uint32_t offsetEnd,
+	const int encoding)
 {
 	assert(pBytecode != nullptr);
+	assert(offsetStart <= offsetEnd);
+	assert(encoding >= 0 && encoding < HQ_BYTECODE_ENCODING__COUNT);
 
-	output.ip = pBytecode + offset;
+	output.ip = pBytecode + offsetStart;
 	output.cachedIp = output.ip;
+	output.pEnd = pBytecode + offsetEnd;
+	output.encoding = encoding;
+	output.invalid = false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+uint32_t HqDecoder::LoadOpCode(HqDecoder& decoder)
+{
+	assert(decoder.ip != nullptr);
+
+	if(decoder.encoding == HQ_BYTECODE_ENCODING_COMPACT)
+	{
+		return _ReadFixed<uint8_t>(decoder);
+	}
+
+	return LoadUint32(decoder);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+uint32_t HqDecoder::LoadRegister(HqDecoder& decoder)
+{
+	assert(decoder.ip != nullptr);
+
+	if(decoder.encoding == HQ_BYTECODE_ENCODING_COMPACT)
+	{
+		return _ReadFixed<uint8_t>(decoder);
+	}
+
+	return LoadUint32(decoder);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+uint32_t HqDecoder::LoadIndex(HqDecoder& decoder)
+{
+	assert(decoder.ip != nullptr);
+
+	if(decoder.encoding == HQ_BYTECODE_ENCODING_COMPACT)
+	{
+		const uint64_t output = _ReadVarUint(decoder, _HQ_VAR_UINT32_MAX_BYTE_COUNT);
+
+		return uint32_t(_HQ_UNSIGNED_INT_CLAMP(output, UINT32_MAX));
+	}
+
+	return LoadUint32(decoder);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int32_t HqDecoder::LoadOffset(HqDecoder& decoder)
+{
+	assert(decoder.ip != nullptr);
+
+	if(decoder.encoding == HQ_BYTECODE_ENCODING_COMPACT)
+	{
+		// Jump offsets are kept at a fixed width in all encodings so they can be patched in-place after emitting.
+		return _ReadFixed<int32_t>(decoder);
+	}
+
+	return LoadInt32(decoder);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -53,6 +231,16 @@ bool HqDecoder::LoadBool(HqDecoder& decoder)
 {
 	assert(decoder.ip != nullptr);
 
+	if(decoder.encoding == HQ_BYTECODE_ENCODING_COMPACT)
+	{
+		return _ReadFixed<uint8_t>(decoder) != 0;
+	}
+
+	if(!_CanRead(decoder, sizeof(int32_t)))
+	{
+		return 0;
+	}
+
 	// Get the byte of the current position of the instruction pointer.
 	const int32_t output = *reinterpret_cast<int32_t*>(decoder.ip);
 
@@ -69,6 +257,16 @@ int8_t HqDecoder::LoadInt8(HqDecoder& decoder)
 {
 	assert(decoder.ip != nullptr);
 
+	if(decoder.encoding == HQ_BYTECODE_ENCODING_COMPACT)
+	{
+		return _ReadFixed<int8_t>(decoder);
+	}
+
+	if(!_CanRead(decoder, sizeof(int32_t)))
+	{
+		return 0;
+	}
+
 	// Get the byte of the current position of the instruction pointer.
 	const int32_t output = *reinterpret_cast<int32_t*>(decoder.ip);
 
@@ -85,6 +283,16 @@ int16_t HqDecoder::LoadInt16(HqDecoder& decoder)
 {
 	assert(decoder.ip != nullptr);
 
+	if(decoder.encoding == HQ_BYTECODE_ENCODING_COMPACT)
+	{
+		return _ReadFixed<int16_t>(decoder);
+	}
+
+	if(!_CanRead(decoder, sizeof(int32_t)))
+	{
+		return 0;
+	}
+
 	// Get the byte of the current position of the instruction pointer.
 	const int32_t output = *reinterpret_cast<int32_t*>(decoder.ip);
 
@@ -101,6 +309,18 @@ int32_t HqDecoder::LoadInt32(HqDecoder& decoder)
 {
 	assert(decoder.ip != nullptr);
 
+	if(decoder.encoding == HQ_BYTECODE_ENCODING_COMPACT)
+	{
+		const int64_t output = _ReadVarInt(decoder, _HQ_VAR_UINT32_MAX_BYTE_COUNT);
+
+		return int32_t(_HQ_SIGNED_INT_CLAMP(output, INT32_MIN, INT32_MAX));
+	}
+
+	if(!_CanRead(decoder, sizeof(int32_t)))
+	{
+		return 0;
+	}
+
 	// Get the byte of the current position of the instruction pointer.
 	const int32_t output = *reinterpret_cast<int32_t*>(decoder.ip);
 
@@ -117,6 +337,16 @@ int64_t HqDecoder::LoadInt64(HqDecoder& decoder)
 {
 	assert(decoder.ip != nullptr);
 
+	if(decoder.encoding == HQ_BYTECODE_ENCODING_COMPACT)
+	{
+		return _ReadVarInt(decoder, _HQ_VAR_UINT64_MAX_BYTE_COUNT);
+	}
+
+	if(!_CanRead(decoder, sizeof(int64_t)))
+	{
+		return 0;
+	}
+
 	// Get the byte of the current position of the instruction pointer.
 	const int64_t output = *reinterpret_cast<int64_t*>(decoder.ip);
 
@@ -133,6 +363,16 @@ uint8_t HqDecoder::LoadUint8(HqDecoder& decoder)
 {
 	assert(decoder.ip != nullptr);
 
+	if(decoder.encoding == HQ_BYTECODE_ENCODING_COMPACT)
+	{
+		return _ReadFixed<uint8_t>(decoder);
+	}
+
+	if(!_CanRead(decoder, sizeof(uint32_t)))
+	{
+		return 0;
+	}
+
 	// Get the byte of the current position of the instruction pointer.
 	const uint32_t output = *reinterpret_cast<uint32_t*>(decoder.ip);
 
@@ -149,6 +389,16 @@ uint16_t HqDecoder::LoadUint16(HqDecoder& decoder)
 {
 	assert(decoder.ip != nullptr);
 
+	if(decoder.encoding == HQ_BYTECODE_ENCODING_COMPACT)
+	{
+		return _ReadFixed<uint16_t>(decoder);
+	}
+
+	if(!_CanRead(decoder, sizeof(uint32_t)))
+	{
+		return 0;
+	}
+
 	// Get the byte of the current position of the instruction pointer.
 	const uint32_t output = *reinterpret_cast<uint32_t*>(decoder.ip);
 
@@ -165,6 +415,18 @@ uint32_t HqDecoder::LoadUint32(HqDecoder& decoder)
 {
 	assert(decoder.ip != nullptr);
 
+	if(decoder.encoding == HQ_BYTECODE_ENCODING_COMPACT)
+	{
+		const uint64_t output = _ReadVarUint(decoder, _HQ_VAR_UINT32_MAX_BYTE_COUNT);
+
+		return uint32_t(_HQ_UNSIGNED_INT_CLAMP(output, UINT32_MAX));
+	}
+
+	if(!_CanRead(decoder, sizeof(uint32_t)))
+	{
+		return 0;
+	}
+
 	// Get the byte of the current position of the instruction pointer.
 	const uint32_t output = *reinterpret_cast<uint32_t*>(decoder.ip);
 
@@ -181,6 +443,16 @@ uint64_t HqDecoder::LoadUint64(HqDecoder& decoder)
 {
 	assert(decoder.ip != nullptr);
 
+	if(decoder.encoding == HQ_BYTECODE_ENCODING_COMPACT)
+	{
+		return _ReadVarUint(decoder, _HQ_VAR_UINT64_MAX_BYTE_COUNT);
+	}
+
+	if(!_CanRead(decoder, sizeof(uint64_t)))
+	{
+		return 0;
+	}
+
 	// Get the byte of the current position of the instruction pointer.
 	const uint64_t output = *reinterpret_cast<uint64_t*>(decoder.ip);
 
@@ -197,6 +469,16 @@ float HqDecoder::LoadFloat32(HqDecoder& decoder)
 {
 	assert(decoder.ip != nullptr);
 
+	if(decoder.encoding == HQ_BYTECODE_ENCODING_COMPACT)
+	{
+		return _ReadFixed<float>(decoder);
+	}
+
+	if(!_CanRead(decoder, sizeof(float)))
+	{
+		return 0;
+	}
+
 	// Get the byte of the current position of the instruction pointer.
 	const float output = *reinterpret_cast<float*>(decoder.ip);
 
@@ -213,6 +495,16 @@ double HqDecoder::LoadFloat64(HqDecoder& decoder)
 {
 	assert(decoder.ip != nullptr);
 
+	if(decoder.encoding == HQ_BYTECODE_ENCODING_COMPACT)
+	{
+		return _ReadFixed<double>(decoder);
+	}
+
+	if(!_CanRead(decoder, sizeof(double)))
+	{
+		return 0;
+	}
+
 	// Get the byte of the current position of the instruction pointer.
 	const double output = *reinterpret_cast<double*>(decoder.ip);
 
@@ -225,10 +517,79 @@ double HqDecoder::LoadFloat64(HqDecoder& decoder)
 
 //----------------------------------------------------------------------------------------------------------------------
 
+uint32_t HqDecoder::EndianSwapOpCode(HqDecoder& decoder)
+{
+	assert(decoder.ip != nullptr);
+
+	if(decoder.encoding == HQ_BYTECODE_ENCODING_COMPACT)
+	{
+		// Single byte values have no byte order.
+		return _ReadFixed<uint8_t>(decoder);
+	}
+
+	return EndianSwapUint32(decoder);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+uint32_t HqDecoder::EndianSwapRegister(HqDecoder& decoder)
+{
+	assert(decoder.ip != nullptr);
+
+	if(decoder.encoding == HQ_BYTECODE_ENCODING_COMPACT)
+	{
+		// Single byte values have no byte order.
+		return _ReadFixed<uint8_t>(decoder);
+	}
+
+	return EndianSwapUint32(decoder);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+uint32_t HqDecoder::EndianSwapIndex(HqDecoder& decoder)
+{
+	assert(decoder.ip != nullptr);
+
+	if(decoder.encoding == HQ_BYTECODE_ENCODING_COMPACT)
+	{
+		// Variable-width values are written a byte at a time, so they have no byte order.
+		return uint32_t(_ReadVarUint(decoder, _HQ_VAR_UINT32_MAX_BYTE_COUNT));
+	}
+
+	return EndianSwapUint32(decoder);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int32_t HqDecoder::EndianSwapOffset(HqDecoder& decoder)
+{
+	assert(decoder.ip != nullptr);
+
+	if(decoder.encoding == HQ_BYTECODE_ENCODING_COMPACT)
+	{
+		return _EndianSwapFixed<int32_t>(decoder, _SwapInt32);
+	}
+
+	return EndianSwapInt32(decoder);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 bool HqDecoder::EndianSwapBool(HqDecoder& decoder)
 {
 	assert(decoder.ip != nullptr);
 
+	if(decoder.encoding == HQ_BYTECODE_ENCODING_COMPACT)
+	{
+		return _ReadFixed<uint8_t>(decoder) != 0;
+	}
+
+	if(!_CanRead(decoder, sizeof(int32_t)))
+	{
+		return 0;
+	}
+
 	int32_t* const pData = reinterpret_cast<int32_t*>(decoder.ip);
 
 	// Endian swap the current bytecode data.
@@ -249,6 +610,16 @@ int8_t HqDecoder::EndianSwapInt8(HqDecoder& decoder)
 {
 	assert(decoder.ip != nullptr);
 
+	if(decoder.encoding == HQ_BYTECODE_ENCODING_COMPACT)
+	{
+		return _ReadFixed<int8_t>(decoder);
+	}
+
+	if(!_CanRead(decoder, sizeof(int32_t)))
+	{
+		return 0;
+	}
+
 	int32_t* const pData = reinterpret_cast<int32_t*>(decoder.ip);
 
 	// Endian swap the current bytecode data.
@@ -269,6 +640,16 @@ int16_t HqDecoder::EndianSwapInt16(HqDecoder& decoder)
 {
 	assert(decoder.ip != nullptr);
 
+	if(decoder.encoding == HQ_BYTECODE_ENCODING_COMPACT)
+	{
+		return _EndianSwapFixed<int16_t>(decoder, _SwapInt16);
+	}
+
+	if(!_CanRead(decoder, sizeof(int32_t)))
+	{
+		return 0;
+	}
+
 	int32_t* const pData = reinterpret_cast<int32_t*>(decoder.ip);
 
 	// Endian swap the current bytecode data.
@@ -289,6 +670,17 @@ int32_t HqDecoder::EndianSwapInt32(HqDecoder& decoder)
 {
 	assert(decoder.ip != nullptr);
 
+	if(decoder.encoding == HQ_BYTECODE_ENCODING_COMPACT)
+	{
+		// Variable-width values are written a byte at a time, so they have no byte order.
+		return int32_t(_ReadVarInt(decoder, _HQ_VAR_UINT32_MAX_BYTE_COUNT));
+	}
+
+	if(!_CanRead(decoder, sizeof(int32_t)))
+	{
+		return 0;
+	}
+
 	int32_t* const pData = reinterpret_cast<int32_t*>(decoder.ip);
 
 	// Endian swap the current bytecode data.
@@ -309,6 +701,17 @@ int64_t HqDecoder::EndianSwapInt64(HqDecoder& decoder)
 {
 	assert(decoder.ip != nullptr);
 
+	if(decoder.encoding == HQ_BYTECODE_ENCODING_COMPACT)
+	{
+		// Variable-width values are written a byte at a time, so they have no byte order.
+		return _ReadVarInt(decoder, _HQ_VAR_UINT64_MAX_BYTE_COUNT);
+	}
+
+	if(!_CanRead(decoder, sizeof(int64_t)))
+	{
+		return 0;
+	}
+
 	int64_t* const pData = reinterpret_cast<int64_t*>(decoder.ip);
 
 	// Endian swap the current bytecode data.
@@ -329,6 +732,16 @@ uint8_t HqDecoder::EndianSwapUint8(HqDecoder& decoder)
 {
 	assert(decoder.ip != nullptr);
 
+	if(decoder.encoding == HQ_BYTECODE_ENCODING_COMPACT)
+	{
+		return _ReadFixed<uint8_t>(decoder);
+	}
+
+	if(!_CanRead(decoder, sizeof(uint32_t)))
+	{
+		return 0;
+	}
+
 	uint32_t* const pData = reinterpret_cast<uint32_t*>(decoder.ip);
 
 	// Endian swap the current bytecode data.
@@ -349,6 +762,16 @@ uint16_t HqDecoder::EndianSwapUint16(HqDecoder& decoder)
 {
 	assert(decoder.ip != nullptr);
 
+	if(decoder.encoding == HQ_BYTECODE_ENCODING_COMPACT)
+	{
+		return _EndianSwapFixed<uint16_t>(decoder, _SwapUint16);
+	}
+
+	if(!_CanRead(decoder, sizeof(uint32_t)))
+	{
+		return 0;
+	}
+
 	uint32_t* const pData = reinterpret_cast<uint32_t*>(decoder.ip);
 
 	// Endian swap the current bytecode data.
@@ -369,6 +792,17 @@ uint32_t HqDecoder::EndianSwapUint32(HqDecoder& decoder)
 {
 	assert(decoder.ip != nullptr);
 
+	if(decoder.encoding == HQ_BYTECODE_ENCODING_COMPACT)
+	{
+		// Variable-width values are written a byte at a time, so they have no byte order.
+		return uint32_t(_ReadVarUint(decoder, _HQ_VAR_UINT32_MAX_BYTE_COUNT));
+	}
+
+	if(!_CanRead(decoder, sizeof(uint32_t)))
+	{
+		return 0;
+	}
+
 	uint32_t* const pData = reinterpret_cast<uint32_t*>(decoder.ip);
 
 	// Endian swap the current bytecode data.
@@ -389,6 +823,17 @@ uint64_t HqDecoder::EndianSwapUint64(HqDecoder& decoder)
 {
 	assert(decoder.ip != nullptr);
 
+	if(decoder.encoding == HQ_BYTECODE_ENCODING_COMPACT)
+	{
+		// Variable-width values are written a byte at a time, so they have no byte order.
+		return _ReadVarUint(decoder, _HQ_VAR_UINT64_MAX_BYTE_COUNT);
+	}
+
+	if(!_CanRead(decoder, sizeof(uint64_t)))
+	{
+		return 0;
+	}
+
 	uint64_t* const pData = reinterpret_cast<uint64_t*>(decoder.ip);
 
 	// Endian swap the current bytecode data.
@@ -409,6 +854,16 @@ float HqDecoder::EndianSwapFloat32(HqDecoder& decoder)
 {
 	assert(decoder.ip != nullptr);
 
+	if(decoder.encoding == HQ_BYTECODE_ENCODING_COMPACT)
+	{
+		return _EndianSwapFixed<float>(decoder, _SwapFloat32);
+	}
+
+	if(!_CanRead(decoder, sizeof(float)))
+	{
+		return 0;
+	}
+
 	float* const pData = reinterpret_cast<float*>(decoder.ip);
 
 	// Endian swap the current bytecode data.
@@ -429,6 +884,16 @@ double HqDecoder::EndianSwapFloat64(HqDecoder& decoder)
 {
 	assert(decoder.ip != nullptr);
 
+	if(decoder.encoding == HQ_BYTECODE_ENCODING_COMPACT)
+	{
+		return _EndianSwapFixed<double>(decoder, _SwapFloat64);
+	}
+
+	if(!_CanRead(decoder, sizeof(double)))
+	{
+		return 0;
+	}
+
 	double* const pData = reinterpret_cast<double*>(decoder.ip);
 
 	// Endian swap the current bytecode data.
@@ -445,6 +910,8 @@ double HqDecoder::EndianSwapFloat64(HqDecoder& decoder)
 
 //----------------------------------------------------------------------------------------------------------------------
 
+#undef _HQ_VAR_UINT64_MAX_BYTE_COUNT
+#undef _HQ_VAR_UINT32_MAX_BYTE_COUNT
 #undef _HQ_UNSIGNED_INT_CLAMP
 #undef _HQ_SIGNED_INT_CLAMP
 
@@ -26,7 +26,12 @@
 
 struct HqDecoder
 {
-	static void Initialize(HqDecoder& output, uint8_t* pBytecode, uint32_t offset);
+	static void Initialize(HqDecoder& output, uint8_t* pBytecode, uint32_t offsetStart, uint32_t offsetEnd, int encoding);
+
+	static uint32_t LoadOpCode(HqDecoder& decoder);
+	static uint32_t LoadRegister(HqDecoder& decoder);
+	static uint32_t LoadIndex(HqDecoder& decoder);
+	static int32_t LoadOffset(HqDecoder& decoder);
 
 	static bool LoadBool(HqDecoder& decoder);
 
@@ -43,6 +48,11 @@ struct HqDecoder
 	static float LoadFloat32(HqDecoder& decoder);
 	static double LoadFloat64(HqDecoder& decoder);
 
+	static uint32_t EndianSwapOpCode(HqDecoder& decoder);
+	static uint32_t EndianSwapRegister(HqDecoder& decoder);
+	static uint32_t EndianSwapIndex(HqDecoder& decoder);
+	static int32_t EndianSwapOffset(HqDecoder& decoder);
+
 	static bool EndianSwapBool(HqDecoder& decoder);
 
 	static int8_t EndianSwapInt8(HqDecoder& decoder);
@@ -60,6 +70,13 @@ struct HqDecoder
 
 	uint8_t* ip;
 	uint8_t* cachedIp;
+	const uint8_t* pEnd;
+
+	int encoding;
+
+	// Set when an operand would run past the end of the bytecode or is too long for its type.
+	// Once this is set, nothing else is read and every load returns zero.
+	bool invalid;
 };
 
 //----------------------------------------------------------------------------------------------------------------------
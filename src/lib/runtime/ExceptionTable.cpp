@@ -1,5 +1,5 @@
 //
-// Copyright (c) 2022, Zoe J. Bare
+// Copyright (c) 2021, Zoe J. Bare
 //
 // Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
 // documentation files (the "Software"), to deal in the Software without restriction, including without limitation
@@ -16,67 +16,77 @@
 // IN THE SOFTWARE.
 //
 
-#include "GuardedBlock.hpp"
+
+#include "ExceptionTable.hpp"
 
 #include <assert.h>
 
 //----------------------------------------------------------------------------------------------------------------------
 
-HqGuardedBlock* HqGuardedBlock::Create(
-	ExceptionHandlerArray& exceptionHandlers, 
-	const uint32_t bytecodeOffset, 
-	const uint32_t bytecodeLength
-)
+void HqExceptionTable::Initialize(HqExceptionTable& output)
 {
-	HqGuardedBlock* const pOutput = new HqGuardedBlock();
-	assert(pOutput != nullptr);
-
-	pOutput->bytecodeOffsetStart = bytecodeOffset;
-	pOutput->bytecodeOffsetEnd = bytecodeOffset + bytecodeLength;
-
-	// Take ownership over the exception handler array.
-	ExceptionHandlerArray::Move(pOutput->handlers, exceptionHandlers);
-
-	// Add a reference to the class name strings in each exception handler.
-	for(size_t i = 0; i < pOutput->handlers.count; ++i)
-	{
-		ExceptionHandler& handler = pOutput->handlers.pData[i];
-
-		HqString::AddRef(handler.pClassName);
-	}
-
-	return pOutput;
+	RangeArray::Initialize(output.ranges);
+	HandlerArray::Initialize(output.handlers);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
-void HqGuardedBlock::Dispose(HqGuardedBlock* const pGuardedBlock)
+void HqExceptionTable::Dispose(HqExceptionTable& table)
 {
 	// Release the exception handler class name strings.
-	for(size_t i = 0; i < pGuardedBlock->handlers.count; ++i)
+	for(size_t i = 0; i < table.handlers.count; ++i)
 	{
-		ExceptionHandler& handler = pGuardedBlock->handlers.pData[i];
+		Handler& handler = table.handlers.pData[i];
 
-		HqString::Release(handler.pClassName);
+		if(handler.pClassName)
+		{
+			HqString::Release(handler.pClassName);
+		}
 	}
 
-	ExceptionHandlerArray::Dispose(pGuardedBlock->handlers);
-
-	delete pGuardedBlock;
+	RangeArray::Dispose(table.ranges);
+	HandlerArray::Dispose(table.handlers);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
-void* HqGuardedBlock::operator new(const size_t sizeInBytes)
+void HqExceptionTable::Move(HqExceptionTable& output, HqExceptionTable& input)
 {
-	return HqMemAlloc(sizeInBytes);
+	RangeArray::Move(output.ranges, input.ranges);
+	HandlerArray::Move(output.handlers, input.handlers);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
-void HqGuardedBlock::operator delete(void* const pObject)
+const HqExceptionTable::Range* HqExceptionTable::FindRange(const HqExceptionTable& table, const uint32_t bytecodeOffset)
 {
-	HqMemFree(pObject);
+	size_t low = 0;
+	size_t high = table.ranges.count;
+
+	// Find the first range that starts after the offset; the range before it is the only one that can contain it.
+	while(low < high)
+	{
+		const size_t mid = low + ((high - low) / 2);
+
+		if(table.ranges.pData[mid].bytecodeOffsetStart <= bytecodeOffset)
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+
+	if(low == 0)
+	{
+		return nullptr;
+	}
+
+	const Range* const pRange = &table.ranges.pData[low - 1];
+	assert(pRange->bytecodeOffsetStart <= bytecodeOffset);
+
+	return (bytecodeOffset <= pRange->bytecodeOffsetEnd) ? pRange : nullptr;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -1,5 +1,5 @@
 //
-// Copyright (c) 2022, Zoe J. Bare
+// Copyright (c) 2021, Zoe J. Bare
 //
 // Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
 // documentation files (the "Software"), to deal in the Software without restriction, including without limitation
@@ -16,6 +16,7 @@
 // IN THE SOFTWARE.
 //
 
+
 #pragma once
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -23,39 +24,49 @@
 #include "../base/String.hpp"
 
 #include "../common/Array.hpp"
-#include "../common/Stack.hpp"
+
+#include <stdint.h>
 
 //----------------------------------------------------------------------------------------------------------------------
 
-struct HqGuardedBlock
+struct HqScriptObject;
+
+// Exception handlers of a function flattened into disjoint bytecode ranges. Each range lists every handler that
+// applies to it, ordered from the innermost guarded block outward, so a raised value only needs one range lookup.
+struct HqExceptionTable
 {
-	struct ExceptionHandler
+	struct Handler
 	{
 		HqString* pClassName;
 
+		// Schema of the handled object type when it was available at load time. Handlers
+		// without one fall back to comparing the class name of the raised object.
+		HqScriptObject* pSchema;
+
 		uint32_t offset;
 		uint8_t type;
 	};
 
-	typedef HqArray<HqGuardedBlock*> PtrArray;
-	typedef HqStack<HqGuardedBlock*> PtrStack;
+	struct Range
+	{
+		uint32_t bytecodeOffsetStart;
+		uint32_t bytecodeOffsetEnd;
 
-	typedef HqArray<ExceptionHandler> ExceptionHandlerArray;
+		uint32_t firstHandler;
+		uint32_t handlerCount;
+	};
 
-	static HqGuardedBlock* Create(
-		ExceptionHandlerArray& exceptionHandlers, 
-		uint32_t bytecodeOffset, 
-		uint32_t bytecodeLength
-	);
-	static void Dispose(HqGuardedBlock* const pGuardedBlock);
+	typedef HqArray<Handler> HandlerArray;
+	typedef HqArray<Range> RangeArray;
 
-	void* operator new(const size_t sizeInBytes);
-	void operator delete(void* const pObject);
+	static void Initialize(HqExceptionTable& output);
+	static void Dispose(HqExceptionTable& table);
+	static void Move(HqExceptionTable& output, HqExceptionTable& input);
 
-	ExceptionHandlerArray handlers;
+	static const Range* FindRange(const HqExceptionTable& table, uint32_t bytecodeOffset);
 
-	uint32_t bytecodeOffsetStart;
-	uint32_t bytecodeOffsetEnd;
+	RangeArray ranges;
+	HandlerArray handlers;
 };
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -21,17 +21,163 @@
 #include "Module.hpp"
 #include "Vm.hpp"
 
+#include "op-impl/Arithmetic/ArithUtil.hpp"
+#include "op-impl/Compare/CmpUtil.hpp"
+
+#include "../base/Clock.hpp"
 #include "../base/Mutex.hpp"
+#include "../common/Atomic.hpp"
 #include "../common/OpCodeEnum.hpp"
 
-#include <algorithm>
-
 #include <assert.h>
+#include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
 
 //----------------------------------------------------------------------------------------------------------------------
 
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(HQ_VM_DISABLE_COMPUTED_GOTO)
+	// Opcode dispatch uses the "labels as values" compiler extension when it's available.
+	// Building with HQ_VM_DISABLE_COMPUTED_GOTO will force the portable dispatch loop.
+	#define HQ_VM_USE_COMPUTED_GOTO
+
+	#if defined(__clang__)
+		#pragma clang diagnostic ignored "-Wgnu-label-as-value"
+	#endif
+#endif
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#if defined(HQ_VM_USE_COMPUTED_GOTO)
+	// Every opcode in the same order as HqOpCodeEnum, along with the name of its handler and whether the
+	// dispatch loop runs it inline or calls out to the handler. The order is verified at compile time below.
+	#define _HQ_DISPATCH_OP_CODE_LIST(X) \
+		X(NOP,    Nop,    call) \
+		X(ABORT,  Abort,  call) \
+		X(RETURN, Return, call) \
+		X(YIELD,  Yield,  call) \
+		\
+		X(CALL,       Call,      call) \
+		X(CALL_VALUE, CallValue, call) \
+		X(RAISE,      Raise,     call) \
+		\
+		X(LOAD_IMM_NULL, LoadImmNull, inline) \
+		X(LOAD_IMM_BOOL, LoadImmBool, inline) \
+		X(LOAD_IMM_I8,   LoadImmI8,   inline) \
+		X(LOAD_IMM_I16,  LoadImmI16,  inline) \
+		X(LOAD_IMM_I32,  LoadImmI32,  inline) \
+		X(LOAD_IMM_I64,  LoadImmI64,  inline) \
+		X(LOAD_IMM_U8,   LoadImmU8,   inline) \
+		X(LOAD_IMM_U16,  LoadImmU16,  inline) \
+		X(LOAD_IMM_U32,  LoadImmU32,  inline) \
+		X(LOAD_IMM_U64,  LoadImmU64,  inline) \
+		X(LOAD_IMM_F32,  LoadImmF32,  inline) \
+		X(LOAD_IMM_F64,  LoadImmF64,  inline) \
+		X(LOAD_IMM_STR,  LoadImmStr,  call) \
+		\
+		X(LOAD_GLOBAL, LoadGlobal,   call) \
+		X(LOAD_PARAM,  LoadParam,    call) \
+		X(LOAD_VAR,    LoadVariable, call) \
+		X(LOAD_OBJECT, LoadObject,   call) \
+		X(LOAD_ARRAY,  LoadArray,    call) \
+		X(LOAD_GRID,   LoadGrid,     call) \
+		\
+		X(STORE_GLOBAL, StoreGlobal,   call) \
+		X(STORE_PARAM,  StoreParam,    call) \
+		X(STORE_VAR,    StoreVariable, call) \
+		X(STORE_OBJECT, StoreObject,   call) \
+		X(STORE_ARRAY,  StoreArray,    call) \
+		X(STORE_GRID,   StoreGrid,     call) \
+		\
+		X(PUSH, Push, call) \
+		X(POP,  Pop,  call) \
+		\
+		X(INIT_OBJECT, InitObject,   call) \
+		X(INIT_ARRAY,  InitArray,    call) \
+		X(INIT_GRID,   InitGrid,     call) \
+		X(INIT_FUNC,   InitFunction, call) \
+		\
+		X(JMP,       Jump,        inline) \
+		X(JMP_TRUE,  JumpIfTrue,  inline) \
+		X(JMP_FALSE, JumpIfFalse, inline) \
+		\
+		X(LENGTH, Length, call) \
+		\
+		X(ADD, Add, inline) \
+		X(SUB, Sub, inline) \
+		X(MUL, Mul, inline) \
+		X(DIV, Div, inline) \
+		X(MOD, Mod, inline) \
+		X(EXP, Exp, call) \
+		\
+		X(AND,  BitAnd,      call) \
+		X(OR,   BitOr,       call) \
+		X(XOR,  BitXor,      call) \
+		X(NOT,  BitNot,      call) \
+		X(LSH,  LeftShift,   call) \
+		X(RSH,  RightShift,  call) \
+		X(LROT, LeftRotate,  call) \
+		X(RROT, RightRotate, call) \
+		\
+		X(CAST_I8,   CastInt8,    call) \
+		X(CAST_I16,  CastInt16,   call) \
+		X(CAST_I32,  CastInt32,   call) \
+		X(CAST_I64,  CastInt64,   call) \
+		X(CAST_U8,   CastUint8,   call) \
+		X(CAST_U16,  CastUint16,  call) \
+		X(CAST_U32,  CastUint32,  call) \
+		X(CAST_U64,  CastUint64,  call) \
+		X(CAST_F32,  CastFloat32, call) \
+		X(CAST_F64,  CastFloat64, call) \
+		X(CAST_BOOL, CastBool,    call) \
+		X(CAST_STR,  CastString,  call) \
+		\
+		X(CMP_EQ, CompareEqual,        inline) \
+		X(CMP_NE, CompareNotEqual,     inline) \
+		X(CMP_GT, CompareGreater,      inline) \
+		X(CMP_GE, CompareGreaterEqual, inline) \
+		X(CMP_LT, CompareLess,         inline) \
+		X(CMP_LE, CompareLessEqual,    inline) \
+		\
+		X(TEST, Test, call) \
+		X(MOVE, Move, inline) \
+		X(COPY, Copy, call) \
+		\
+		X(CALL_WINDOW,     CallWindow,    call) \
+		X(TAIL_CALL,       TailCall,      call) \
+		X(TAIL_CALL_VALUE, TailCallValue, call)
+
+	#define _HQ_DISPATCH_ORDER_ENTRY(op_code, name, kind) HQ_OP_CODE_ ## op_code,
+
+	static constexpr uint32_t _dispatchOpCodeOrder[] =
+	{
+		_HQ_DISPATCH_OP_CODE_LIST(_HQ_DISPATCH_ORDER_ENTRY)
+	};
+
+	#undef _HQ_DISPATCH_ORDER_ENTRY
+
+	static constexpr bool _isDispatchOrderValid()
+	{
+		for(uint32_t opIndex = 0; opIndex < HQ_OP_CODE__TOTAL_COUNT; ++opIndex)
+		{
+			if(_dispatchOpCodeOrder[opIndex] != opIndex)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	static_assert(
+		sizeof(_dispatchOpCodeOrder) / sizeof(_dispatchOpCodeOrder[0]) == HQ_OP_CODE__TOTAL_COUNT,
+		"Every opcode needs an entry in the dispatch table"
+	);
+	static_assert(_isDispatchOrderValid(), "Dispatch table entries must be in the same order as HqOpCodeEnum");
+#endif
+
+//----------------------------------------------------------------------------------------------------------------------
+
 HqExecutionHandle HqExecution::Create(HqVmHandle hVm)
 {
 	assert(hVm != HQ_VM_HANDLE_NULL);
@@ -45,18 +191,35 @@ HqExecutionHandle HqExecution::Create(HqVmHandle hVm)
 	pOutput->pExceptionLocation = nullptr;
 	pOutput->lastOpCode = UINT_MAX;
 	pOutput->runMode = HQ_RUN_STEP;
+	pOutput->pProfiler = nullptr;
+	pOutput->profilerSuspendedTime = 0;
 	pOutput->frameStackDirty = false;
+	pOutput->isProfiling = false;
+	pOutput->isRunning = false;
+	pOutput->hasMainFiber = false;
 	pOutput->stateBits = 0;
 	pOutput->firstRun = true;
 	pOutput->created = false;
 
+	// Create the main execution fiber. This is done before anything else is initialized since there's nothing
+	// else to clean up if it fails.
+	if(_createMainFiber(pOutput) != HQ_SUCCESS)
+	{
+		delete pOutput;
+		return HQ_EXECUTION_HANDLE_NULL;
+	}
+
 	// Initialize the GC proxy to make this object visible to the garbage collector.
 	// Keep the execution context alive indefinitely until we're ready to dispose of it.
-	HqGcProxy::Initialize(pOutput->gcProxy, hVm->gc, _onGcDiscovery, _onGcDestruct, pOutput, true, true);
+	HqGcProxy::Initialize(pOutput->gcProxy, hVm->gc, HqGcProxy::Type::Execution, pOutput, true, true);
 
 	HqFrame::HandleStack::Initialize(pOutput->frameStack, HQ_VM_FRAME_STACK_SIZE);
 	HqFrame::HandleStack::Initialize(pOutput->framePool, HQ_VM_FRAME_STACK_SIZE);
+	HqFrameArena::Initialize(pOutput->frameArena);
+	HqFrameArena::Initialize(pOutput->registerArena);
 	HqValue::HandleArray::Initialize(pOutput->registers);
+	HqGcNursery::Initialize(pOutput->nursery, hVm->gc);
+	HqSlabAllocator::InitializeCache(pOutput->slabCache, hVm->pSlabAllocator);
 	HqValue::HandleArray::Reserve(pOutput->registers, HQ_VM_IO_REGISTER_COUNT);
 
 	pOutput->registers.count = HQ_VM_IO_REGISTER_COUNT;
@@ -64,9 +227,6 @@ HqExecutionHandle HqExecution::Create(HqVmHandle hVm)
 	// Initialize each value in the I/O register set.
 	memset(pOutput->registers.pData, 0, sizeof(HqValueHandle) * pOutput->registers.count);
 
-	// Create the main execution fiber.
-	_createMainFiber(pOutput);
-
 	// The execution context has finished being created.
 	pOutput->created = true;
 
@@ -121,10 +281,22 @@ int HqExecution::Reset(HqExecutionHandle hExec)
 		// Only re-create the main fiber if execution was stopped somewhere in an instruction.
 		if(hExec->state.exception || hExec->state.abort || hExec->state.yield)
 		{
-			// Dispose of the existing fiber before re-creating it.
-			HqFiber::Dispose(hExec->mainFiber);
+			if(hExec->hasMainFiber)
+			{
+				// Dispose of the existing fiber before re-creating it.
+				HqFiber::Dispose(hExec->mainFiber);
+
+				hExec->hasMainFiber = false;
+			}
 
-			_createMainFiber(hExec);
+			const int createFiberResult = _createMainFiber(hExec);
+			if(createFiberResult != HQ_SUCCESS)
+			{
+				// Leave the execution context aborted so it can't be run without a fiber. The next reset will
+				// come back through here to try creating the fiber again.
+				hExec->state.abort = true;
+				return createFiberResult;
+			}
 		}
 
 		hExec->firstRun = true;
@@ -138,7 +310,7 @@ int HqExecution::Reset(HqExecutionHandle hExec)
 		if(hExec->hFunction)
 		{
 			// Push the entry point frame to the frame stack.
-			int pushEntryFrameResult = PushFrame(hExec, hExec->hFunction);
+			int pushEntryFrameResult = PushFrame(hExec, hExec->hFunction, HQ_FRAME_NO_WINDOW);
 			if(pushEntryFrameResult == HQ_ERROR_BAD_ALLOCATION)
 			{
 				return HQ_ERROR_BAD_ALLOCATION;
@@ -161,7 +333,7 @@ int HqExecution::Reset(HqExecutionHandle hExec)
 
 //----------------------------------------------------------------------------------------------------------------------
 
-int HqExecution::PushFrame(HqExecutionHandle hExec, HqFunctionHandle hFunction)
+int HqExecution::PushFrame(HqExecutionHandle hExec, HqFunctionHandle hFunction, const uint32_t windowBase)
 {
 	assert(hExec != HQ_EXECUTION_HANDLE_NULL);
 	assert(hFunction != HQ_FUNCTION_HANDLE_NULL);
@@ -179,14 +351,25 @@ int HqExecution::PushFrame(HqExecutionHandle hExec, HqFunctionHandle hFunction)
 	}
 
 	// Initialize the frame with the supplied function.
-	HqFrame::Initialize(hFrame, hFunction);
+	int result = HqFrame::Initialize(hFrame, hFunction, windowBase);
+	if(result != HQ_SUCCESS)
+	{
+		HqFrame::HandleStack::Push(hExec->framePool, hFrame);
+		return result;
+	}
 
 	// Push the new frame onto the active frame stack.
-	int result = HqFrame::HandleStack::Push(hExec->frameStack, hFrame);
+	result = HqFrame::HandleStack::Push(hExec->frameStack, hFrame);
 	if(result == HQ_SUCCESS)
 	{
 		hExec->hCurrentFrame = hFrame;
 	}
+	else
+	{
+		// Return the frame's memory to the arena since it can't be used.
+		HqFrame::Reset(hFrame);
+		HqFrame::HandleStack::Push(hExec->framePool, hFrame);
+	}
 
 	hExec->frameStackDirty = true;
 
@@ -220,6 +403,47 @@ int HqExecution::PopFrame(HqExecutionHandle hExec)
 
 //----------------------------------------------------------------------------------------------------------------------;
 
+int HqExecution::ReplaceFrame(HqExecutionHandle hExec, HqFunctionHandle hFunction)
+{
+	assert(hExec != HQ_EXECUTION_HANDLE_NULL);
+	assert(hFunction != HQ_FUNCTION_HANDLE_NULL);
+
+	HqFrameHandle hFrame = hExec->hCurrentFrame;
+	if(!hFrame)
+	{
+		return HQ_ERROR_STACK_EMPTY;
+	}
+
+	const uint32_t windowBase = hFrame->windowBase;
+
+	// Temporarily take the frame off the top of the frame stack so its memory can be given back
+	// to the arenas and re-initialized against the caller's frame, exactly as if it was just pushed.
+	--hExec->frameStack.nextIndex;
+	hExec->hCurrentFrame = (hExec->frameStack.nextIndex > 0)
+		? hExec->frameStack.memory.pData[hExec->frameStack.nextIndex - 1]
+		: nullptr;
+
+	HqFrame::Reset(hFrame);
+
+	const int result = HqFrame::Initialize(hFrame, hFunction, windowBase);
+	if(result == HQ_SUCCESS)
+	{
+		++hExec->frameStack.nextIndex;
+		hExec->hCurrentFrame = hFrame;
+	}
+	else
+	{
+		// The original function's frame is already gone, so the frame can only go back to the pool.
+		HqFrame::HandleStack::Push(hExec->framePool, hFrame);
+	}
+
+	hExec->frameStackDirty = true;
+
+	return result;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 int HqExecution::SetIoRegister(HqExecutionHandle hExec, HqValueHandle hValue, const size_t index)
 {
 	assert(hExec != HQ_EXECUTION_HANDLE_NULL);
@@ -265,6 +489,14 @@ void HqExecution::Run(HqExecutionHandle hExec, const int runMode)
 		return;
 	}
 
+	if(!hExec->state.started
+		&& hExec->hCurrentFrame
+		&& hExec->hCurrentFrame->hFunction->usesRegisterWindow)
+	{
+		// The host always passes arguments to the entry point through the I/O registers.
+		_copyIoRegistersToFrame(hExec, hExec->hCurrentFrame, 0, hExec->hCurrentFrame->hFunction->numParameters);
+	}
+
 	// Set the run mode so the fiber context knows how many instructions
 	// it needs to process in this iteration.
 	hExec->runMode = runMode;
@@ -279,8 +511,17 @@ void HqExecution::Run(HqExecutionHandle hExec, const int runMode)
 	hExec->firstRun = false;
 	hExec->frameStackDirty = true;
 
+	// Objects created by the script are linked into the execution's own nursery while it's running.
+	// Everything left in the nursery is handed off to the garbage collector when the fiber yields back.
+	HqScopedGcNursery nursery(&hExec->nursery);
+
+	// Small objects created by the script are served from the execution's own slab cache without taking any locks.
+	HqScopedSlabCache slabCache(&hExec->slabCache);
+
 	// Run an iteration of the instruction processing fiber context.
+	HqAtomic::Store(&hExec->isRunning, true);
 	HqFiber::Run(hExec->mainFiber);
+	HqAtomic::Store(&hExec->isRunning, false);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -289,7 +530,18 @@ void HqExecution::Pause(HqExecutionHandle hExec)
 {
 	assert(hExec != HQ_EXECUTION_HANDLE_NULL);
 
-	HqFiber::Wait(hExec->mainFiber);
+	if(hExec->isProfiling)
+	{
+		const uint64_t startTime = HqClockGetTimestamp();
+
+		HqFiber::Wait(hExec->mainFiber);
+
+		hExec->profilerSuspendedTime += HqClockGetTimestamp() - startTime;
+	}
+	else
+	{
+		HqFiber::Wait(hExec->mainFiber);
+	}
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -313,33 +565,18 @@ void HqExecution::RaiseException(HqExecutionHandle hExec, HqValueHandle hValue,
 	}
 	else
 	{
-		auto blockReverseSortFunc = [](
-			HqGuardedBlock* const pLeft,
-			HqGuardedBlock* const pRight
+		auto findExceptionHandler = [&hValue](
+			HqFrameHandle hFrame,
+			uint32_t* pOutHandlerOffset
 		) -> bool
 		{
-			if(pLeft->bytecodeOffsetStart > pRight->bytecodeOffsetStart)
+			const HqExceptionTable& exceptionTable = hFrame->hFunction->exceptionTable;
+			if(exceptionTable.ranges.count == 0)
 			{
-				// Earlier guarded blocks are sorted after the blocks that come after them.
-				return true;
-			}
-			else if(pLeft->bytecodeOffsetStart == pRight->bytecodeOffsetStart)
-			{
-				// Nested blocks are sorted *before* the blocks that contain them.
-				if(pLeft->bytecodeOffsetEnd < pRight->bytecodeOffsetEnd)
-				{
-					return true;
-				}
+				// Functions without any guarded blocks can never handle an exception.
+				return false;
 			}
 
-			return false;
-		};
-
-		auto findExceptionHandler = [&hValue, &blockReverseSortFunc](
-			HqFrameHandle hFrame,
-			uint32_t* pOutHandlerOffset
-		) -> bool
-		{
 			const uint8_t valueType = hValue 
 				? uint8_t(hValue->type) 
 				: uint8_t(HQ_VALUE_TYPE_OBJECT);
@@ -352,59 +589,53 @@ void HqExecution::RaiseException(HqExecutionHandle hExec, HqValueHandle hValue,
 				return false;
 			}
 
-			HqGuardedBlock::PtrStack validBlocks;
-			HqGuardedBlock::PtrStack::Initialize(validBlocks, hFrame->hFunction->guardedBlocks.count);
-
-			// Find all the guarded blocks that encapsulate the instruction that raised the exception.
-			for(size_t blockIndex = 0; blockIndex < hFrame->hFunction->guardedBlocks.count; ++blockIndex)
+			// Find the range of guarded bytecode that encapsulates the instruction that raised the exception.
+			const HqExceptionTable::Range* const pRange = HqExceptionTable::FindRange(exceptionTable, currentOffset);
+			if(!pRange)
 			{
-				HqGuardedBlock* pBlock = hFrame->hFunction->guardedBlocks.pData[blockIndex];
-
-				if(currentOffset >= pBlock->bytecodeOffsetStart
-					&& currentOffset <= pBlock->bytecodeOffsetEnd)
-				{
-					HqGuardedBlock::PtrStack::Push(validBlocks, pBlock);
-				}
+				return false;
 			}
 
-			// Sort the guarded blocks in reverse order since we need to start with the most nested block first.
-			std::sort(validBlocks.memory.pData, validBlocks.memory.pData + validBlocks.nextIndex, blockReverseSortFunc);
+			// The range's handlers are already ordered from the most nested guarded block outward.
+			const HqExceptionTable::Handler* const pHandlers = exceptionTable.handlers.pData + pRange->firstHandler;
 
-			// Search the blocks for an exception handler that is capable of handling the raised value.
-			for(size_t blockIndex = 0; blockIndex < validBlocks.nextIndex; ++blockIndex)
+			for(size_t handlerIndex = 0; handlerIndex < pRange->handlerCount; ++handlerIndex)
 			{
-				HqGuardedBlock* const pBlock = validBlocks.memory.pData[blockIndex];
+				const HqExceptionTable::Handler& handler = pHandlers[handlerIndex];
+
+				// Check if the general type of the handler matches the raised value.
+				if(handler.type != valueType)
+				{
+					continue;
+				}
 
-				// Check each handler on the current block.
-				for(size_t handlerIndex = 0; handlerIndex < pBlock->handlers.count; ++handlerIndex)
+				// If the value is an object, we need to also compare the class type to verify
+				// this handler will handle the exact object type that was raised.
+				if(valueType == HQ_VALUE_TYPE_OBJECT && hValue)
 				{
-					const HqGuardedBlock::ExceptionHandler& handler = pBlock->handlers.pData[handlerIndex];
+					const HqScriptObject* const pObject = hValue->as.pObject;
 
-					// Check if the general type of the handler matches the raised value.
-					if(handler.type == valueType)
+					if(handler.pSchema)
 					{
-						// If the value is an object, we need to also compare the class type name to
-						// verify this handler will handle the exact object type that was raised.
-						if(valueType != HQ_VALUE_TYPE_OBJECT ||
-							(
-								valueType == HQ_VALUE_TYPE_OBJECT
-									&& (!hValue || HqString::FastCompare(handler.pClassName, hValue->as.pObject->pTypeName))
-							)
-						)
-						{
-							// This is the handler we'll use.
-							HqGuardedBlock::PtrStack::Dispose(validBlocks);
+						const HqScriptObject* const pObjectSchema = pObject->pSchema ? pObject->pSchema : pObject;
 
-							(*pOutHandlerOffset) = handler.offset;
-							return true;
+						if(handler.pSchema != pObjectSchema)
+						{
+							continue;
 						}
 					}
+					else if(!HqString::FastCompare(handler.pClassName, pObject->pTypeName))
+					{
+						continue;
+					}
 				}
+
+				// This is the handler we'll use.
+				(*pOutHandlerOffset) = handler.offset;
+				return true;
 			}
 
 			// No acceptable handler was found for this frame.
-			HqGuardedBlock::PtrStack::Dispose(validBlocks);
-
 			return false;
 		};
 
@@ -419,7 +650,11 @@ void HqExecution::RaiseException(HqExecutionHandle hExec, HqValueHandle hValue,
 
 				uint32_t handlerOffset = 0;
 
-				if(findExceptionHandler(hFrame, &handlerOffset))
+				HqInstruction* pHandlerInstr = nullptr;
+
+				// The handler offset must land on a decoded instruction in the function for it to be usable.
+				if(findExceptionHandler(hFrame, &handlerOffset)
+					&& (pHandlerInstr = HqFunction::FindInstruction(hFrame->hFunction, handlerOffset)) != nullptr)
 				{
 					// We found the frame that will handle the exception, now we need
 					// to actually pop the frame stack until we get to that frame.
@@ -436,8 +671,8 @@ void HqExecution::RaiseException(HqExecutionHandle hExec, HqValueHandle hValue,
 					assert(hExec->hCurrentFrame != HQ_FRAME_HANDLE_NULL);
 
 					// Set the instruction pointer to the start of the exception handler.
-					hExec->hCurrentFrame->decoder.cachedIp = hExec->hCurrentFrame->hFunction->hModule->code.pData + handlerOffset;
-					hExec->hCurrentFrame->decoder.ip = hExec->hCurrentFrame->decoder.cachedIp;
+					hExec->hCurrentFrame->pInstruction = pHandlerInstr;
+					hExec->hCurrentFrame->pNextInstruction = pHandlerInstr;
 
 					break;
 				}
@@ -490,7 +725,56 @@ void HqExecution::RaiseOpCodeException(HqExecutionHandle hExec, const int type,
 
 //----------------------------------------------------------------------------------------------------------------------
 
-void HqExecution::_createMainFiber(HqExecutionHandle hExec)
+void HqExecution::_copyIoRegistersToFrame(
+	HqExecutionHandle hExec,
+	HqFrameHandle hFrame,
+	const uint32_t firstRegister,
+	const size_t count
+)
+{
+	assert(hExec != HQ_EXECUTION_HANDLE_NULL);
+	assert(hFrame != HQ_FRAME_HANDLE_NULL);
+
+	for(size_t ioRegIndex = 0; ioRegIndex < count && ioRegIndex < hExec->registers.count; ++ioRegIndex)
+	{
+		// Stop at the end of the frame's registers; the writer sizes register window frames to fit.
+		if(HqFrame::SetGpRegister(hFrame, hExec->registers.pData[ioRegIndex], firstRegister + uint32_t(ioRegIndex)) != HQ_SUCCESS)
+		{
+			break;
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqExecution::_copyFrameToIoRegisters(
+	HqExecutionHandle hExec,
+	HqFrameHandle hFrame,
+	const uint32_t firstRegister,
+	const size_t count
+)
+{
+	assert(hExec != HQ_EXECUTION_HANDLE_NULL);
+	assert(hFrame != HQ_FRAME_HANDLE_NULL);
+
+	for(size_t ioRegIndex = 0; ioRegIndex < count && ioRegIndex < hExec->registers.count; ++ioRegIndex)
+	{
+		int result = HQ_SUCCESS;
+
+		// Primitive values are boxed here since the I/O registers only hold value handles.
+		HqValueHandle hValue = HqFrame::GetGpRegister(hFrame, firstRegister + uint32_t(ioRegIndex), &result);
+		if(result != HQ_SUCCESS)
+		{
+			break;
+		}
+
+		hExec->registers.pData[ioRegIndex] = hValue;
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int HqExecution::_createMainFiber(HqExecutionHandle hExec)
 {
 	assert(hExec != HQ_EXECUTION_HANDLE_NULL);
 
@@ -501,7 +785,14 @@ void HqExecution::_createMainFiber(HqExecutionHandle hExec)
 	strncpy(runFiberConfig.name, "ExecMainFiber", sizeof(runFiberConfig.name) - 1);
 
 	// Create the fiber context that will be used for running scripts.
-	HqFiber::Create(hExec->mainFiber, runFiberConfig);
+	if(!HqFiber::Create(hExec->mainFiber, runFiberConfig))
+	{
+		return HQ_ERROR_BAD_ALLOCATION;
+	}
+
+	hExec->hasMainFiber = true;
+
+	return HQ_SUCCESS;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -517,27 +808,30 @@ void HqExecution::_runFiberLoop(void* const pArg)
 		// Cache the run mode to decrease access time in a continuous run loop.
 		const uint32_t runMode = hExec->runMode;
 
-		// We only need to check if the execution has finished because when a fatal error
-		// occurs or a script aborts, they'll immediately yield the fiber and the execution
-		// context won't be able to run it again.
-		while(!hExec->state.finished)
+		if(runMode == HQ_RUN_STEP)
 		{
-			if(hExec->hVm->isGcThreadEnabled)
+			// When manually stepping instructions, we should only process a single
+			// instruction per iteration. We only need to check if the execution has
+			// finished because when a fatal error occurs or a script aborts, they'll
+			// immediately yield the fiber and the execution context won't be able to
+			// run it again.
+			if(!hExec->state.finished)
 			{
-				// Allow the GC to interrupt between each instruction in case it has work that it needs to do.
-				HqRwLock::ReadUnlock(hExec->hVm->gc.rwLock);
-				HqRwLock::ReadLock(hExec->hVm->gc.rwLock);
-			}
-
-			_runStep(hExec);
+				// Stepping is slow enough already that it doesn't matter if the GC is allowed to
+				// interrupt between every instruction, so treat each step as a safepoint.
+				HqGarbageCollector::PollSafepoint(hExec->hVm->gc);
 
-			if(runMode == HQ_RUN_STEP)
-			{
-				// When manually stepping instructions, we should only process a single
-				// instruction per iteration.
-				break;
+				_runStep(hExec);
 			}
 		}
+		else if(hExec->isProfiling)
+		{
+			_runProfiledLoop(hExec);
+		}
+		else
+		{
+			_runDispatchLoop(hExec);
+		}
 
 		if(hExec->lastOpCode != HQ_OP_CODE_YIELD)
 		{
@@ -557,15 +851,323 @@ void HqExecution::_runStep(HqExecutionHandle hExec)
 
 	HqFrameHandle hFrame = hExec->hCurrentFrame;
 
-	// Save the current instruction pointer position at the start of the opcode that will now be executed.
-	hFrame->decoder.cachedIp = hFrame->decoder.ip;
-
-	const uint32_t opCode = HqDecoder::LoadUint32(hFrame->decoder);
+	// Advance to the instruction that will now be executed.
+	HqInstruction* const pInstr = hFrame->pNextInstruction;
+	hFrame->pInstruction = pInstr;
+	hFrame->pNextInstruction = pInstr + 1;
 
 	// Cache the opcode prior to executing it so we can query it in the event of a fiber yield.
-	hExec->lastOpCode = opCode;
+	hExec->lastOpCode = pInstr->opCode;
 
-	HqVm::ExecuteOpCode(hExec->hVm, hExec, opCode);
+	if(pInstr->execFn)
+	{
+		pInstr->execFn(hExec);
+	}
+	else
+	{
+		RaiseOpCodeException(hExec, HQ_STANDARD_EXCEPTION_RUNTIME_ERROR, "Invalid opcode: 0x%" PRIX32, pInstr->opCode);
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqExecution::_runDispatchLoop(HqExecutionHandle hExec)
+{
+	assert(hExec != HQ_EXECUTION_HANDLE_NULL);
+
+#if defined(HQ_VM_USE_COMPUTED_GOTO)
+	#define _HQ_DISPATCH_TABLE_ENTRY(op_code, name, kind) &&_ ## kind ## _ ## op_code,
+
+	// Each entry points to either the inline handler for its opcode or the stub that calls out to it.
+	static const void* const dispatchTable[] =
+	{
+		_HQ_DISPATCH_OP_CODE_LIST(_HQ_DISPATCH_TABLE_ENTRY)
+	};
+
+	#undef _HQ_DISPATCH_TABLE_ENTRY
+
+	if(hExec->state.finished)
+	{
+		return;
+	}
+
+	HqGarbageCollector& gc = hExec->hVm->gc;
+	const HqSampleProfiler& sampleProfiler = hExec->hVm->sampleProfiler;
+
+	// The current frame and instruction pointer live in locals for as long as the loop keeps running inline
+	// handlers. The frame is only brought up to date before something that can observe it: every out-of-line
+	// handler (which covers calls, returns, and anything that can raise an exception) and every safepoint.
+	// The one exception is the sample profiler reading instruction offsets from another thread, so while
+	// it's running, each instruction is published to the frame before it's dispatched.
+	HqFrameHandle hFrame = hExec->hCurrentFrame;
+	HqInstruction* pInstr = hFrame->pNextInstruction;
+	uint32_t opCode;
+
+	bool publishInstruction = sampleProfiler.isRunning && sampleProfiler.includeOffsets;
+
+	#define _HQ_DISPATCH_CHECK_SAMPLER() \
+		publishInstruction = sampleProfiler.isRunning && sampleProfiler.includeOffsets
+
+	// Decode the instruction at the local instruction pointer and jump directly to its handler. Each handler gets
+	// its own copy of this indirect branch which gives the branch predictor a much better chance than a single
+	// shared call site.
+	#define _HQ_DISPATCH_NEXT() \
+		if(publishInstruction) \
+		{ \
+			hFrame->pInstruction = pInstr; \
+		} \
+		opCode = pInstr->opCode; \
+		if(opCode >= HQ_OP_CODE__TOTAL_COUNT) \
+		{ \
+			goto _op_invalid; \
+		} \
+		goto *dispatchTable[opCode]
+
+	// Leave the frame in the same state _runStep() would have prior to running the current instruction.
+	#define _HQ_DISPATCH_SYNC() \
+		hFrame->pInstruction = pInstr; \
+		hFrame->pNextInstruction = pInstr + 1; \
+		hExec->lastOpCode = opCode
+
+	// Out-of-line handlers are free to jump, switch frames, raise, or finish the script,
+	// so the local state is reloaded from wherever they left the execution.
+	#define _HQ_DISPATCH_RESUME() \
+		if(hExec->state.finished) \
+		{ \
+			goto _dispatch_end; \
+		} \
+		hFrame = hExec->hCurrentFrame; \
+		pInstr = hFrame->pNextInstruction; \
+		_HQ_DISPATCH_CHECK_SAMPLER(); \
+		_HQ_DISPATCH_NEXT()
+
+	#define _HQ_DISPATCH_CALL_STUB(op_code, name, kind) \
+		_call_ ## op_code: \
+			_HQ_DISPATCH_SYNC(); \
+			OpCodeExec_ ## name(hExec); \
+			_HQ_DISPATCH_RESUME();
+
+	// Move the instruction pointer to a resolved jump target. Loops are the only way a script can run
+	// indefinitely without calling a function, so backward jumps are safepoints for the GC.
+	#define _HQ_DISPATCH_JUMP(target) \
+		if((target) <= pInstr) \
+		{ \
+			pInstr = (target); \
+			hFrame->pInstruction = pInstr; \
+			hFrame->pNextInstruction = pInstr; \
+			HqGarbageCollector::PollSafepoint(gc); \
+			_HQ_DISPATCH_CHECK_SAMPLER(); \
+		} \
+		else \
+		{ \
+			pInstr = (target); \
+		} \
+		_HQ_DISPATCH_NEXT()
+
+	// The inline handlers only cover the common case for their opcode. Anything else, including every error,
+	// is handed to the opcode's out-of-line handler before the inline handler has modified anything.
+	#define _HQ_DISPATCH_LOAD_IMM(op_code, value_type, field) \
+		_inline_ ## op_code: \
+		{ \
+			HqRegister* const pDst = HqFrame::GetGpRegisterSlot(hFrame, pInstr->operands[0].index); \
+			if(!pDst) \
+			{ \
+				goto _call_ ## op_code; \
+			} \
+			HqRegister::Primitive value; \
+			value.field = pInstr->operands[1].field; \
+			HqRegister::SetPrimitive(*pDst, value_type, value); \
+			++pInstr; \
+			_HQ_DISPATCH_NEXT(); \
+		}
+
+	#define _HQ_DISPATCH_JUMP_IF(op_code, condition) \
+		_inline_ ## op_code: \
+		{ \
+			const HqRegister* const pRegister = HqFrame::GetGpRegisterSlot(hFrame, pInstr->operands[0].index); \
+			HqInstruction* const pTarget = pInstr->operands[2].pTarget; \
+			if(!pRegister || !pTarget) \
+			{ \
+				goto _call_ ## op_code; \
+			} \
+			const bool pass = (pRegister->type == HQ_VALUE_TYPE_BOOL) \
+				? pRegister->as.boolean \
+				: HqRegister::EvaluateAsBoolean(*pRegister); \
+			if(pass == condition) \
+			{ \
+				_HQ_DISPATCH_JUMP(pTarget); \
+			} \
+			++pInstr; \
+			_HQ_DISPATCH_NEXT(); \
+		}
+
+	#define _HQ_DISPATCH_ARITH(op_code, operation) \
+		_inline_ ## op_code: \
+			if(!ArithUtil::TryPrimitive<ArithUtil::operation>( \
+				hFrame, \
+				pInstr->operands[0].index, \
+				pInstr->operands[1].index, \
+				pInstr->operands[2].index)) \
+			{ \
+				goto _call_ ## op_code; \
+			} \
+			++pInstr; \
+			_HQ_DISPATCH_NEXT();
+
+	#define _HQ_DISPATCH_COMPARE(op_code, comparison) \
+		_inline_ ## op_code: \
+		{ \
+			HqRegister* const pDst = HqFrame::GetGpRegisterSlot(hFrame, pInstr->operands[0].index); \
+			bool cmpResult; \
+			if(!pDst \
+				|| !CmpUtil::TryCompare<CmpUtil::comparison>( \
+					hFrame, \
+					pInstr->operands[1].index, \
+					pInstr->operands[2].index, \
+					cmpResult)) \
+			{ \
+				goto _call_ ## op_code; \
+			} \
+			HqRegister::Primitive output; \
+			output.boolean = cmpResult; \
+			HqRegister::SetPrimitive(*pDst, HQ_VALUE_TYPE_BOOL, output); \
+			++pInstr; \
+			_HQ_DISPATCH_NEXT(); \
+		}
+
+	_HQ_DISPATCH_NEXT();
+
+	_HQ_DISPATCH_OP_CODE_LIST(_HQ_DISPATCH_CALL_STUB)
+
+_inline_LOAD_IMM_NULL:
+	{
+		HqRegister* const pDst = HqFrame::GetGpRegisterSlot(hFrame, pInstr->operands[0].index);
+		if(!pDst)
+		{
+			goto _call_LOAD_IMM_NULL;
+		}
+
+		HqRegister::Clear(*pDst);
+
+		++pInstr;
+		_HQ_DISPATCH_NEXT();
+	}
+
+	_HQ_DISPATCH_LOAD_IMM(LOAD_IMM_BOOL, HQ_VALUE_TYPE_BOOL,    boolean);
+	_HQ_DISPATCH_LOAD_IMM(LOAD_IMM_I8,   HQ_VALUE_TYPE_INT8,    int8);
+	_HQ_DISPATCH_LOAD_IMM(LOAD_IMM_I16,  HQ_VALUE_TYPE_INT16,   int16);
+	_HQ_DISPATCH_LOAD_IMM(LOAD_IMM_I32,  HQ_VALUE_TYPE_INT32,   int32);
+	_HQ_DISPATCH_LOAD_IMM(LOAD_IMM_I64,  HQ_VALUE_TYPE_INT64,   int64);
+	_HQ_DISPATCH_LOAD_IMM(LOAD_IMM_U8,   HQ_VALUE_TYPE_UINT8,   uint8);
+	_HQ_DISPATCH_LOAD_IMM(LOAD_IMM_U16,  HQ_VALUE_TYPE_UINT16,  uint16);
+	_HQ_DISPATCH_LOAD_IMM(LOAD_IMM_U32,  HQ_VALUE_TYPE_UINT32,  uint32);
+	_HQ_DISPATCH_LOAD_IMM(LOAD_IMM_U64,  HQ_VALUE_TYPE_UINT64,  uint64);
+	_HQ_DISPATCH_LOAD_IMM(LOAD_IMM_F32,  HQ_VALUE_TYPE_FLOAT32, float32);
+	_HQ_DISPATCH_LOAD_IMM(LOAD_IMM_F64,  HQ_VALUE_TYPE_FLOAT64, float64);
+
+_inline_JMP:
+	{
+		HqInstruction* const pTarget = pInstr->operands[1].pTarget;
+		if(!pTarget)
+		{
+			goto _call_JMP;
+		}
+
+		_HQ_DISPATCH_JUMP(pTarget);
+	}
+
+	_HQ_DISPATCH_JUMP_IF(JMP_TRUE,  true);
+	_HQ_DISPATCH_JUMP_IF(JMP_FALSE, false);
+
+	_HQ_DISPATCH_ARITH(ADD, AddOperation);
+	_HQ_DISPATCH_ARITH(SUB, SubOperation);
+	_HQ_DISPATCH_ARITH(MUL, MulOperation);
+	_HQ_DISPATCH_ARITH(DIV, DivOperation);
+	_HQ_DISPATCH_ARITH(MOD, ModOperation);
+
+	_HQ_DISPATCH_COMPARE(CMP_EQ, EqualComparison);
+	_HQ_DISPATCH_COMPARE(CMP_NE, NotEqualComparison);
+	_HQ_DISPATCH_COMPARE(CMP_GT, GreaterComparison);
+	_HQ_DISPATCH_COMPARE(CMP_GE, GreaterEqualComparison);
+	_HQ_DISPATCH_COMPARE(CMP_LT, LessComparison);
+	_HQ_DISPATCH_COMPARE(CMP_LE, LessEqualComparison);
+
+_inline_MOVE:
+	{
+		HqRegister* const pSource = HqFrame::GetGpRegisterSlot(hFrame, pInstr->operands[1].index);
+		HqRegister* const pDest = HqFrame::GetGpRegisterSlot(hFrame, pInstr->operands[0].index);
+
+		// Register errors are left to the out-of-line handler.
+		if(!pSource || !pDest)
+		{
+			goto _call_MOVE;
+		}
+
+		(*pDest) = (*pSource);
+
+		++pInstr;
+		_HQ_DISPATCH_NEXT();
+	}
+
+_op_invalid:
+	_HQ_DISPATCH_SYNC();
+	RaiseOpCodeException(hExec, HQ_STANDARD_EXCEPTION_RUNTIME_ERROR, "Invalid opcode: 0x%" PRIX32, opCode);
+	_HQ_DISPATCH_RESUME();
+
+	#undef _HQ_DISPATCH_COMPARE
+	#undef _HQ_DISPATCH_ARITH
+	#undef _HQ_DISPATCH_JUMP_IF
+	#undef _HQ_DISPATCH_LOAD_IMM
+	#undef _HQ_DISPATCH_JUMP
+	#undef _HQ_DISPATCH_CALL_STUB
+	#undef _HQ_DISPATCH_RESUME
+	#undef _HQ_DISPATCH_SYNC
+	#undef _HQ_DISPATCH_NEXT
+	#undef _HQ_DISPATCH_CHECK_SAMPLER
+
+_dispatch_end:
+	return;
+
+#else
+	while(!hExec->state.finished)
+	{
+		_runStep(hExec);
+	}
+
+#endif
+}
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqExecution::_runProfiledLoop(HqExecutionHandle hExec)
+{
+	assert(hExec != HQ_EXECUTION_HANDLE_NULL);
+	assert(hExec->pProfiler != nullptr);
+
+	// Profiling is chosen once per run of the loop rather than per instruction, so it costs the
+	// regular dispatch loop nothing. Each instruction is timed from the opcode's handler down, which
+	// includes any native function it calls. Time spent suspended by a yield is tracked separately
+	// by Pause() and excluded, so a YIELD is only charged for the work done up to the yield point.
+	while(!hExec->state.finished)
+	{
+		HqFrameHandle hFrame = hExec->hCurrentFrame;
+		HqFunctionHandle hFunction = hFrame->hFunction;
+
+		const uint32_t opCode = hFrame->pNextInstruction->opCode;
+		const uint64_t suspendedTime = hExec->profilerSuspendedTime;
+		const uint64_t startTime = HqClockGetTimestamp();
+
+		_runStep(hExec);
+
+		const uint64_t elapsedTime = HqClockGetTimestamp() - startTime;
+		const uint64_t stepSuspendedTime = hExec->profilerSuspendedTime - suspendedTime;
+
+		HqProfiler::Record(
+			hExec->pProfiler,
+			hFunction,
+			opCode,
+			(elapsedTime > stepSuspendedTime) ? (elapsedTime - stepSuspendedTime) : 0
+		);
+	}
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -575,6 +1177,10 @@ void HqExecution::_onGcDiscovery(HqGarbageCollector& gc, void* const pOpaque)
 	HqExecutionHandle hExec = reinterpret_cast<HqExecutionHandle>(pOpaque);
 	assert(hExec != HQ_EXECUTION_HANDLE_NULL);
 
+	// The frames can't be safely read while the execution may be running on another thread,
+	// so execution contexts are only ever discovered once scripts have been stopped.
+	assert(!gc.isConcurrentMark);
+
 	// Visit all active frames.
 	const size_t activeStackSize = HqFrame::HandleStack::GetCurrentSize(hExec->frameStack);
 	for(size_t frameIndex = 0; frameIndex < activeStackSize; ++frameIndex)
@@ -595,10 +1201,11 @@ void HqExecution::_onGcDiscovery(HqGarbageCollector& gc, void* const pOpaque)
 				}
 			}
 
-			// Discover values held in the general purpose registers.
-			for(size_t stackIndex = 0; stackIndex < hFrame->registers.count; ++stackIndex)
+			// Discover values held in the general purpose registers. Only registers below the high-water
+			// mark have been touched. Primitive values stored directly in registers have nothing to discover.
+			for(size_t stackIndex = 0; stackIndex < hFrame->gpRegisterHighWaterMark; ++stackIndex)
 			{
-				HqValueHandle hValue = hFrame->registers.pData[stackIndex];
+				HqValueHandle hValue = hFrame->registers.pData[stackIndex].hValue;
 
 				if(hValue)
 				{
@@ -607,7 +1214,7 @@ void HqExecution::_onGcDiscovery(HqGarbageCollector& gc, void* const pOpaque)
 			}
 
 			// Discover values held in the variable registers.
-			for(size_t stackIndex = 0; stackIndex < hFrame->variables.count; ++stackIndex)
+			for(size_t stackIndex = 0; stackIndex < hFrame->vrRegisterHighWaterMark; ++stackIndex)
 			{
 				HqValueHandle hValue = hFrame->variables.pData[stackIndex];
 
@@ -654,10 +1261,26 @@ void HqExecution::_onGcDestruct(void* pObject)
 		HqFrame::Dispose(hFrame);
 	}
 
+	// Give back any blocks the execution was still holding onto now that nothing else can be allocated from them.
+	HqSlabAllocator::FlushCache(&hExec->slabCache);
+
 	HqFrame::HandleStack::Dispose(hExec->frameStack);
 	HqFrame::HandleStack::Dispose(hExec->framePool);
+	HqFrameArena::Dispose(hExec->frameArena);
+	HqFrameArena::Dispose(hExec->registerArena);
 	HqValue::HandleArray::Dispose(hExec->registers);
 
+	if(hExec->pProfiler)
+	{
+		HqProfiler::Dispose(hExec->pProfiler);
+	}
+
+	if(hExec->hasMainFiber)
+	{
+		// Hand the fiber's stack back so it can be reused by the next execution context.
+		HqFiber::Dispose(hExec->mainFiber);
+	}
+
 	delete hExec;
 }
 
@@ -21,7 +21,9 @@
 //----------------------------------------------------------------------------------------------------------------------
 
 #include "Frame.hpp"
+#include "GarbageCollector.hpp"
 #include "GcProxy.hpp"
+#include "Profiler.hpp"
 #include "Value.hpp"
 
 #include "../base/Fiber.hpp"
@@ -42,8 +44,9 @@ struct HqExecution
 	static int Initialize(HqExecutionHandle hExec, HqFunctionHandle hEntryPoint);
 	static int Reset(HqExecutionHandle hExec);
 
-	static int PushFrame(HqExecutionHandle hExec, HqFunctionHandle hFunction);
+	static int PushFrame(HqExecutionHandle hExec, HqFunctionHandle hFunction, uint32_t windowBase);
 	static int PopFrame(HqExecutionHandle hExec);
+	static int ReplaceFrame(HqExecutionHandle hExec, HqFunctionHandle hFunction);
 
 	static int SetIoRegister(HqExecutionHandle hExec, HqValueHandle hValue, const size_t index);
 
@@ -55,9 +58,13 @@ struct HqExecution
 	static void RaiseException(HqExecutionHandle hExec, HqValueHandle hValue, const int severity);
 	static void RaiseOpCodeException(HqExecutionHandle hExec, const int type, const char* const fmt, ...);
 
-	static void _createMainFiber(HqExecutionHandle);
+	static void _copyIoRegistersToFrame(HqExecutionHandle, HqFrameHandle, uint32_t, size_t);
+	static void _copyFrameToIoRegisters(HqExecutionHandle, HqFrameHandle, uint32_t, size_t);
+	static int _createMainFiber(HqExecutionHandle);
 	static void _runFiberLoop(void*);
 	static void _runStep(HqExecutionHandle);
+	static void _runDispatchLoop(HqExecutionHandle);
+	static void _runProfiledLoop(HqExecutionHandle);
 	static void _onGcDiscovery(HqGarbageCollector&, void*);
 	static void _onGcDestruct(void*);
 
@@ -73,10 +80,22 @@ struct HqExecution
 	HqFrame::HandleStack frameStack;
 	HqFrame::HandleStack framePool;
 
+	HqFrameArena frameArena;
+	HqFrameArena registerArena;
+
 	HqValue::HandleArray registers;
 
 	HqFiber mainFiber;
 
+	HqGcNursery nursery;
+	HqSlabCache slabCache;
+
+	HqProfiler* pProfiler;
+
+	// Total time the execution context has spent suspended while profiling, so it can be excluded from the
+	// instruction that suspended it.
+	uint64_t profilerSuspendedTime;
+
 	uint8_t* pExceptionLocation;
 
 	uint32_t lastOpCode;
@@ -100,6 +119,15 @@ struct HqExecution
 
 	bool firstRun;
 	bool frameStackDirty;
+	bool isProfiling;
+
+	// Set while the calling thread is inside Run(). Unlike the fiber's own state, this can be read from other
+	// threads (such as the sample profiler) without racing the fiber being re-created by Reset().
+	volatile bool isRunning;
+
+	// The main fiber can fail to be re-created when the execution context is reset, in which case the execution
+	// context is left aborted and without a fiber until the next reset succeeds.
+	bool hasMainFiber;
 
 	bool created;
 };
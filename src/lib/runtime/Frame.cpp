@@ -21,53 +21,136 @@
 #include "Vm.hpp"
 
 #include "../base/Mutex.hpp"
+#include "../base/SlabAllocator.hpp"
 
 #include <assert.h>
 #include <string.h>
 
 //----------------------------------------------------------------------------------------------------------------------
 
+void HqFrameArena::Initialize(HqFrameArena& output)
+{
+	output.pMemory = nullptr;
+	output.capacity = 0;
+	output.usedSize = 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqFrameArena::Dispose(HqFrameArena& arena)
+{
+	if(arena.pMemory)
+	{
+		HqMemFree(arena.pMemory);
+	}
+
+	Initialize(arena);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 HqFrame* HqFrame::Create(HqExecutionHandle hExec)
 {
 	assert(hExec != HQ_EXECUTION_HANDLE_NULL);
 
-	HqFrame* const pOutput = new HqFrame();
+	HqFrame* const pOutput = new(hExec->slabCache.pAllocator) HqFrame();
 	assert(pOutput != nullptr);
 
 	pOutput->hExec = hExec;
-
-	// Initialize the value stack and registers.
-	HqValue::HandleStack::Initialize(pOutput->stack, HQ_VM_FRAME_STACK_SIZE);
-	HqValue::HandleArray::Initialize(pOutput->registers);
+	pOutput->hFunction = HQ_FUNCTION_HANDLE_NULL;
+	pOutput->pInstruction = nullptr;
+	pOutput->pNextInstruction = nullptr;
+	pOutput->arenaOffset = 0;
+	pOutput->arenaSize = 0;
+	pOutput->registerOffset = 0;
+	pOutput->registerArenaRestoreSize = 0;
+	pOutput->windowBase = HQ_FRAME_NO_WINDOW;
+	pOutput->gpRegisterHighWaterMark = 0;
+	pOutput->vrRegisterHighWaterMark = 0;
+
+	// The value stack and registers have no memory until the frame is initialized with a function.
+	HqValue::HandleStack::Initialize(pOutput->stack, 0);
+	HqRegister::Array::Initialize(pOutput->registers);
 	HqValue::HandleArray::Initialize(pOutput->variables);
 
-	// Reserve enough space for all the registers.
-	HqValue::HandleArray::Reserve(pOutput->registers, HQ_VM_GP_REGISTER_COUNT);
-	HqValue::HandleArray::Reserve(pOutput->variables, HQ_VM_VR_REGISTER_COUNT);
-
-	pOutput->stack.nextIndex = 0;
-	pOutput->registers.count = HQ_VM_GP_REGISTER_COUNT;
-
-	// Reset the state of the value stack and registers.
-	Reset(pOutput);
-
 	return pOutput;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
-void HqFrame::Initialize(HqFrameHandle hFrame, HqFunctionHandle hFunction)
+int HqFrame::Initialize(HqFrameHandle hFrame, HqFunctionHandle hFunction, const uint32_t windowBase)
 {
 	assert(hFrame != HQ_FRAME_HANDLE_NULL);
 	assert(hFunction != HQ_FUNCTION_HANDLE_NULL);
 
+	HqExecutionHandle hExec = hFrame->hExec;
+	HqFrameHandle hCaller = hExec->hCurrentFrame;
+
+	HqFrameArena& arena = hExec->frameArena;
+	HqFrameArena& registerArena = hExec->registerArena;
+
+	const HqFunction::FrameSize& frameSize = hFunction->frameSize;
+	const size_t arenaSize = sizeof(HqValueHandle) * (size_t(frameSize.vrRegisterCount) + size_t(frameSize.stackSize));
+
+	// A register window function called through a window starts its registers at the caller's window
+	// base register, so the arguments the caller placed there become its leading registers.
+	const bool sharesWindow = (windowBase != HQ_FRAME_NO_WINDOW) && hCaller && hFunction->usesRegisterWindow;
+	assert(!sharesWindow || windowBase < hCaller->registers.count);
+
+	const size_t registerOffset = sharesWindow
+		? hCaller->registerOffset + (sizeof(HqRegister) * windowBase)
+		: registerArena.usedSize;
+	const size_t registerEnd = registerOffset + (sizeof(HqRegister) * frameSize.gpRegisterCount);
+
+	if(arena.usedSize + arenaSize > arena.capacity && !_growArena(hExec, arena, arena.usedSize + arenaSize))
+	{
+		return HQ_ERROR_BAD_ALLOCATION;
+	}
+
+	if(registerEnd > registerArena.capacity && !_growArena(hExec, registerArena, registerEnd))
+	{
+		return HQ_ERROR_BAD_ALLOCATION;
+	}
+
 	hFrame->hFunction = hFunction;
+	hFrame->arenaOffset = arena.usedSize;
+	hFrame->arenaSize = arenaSize;
+	hFrame->registerOffset = registerOffset;
+	hFrame->registerArenaRestoreSize = registerArena.usedSize;
+	hFrame->windowBase = windowBase;
+	hFrame->registers.count = frameSize.gpRegisterCount;
+	hFrame->variables.count = frameSize.vrRegisterCount;
+	hFrame->stack.memory.count = frameSize.stackSize;
+	hFrame->stack.nextIndex = 0;
+
+	arena.usedSize += arenaSize;
+	registerArena.usedSize = (registerEnd > registerArena.usedSize) ? registerEnd : registerArena.usedSize;
+
+	_bindArenaMemory(hFrame, registerArena.pMemory, arena.pMemory);
+
+	// The frame's memory may still hold values from a previous frame, but none of it is cleared up front.
+	// Registers are cleared as they're first touched, and the value stack is only ever read below its top.
+	// Registers shared with the caller were already cleared by the caller up to its own high-water mark.
+	hFrame->gpRegisterHighWaterMark = 0;
+	hFrame->vrRegisterHighWaterMark = 0;
+
+	if(sharesWindow && hCaller->gpRegisterHighWaterMark > windowBase)
+	{
+		const uint32_t sharedCount = hCaller->gpRegisterHighWaterMark - windowBase;
+
+		hFrame->gpRegisterHighWaterMark = (sharedCount < hFrame->registers.count)
+			? sharedCount
+			: uint32_t(hFrame->registers.count);
+	}
 
 	// Native functions are effectively represented as dummy frames, so they need no other initialization.
 	if(hFunction->type != HqFunction::Type::Native)
 	{
-		HqDecoder::Initialize(hFrame->decoder, hFunction->hModule->code.pData, hFunction->bytecodeOffsetStart);
+		hFrame->pInstruction = hFunction->instructions.pData;
+		hFrame->pNextInstruction = hFunction->instructions.pData;
 	}
+
+	return HQ_SUCCESS;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -76,12 +159,8 @@ void HqFrame::Dispose(HqFrameHandle hFrame)
 {
 	assert(hFrame != HQ_FRAME_HANDLE_NULL);
 
-	// Dispose of the value stack and registers.
-	HqValue::HandleStack::Dispose(hFrame->stack);
-	HqValue::HandleArray::Dispose(hFrame->registers);
-	HqValue::HandleArray::Dispose(hFrame->variables);
-
-	delete hFrame;
+	// The value stack and registers are owned by the frame arena, so there's nothing else to free.
+	HqFrame::operator delete(hFrame, hFrame->hExec->slabCache.pAllocator);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -90,14 +169,31 @@ void HqFrame::Reset(HqFrameHandle hFrame)
 {
 	assert(hFrame != HQ_FRAME_HANDLE_NULL);
 
-	hFrame->hFunction = HQ_FUNCTION_HANDLE_NULL;
+	HqFrameArena& arena = hFrame->hExec->frameArena;
+	HqFrameArena& registerArena = hFrame->hExec->registerArena;
+
+	// Frames are only ever reset in the reverse order they were initialized.
+	assert(hFrame->arenaOffset + hFrame->arenaSize == arena.usedSize);
+	assert(hFrame->registerArenaRestoreSize <= registerArena.usedSize);
 
-	// Clear the stack and registers to prevent the garbage collector from
-	// attempting to collect non-null values that happen to be garbage memory
-	// or old values from a previous frame.
-	memset(hFrame->stack.memory.pData, 0, sizeof(HqValueHandle) * HQ_VM_VALUE_STACK_SIZE);
-	memset(hFrame->registers.pData, 0, sizeof(HqValueHandle) * HQ_VM_GP_REGISTER_COUNT);
-	memset(hFrame->variables.pData, 0, sizeof(HqValueHandle) * HQ_VM_VR_REGISTER_COUNT);
+	// Give the frame's memory back to the arenas.
+	arena.usedSize = hFrame->arenaOffset;
+	registerArena.usedSize = hFrame->registerArenaRestoreSize;
+
+	hFrame->hFunction = HQ_FUNCTION_HANDLE_NULL;
+	hFrame->arenaOffset = 0;
+	hFrame->arenaSize = 0;
+	hFrame->registerOffset = 0;
+	hFrame->registerArenaRestoreSize = 0;
+	hFrame->windowBase = HQ_FRAME_NO_WINDOW;
+	hFrame->gpRegisterHighWaterMark = 0;
+	hFrame->vrRegisterHighWaterMark = 0;
+	hFrame->registers.count = 0;
+	hFrame->variables.count = 0;
+	hFrame->stack.memory.count = 0;
+	hFrame->stack.nextIndex = 0;
+
+	_bindArenaMemory(hFrame, nullptr, nullptr);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -153,9 +249,37 @@ int HqFrame::PeekValue(
 int HqFrame::SetGpRegister(HqFrameHandle hFrame, HqValueHandle hValue, const uint32_t index)
 {
 	assert(hFrame != HQ_FRAME_HANDLE_NULL);
-	assert(index < HQ_VM_GP_REGISTER_COUNT);
 
-	hFrame->registers.pData[index] = hValue;
+	HqRegister* const pRegister = GetGpRegisterSlot(hFrame, index);
+	if(!pRegister)
+	{
+		return HQ_ERROR_INDEX_OUT_OF_RANGE;
+	}
+
+	HqRegister::SetValue(*pRegister, hValue);
+
+	return HQ_SUCCESS;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int HqFrame::SetGpRegisterPrimitive(
+	HqFrameHandle hFrame,
+	const int type,
+	const HqRegister::Primitive& value,
+	const uint32_t index
+)
+{
+	assert(hFrame != HQ_FRAME_HANDLE_NULL);
+	assert(type >= 0 && type <= HQ_VALUE_TYPE_BOOL);
+
+	HqRegister* const pRegister = GetGpRegisterSlot(hFrame, index);
+	if(!pRegister)
+	{
+		return HQ_ERROR_INDEX_OUT_OF_RANGE;
+	}
+
+	HqRegister::SetPrimitive(*pRegister, type, value);
 
 	return HQ_SUCCESS;
 }
@@ -165,7 +289,16 @@ int HqFrame::SetGpRegister(HqFrameHandle hFrame, HqValueHandle hValue, const uin
 int HqFrame::SetVrRegister(HqFrameHandle hFrame, HqValueHandle hValue, const uint32_t index)
 {
 	assert(hFrame != HQ_FRAME_HANDLE_NULL);
-	assert(index < HQ_VM_VR_REGISTER_COUNT);
+
+	if(index >= hFrame->variables.count)
+	{
+		return HQ_ERROR_INDEX_OUT_OF_RANGE;
+	}
+
+	if(index >= hFrame->vrRegisterHighWaterMark)
+	{
+		_raiseVrHighWaterMark(hFrame, index);
+	}
 
 	hFrame->variables.pData[index] = hValue;
 
@@ -179,14 +312,16 @@ HqValueHandle HqFrame::GetGpRegister(HqFrameHandle hFrame, const uint32_t index,
 	assert(hFrame != HQ_FRAME_HANDLE_NULL);
 	assert(pOutResult != nullptr);
 
-	if(index >= HQ_VM_GP_REGISTER_COUNT)
+	HqRegister* const pRegister = GetGpRegisterSlot(hFrame, index);
+	if(!pRegister)
 	{
 		(*pOutResult) = HQ_ERROR_INDEX_OUT_OF_RANGE;
 		return HQ_VALUE_HANDLE_NULL;
 	}
 
+	// Primitive values held directly in the register will be boxed on demand.
 	(*pOutResult) = HQ_SUCCESS;
-	return hFrame->registers.pData[index];
+	return HqRegister::GetValue(*pRegister, hFrame->hExec->hVm);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -196,28 +331,143 @@ HqValueHandle HqFrame::GetVrRegister(HqFrameHandle hFrame, const uint32_t index,
 	assert(hFrame != HQ_FRAME_HANDLE_NULL);
 	assert(pOutResult != nullptr);
 
-	if(index >= HQ_VM_VR_REGISTER_COUNT)
+	if(index >= hFrame->variables.count)
 	{
 		(*pOutResult) = HQ_ERROR_INDEX_OUT_OF_RANGE;
 		return HQ_VALUE_HANDLE_NULL;
 	}
 
+	if(index >= hFrame->vrRegisterHighWaterMark)
+	{
+		_raiseVrHighWaterMark(hFrame, index);
+	}
+
 	(*pOutResult) = HQ_SUCCESS;
 	return hFrame->variables.pData[index];
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
-void* HqFrame::operator new(const size_t sizeInBytes)
+void HqFrame::_raiseGpHighWaterMark(HqFrameHandle hFrame, const uint32_t index)
+{
+	assert(index < hFrame->registers.count);
+
+	// Clear every register up to and including the one being touched so the
+	// GC never sees stale values left behind in the arena by an older frame.
+	for(uint32_t regIndex = hFrame->gpRegisterHighWaterMark; regIndex <= index; ++regIndex)
+	{
+		HqRegister::Clear(hFrame->registers.pData[regIndex]);
+	}
+
+	hFrame->gpRegisterHighWaterMark = index + 1;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqFrame::_adoptWindowRegisters(HqFrameHandle hFrame, const uint32_t windowBase, const uint32_t count)
+{
+	assert(windowBase < hFrame->registers.count);
+
+	// The registers in the window were written or cleared by the callee that shared them, so they need to
+	// be kept as-is. Only the registers between the current mark and the start of the window still need
+	// to be cleared before the mark can be moved past the window.
+	const uint32_t windowEnd = (count < hFrame->registers.count - windowBase)
+		? windowBase + count
+		: uint32_t(hFrame->registers.count);
+
+	if(windowEnd <= hFrame->gpRegisterHighWaterMark)
+	{
+		return;
+	}
+
+	for(uint32_t regIndex = hFrame->gpRegisterHighWaterMark; regIndex < windowBase; ++regIndex)
+	{
+		HqRegister::Clear(hFrame->registers.pData[regIndex]);
+	}
+
+	hFrame->gpRegisterHighWaterMark = windowEnd;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqFrame::_raiseVrHighWaterMark(HqFrameHandle hFrame, const uint32_t index)
+{
+	assert(index < hFrame->variables.count);
+
+	const uint32_t startIndex = hFrame->vrRegisterHighWaterMark;
+
+	memset(hFrame->variables.pData + startIndex, 0, sizeof(HqValueHandle) * (index + 1 - startIndex));
+
+	hFrame->vrRegisterHighWaterMark = index + 1;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqFrame::_bindArenaMemory(HqFrameHandle hFrame, uint8_t* const pRegisterMemory, uint8_t* const pArenaMemory)
+{
+	hFrame->registers.pData = pRegisterMemory
+		? reinterpret_cast<HqRegister*>(pRegisterMemory + hFrame->registerOffset)
+		: nullptr;
+
+	if(!pArenaMemory)
+	{
+		hFrame->variables.pData = nullptr;
+		hFrame->stack.memory.pData = nullptr;
+	}
+	else
+	{
+		// Frame memory layout: [ variable registers | value stack ]
+		hFrame->variables.pData = reinterpret_cast<HqValueHandle*>(pArenaMemory + hFrame->arenaOffset);
+		hFrame->stack.memory.pData = hFrame->variables.pData + hFrame->variables.count;
+	}
+
+	// The capacities match the counts so nothing mistakes this memory as resizable.
+	hFrame->registers.capacity = hFrame->registers.count;
+	hFrame->variables.capacity = hFrame->variables.count;
+	hFrame->stack.memory.capacity = hFrame->stack.memory.count;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+bool HqFrame::_growArena(HqExecutionHandle hExec, HqFrameArena& arena, const size_t minCapacity)
+{
+	size_t newCapacity = (arena.capacity > 0) ? arena.capacity : 4096;
+	while(newCapacity < minCapacity)
+	{
+		newCapacity *= 2;
+	}
+
+	uint8_t* const pNewMemory = reinterpret_cast<uint8_t*>(HqMemRealloc(arena.pMemory, newCapacity));
+	if(!pNewMemory)
+	{
+		return false;
+	}
+
+	arena.pMemory = pNewMemory;
+	arena.capacity = newCapacity;
+
+	// The arena may have moved, so every active frame needs to be pointed at the new memory.
+	const size_t activeStackSize = HandleStack::GetCurrentSize(hExec->frameStack);
+	for(size_t frameIndex = 0; frameIndex < activeStackSize; ++frameIndex)
+	{
+		_bindArenaMemory(hExec->frameStack.memory.pData[frameIndex], hExec->registerArena.pMemory, hExec->frameArena.pMemory);
+	}
+
+	return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void* HqFrame::operator new(const size_t sizeInBytes, HqSlabAllocator* const pAllocator)
 {
-	return HqMemAlloc(sizeInBytes);
+	return HqSlabAllocator::Alloc(pAllocator, sizeInBytes);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
-void HqFrame::operator delete(void* const pObject)
+void HqFrame::operator delete(void* const pObject, HqSlabAllocator* const pAllocator)
 {
-	HqMemFree(pObject);
+	HqSlabAllocator::Free(pAllocator, pObject, sizeof(HqFrame));
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -20,8 +20,9 @@
 
 //----------------------------------------------------------------------------------------------------------------------
 
-#include "Decoder.hpp"
 #include "Function.hpp"
+#include "Instruction.hpp"
+#include "Register.hpp"
 #include "Value.hpp"
 
 #include "../common/Array.hpp"
@@ -29,6 +30,26 @@
 
 //----------------------------------------------------------------------------------------------------------------------
 
+#define HQ_FRAME_NO_WINDOW UINT32_MAX
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// Contiguous block of memory that all of an execution context's active frames carve their registers and value
+// stack out of. Frames are always pushed and popped in order, so the arena is managed like a stack. Each execution
+// context has one arena for general-purpose registers and another for variable registers and value stacks.
+struct HqFrameArena
+{
+	static void Initialize(HqFrameArena& output);
+	static void Dispose(HqFrameArena& arena);
+
+	uint8_t* pMemory;
+
+	size_t capacity;
+	size_t usedSize;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
 struct HqFrame
 {
 	typedef HqArray<HqFrameHandle> HandleArray;
@@ -36,7 +57,7 @@ struct HqFrame
 
 	static HqFrameHandle Create(HqExecutionHandle hExec);
 
-	static void Initialize(HqFrameHandle hFrame, HqFunctionHandle hFunction);
+	static int Initialize(HqFrameHandle hFrame, HqFunctionHandle hFunction, uint32_t windowBase);
 	static void Dispose(HqFrameHandle hFrame);
 	static void Reset(HqFrameHandle hFrame);
 
@@ -45,22 +66,66 @@ struct HqFrame
 	static int PeekValue(HqFrameHandle hFrame, HqValueHandle* const phOutValue, const size_t index);
 
 	static int SetGpRegister(HqFrameHandle hFrame, HqValueHandle hValue, const uint32_t index);
+	static int SetGpRegisterPrimitive(HqFrameHandle hFrame, const int type, const HqRegister::Primitive& value, const uint32_t index);
 	static int SetVrRegister(HqFrameHandle hFrame, HqValueHandle hValue, const uint32_t index);
 
 	static HqValueHandle GetGpRegister(HqFrameHandle hFrame, const uint32_t index, int* const pOutResult);
 	static HqValueHandle GetVrRegister(HqFrameHandle hFrame, const uint32_t index, int* const pOutResult);
 
-	void* operator new(const size_t sizeInBytes);
-	void operator delete(void* const pObject);
+	static HqRegister* GetGpRegisterSlot(HqFrameHandle hFrame, const uint32_t index);
 
+	static void _raiseGpHighWaterMark(HqFrameHandle, uint32_t);
+	static void _raiseVrHighWaterMark(HqFrameHandle, uint32_t);
+	static void _adoptWindowRegisters(HqFrameHandle, uint32_t, uint32_t);
+	static void _bindArenaMemory(HqFrameHandle, uint8_t*, uint8_t*);
+	static bool _growArena(HqExecutionHandle, HqFrameArena&, size_t);
+
+	void* operator new(const size_t sizeInBytes, HqSlabAllocator* const pAllocator);
+	void operator delete(void* const pObject, HqSlabAllocator* const pAllocator);
+
+	// These all point into the execution context's frame arenas rather than owning their memory.
 	HqValue::HandleStack stack;
-	HqValue::HandleArray registers;
+	HqRegister::Array registers;
 	HqValue::HandleArray variables;
 
 	HqExecutionHandle hExec;
 	HqFunctionHandle hFunction;
 
-	HqDecoder decoder;
+	HqInstruction* pInstruction;
+	HqInstruction* pNextInstruction;
+
+	size_t arenaOffset;
+	size_t arenaSize;
+
+	// The GP registers live in their own arena so a register window callee can overlap its caller's registers.
+	size_t registerOffset;
+	size_t registerArenaRestoreSize;
+
+	// Caller register that this frame's parameters and return values are exchanged through when
+	// it was entered with CALL_WINDOW. Otherwise, this is HQ_FRAME_NO_WINDOW.
+	uint32_t windowBase;
+
+	// Number of leading registers that have been cleared since the frame was initialized. Registers are cleared
+	// when they're first touched, so nothing at or above these marks needs to be cleared or scanned by the GC.
+	uint32_t gpRegisterHighWaterMark;
+	uint32_t vrRegisterHighWaterMark;
 };
 
 //----------------------------------------------------------------------------------------------------------------------
+
+inline HqRegister* HqFrame::GetGpRegisterSlot(HqFrameHandle hFrame, const uint32_t index)
+{
+	if(index >= hFrame->registers.count)
+	{
+		return nullptr;
+	}
+
+	if(index >= hFrame->gpRegisterHighWaterMark)
+	{
+		_raiseGpHighWaterMark(hFrame, index);
+	}
+
+	return &hFrame->registers.pData[index];
+}
+
+//----------------------------------------------------------------------------------------------------------------------
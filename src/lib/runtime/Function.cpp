@@ -22,6 +22,8 @@
 #include <assert.h>
 #include <stdio.h>
 
+#include <algorithm>
+
 //----------------------------------------------------------------------------------------------------------------------
 
 HqFunctionHandle HqFunction::CreateInit(
@@ -45,8 +47,14 @@ HqFunctionHandle HqFunction::CreateInit(
 	pOutput->bytecodeOffsetEnd = bytecodeOffset + bytecodeLength;
 	pOutput->numParameters = 0;
 	pOutput->numReturnValues = 0;
+	pOutput->usesRegisterWindow = false;
 	pOutput->type = Type::Init;
 
+	// The module format doesn't describe the init function's frame, so it gets the largest one possible.
+	pOutput->frameSize.gpRegisterCount = HQ_VM_GP_REGISTER_COUNT;
+	pOutput->frameSize.vrRegisterCount = HQ_VM_VR_REGISTER_COUNT;
+	pOutput->frameSize.stackSize = HQ_VM_VALUE_STACK_SIZE;
+
 	return pOutput;
 }
 
@@ -55,11 +63,12 @@ HqFunctionHandle HqFunction::CreateInit(
 HqFunctionHandle HqFunction::CreateScript(
 	HqModuleHandle hModule,
 	HqString* const pSignature,
-	HqGuardedBlock::PtrArray& guardedBlocks,
+	HqExceptionTable& exceptionTable,
 	const uint32_t bytecodeOffset,
 	const uint32_t bytecodeLength,
 	const uint16_t numParameters,
-	const uint16_t numReturnValues
+	const uint16_t numReturnValues,
+	const FrameSize& frameSize
 )
 {
 	assert(hModule != HQ_MODULE_HANDLE_NULL);
@@ -74,10 +83,12 @@ HqFunctionHandle HqFunction::CreateScript(
 	pOutput->bytecodeOffsetEnd = bytecodeOffset + bytecodeLength;
 	pOutput->numParameters = numParameters;
 	pOutput->numReturnValues = numReturnValues;
+	pOutput->usesRegisterWindow = false;
+	pOutput->frameSize = frameSize;
 	pOutput->type = Type::Normal;
 
-	// Take ownership of the guarded block array.
-	HqGuardedBlock::PtrArray::Move(pOutput->guardedBlocks, guardedBlocks);
+	// Take ownership of the exception table.
+	HqExceptionTable::Move(pOutput->exceptionTable, exceptionTable);
 
 	// Add a reference to the function signature string.
 	HqString::AddRef(pOutput->pSignature);
@@ -108,6 +119,8 @@ HqFunctionHandle HqFunction::CreateNative(
 	pOutput->nativeFn = nullptr; // The callback will be provided externally.
 	pOutput->numParameters = numParameters;
 	pOutput->numReturnValues = numReturnValues;
+	pOutput->usesRegisterWindow = false;
+	pOutput->frameSize = {};
 	pOutput->type = Type::Native;
 
 	HqString::AddRef(pOutput->pSignature);
@@ -138,6 +151,8 @@ HqFunctionHandle HqFunction::CreateBuiltIn(
 	pOutput->nativeFn = nativeFn;
 	pOutput->numParameters = numParameters;
 	pOutput->numReturnValues = numReturnValues;
+	pOutput->usesRegisterWindow = false;
+	pOutput->frameSize = {};
 	pOutput->type = Type::Native;
 
 	HqString::AddRef(pOutput->pSignature);
@@ -151,13 +166,8 @@ void HqFunction::Dispose(HqFunctionHandle hFunction)
 {
 	assert(hFunction != HQ_FUNCTION_HANDLE_NULL);
 
-	// Release each guarded block.
-	for(size_t blockIndex = 0; blockIndex < hFunction->guardedBlocks.count; ++blockIndex)
-	{
-		HqGuardedBlock::Dispose(hFunction->guardedBlocks.pData[blockIndex]);
-	}
-
-	HqGuardedBlock::PtrArray::Dispose(hFunction->guardedBlocks);
+	HqExceptionTable::Dispose(hFunction->exceptionTable);
+	HqInstruction::Array::Dispose(hFunction->instructions);
 	HqString::Release(hFunction->pSignature);
 
 	delete hFunction;
@@ -176,6 +186,31 @@ HqVmHandle HqFunction::GetVm(HqFunctionHandle hFunction)
 
 //----------------------------------------------------------------------------------------------------------------------
 
+HqInstruction* HqFunction::FindInstruction(HqFunctionHandle hFunction, const uint32_t bytecodeOffset)
+{
+	assert(hFunction != HQ_FUNCTION_HANDLE_NULL);
+
+	// Decoded instructions are stored in bytecode order, so we can binary search them by their offsets.
+	HqInstruction* const pBegin = hFunction->instructions.pData;
+	HqInstruction* const pEnd = pBegin + hFunction->instructions.count;
+
+	HqInstruction* const pInstr = std::lower_bound(
+		pBegin,
+		pEnd,
+		bytecodeOffset,
+		[](const HqInstruction& instr, const uint32_t offset) { return instr.offset < offset; }
+	);
+
+	if(pInstr == pEnd || pInstr->offset != bytecodeOffset)
+	{
+		return nullptr;
+	}
+
+	return pInstr;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 void* HqFunction::operator new(const size_t sizeInBytes)
 {
 	return HqMemAlloc(sizeInBytes);
@@ -20,7 +20,8 @@
 
 //----------------------------------------------------------------------------------------------------------------------
 
-#include "GuardedBlock.hpp"
+#include "ExceptionTable.hpp"
+#include "Instruction.hpp"
 #include "Value.hpp"
 
 #include "../base/String.hpp"
@@ -50,6 +51,14 @@ struct HqFunction
 
 	typedef HqStack<HqFunctionHandle> HandleStack;
 
+	// Number of each kind of slot a frame needs to run the function.
+	struct FrameSize
+	{
+		uint16_t gpRegisterCount;
+		uint16_t vrRegisterCount;
+		uint16_t stackSize;
+	};
+
 	static HqFunctionHandle CreateInit(
 		HqModuleHandle hModule,
 		uint32_t bytecodeOffset,
@@ -58,11 +67,12 @@ struct HqFunction
 	static HqFunctionHandle CreateScript(
 		HqModuleHandle hModule,
 		HqString* pSignature,
-		HqGuardedBlock::PtrArray& guardedBlocks,
+		HqExceptionTable& exceptionTable,
 		uint32_t bytecodeOffset,
 		uint32_t bytecodeLength,
 		uint16_t numParameters,
-		uint16_t numReturnValues
+		uint16_t numReturnValues,
+		const FrameSize& frameSize
 	);
 	static HqFunctionHandle CreateNative(
 		HqModuleHandle hModule,
@@ -80,6 +90,8 @@ struct HqFunction
 
 	static HqVmHandle GetVm(HqFunctionHandle hFunction);
 
+	static HqInstruction* FindInstruction(HqFunctionHandle hFunction, uint32_t bytecodeOffset);
+
 	void* operator new(const size_t sizeInBytes);
 	void operator delete(void* const pObject);
 
@@ -89,7 +101,10 @@ struct HqFunction
 	HqString* pSignature;
 	void* pNativeUserData;
 
-	HqGuardedBlock::PtrArray guardedBlocks;
+	HqExceptionTable exceptionTable;
+	HqInstruction::Array instructions;
+
+	FrameSize frameSize;
 
 	uint32_t bytecodeOffsetStart;
 	uint32_t bytecodeOffsetEnd;
@@ -98,6 +113,10 @@ struct HqFunction
 	uint16_t numReturnValues;
 
 	Type type;
+
+	// Parameters and return values are passed in the function's leading general-purpose registers
+	// rather than through the I/O registers.
+	bool usesRegisterWindow;
 };
 
 
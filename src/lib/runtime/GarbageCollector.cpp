@@ -17,18 +17,32 @@
 //
 
 #include "GarbageCollector.hpp"
+#include "Execution.hpp"
 #include "GcProxy.hpp"
 #include "Value.hpp"
 #include "Vm.hpp"
 
 #include "../base/Clock.hpp"
+#include "../base/Thread.hpp"
+
+#include "../common/Atomic.hpp"
 
 #include <assert.h>
+#include <string.h>
 
 //----------------------------------------------------------------------------------------------------------------------
 
 #define _HQ_GC_TIME_CHECK_INTERVAL 10
 
+// Number of young generation collections to run between each collection of the full heap.
+#define _HQ_GC_MINOR_CYCLES_PER_MAJOR 8
+
+// Number of objects a nursery can hold before they're handed off to the collector.
+#define _HQ_GC_NURSERY_FLUSH_COUNT 256
+
+// Upper limit on how much the time slice of a single step can be stretched when the collector is falling behind.
+#define _HQ_GC_MAX_TIME_SLICE_SCALE 4
+
 //----------------------------------------------------------------------------------------------------------------------
 
 enum HqGcPhase
@@ -36,14 +50,19 @@ enum HqGcPhase
 	_HQ_GC_PHASE_LINK_PENDING,
 	_HQ_GC_PHASE_AUTO_MARK,
 	_HQ_GC_PHASE_GLOBAL_MARK,
+	_HQ_GC_PHASE_REMEMBERED_MARK,
 	_HQ_GC_PHASE_DISCOVERY,
+	_HQ_GC_PHASE_REMARK,
 	_HQ_GC_PHASE_DISPOSE,
+	_HQ_GC_PHASE_PROMOTE,
 
 	_HQ_GC_PHASE__COUNT,
 	_HQ_GC_PHASE__START = _HQ_GC_PHASE_LINK_PENDING,
-	_HQ_GC_PHASE__END = _HQ_GC_PHASE_DISPOSE,
+	_HQ_GC_PHASE__END = _HQ_GC_PHASE_PROMOTE,
 };
 
+static_assert(int(_HQ_GC_PHASE__COUNT) == int(HQ_GC_PHASE__COUNT), "GC phases are out of sync with the public API");
+
 enum HqGcRunResult
 {
 	_HQ_GC_RUN_MORE_WORK,
@@ -53,23 +72,64 @@ enum HqGcRunResult
 
 //----------------------------------------------------------------------------------------------------------------------
 
-void HqGarbageCollector::Initialize(HqGarbageCollector& output, HqVmHandle hVm, const uint32_t maxTimeSliceMs)
+// Nursery that new objects on the current thread are linked into. This is only ever set while a script is running
+// on this thread, so objects created by the script can skip the shared pending list lock until the next handoff.
+static thread_local HqGcNursery* _activeNursery = nullptr;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqGcNursery::Initialize(HqGcNursery& output, HqGarbageCollector& gc)
+{
+	output.pGc = &gc;
+	output.pHead = nullptr;
+	output.pTail = nullptr;
+	output.allocatedSize = 0;
+	output.allocatedObjectCount = 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqGarbageCollector::Initialize(
+	HqGarbageCollector& output,
+	HqVmHandle hVm,
+	const uint32_t maxTimeSliceMs,
+	const uint32_t markThreadCount,
+	const uint32_t markThreadStackSize,
+	const uint32_t heapGrowthPercent,
+	const uint32_t minTriggerHeapSize
+)
 {
 	assert(hVm != HQ_VM_HANDLE_NULL);
 	assert(maxTimeSliceMs > 0);
 
 	HqRwLock::Create(output.rwLock);
 	HqMutex::Create(output.pendingLock);
+	HqMutex::Create(output.collectLock);
 
 	output.hVm = hVm;
+	output.safepointRequests = 0;
 	output.pPendingHead = nullptr;
 	output.pUnmarkedHead = nullptr;
 	output.pMarkedLeafHead = nullptr;
 	output.pMarkedLeafTail = nullptr;
 	output.pMarkedHead = nullptr;
 	output.pMarkedTail = nullptr;
+	output.pOldHead = nullptr;
+	output.pOldTail = nullptr;
 	output.pIterCurrent = nullptr;
 	output.pIterPrev = nullptr;
+	output.heapSize = 0;
+	output.heapObjectCount = 0;
+	output.allocatedSize = 0;
+	output.allocatedObjectCount = 0;
+	output.liveHeapSize = 0;
+	output.triggerHeapSize = minTriggerHeapSize;
+	output.minTriggerHeapSize = minTriggerHeapSize;
+	output.heapGrowthPercent = heapGrowthPercent;
+	output.scriptParkTime = 0;
+
+	memset(&output.stats, 0, sizeof(output.stats));
+
 	output.maxTimeSlice = maxTimeSliceMs * HqClockGetFrequency() / 1000;
 	output.startTime = 0;
 	output.timeCheck = 0;
@@ -77,6 +137,13 @@ void HqGarbageCollector::Initialize(HqGarbageCollector& output, HqVmHandle hVm,
 	output.lastMarkId = 0;
 	output.phase = 0;
 	output.lastPhase = 0;
+	output.minorCycleCount = 0;
+	output.isMajorCycle = false;
+	output.isConcurrentMark = false;
+
+	HqGcProxy::PtrArray::Initialize(output.remembered);
+	HqGcMarker::Initialize(output.marker, output, markThreadCount, markThreadStackSize);
+	HqSlabAllocator::InitializeCache(output.slabCache, hVm->pSlabAllocator);
 
 	// Reset the garbage collector so we're guaranteed to kick things off in a good state.
 	_reset(output);
@@ -108,20 +175,30 @@ void HqGarbageCollector::Dispose(HqGarbageCollector& gc)
 	disableAutoMark(gc.pUnmarkedHead);
 	disableAutoMark(gc.pMarkedLeafHead);
 	disableAutoMark(gc.pMarkedHead);
+	disableAutoMark(gc.pOldHead);
 
 	// Continue running the garbage collector until everything has been released.
 	for(;;)
 	{
 		RunFull(gc);
 
-		if(!gc.pPendingHead && !gc.pMarkedLeafHead && !gc.pUnmarkedHead && !gc.pMarkedHead)
+		if(!gc.pPendingHead && !gc.pMarkedLeafHead && !gc.pUnmarkedHead && !gc.pMarkedHead && !gc.pOldHead)
 		{
 			break;
 		}
 	};
 
+	// Every object has been disposed by now, so any leftover size means the allocation accounting is off.
+	assert(gc.heapObjectCount == 0);
+	assert(gc.heapSize == 0);
+
+	HqGcMarker::Dispose(gc.marker);
+
 	HqRwLock::Dispose(gc.rwLock);
 	HqMutex::Dispose(gc.pendingLock);
+	HqMutex::Dispose(gc.collectLock);
+
+	HqGcProxy::PtrArray::Dispose(gc.remembered);
 
 	gc.hVm = HQ_VM_HANDLE_NULL;
 	gc.pPendingHead = nullptr;
@@ -130,6 +207,8 @@ void HqGarbageCollector::Dispose(HqGarbageCollector& gc)
 	gc.pMarkedLeafTail = nullptr;
 	gc.pMarkedHead = nullptr;
 	gc.pMarkedTail = nullptr;
+	gc.pOldHead = nullptr;
+	gc.pOldTail = nullptr;
 	gc.pIterCurrent = nullptr;
 	gc.pIterPrev = nullptr;
 	gc.maxTimeSlice = 0;
@@ -143,26 +222,116 @@ void HqGarbageCollector::Dispose(HqGarbageCollector& gc)
 
 void HqGarbageCollector::RunStep(HqGarbageCollector& gc)
 {
-	HqScopedWriteLock writeLock(gc.rwLock, gc.hVm->isGcThreadEnabled);
+	HqScopedMutex collectLock(gc.collectLock);
+
+	if(gc.phase == _HQ_GC_PHASE_DISCOVERY && _canMarkConcurrently(gc))
+	{
+		// Tracing the heap is the longest part of a major collection, so it's done without stopping scripts.
+		_runConcurrentMark(gc);
+	}
+
+	HqScopedGcSafepoint safepoint(gc, gc.hVm->isGcThreadEnabled);
+
+	const uint64_t pauseStartTime = HqClockGetTimestamp();
+
+	if(gc.phase == _HQ_GC_PHASE__START && gc.lastPhase == _HQ_GC_PHASE__END)
+	{
+		// There is no collection in progress, so pick which generation to collect next. Minor collections
+		// only ever have to deal with the young generation, so they are always run in a single step.
+		if(gc.minorCycleCount < _HQ_GC_MINOR_CYCLES_PER_MAJOR)
+		{
+			++gc.minorCycleCount;
+
+			_beginCycle(gc, false);
+			_runCycle(gc);
+			_recordPause(gc, pauseStartTime);
+			return;
+		}
+
+		gc.minorCycleCount = 0;
+
+		_beginCycle(gc, true);
+	}
 
 	gc.startTime = HqClockGetTimestamp();
 	gc.timeCheck = 0;
 
+	const uint64_t oldMaxTimeSlice = gc.maxTimeSlice;
+	gc.maxTimeSlice = _getPacedTimeSlice(gc);
+
 	// Keep running phases while the GC reports there is more work that can be done right now.
 	while(_runPhase(gc) == _HQ_GC_RUN_MORE_WORK)
 	{
+		if(gc.phase == _HQ_GC_PHASE_DISCOVERY && _canMarkConcurrently(gc))
+		{
+			// Stop here so the next step can run discovery outside of the safepoint.
+			break;
+		}
 	}
+
+	gc.maxTimeSlice = oldMaxTimeSlice;
+
+	_recordPause(gc, pauseStartTime);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+bool HqGarbageCollector::ShouldRunStep(HqGarbageCollector& gc)
+{
+	if(gc.heapGrowthPercent == 0)
+	{
+		// Pacing is disabled, so the collector runs continuously.
+		return true;
+	}
+
+	if(gc.phase != _HQ_GC_PHASE__START || gc.lastPhase != _HQ_GC_PHASE__END)
+	{
+		// Always finish a cycle once it's been started.
+		return true;
+	}
+
+	// Don't start a new cycle until enough has been allocated to make it worthwhile. Nothing
+	// bad will happen if this reads a stale value; the check will just run again next time.
+	return gc.heapSize >= gc.triggerHeapSize;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
 void HqGarbageCollector::RunFull(HqGarbageCollector& gc)
 {
-	HqScopedWriteLock writeLock(gc.rwLock, gc.hVm->isGcThreadEnabled);
+	HqScopedMutex collectLock(gc.collectLock);
+	HqScopedGcSafepoint safepoint(gc, gc.hVm->isGcThreadEnabled);
+
+	const uint64_t pauseStartTime = HqClockGetTimestamp();
 
 	// Reset the garbage collector state so that running it again starts at the beginning of the 1st phase.
 	_reset(gc);
+	_beginCycle(gc, true);
+
+	gc.minorCycleCount = 0;
+
+	_runCycle(gc);
+	_recordPause(gc, pauseStartTime);
+}
 
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqGarbageCollector::GetStats(HqGarbageCollector& gc, HqGcStats& outStats)
+{
+	HqScopedMutex lock(gc.pendingLock);
+
+	// Taking the collect lock here could deadlock with a caller holding the GC read lock, so the stats written by
+	// the collector are copied as they are. They may be slightly out of date while a step is in progress.
+	outStats = gc.stats;
+	outStats.heapObjectCount = gc.heapObjectCount;
+	outStats.heapSize = gc.heapSize;
+	outStats.scriptParkTime = uint64_t(gc.scriptParkTime);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqGarbageCollector::_runCycle(HqGarbageCollector& gc)
+{
 	// To minimize the number of steps that need to be run, we cache the maximum time slice allowed for a single GC phase,
 	// then override it to 0, effectively disabling the timeout. This will allow us to run each phase as a single step.
 	const uint64_t oldMaxTimeSlice = gc.maxTimeSlice;
@@ -186,14 +355,228 @@ void HqGarbageCollector::RunFull(HqGarbageCollector& gc)
 
 //----------------------------------------------------------------------------------------------------------------------
 
+void HqGarbageCollector::_runConcurrentMark(HqGarbageCollector& gc)
+{
+	assert(gc.phase == _HQ_GC_PHASE_DISCOVERY);
+
+	// Scripts are free to keep running while we trace the heap. Anything they change in the meantime
+	// is caught by the write barriers and picked back up by the remark phase once discovery is done.
+	gc.isConcurrentMark = true;
+
+	// There is no pause to limit here, so discovery always runs to completion in a single call.
+	const uint64_t oldMaxTimeSlice = gc.maxTimeSlice;
+	gc.maxTimeSlice = 0;
+
+	_runPhase(gc);
+	assert(gc.phase == _HQ_GC_PHASE_REMARK);
+
+	gc.maxTimeSlice = oldMaxTimeSlice;
+	gc.isConcurrentMark = false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqGarbageCollector::_remark(HqGarbageCollector& gc)
+{
+	// Everything marked from here on gets appended to the marked list, so remember where the new work starts.
+	HqGcProxy* const pLastMarked = gc.pMarkedTail;
+
+	// Frames and registers are not write barriered, so every execution context is scanned again.
+	for(size_t i = 0; i < gc.hVm->executionContexts.count; ++i)
+	{
+		HqExecutionHandle hExec = gc.hVm->executionContexts.pData[i];
+
+		HqGcProxy::Discover(gc, &hExec->gcProxy);
+	}
+
+	// The same goes for the global variables.
+	for(size_t slot = 0; slot < gc.hVm->globalValues.count; ++slot)
+	{
+		HqValueHandle hValue = gc.hVm->globalValues.pData[slot];
+
+		if(hValue)
+		{
+			MarkObject(gc, &(hValue->gcProxy));
+		}
+	}
+
+	{
+		HqScopedMutex lock(gc.pendingLock);
+
+		// Rescan every container that was written to since the cycle started. The remembered set is left as it is
+		// since the next minor collection still needs it for any young objects held by containers promoted here.
+		for(size_t i = 0; i < gc.remembered.count; ++i)
+		{
+			HqGcProxy* const pGcProxy = gc.remembered.pData[i];
+
+			if(pGcProxy->autoMark)
+			{
+				MarkObject(gc, pGcProxy);
+			}
+
+			// Containers that are still unmarked will get discovered normally if they're reachable.
+			if(pGcProxy->discover && (pGcProxy->pending || pGcProxy->markId == gc.currentMarkId))
+			{
+				HqGcProxy::Discover(gc, pGcProxy);
+			}
+		}
+	}
+
+	HqGcProxy* const pFirstNew = pLastMarked ? pLastMarked->pNext : gc.pMarkedHead;
+
+	if(!pFirstNew)
+	{
+		// Nothing new was found.
+		return;
+	}
+
+	// Discover everything reachable from the newly marked objects.
+	if(gc.marker.workerCount > 0)
+	{
+		HqGcMarker::Seed(gc.marker, pFirstNew);
+		HqGcMarker::Run(gc.marker, 0);
+	}
+	else
+	{
+		for(HqGcProxy* pCurrent = pFirstNew; pCurrent; pCurrent = pCurrent->pNext)
+		{
+			HqGcProxy::Discover(gc, pCurrent);
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline uint64_t HqGarbageCollector::_getPacedTimeSlice(HqGarbageCollector& gc)
+{
+	if(gc.heapGrowthPercent == 0 || gc.maxTimeSlice == 0 || gc.heapSize <= gc.triggerHeapSize)
+	{
+		return gc.maxTimeSlice;
+	}
+
+	// The heap has kept growing past the size that started the current cycle, meaning the scripts are allocating
+	// faster than we're collecting. Give each step more time for every growth increment we've fallen behind by.
+	const uint64_t growthSize = (gc.triggerHeapSize > gc.liveHeapSize) ? gc.triggerHeapSize - gc.liveHeapSize : 1;
+	const uint64_t scale = 1 + ((gc.heapSize - gc.triggerHeapSize) / growthSize);
+
+	return gc.maxTimeSlice * ((scale < _HQ_GC_MAX_TIME_SLICE_SCALE) ? scale : _HQ_GC_MAX_TIME_SLICE_SCALE);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqGarbageCollector::_updateTrigger(HqGarbageCollector& gc)
+{
+	HqScopedMutex lock(gc.pendingLock);
+
+	// Whatever is left at the end of a cycle is what survived it, plus anything allocated while it was running.
+	gc.liveHeapSize = gc.heapSize;
+	gc.triggerHeapSize = gc.heapSize + (gc.heapSize * gc.heapGrowthPercent / 100);
+
+	if(gc.triggerHeapSize < gc.minTriggerHeapSize)
+	{
+		gc.triggerHeapSize = gc.minTriggerHeapSize;
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline void HqGarbageCollector::_recordPause(HqGarbageCollector& gc, const uint64_t startTime)
+{
+	const uint64_t pauseTime = HqClockGetTimestamp() - startTime;
+
+	++gc.stats.pauseCount;
+	gc.stats.totalPauseTime += pauseTime;
+
+	if(pauseTime > gc.stats.maxPauseTime)
+	{
+		gc.stats.maxPauseTime = pauseTime;
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline bool HqGarbageCollector::_canMarkConcurrently(HqGarbageCollector& gc)
+{
+	// Minor collections are always run in a single step, so only major collections are worth running concurrently.
+	// Without the GC thread, the collector is stepped by the same thread running the scripts.
+	return gc.isMajorCycle && gc.hVm->isGcThreadEnabled;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqGarbageCollector::BeginSafepoint(HqGarbageCollector& gc)
+{
+	// Script executions hold the GC read lock for as long as they're running and only give it up when they
+	// see a pending request at a safepoint. Raising the request first guarantees they will eventually release
+	// the lock so we can acquire it for writing.
+	HqAtomic::FetchAdd(&gc.safepointRequests, 1);
+
+	const uint64_t waitStartTime = HqClockGetTimestamp();
+	HqRwLock::WriteLock(gc.rwLock);
+
+	// Only one thread can be holding the write lock, so this doesn't need to be atomic.
+	gc.stats.safepointWaitTime += HqClockGetTimestamp() - waitStartTime;
+
+	// Now that we have exclusive access, withdraw the request. Any execution that parked waiting
+	// on it will now block on the read lock until this safepoint has ended.
+	HqAtomic::FetchAdd(&gc.safepointRequests, -1);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqGarbageCollector::EndSafepoint(HqGarbageCollector& gc)
+{
+	HqRwLock::WriteUnlock(gc.rwLock);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 void HqGarbageCollector::LinkObject(HqGarbageCollector& gc, HqGcProxy* const pGcProxy)
 {
 	assert(pGcProxy != nullptr);
 
+	// Proxies in a nursery are still considered pending; they just haven't been handed to the collector yet.
+	pGcProxy->pending = true;
+
+	const size_t objectSize = HqGcProxy::typeInfo[size_t(pGcProxy->type)].size;
+
+	HqGcNursery* const pNursery = _activeNursery;
+	if(pNursery && pNursery->pGc == &gc)
+	{
+		// The nursery is owned by this thread, so no lock is needed to link into it.
+		if(pNursery->pHead)
+		{
+			_proxyInsertBefore(pNursery->pHead, pGcProxy);
+		}
+		else
+		{
+			pNursery->pTail = pGcProxy;
+		}
+
+		pNursery->pHead = pGcProxy;
+		pNursery->allocatedSize += objectSize;
+		++pNursery->allocatedObjectCount;
+
+		if(pNursery->allocatedObjectCount >= _HQ_GC_NURSERY_FLUSH_COUNT)
+		{
+			// Hand the nursery off every so often so the pacer can see how much is being allocated.
+			FlushNursery(pNursery);
+		}
+		return;
+	}
+
 	HqScopedMutex lock(gc.pendingLock);
 
+	gc.heapSize += objectSize;
+	gc.allocatedSize += objectSize;
+	++gc.heapObjectCount;
+	++gc.allocatedObjectCount;
+
+	gc.stats.linkedSize += objectSize;
+	++gc.stats.linkedObjectCount;
+	++gc.stats.pendingObjectCount;
+
 	// Link the proxy the head of the pending list.
-	pGcProxy->pending = true;
 
 	if(gc.pPendingHead)
 	{
@@ -205,11 +588,51 @@ void HqGarbageCollector::LinkObject(HqGarbageCollector& gc, HqGcProxy* const pGc
 
 //----------------------------------------------------------------------------------------------------------------------
 
+void HqGarbageCollector::AddStorageSize(HqGarbageCollector& gc, const size_t storageSize)
+{
+	// Objects only allocate their backing storage after they've been linked, so it gets counted separately. Like new
+	// objects, it's counted in the running script's nursery when there is one to avoid taking the pending lock.
+	HqGcNursery* const pNursery = _activeNursery;
+	if(pNursery && pNursery->pGc == &gc)
+	{
+		pNursery->allocatedSize += storageSize;
+		return;
+	}
+
+	HqScopedMutex lock(gc.pendingLock);
+
+	gc.heapSize += storageSize;
+	gc.allocatedSize += storageSize;
+
+	gc.stats.linkedSize += storageSize;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 void HqGarbageCollector::MarkObject(HqGarbageCollector& gc, HqGcProxy* const pGcProxy)
 {
 	assert(pGcProxy != nullptr);
 	assert(pGcProxy->pObject != nullptr);
 
+	if(pGcProxy->old && !gc.isMajorCycle)
+	{
+		// Old objects are not part of a minor collection, so they're treated as though they are always marked.
+		return;
+	}
+
+	if(gc.isConcurrentMark && pGcProxy->pending)
+	{
+		// Objects created while marking is running survive this cycle regardless. They also sit
+		// in the pending list, which the running scripts are still linking new objects into.
+		return;
+	}
+
+	if(HqGcMarker::TryMarkObject(gc, pGcProxy))
+	{
+		// The object was handled by a parallel mark worker.
+		return;
+	}
+
 	// Only mark proxies that we detect being unmarked and the ones we know are already in an active list.
 	if(pGcProxy->markId != gc.currentMarkId)
 	{
@@ -283,9 +706,167 @@ void HqGarbageCollector::MarkObject(HqGarbageCollector& gc, HqGcProxy* const pGc
 
 //----------------------------------------------------------------------------------------------------------------------
 
+HqGcNursery* HqGarbageCollector::SwapNursery(HqGcNursery* const pNursery)
+{
+	HqGcNursery* const pPrevNursery = _activeNursery;
+	_activeNursery = pNursery;
+
+	return pPrevNursery;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqGarbageCollector::FlushNursery(HqGcNursery* const pNursery)
+{
+	if(!pNursery || !pNursery->pHead)
+	{
+		// Nothing to hand off.
+		return;
+	}
+
+	HqGarbageCollector& gc = *pNursery->pGc;
+
+	HqScopedMutex lock(gc.pendingLock);
+
+	// Splice the entire nursery list onto the head of the pending list in one go.
+	if(gc.pPendingHead)
+	{
+		pNursery->pTail->pNext = gc.pPendingHead;
+		gc.pPendingHead->pPrev = pNursery->pTail;
+	}
+
+	gc.pPendingHead = pNursery->pHead;
+	gc.heapSize += pNursery->allocatedSize;
+	gc.allocatedSize += pNursery->allocatedSize;
+	gc.heapObjectCount += pNursery->allocatedObjectCount;
+	gc.allocatedObjectCount += pNursery->allocatedObjectCount;
+
+	gc.stats.linkedSize += pNursery->allocatedSize;
+	gc.stats.linkedObjectCount += pNursery->allocatedObjectCount;
+	gc.stats.pendingObjectCount += pNursery->allocatedObjectCount;
+
+	pNursery->pHead = nullptr;
+	pNursery->pTail = nullptr;
+	pNursery->allocatedSize = 0;
+	pNursery->allocatedObjectCount = 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqGarbageCollector::_rememberObject(HqGarbageCollector& gc, HqGcProxy* const pGcProxy)
+{
+	assert(pGcProxy != nullptr);
+
+	HqScopedMutex lock(gc.pendingLock);
+
+	// Check the flag again now that we have the lock in case another thread beat us here.
+	if(!pGcProxy->remembered)
+	{
+		HqGcProxy::PtrArray::Reserve(gc.remembered, gc.remembered.count + 1);
+
+		gc.remembered.pData[gc.remembered.count] = pGcProxy;
+
+		pGcProxy->rememberedIndex = uint32_t(gc.remembered.count);
+		pGcProxy->remembered = true;
+
+		++gc.remembered.count;
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqGarbageCollector::_forgetObject(HqGarbageCollector& gc, HqGcProxy* const pGcProxy)
+{
+	assert(pGcProxy != nullptr);
+
+	HqScopedMutex lock(gc.pendingLock);
+
+	const uint32_t index = pGcProxy->rememberedIndex;
+	assert(index < gc.remembered.count);
+	assert(gc.remembered.pData[index] == pGcProxy);
+
+	// Order doesn't matter in the remembered set, so swap the last entry into the removed slot.
+	--gc.remembered.count;
+
+	HqGcProxy* const pMovedProxy = gc.remembered.pData[gc.remembered.count];
+
+	gc.remembered.pData[index] = pMovedProxy;
+	pMovedProxy->rememberedIndex = index;
+
+	pGcProxy->remembered = false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqGarbageCollector::_beginCycle(HqGarbageCollector& gc, const bool isMajorCycle)
+{
+	gc.isMajorCycle = isMajorCycle;
+
+	if(isMajorCycle && gc.pOldHead)
+	{
+		// The entire heap is traced in a major collection, so the old generation
+		// gets put back into the unmarked list along with the young generation.
+		gc.pOldTail->pNext = gc.pUnmarkedHead;
+
+		if(gc.pUnmarkedHead)
+		{
+			gc.pUnmarkedHead->pPrev = gc.pOldTail;
+		}
+
+		gc.pUnmarkedHead = gc.pOldHead;
+
+		gc.pOldHead = nullptr;
+		gc.pOldTail = nullptr;
+	}
+
+	gc.lastMarkId = gc.currentMarkId;
+	++gc.currentMarkId;
+
+	{
+		HqScopedMutex lock(gc.pendingLock);
+
+		gc.allocatedSize = 0;
+		gc.allocatedObjectCount = 0;
+	}
+
+	gc.phase = _HQ_GC_PHASE__START;
+	gc.lastPhase = _HQ_GC_PHASE__END;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqGarbageCollector::_parkAtSafepoint(HqGarbageCollector& gc)
+{
+	// The collector must never run while this thread is holding objects that it can't see.
+	if(_activeNursery && _activeNursery->pGc == &gc)
+	{
+		FlushNursery(_activeNursery);
+	}
+
+	// Release the read lock so the requester can take the write lock. We wait for the request to be withdrawn
+	// before trying to lock again, otherwise the rwlock implementation may let us straight back in ahead of the
+	// waiting writer. Once the request is withdrawn, the writer owns the lock and we'll block until it's done.
+	const uint64_t parkStartTime = HqClockGetTimestamp();
+
+	HqRwLock::ReadUnlock(gc.rwLock);
+
+	while(gc.safepointRequests > 0)
+	{
+		HqThread::Yield();
+	}
+
+	HqRwLock::ReadLock(gc.rwLock);
+
+	HqAtomic::FetchAdd(&gc.scriptParkTime, int64_t(HqClockGetTimestamp() - parkStartTime));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 inline int HqGarbageCollector::_runPhase(HqGarbageCollector& gc)
 {
 	const bool isPhaseStart = (gc.lastPhase != gc.phase);
+	const int currentPhase = gc.phase;
+	const uint64_t phaseStartTime = HqClockGetTimestamp();
 
 	bool endOfAllPhases = false;
 	bool endOfPhase = false;
@@ -329,6 +910,8 @@ inline int HqGarbageCollector::_runPhase(HqGarbageCollector& gc)
 				// Update the heads of the unmarked and pending lists.
 				gc.pUnmarkedHead = pCurrent;
 				gc.pPendingHead = pNext;
+
+				--gc.stats.pendingObjectCount;
 			}
 
 			if(!gc.pPendingHead)
@@ -396,15 +979,13 @@ inline int HqGarbageCollector::_runPhase(HqGarbageCollector& gc)
 				break;
 			}
 
-			// There's no good way to go over the globals incrementally since the map can hypothetically
-			// change between steps of the garbage collector. We also can't rely on auto-marking because
-			// globals can change what values they point to. Since we're just enqueuing proxies, it shouldn't
-			// be too bad to loop over all the globals at once. This may only become problematic if a script
-			// module contains many hundreds of globals or more. We'll cross that bridge when we come to it.
-			HqValue::StringToHandleMap::Iterator iter;
-			while(HqValue::StringToHandleMap::IterateNext(gc.hVm->globals, iter))
+			// There's no good way to go over the globals incrementally since the slot table can hypothetically
+			// grow between steps of the garbage collector. We also can't rely on auto-marking because globals
+			// can change what values they point to. Since we're just enqueuing proxies from a flat array, it
+			// shouldn't be too bad to loop over all the globals at once.
+			for(size_t slot = 0; slot < gc.hVm->globalValues.count; ++slot)
 			{
-				HqValueHandle hValue = iter.pData->value;
+				HqValueHandle hValue = gc.hVm->globalValues.pData[slot];
 
 				if(hValue)
 				{
@@ -420,9 +1001,70 @@ inline int HqGarbageCollector::_runPhase(HqGarbageCollector& gc)
 			break;
 		}
 
+		// Trace the old objects that may be holding references to young objects.
+		case _HQ_GC_PHASE_REMEMBERED_MARK:
+		{
+			// Major collections trace everything from the roots, so there's nothing to do for them here.
+			if(!gc.isMajorCycle)
+			{
+				// Stores into frames and registers are not write barriered, so the active frames
+				// in each old execution context are always treated as roots of a minor collection.
+				for(size_t i = 0; i < gc.hVm->executionContexts.count; ++i)
+				{
+					HqExecutionHandle hExec = gc.hVm->executionContexts.pData[i];
+
+					if(hExec->gcProxy.old)
+					{
+						HqGcProxy::Discover(gc, &hExec->gcProxy);
+					}
+				}
+
+				HqScopedMutex lock(gc.pendingLock);
+
+				for(size_t i = 0; i < gc.remembered.count; ++i)
+				{
+					HqGcProxy* const pGcProxy = gc.remembered.pData[i];
+
+					pGcProxy->remembered = false;
+
+					if(pGcProxy->discover)
+					{
+						HqGcProxy::Discover(gc, pGcProxy);
+					}
+				}
+
+				gc.remembered.count = 0;
+			}
+
+			endOfPhase = true;
+			break;
+		}
+
 		// Mark any dependent proxies referenced by the current marked list.
 		case _HQ_GC_PHASE_DISCOVERY:
 		{
+			if(gc.marker.workerCount > 0)
+			{
+				if(isPhaseStart)
+				{
+					// Hand the objects marked so far out to the mark workers. Anything they discover from here on
+					// is tracked in their own mark stacks rather than being moved into the marked list.
+					HqGcMarker::Seed(gc.marker, gc.pMarkedHead);
+				}
+
+				const uint64_t deadline = (gc.maxTimeSlice > 0) ? gc.startTime + gc.maxTimeSlice : 0;
+
+				if(HqGcMarker::Run(gc.marker, deadline))
+				{
+					endOfPhase = true;
+				}
+				else
+				{
+					timeOut = true;
+				}
+				break;
+			}
+
 			if(isPhaseStart)
 			{
 				// For the start of the phase, set the current proxy pointer to the head of the marked active list.
@@ -441,7 +1083,10 @@ inline int HqGarbageCollector::_runPhase(HqGarbageCollector& gc)
 				}
 
 				// Discover any garbage collected objects that need to be marked contained within the current object.
-				gc.pIterCurrent->onGcDiscoveryFn(gc, gc.pIterCurrent->pObject);
+				if(!gc.isConcurrentMark || HqGcProxy::CanDiscoverConcurrently(gc.pIterCurrent))
+				{
+					HqGcProxy::Discover(gc, gc.pIterCurrent);
+				}
 
 				// Move to the next proxy in the list.
 				gc.pIterCurrent = gc.pIterCurrent->pNext;
@@ -455,9 +1100,29 @@ inline int HqGarbageCollector::_runPhase(HqGarbageCollector& gc)
 			break;
 		}
 
+		// Catch any changes made by scripts while discovery was running.
+		case _HQ_GC_PHASE_REMARK:
+		{
+			// This is the only pause in a major collection that can't be split up, since
+			// everything reachable must be marked before the dispose phase is allowed to start.
+			if(gc.isMajorCycle)
+			{
+				_remark(gc);
+			}
+
+			endOfPhase = true;
+			break;
+		}
+
 		// Dispose of any objects that are no longer in use.
 		case _HQ_GC_PHASE_DISPOSE:
 		{
+			// Freed objects go to the collector's own slab cache so the slab lock is only taken once per batch.
+			HqScopedSlabCache slabCache(&gc.slabCache);
+
+			uint64_t disposedSize = 0;
+			uint64_t disposedObjectCount = 0;
+
 			// Iterate until the end of the list has been reached.
 			while(gc.pUnmarkedHead)
 			{
@@ -471,13 +1136,60 @@ inline int HqGarbageCollector::_runPhase(HqGarbageCollector& gc)
 				// Cache the next proxy in case the current one is freed from memory when disposed.
 				HqGcProxy* const pNext = gc.pUnmarkedHead->pNext;
 
+				if(gc.pUnmarkedHead->markId == gc.currentMarkId)
+				{
+					// This object was marked by a parallel mark worker, so it needs to be moved to the marked list.
+					HqGcProxy* const pGcProxy = gc.pUnmarkedHead;
+
+					// Anything before the head of the unmarked list has already been disposed.
+					pGcProxy->pPrev = nullptr;
+
+					_proxyUnlink(pGcProxy);
+
+					if(gc.pMarkedHead)
+					{
+						_proxyInsertAfter(gc.pMarkedTail, pGcProxy);
+					}
+					else
+					{
+						gc.pMarkedHead = pGcProxy;
+					}
+
+					gc.pMarkedTail = pGcProxy;
+					gc.pUnmarkedHead = pNext;
+					continue;
+				}
+
+				if(gc.pUnmarkedHead->remembered)
+				{
+					// Make sure the remembered set isn't left holding onto the object after it's gone.
+					_forgetObject(gc, gc.pUnmarkedHead);
+				}
+
+				disposedSize += HqGcProxy::GetSize(gc.pUnmarkedHead);
+				++disposedObjectCount;
+
 				// Dispose of the current proxy.
-				gc.pUnmarkedHead->onGcDisposeFn(gc.pUnmarkedHead->pObject);
+				HqGcProxy::Dispose(gc.pUnmarkedHead);
 
 				// Update the head of the unmarked list.
 				gc.pUnmarkedHead = pNext;
 			}
 
+			if(disposedObjectCount > 0)
+			{
+				HqScopedMutex lock(gc.pendingLock);
+
+				gc.heapSize -= disposedSize;
+				gc.heapObjectCount -= disposedObjectCount;
+			}
+
+			gc.stats.disposedSize += disposedSize;
+			gc.stats.disposedObjectCount += disposedObjectCount;
+
+			// Nothing allocates from the collector's cache, so there's no reason to hold onto the freed blocks.
+			HqSlabAllocator::FlushCache(&gc.slabCache);
+
 			if(!gc.pUnmarkedHead)
 			{
 				// The end of the phase is when there are no unmarked proxies remaining.
@@ -486,12 +1198,80 @@ inline int HqGarbageCollector::_runPhase(HqGarbageCollector& gc)
 			break;
 		}
 
+		// Move everything that survived the collection into the old generation.
+		case _HQ_GC_PHASE_PROMOTE:
+		{
+			if(isPhaseStart)
+			{
+				_mergeMarkedLeafList(gc);
+
+				gc.pIterCurrent = gc.pMarkedHead;
+			}
+
+			// Iterate until the end of the list has been reached.
+			while(gc.pIterCurrent)
+			{
+				if(_hasReachedTimeSlice(gc))
+				{
+					// We ran out of time.
+					timeOut = true;
+					break;
+				}
+
+				// Everything left in the marked list at this point is what survived the collection.
+				gc.stats.markedSize += HqGcProxy::GetSize(gc.pIterCurrent);
+				++gc.stats.markedObjectCount;
+
+				gc.pIterCurrent->old = true;
+				gc.pIterCurrent = gc.pIterCurrent->pNext;
+			}
+
+			if(!gc.pIterCurrent)
+			{
+				if(gc.pMarkedHead)
+				{
+					// Link the entire marked list to the head of the old list.
+					gc.pMarkedTail->pNext = gc.pOldHead;
+
+					if(gc.pOldHead)
+					{
+						gc.pOldHead->pPrev = gc.pMarkedTail;
+					}
+					else
+					{
+						gc.pOldTail = gc.pMarkedTail;
+					}
+
+					gc.pOldHead = gc.pMarkedHead;
+				}
+
+				gc.pMarkedHead = nullptr;
+				gc.pMarkedTail = nullptr;
+
+				++gc.stats.cycleCount;
+
+				if(gc.isMajorCycle)
+				{
+					++gc.stats.majorCycleCount;
+				}
+
+				gc.isMajorCycle = false;
+
+				_updateTrigger(gc);
+
+				endOfPhase = true;
+			}
+			break;
+		}
+
 		default:
 			// This should never happen.
 			assert(false);
 			break;
 	}
 
+	gc.stats.phaseTime[currentPhase] += HqClockGetTimestamp() - phaseStartTime;
+
 	// Cache the current phase so we know if the last step was running a different phase.
 	// This effectively lets us detect the start of a phase.
 	gc.lastPhase = gc.phase;
@@ -536,24 +1316,9 @@ inline bool HqGarbageCollector::_hasReachedTimeSlice(HqGarbageCollector& gc)
 
 inline void HqGarbageCollector::_reset(HqGarbageCollector& gc)
 {
-	if(gc.pMarkedLeafHead)
-	{
-		// The easiest way to concatenate the marked leaf list into everything else is to
-		// just make it part of the marked list.
-		if(gc.pMarkedHead)
-		{
-			// Link the marked list and the marked leaf list directly to each other.
-			gc.pMarkedLeafHead->pPrev = gc.pMarkedTail;
-			gc.pMarkedTail->pNext = gc.pMarkedLeafHead;
-			gc.pMarkedTail = gc.pMarkedLeafTail;
-		}
-		else
-		{
-			// The marked leaf list becomes the marked list.
-			gc.pMarkedHead = gc.pMarkedLeafHead;
-			gc.pMarkedTail = gc.pMarkedLeafTail;
-		}
-	}
+	HqGcMarker::Reset(gc.marker);
+
+	_mergeMarkedLeafList(gc);
 
 	if(gc.pMarkedHead)
 	{
@@ -571,14 +1336,10 @@ inline void HqGarbageCollector::_reset(HqGarbageCollector& gc)
 		gc.pUnmarkedHead = gc.pMarkedHead;
 	}
 
-	gc.pMarkedLeafHead = nullptr;
-	gc.pMarkedLeafTail = nullptr;
-
 	gc.pMarkedHead = nullptr;
 	gc.pMarkedTail = nullptr;
 
-	gc.lastMarkId = gc.currentMarkId;
-	++gc.currentMarkId;
+	gc.isMajorCycle = false;
 
 	gc.phase = _HQ_GC_PHASE__START;
 	gc.lastPhase = _HQ_GC_PHASE__END;
@@ -586,6 +1347,33 @@ inline void HqGarbageCollector::_reset(HqGarbageCollector& gc)
 
 //----------------------------------------------------------------------------------------------------------------------
 
+inline void HqGarbageCollector::_mergeMarkedLeafList(HqGarbageCollector& gc)
+{
+	if(gc.pMarkedLeafHead)
+	{
+		// The easiest way to concatenate the marked leaf list into everything else is to
+		// just make it part of the marked list.
+		if(gc.pMarkedHead)
+		{
+			// Link the marked list and the marked leaf list directly to each other.
+			gc.pMarkedLeafHead->pPrev = gc.pMarkedTail;
+			gc.pMarkedTail->pNext = gc.pMarkedLeafHead;
+			gc.pMarkedTail = gc.pMarkedLeafTail;
+		}
+		else
+		{
+			// The marked leaf list becomes the marked list.
+			gc.pMarkedHead = gc.pMarkedLeafHead;
+			gc.pMarkedTail = gc.pMarkedLeafTail;
+		}
+	}
+
+	gc.pMarkedLeafHead = nullptr;
+	gc.pMarkedLeafTail = nullptr;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 inline void HqGarbageCollector::_proxyInsertBefore(HqGcProxy* const pGcListProxy, HqGcProxy* const pGcInsertProxy)
 {
 	assert(pGcListProxy != nullptr);
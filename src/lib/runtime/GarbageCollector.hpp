@@ -20,23 +20,80 @@
 
 //----------------------------------------------------------------------------------------------------------------------
 
+#include "GcMarker.hpp"
+#include "GcProxy.hpp"
+
 #include "../base/Mutex.hpp"
 #include "../base/RwLock.hpp"
+#include "../base/SlabAllocator.hpp"
+
+#include <stdint.h>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct HqGarbageCollector;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct HqGcNursery
+{
+	static void Initialize(HqGcNursery& output, HqGarbageCollector& gc);
+
+	HqGarbageCollector* pGc;
+
+	HqGcProxy* pHead;
+	HqGcProxy* pTail;
+
+	uint64_t allocatedSize;
+	uint32_t allocatedObjectCount;
+};
 
 //----------------------------------------------------------------------------------------------------------------------
 
-struct HqGcProxy;
 struct HqGarbageCollector
 {
-	static void Initialize(HqGarbageCollector& output, HqVmHandle hVm, const uint32_t maxTimeSliceMs);
+	static void Initialize(
+		HqGarbageCollector& output,
+		HqVmHandle hVm,
+		const uint32_t maxTimeSliceMs,
+		const uint32_t markThreadCount,
+		const uint32_t markThreadStackSize,
+		const uint32_t heapGrowthPercent,
+		const uint32_t minTriggerHeapSize
+	);
 	static void Dispose(HqGarbageCollector& gc);
 
 	static void RunStep(HqGarbageCollector& gc);
 	static void RunFull(HqGarbageCollector& gc);
 
+	static bool ShouldRunStep(HqGarbageCollector& gc);
+
+	static void GetStats(HqGarbageCollector& gc, HqGcStats& outStats);
+
+	static void BeginSafepoint(HqGarbageCollector& gc);
+	static void EndSafepoint(HqGarbageCollector& gc);
+	static void PollSafepoint(HqGarbageCollector& gc);
+
 	static void LinkObject(HqGarbageCollector& gc, HqGcProxy* const pGcProxy);
+	static void AddStorageSize(HqGarbageCollector& gc, const size_t storageSize);
 	static void MarkObject(HqGarbageCollector& gc, HqGcProxy* const pGcProxy);
+	static void WriteBarrier(HqGarbageCollector& gc, HqGcProxy* const pGcProxy);
+
+	static HqGcNursery* SwapNursery(HqGcNursery* const pNursery);
+	static void FlushNursery(HqGcNursery* const pNursery);
 
+	static void _parkAtSafepoint(HqGarbageCollector&);
+	static void _rememberObject(HqGarbageCollector&, HqGcProxy*);
+	static void _forgetObject(HqGarbageCollector&, HqGcProxy*);
+	static void _beginCycle(HqGarbageCollector&, bool);
+	static void _runCycle(HqGarbageCollector&);
+	static void _runConcurrentMark(HqGarbageCollector&);
+	static void _remark(HqGarbageCollector&);
+	static bool _canMarkConcurrently(HqGarbageCollector&);
+	static uint64_t _getPacedTimeSlice(HqGarbageCollector&);
+	static void _updateTrigger(HqGarbageCollector&);
+	static void _recordPause(HqGarbageCollector&, uint64_t);
+	static void _mergeMarkedLeafList(HqGarbageCollector&);
 	static int _runPhase(HqGarbageCollector&);
 	static bool _hasReachedTimeSlice(HqGarbageCollector&);
 	static void _reset(HqGarbageCollector&);
@@ -46,6 +103,7 @@ struct HqGarbageCollector
 
 	HqRwLock rwLock;
 	HqMutex pendingLock;
+	HqMutex collectLock;
 
 	HqVmHandle hVm;
 
@@ -55,10 +113,39 @@ struct HqGarbageCollector
 	HqGcProxy* pMarkedLeafTail;
 	HqGcProxy* pMarkedHead;
 	HqGcProxy* pMarkedTail;
+	HqGcProxy* pOldHead;
+	HqGcProxy* pOldTail;
+
+	HqGcProxy::PtrArray remembered;
+
+	HqGcMarker marker;
+
+	HqSlabCache slabCache;
 
 	HqGcProxy* pIterCurrent;
 	HqGcProxy* pIterPrev;
 
+	// Approximate size of all objects tracked by the collector. These are guarded by the pending lock.
+	uint64_t heapSize;
+	uint64_t heapObjectCount;
+	uint64_t allocatedSize;
+	uint64_t allocatedObjectCount;
+
+	// Pacing state; a new cycle is started once the heap grows to the trigger size.
+	uint64_t liveHeapSize;
+	uint64_t triggerHeapSize;
+	uint64_t minTriggerHeapSize;
+	uint32_t heapGrowthPercent;
+
+	// Running totals reported by HqVmGetGcStats(). The linked and pending counts are guarded by the pending lock,
+	// everything else is only updated by whichever thread is running the collector. The heap size and count are
+	// copied in from the pacing state above when the stats are requested.
+	HqGcStats stats;
+
+	// Time spent by script executions waiting for the collector at safepoints. This is added to from every
+	// thread running a script, so it's kept out of the stats struct to be updated atomically.
+	volatile int64_t scriptParkTime;
+
 	uint64_t maxTimeSlice;
 	uint64_t startTime;
 	uint32_t timeCheck;
@@ -68,6 +155,106 @@ struct HqGarbageCollector
 
 	int phase;
 	int lastPhase;
+
+	uint32_t minorCycleCount;
+
+	bool isMajorCycle;
+	bool isConcurrentMark;
+
+	volatile int32_t safepointRequests;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline void HqGarbageCollector::PollSafepoint(HqGarbageCollector& gc)
+{
+	// This is called by running scripts at backward jumps, calls, returns, and allocations, so the common
+	// case needs to stay as cheap as possible. A plain read of the request counter is enough here since
+	// the GC thread does not rely on seeing an execution park at any specific instruction.
+	if(gc.safepointRequests > 0)
+	{
+		_parkAtSafepoint(gc);
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline void HqGarbageCollector::WriteBarrier(HqGarbageCollector& gc, HqGcProxy* const pGcProxy)
+{
+	// Only containers that won't be traced by a minor collection need to be remembered. While a major collection is
+	// in progress, every container is remembered so the remark phase can rescan anything changed during discovery.
+	// Young containers also need to stay remembered after that since they'll be promoted once the cycle is finished.
+	if(!pGcProxy->remembered && (pGcProxy->old || gc.isMajorCycle))
+	{
+		_rememberObject(gc, pGcProxy);
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class HqScopedGcSafepoint
+{
+public:
+
+	HqScopedGcSafepoint() = delete;
+	HqScopedGcSafepoint(const HqScopedGcSafepoint&) = delete;
+	HqScopedGcSafepoint(HqScopedGcSafepoint&&) = delete;
+
+	explicit HqScopedGcSafepoint(HqGarbageCollector& gc, const bool condition = true)
+		: m_pGc(&gc)
+		, m_condition(condition)
+	{
+		if(m_condition)
+		{
+			HqGarbageCollector::BeginSafepoint(*m_pGc);
+		}
+	}
+
+	~HqScopedGcSafepoint()
+	{
+		if(m_condition)
+		{
+			HqGarbageCollector::EndSafepoint(*m_pGc);
+		}
+	}
+
+
+private:
+
+	HqGarbageCollector* m_pGc;
+	bool m_condition;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class HqScopedGcNursery
+{
+public:
+
+	HqScopedGcNursery() = delete;
+	HqScopedGcNursery(const HqScopedGcNursery&) = delete;
+	HqScopedGcNursery(HqScopedGcNursery&&) = delete;
+
+	explicit HqScopedGcNursery(HqGcNursery* const pNursery)
+		: m_pNursery(pNursery)
+		, m_pPrevNursery(nullptr)
+	{
+		// Anything allocated into the outgoing nursery needs to be handed off before it's swapped out.
+		m_pPrevNursery = HqGarbageCollector::SwapNursery(m_pNursery);
+		HqGarbageCollector::FlushNursery(m_pPrevNursery);
+	}
+
+	~HqScopedGcNursery()
+	{
+		HqGarbageCollector::FlushNursery(m_pNursery);
+		HqGarbageCollector::SwapNursery(m_pPrevNursery);
+	}
+
+
+private:
+
+	HqGcNursery* m_pNursery;
+	HqGcNursery* m_pPrevNursery;
 };
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,425 @@
+//
+// Copyright (c) 2021, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include "GcMarker.hpp"
+#include "GarbageCollector.hpp"
+
+#include "../base/Clock.hpp"
+
+#include "../common/Atomic.hpp"
+
+#include <assert.h>
+#include <inttypes.h>
+#include <stdio.h>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// Number of objects a worker will discover between each check of the time slice deadline.
+#define _HQ_GC_MARKER_TIME_CHECK_INTERVAL 32
+
+// Number of times an idle worker thread will yield while waiting for a new job before it starts sleeping instead.
+#define _HQ_GC_MARKER_SPIN_COUNT 1000
+
+// Upper limit on the number of objects taken from another worker in a single steal.
+#define _HQ_GC_MARKER_MAX_STEAL_COUNT 64
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// Worker that owns the current thread while it's draining mark stacks.
+static thread_local HqGcMarkWorker* _activeWorker = nullptr;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqGcMarker::Initialize(
+	HqGcMarker& output,
+	HqGarbageCollector& gc,
+	const uint32_t threadCount,
+	const uint32_t threadStackSize
+)
+{
+	output.pGc = &gc;
+	output.pWorkers = nullptr;
+	output.workerCount = 0;
+	output.deadline = 0;
+	output.jobId = 0;
+	output.activeCount = 0;
+	output.finishedCount = 0;
+	output.timedOut = 0;
+	output.shutdown = 0;
+
+	if(threadCount == 0)
+	{
+		// Marking will stay on the collector thread.
+		return;
+	}
+
+	output.workerCount = threadCount + 1;
+	output.pWorkers = reinterpret_cast<HqGcMarkWorker*>(HqMemAlloc(sizeof(HqGcMarkWorker) * output.workerCount));
+	assert(output.pWorkers != nullptr);
+
+	for(uint32_t i = 0; i < output.workerCount; ++i)
+	{
+		HqGcMarkWorker& worker = output.pWorkers[i];
+
+		worker.pMarker = &output;
+		worker.lastJobId = 0;
+
+		HqMutex::Create(worker.lock);
+		HqGcProxy::PtrArray::Initialize(worker.stack);
+
+		if(i > 0)
+		{
+			HqThreadConfig threadConfig;
+			threadConfig.mainFn = _workerMain;
+			threadConfig.pArg = &worker;
+			threadConfig.stackSize = threadStackSize;
+			snprintf(threadConfig.name, sizeof(threadConfig.name), "HqGcMarker%" PRIu32, i);
+
+			HqThread::Create(worker.thread, threadConfig);
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqGcMarker::Dispose(HqGcMarker& marker)
+{
+	if(!marker.pWorkers)
+	{
+		return;
+	}
+
+	HqAtomic::FetchAdd(&marker.shutdown, 1);
+
+	for(uint32_t i = 0; i < marker.workerCount; ++i)
+	{
+		HqGcMarkWorker& worker = marker.pWorkers[i];
+
+		if(i > 0)
+		{
+			int32_t threadReturnValue = 0;
+			HqThread::Join(worker.thread, &threadReturnValue);
+		}
+
+		HqMutex::Dispose(worker.lock);
+		HqGcProxy::PtrArray::Dispose(worker.stack);
+	}
+
+	HqMemFree(marker.pWorkers);
+
+	marker.pWorkers = nullptr;
+	marker.workerCount = 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqGcMarker::Reset(HqGcMarker& marker)
+{
+	// Drop anything left over from an interrupted collection.
+	for(uint32_t i = 0; i < marker.workerCount; ++i)
+	{
+		marker.pWorkers[i].stack.count = 0;
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqGcMarker::Seed(HqGcMarker& marker, HqGcProxy* const pGcProxyHead)
+{
+	assert(marker.workerCount > 0);
+
+	// Deal the initial set of marked objects out to the workers evenly.
+	// Work stealing will take care of any imbalance from here.
+	uint32_t workerIndex = 0;
+
+	for(HqGcProxy* pCurrent = pGcProxyHead; pCurrent; pCurrent = pCurrent->pNext)
+	{
+		_push(marker.pWorkers[workerIndex], pCurrent);
+
+		workerIndex = (workerIndex + 1) % marker.workerCount;
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+bool HqGcMarker::Run(HqGcMarker& marker, const uint64_t deadline)
+{
+	assert(marker.workerCount > 0);
+
+	marker.deadline = deadline;
+	marker.timedOut = 0;
+	marker.activeCount = int32_t(marker.workerCount);
+	marker.finishedCount = 0;
+
+	// Bumping the job ID is what releases the worker threads.
+	HqAtomic::FetchAdd(&marker.jobId, 1);
+
+	_drain(marker.pWorkers[0]);
+
+	// Wait for the worker threads to finish up.
+	while(marker.finishedCount < int32_t(marker.workerCount - 1))
+	{
+		HqThread::Yield();
+	}
+
+	// Any work left behind by a time out will be picked back up on the next run.
+	return !_hasWork(marker);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+bool HqGcMarker::TryMarkObject(HqGarbageCollector& gc, HqGcProxy* const pGcProxy)
+{
+	HqGcMarkWorker* const pWorker = _activeWorker;
+	if(!pWorker)
+	{
+		// Not running on a mark worker, so the caller needs to handle the object itself.
+		return false;
+	}
+
+	const int32_t currentMarkId = int32_t(gc.currentMarkId);
+	const int32_t markId = int32_t(pGcProxy->markId);
+
+	// Objects are left in whatever list they're in while marking in parallel. Claiming the mark ID atomically
+	// guarantees only one worker will ever go on to discover each object. The collector will sort the marked
+	// objects out of the unmarked list when it sweeps.
+	if(markId != currentMarkId
+		&& HqAtomic::CompareExchange(reinterpret_cast<volatile int32_t*>(&pGcProxy->markId), markId, currentMarkId)
+		&& pGcProxy->discover)
+	{
+		_push(*pWorker, pGcProxy);
+	}
+
+	return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int32_t HqGcMarker::_workerMain(void* const pArg)
+{
+	HqGcMarkWorker& worker = *reinterpret_cast<HqGcMarkWorker*>(pArg);
+	HqGcMarker& marker = *worker.pMarker;
+
+	uint32_t spinCount = 0;
+
+	while(!marker.shutdown)
+	{
+		const int32_t jobId = marker.jobId;
+
+		if(jobId != worker.lastJobId)
+		{
+			worker.lastJobId = jobId;
+
+			_drain(worker);
+
+			HqAtomic::FetchAdd(&marker.finishedCount, 1);
+
+			spinCount = 0;
+		}
+		else if(spinCount < _HQ_GC_MARKER_SPIN_COUNT)
+		{
+			// Collections tend to run several steps back to back, so stay responsive for a little while.
+			++spinCount;
+			HqThread::Yield();
+		}
+		else
+		{
+			HqThread::Sleep(1);
+		}
+	}
+
+	return HQ_SUCCESS;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqGcMarker::_drain(HqGcMarkWorker& worker)
+{
+	HqGcMarker& marker = *worker.pMarker;
+	HqGarbageCollector& gc = *marker.pGc;
+
+	_activeWorker = &worker;
+
+	uint32_t timeCheck = 0;
+
+	for(;;)
+	{
+		if(marker.timedOut)
+		{
+			HqAtomic::FetchAdd(&marker.activeCount, -1);
+			break;
+		}
+
+		HqGcProxy* const pGcProxy = _pop(worker);
+
+		if(!pGcProxy)
+		{
+			if(_steal(worker))
+			{
+				continue;
+			}
+
+			// There is nothing left for this worker to do, so it goes idle until either another
+			// worker produces more work or every worker has gone idle, meaning marking is done.
+			HqAtomic::FetchAdd(&marker.activeCount, -1);
+
+			bool resume = false;
+
+			while(marker.activeCount > 0 && !marker.timedOut)
+			{
+				if(_hasWork(marker))
+				{
+					HqAtomic::FetchAdd(&marker.activeCount, 1);
+					resume = true;
+					break;
+				}
+
+				HqThread::Yield();
+			}
+
+			if(!resume)
+			{
+				break;
+			}
+
+			continue;
+		}
+
+		if(!gc.isConcurrentMark || HqGcProxy::CanDiscoverConcurrently(pGcProxy))
+		{
+			HqGcProxy::Discover(gc, pGcProxy);
+		}
+
+		++timeCheck;
+
+		if(marker.deadline > 0
+			&& (timeCheck % _HQ_GC_MARKER_TIME_CHECK_INTERVAL) == 0
+			&& HqClockGetTimestamp() >= marker.deadline)
+		{
+			HqAtomic::FetchAdd(&marker.timedOut, 1);
+		}
+	}
+
+	_activeWorker = nullptr;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqGcMarker::_push(HqGcMarkWorker& worker, HqGcProxy* const pGcProxy)
+{
+	HqScopedMutex lock(worker.lock);
+
+	HqGcProxy::PtrArray::Reserve(worker.stack, worker.stack.count + 1);
+
+	worker.stack.pData[worker.stack.count] = pGcProxy;
+	++worker.stack.count;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+HqGcProxy* HqGcMarker::_pop(HqGcMarkWorker& worker)
+{
+	HqScopedMutex lock(worker.lock);
+
+	if(worker.stack.count == 0)
+	{
+		return nullptr;
+	}
+
+	--worker.stack.count;
+
+	return worker.stack.pData[worker.stack.count];
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+bool HqGcMarker::_steal(HqGcMarkWorker& worker)
+{
+	HqGcMarker& marker = *worker.pMarker;
+
+	HqGcProxy* stolen[_HQ_GC_MARKER_MAX_STEAL_COUNT];
+	size_t stealCount = 0;
+
+	for(uint32_t i = 0; i < marker.workerCount && stealCount == 0; ++i)
+	{
+		HqGcMarkWorker& victim = marker.pWorkers[i];
+
+		if(&victim == &worker || victim.stack.count == 0)
+		{
+			continue;
+		}
+
+		// Only one worker lock is ever held at a time, so two workers stealing from each other can't deadlock.
+		HqScopedMutex victimLock(victim.lock);
+
+		// Take half of the victim's work (rounded up) from the bottom of its stack
+		// where the oldest entries are most likely to have the most work under them.
+		stealCount = (victim.stack.count + 1) / 2;
+		if(stealCount > _HQ_GC_MARKER_MAX_STEAL_COUNT)
+		{
+			stealCount = _HQ_GC_MARKER_MAX_STEAL_COUNT;
+		}
+
+		for(size_t index = 0; index < stealCount; ++index)
+		{
+			stolen[index] = victim.stack.pData[index];
+		}
+
+		for(size_t index = stealCount; index < victim.stack.count; ++index)
+		{
+			victim.stack.pData[index - stealCount] = victim.stack.pData[index];
+		}
+
+		victim.stack.count -= stealCount;
+	}
+
+	if(stealCount == 0)
+	{
+		return false;
+	}
+
+	HqScopedMutex lock(worker.lock);
+
+	HqGcProxy::PtrArray::Reserve(worker.stack, worker.stack.count + stealCount);
+
+	for(size_t index = 0; index < stealCount; ++index)
+	{
+		worker.stack.pData[worker.stack.count + index] = stolen[index];
+	}
+
+	worker.stack.count += stealCount;
+
+	return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+bool HqGcMarker::_hasWork(HqGcMarker& marker)
+{
+	for(uint32_t i = 0; i < marker.workerCount; ++i)
+	{
+		if(marker.pWorkers[i].stack.count > 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,82 @@
+//
+// Copyright (c) 2021, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#pragma once
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#include "GcProxy.hpp"
+
+#include "../base/Mutex.hpp"
+#include "../base/Thread.hpp"
+
+#include <stdint.h>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct HqGarbageCollector;
+struct HqGcMarker;
+
+struct HqGcMarkWorker
+{
+	HqGcMarker* pMarker;
+
+	HqThread thread;
+	HqMutex lock;
+
+	HqGcProxy::PtrArray stack;
+
+	int32_t lastJobId;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct HqGcMarker
+{
+	static void Initialize(HqGcMarker& output, HqGarbageCollector& gc, uint32_t threadCount, uint32_t threadStackSize);
+	static void Dispose(HqGcMarker& marker);
+	static void Reset(HqGcMarker& marker);
+
+	static void Seed(HqGcMarker& marker, HqGcProxy* const pGcProxyHead);
+	static bool Run(HqGcMarker& marker, const uint64_t deadline);
+
+	static bool TryMarkObject(HqGarbageCollector& gc, HqGcProxy* const pGcProxy);
+
+	static int32_t _workerMain(void*);
+	static void _drain(HqGcMarkWorker&);
+	static void _push(HqGcMarkWorker&, HqGcProxy*);
+	static HqGcProxy* _pop(HqGcMarkWorker&);
+	static bool _steal(HqGcMarkWorker&);
+	static bool _hasWork(HqGcMarker&);
+
+	HqGarbageCollector* pGc;
+
+	// The thread running the collector always participates as the first worker.
+	HqGcMarkWorker* pWorkers;
+	uint32_t workerCount;
+
+	uint64_t deadline;
+
+	volatile int32_t jobId;
+	volatile int32_t activeCount;
+	volatile int32_t finishedCount;
+	volatile int32_t timedOut;
+	volatile int32_t shutdown;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
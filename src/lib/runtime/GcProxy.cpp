@@ -17,7 +17,9 @@
 //
 
 #include "GcProxy.hpp"
+#include "Execution.hpp"
 #include "GarbageCollector.hpp"
+#include "Value.hpp"
 
 #include "../common/Atomic.hpp"
 
@@ -25,30 +27,37 @@
 
 //----------------------------------------------------------------------------------------------------------------------
 
+const HqGcProxy::TypeInfo HqGcProxy::typeInfo[size_t(HqGcProxy::Type::Count)] =
+{
+	{ HqValue::_onGcDiscovery, HqValue::_onGcDestruct, HqValue::_onGcGetStorageSize, sizeof(HqValue), true },
+	{ HqExecution::_onGcDiscovery, HqExecution::_onGcDestruct, nullptr, sizeof(HqExecution), false },
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
 void HqGcProxy::Initialize(
 	HqGcProxy& output,
 	HqGarbageCollector& gc,
-	HqGcDiscoveryCallback onGcDiscoveryFn,
-	HqDisposeCallback onGcDisposeFn,
+	const Type type,
 	void* const pObject,
 	const bool autoMark,
 	const bool discover
 )
 {
-	assert(onGcDiscoveryFn != nullptr);
-	assert(onGcDisposeFn != nullptr);
+	assert(type < Type::Count);
 	assert(pObject != nullptr);
 
-	output.onGcDiscoveryFn = onGcDiscoveryFn;
-	output.onGcDisposeFn = onGcDisposeFn;
-	output.pGc = &gc;
 	output.pPrev = nullptr;
 	output.pNext = nullptr;
 	output.pObject = pObject;
 	output.markId = 0;
+	output.rememberedIndex = 0;
+	output.type = type;
 	output.pending = false;
 	output.autoMark = autoMark;
 	output.discover = discover;
+	output.old = false;
+	output.remembered = false;
 
 	HqGarbageCollector::LinkObject(gc, &output);
 }
@@ -22,6 +22,7 @@
 
 #include "../Harlequin.h"
 
+#include "../common/Array.hpp"
 #include "../common/DisposeCallback.hpp"
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -29,25 +30,58 @@
 struct HqGarbageCollector;
 
 typedef void (*HqGcDiscoveryCallback)(HqGarbageCollector&, void*);
+typedef size_t (*HqGcStorageSizeCallback)(void*);
 
 //----------------------------------------------------------------------------------------------------------------------
 
 struct HqGcProxy
 {
+	typedef HqArray<HqGcProxy*> PtrArray;
+
+	enum class Type : uint8_t
+	{
+		Value,
+		Execution,
+
+		Count,
+	};
+
+	struct TypeInfo
+	{
+		HqGcDiscoveryCallback onDiscoveryFn;
+		HqDisposeCallback onDisposeFn;
+
+		// Returns the size of any backing storage the object owns on top of its own size. This is optional
+		// since not every type owns storage that is worth counting toward the heap size.
+		HqGcStorageSizeCallback onGetStorageSizeFn;
+
+		size_t size;
+
+		// Types that can't have their references read while their owner is running on another thread are
+		// skipped by a concurrent mark. They get discovered by the remark phase once every script has parked.
+		bool concurrentDiscovery;
+	};
+
 	static void Initialize(
 		HqGcProxy& output,
 		HqGarbageCollector& gc,
-		HqGcDiscoveryCallback onGcDiscoveryFn,
-		HqDisposeCallback onGcDisposeFn,
+		Type type,
 		void* pObject,
 		bool autoMark,
 		bool discover
 	);
 
-	HqGcDiscoveryCallback onGcDiscoveryFn;
-	HqDisposeCallback onGcDisposeFn;
+	static void Discover(HqGarbageCollector& gc, HqGcProxy* const pGcProxy);
+	static void Dispose(HqGcProxy* const pGcProxy);
+
+	static bool CanDiscoverConcurrently(HqGcProxy* const pGcProxy);
 
-	HqGarbageCollector* pGc;
+	static size_t GetSize(HqGcProxy* const pGcProxy);
+	static size_t GetStorageSize(HqGcProxy* const pGcProxy);
+
+	// The callbacks are shared by every object of the same type, so they're kept out
+	// of the proxy itself. This keeps the per-object overhead of the GC down.
+	static const TypeInfo typeInfo[size_t(Type::Count)];
 
 	HqGcProxy* pPrev;
 	HqGcProxy* pNext;
@@ -55,10 +89,52 @@ struct HqGcProxy
 	void* pObject;
 
 	uint32_t markId;
+	uint32_t rememberedIndex;
+
+	Type type;
 
 	bool pending;
 	bool autoMark;
 	bool discover;
+	bool old;
+	bool remembered;
 };
 
 //----------------------------------------------------------------------------------------------------------------------
+
+inline void HqGcProxy::Discover(HqGarbageCollector& gc, HqGcProxy* const pGcProxy)
+{
+	typeInfo[size_t(pGcProxy->type)].onDiscoveryFn(gc, pGcProxy->pObject);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline void HqGcProxy::Dispose(HqGcProxy* const pGcProxy)
+{
+	typeInfo[size_t(pGcProxy->type)].onDisposeFn(pGcProxy->pObject);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline bool HqGcProxy::CanDiscoverConcurrently(HqGcProxy* const pGcProxy)
+{
+	return typeInfo[size_t(pGcProxy->type)].concurrentDiscovery;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline size_t HqGcProxy::GetSize(HqGcProxy* const pGcProxy)
+{
+	return typeInfo[size_t(pGcProxy->type)].size + GetStorageSize(pGcProxy);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline size_t HqGcProxy::GetStorageSize(HqGcProxy* const pGcProxy)
+{
+	const HqGcStorageSizeCallback onGetStorageSizeFn = typeInfo[size_t(pGcProxy->type)].onGetStorageSizeFn;
+
+	return onGetStorageSizeFn ? onGetStorageSizeFn(pGcProxy->pObject) : 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -113,6 +113,85 @@ int HqVmRunGarbageCollector(HqVmHandle hVm, const int runMode)
 
 //----------------------------------------------------------------------------------------------------------------------
 
+int HqVmGetGcStats(HqVmHandle hVm, HqGcStats* const pOutStats)
+{
+	if(!hVm || !pOutStats)
+	{
+		return HQ_ERROR_INVALID_ARG;
+	}
+
+	HqGarbageCollector::GetStats(hVm->gc, *pOutStats);
+
+	return HQ_SUCCESS;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int HqVmStartSampleProfiler(HqVmHandle hVm, const uint32_t intervalMs, const bool includeOffsets)
+{
+	if(!hVm || intervalMs == 0)
+	{
+		return HQ_ERROR_INVALID_ARG;
+	}
+
+	HqScopedMutex vmLock(hVm->lock);
+
+	if(hVm->sampleProfiler.isRunning)
+	{
+		return HQ_ERROR_INVALID_OPERATION;
+	}
+
+	HqSampleProfiler::Start(hVm->sampleProfiler, intervalMs, includeOffsets);
+
+	return HQ_SUCCESS;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int HqVmStopSampleProfiler(HqVmHandle hVm)
+{
+	if(!hVm)
+	{
+		return HQ_ERROR_INVALID_ARG;
+	}
+
+	HqScopedMutex vmLock(hVm->lock);
+
+	HqSampleProfiler::Stop(hVm->sampleProfiler);
+
+	return HQ_SUCCESS;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int HqVmClearSampleProfile(HqVmHandle hVm)
+{
+	if(!hVm)
+	{
+		return HQ_ERROR_INVALID_ARG;
+	}
+
+	HqSampleProfiler::Clear(hVm->sampleProfiler);
+
+	return HQ_SUCCESS;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int HqVmWriteSampleProfile(HqVmHandle hVm, HqCallbackIterateString onLineFn, void* pUserData)
+{
+	if(!hVm || !onLineFn)
+	{
+		return HQ_ERROR_INVALID_ARG;
+	}
+
+	HqSampleProfiler::Write(hVm->sampleProfiler, onLineFn, pUserData);
+
+	return HQ_SUCCESS;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 int HqVmGetReportHandle(HqVmHandle hVm, HqReportHandle* phOutReport)
 {
 	if(!hVm || !phOutReport || *phOutReport)
@@ -318,7 +397,7 @@ int HqVmGetGlobalVariableCount(HqVmHandle hVm, size_t* pOutCount)
 		return HQ_ERROR_INVALID_ARG;
 	}
 
-	(*pOutCount) = hVm->globals.count;
+	(*pOutCount) = hVm->globalValues.count;
 
 	return HQ_SUCCESS;
 }
@@ -333,10 +412,10 @@ int HqVmListGlobalVariables(HqVmHandle hVm, HqCallbackIterateVariable onIterateF
 	}
 
 	// Call the callback for each global variable we currently have loaded.
-	HqValue::StringToHandleMap::Iterator iter;
-	while(HqValue::StringToHandleMap::IterateNext(hVm->globals, iter))
+	HqVm::GlobalSlotMap::Iterator iter;
+	while(HqVm::GlobalSlotMap::IterateNext(hVm->globalSlots, iter))
 	{
-		if(!onIterateFn(pUserData, iter.pData->key->data, iter.pData->value))
+		if(!onIterateFn(pUserData, iter.pData->key->data, hVm->globalValues.pData[iter.pData->value]))
 		{
 			break;
 		}
@@ -912,13 +991,19 @@ int HqFunctionDisassemble(HqFunctionHandle hFunction, HqCallbackOpDisasm onDisas
 	disasm.onDisasmFn = onDisasmFn;
 	disasm.pUserData = pUserData;
 
-	HqDecoder::Initialize(disasm.decoder, hFunction->hModule->code.pData, hFunction->bytecodeOffsetStart);
+	HqDecoder::Initialize(
+		disasm.decoder,
+		hFunction->hModule->code.pData,
+		hFunction->bytecodeOffsetStart,
+		hFunction->bytecodeOffsetEnd,
+		hFunction->hModule->encoding
+	);
 
 	// Iterate through each instruction.
-	for(;;)
+	while(disasm.decoder.ip < disasm.decoder.pEnd)
 	{
 		const uintptr_t offset = uintptr_t(disasm.decoder.ip - hFunction->hModule->code.pData);
-		const uint8_t opCode = HqDecoder::LoadUint8(disasm.decoder);
+		const uint32_t opCode = HqDecoder::LoadOpCode(disasm.decoder);
 
 		disasm.opcodeOffset = offset;
 
@@ -976,6 +1061,7 @@ int HqExecutionDispose(HqExecutionHandle* phExecution)
 	}
 
 	HqScopedMutex vmLock(hVm->lock);
+	HqScopedReadLock gcLock(hVm->gc.rwLock, hVm->isGcThreadEnabled);
 
 	// Remove the execution context from the VM, then dispose of it.
 	HqVm::DetachExec(hVm, hExec);
@@ -1325,6 +1411,110 @@ int HqExecutionGetIoRegister(HqExecutionHandle hExec, HqValueHandle* phOutValue,
 
 //----------------------------------------------------------------------------------------------------------------------
 
+int HqExecutionSetProfilingEnabled(HqExecutionHandle hExec, const bool enabled)
+{
+	if(!hExec)
+	{
+		return HQ_ERROR_INVALID_ARG;
+	}
+	else if(HqFiber::IsRunning(hExec->mainFiber))
+	{
+		return HQ_ERROR_INVALID_OPERATION;
+	}
+
+	if(enabled && !hExec->pProfiler)
+	{
+		hExec->pProfiler = HqProfiler::Create();
+	}
+
+	// Disabling the profiler keeps anything recorded so far so it can still be queried.
+	hExec->isProfiling = enabled;
+
+	return HQ_SUCCESS;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int HqExecutionResetProfile(HqExecutionHandle hExec)
+{
+	if(!hExec)
+	{
+		return HQ_ERROR_INVALID_ARG;
+	}
+	else if(HqFiber::IsRunning(hExec->mainFiber))
+	{
+		return HQ_ERROR_INVALID_OPERATION;
+	}
+
+	if(hExec->pProfiler)
+	{
+		HqProfiler::Reset(hExec->pProfiler);
+	}
+
+	return HQ_SUCCESS;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int HqExecutionGetProfile(
+	HqExecutionHandle hExec,
+	HqCallbackIterateOpCodeProfile onOpCodeFn,
+	HqCallbackIterateFunctionProfile onFunctionFn,
+	void* pUserData)
+{
+	if(!hExec || (!onOpCodeFn && !onFunctionFn))
+	{
+		return HQ_ERROR_INVALID_ARG;
+	}
+	else if(HqFiber::IsRunning(hExec->mainFiber))
+	{
+		return HQ_ERROR_INVALID_OPERATION;
+	}
+
+	HqProfiler* const pProfiler = hExec->pProfiler;
+	if(!pProfiler)
+	{
+		// Nothing has been profiled yet.
+		return HQ_SUCCESS;
+	}
+
+	if(onOpCodeFn)
+	{
+		for(size_t opCode = 0; opCode < HQ_OP_CODE__TOTAL_COUNT; ++opCode)
+		{
+			const HqProfileCounter& counter = pProfiler->opCodes[opCode];
+
+			// Skip any opcodes that were never run.
+			if(counter.count == 0)
+			{
+				continue;
+			}
+
+			if(!onOpCodeFn(pUserData, hExec->hVm->opCodes.pData[opCode].mnemonic, &counter))
+			{
+				break;
+			}
+		}
+	}
+
+	if(onFunctionFn)
+	{
+		for(size_t index = 0; index < pProfiler->functions.count; ++index)
+		{
+			const HqProfiler::FunctionEntry& entry = pProfiler->functions.pData[index];
+
+			if(!onFunctionFn(pUserData, entry.hFunction, &entry.counter))
+			{
+				break;
+			}
+		}
+	}
+
+	return HQ_SUCCESS;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 int HqFrameGetFunction(HqFrameHandle hFrame, HqFunctionHandle* phOutFunction)
 {
 	if(!hFrame || !phOutFunction || (*phOutFunction))
@@ -1351,7 +1541,7 @@ int HqFrameGetBytecodeOffset(HqFrameHandle hFrame, uint32_t* pOutOffset)
 		return HQ_ERROR_INVALID_TYPE;
 	}
 
-	(*pOutOffset) = uint32_t(hFrame->decoder.cachedIp - hFrame->hFunction->hModule->code.pData);
+	(*pOutOffset) = hFrame->pInstruction->offset;
 
 	return HQ_SUCCESS;
 }
@@ -1394,7 +1584,7 @@ int HqFramePopValue(HqFrameHandle hFrame, HqValueHandle* phOutValue)
 
 	// We need to lock the GC because it can potentially be running on another
 	// thread and clean up the popped value before it can be auto-marked.
-	HqScopedWriteLock gcLock(hFrame->hExec->hVm->gc.rwLock, hFrame->hExec->hVm->isGcThreadEnabled);
+	HqScopedGcSafepoint gcLock(hFrame->hExec->hVm->gc, hFrame->hExec->hVm->isGcThreadEnabled);
 
 	HqValueHandle hValue = HQ_VALUE_HANDLE_NULL;
 	int result = HqFrame::PopValue(hFrame, &hValue);
@@ -2270,6 +2460,7 @@ int HqValueSetObjectMemberValue(HqValueHandle hValue, const char* memberName, Hq
 	// Release the member name string now that we don't need it anymore.
 	HqString::Release(pMemberName);
 
+	HqGarbageCollector::WriteBarrier(hValue->hVm->gc, &hValue->gcProxy);
 	HqScriptObject::SetMemberValue(pScriptObject, memberDef.bindingIndex, hMemberValue);
 
 	return HQ_SUCCESS;
@@ -2371,7 +2562,9 @@ int HqValueSetArrayElement(HqValueHandle hValue, size_t index, HqValueHandle hEl
 		return HQ_ERROR_INDEX_OUT_OF_RANGE;
 	}
 
-	hValue->as.array.pData[index] = hElementValue;
+	HqGarbageCollector::WriteBarrier(hValue->hVm->gc, &hValue->gcProxy);
+
+	HqValue::StoreElement(&hValue->as.array.pData[index], hElementValue);
 
 	return HQ_SUCCESS;
 }
@@ -2460,7 +2653,9 @@ int HqValueSetGridElement(
 
 	const size_t finalIndex = HqValue::CalculateGridIndex(lengthX, lengthY, indexX, indexY, indexZ);
 
-	hValue->as.array.pData[finalIndex] = hElementValue;
+	HqGarbageCollector::WriteBarrier(hValue->hVm->gc, &hValue->gcProxy);
+
+	HqValue::StoreElement(&hValue->as.array.pData[finalIndex], hElementValue);
 
 	return HQ_SUCCESS;
 }
@@ -0,0 +1,79 @@
+//
+// Copyright (c) 2021, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#pragma once
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#include "../Harlequin.h"
+
+#include "../common/Array.hpp"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#define HQ_INSTRUCTION_MAX_OPERANDS 5
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct HqString;
+struct HqInstruction;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+union HqOperand
+{
+	HqInstruction* pTarget;
+	HqString* pString;
+	HqFunctionHandle hFunction;
+
+	uint32_t index;
+	int32_t offset;
+
+	bool boolean;
+
+	int8_t int8;
+	int16_t int16;
+	int32_t int32;
+	int64_t int64;
+
+	uint8_t uint8;
+	uint16_t uint16;
+	uint32_t uint32;
+	uint64_t uint64;
+
+	float float32;
+	double float64;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct HqInstruction
+{
+	typedef void (*ExecuteCallback)(HqExecutionHandle);
+
+	typedef HqArray<HqInstruction> Array;
+
+	ExecuteCallback execFn;
+
+	uint32_t opCode;
+	uint32_t offset;
+
+	HqOperand operands[HQ_INSTRUCTION_MAX_OPERANDS];
+};
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -24,12 +24,15 @@
 #include "../base/ModuleLoader.hpp"
 #include "../base/Mutex.hpp"
 
+#include "../common/Atomic.hpp"
 #include "../common/OpCodeEnum.hpp"
 
 #include <assert.h>
+#include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
 
+
 //----------------------------------------------------------------------------------------------------------------------
 
 HqModuleHandle HqModule::Create(HqVmHandle hVm, HqString* const pModuleName, const char* const filePath)
@@ -210,26 +213,25 @@ inline bool HqModule::_init(HqVmHandle hVm, HqReportHandle hReport, HqModuleHand
 	assert(hModule != HQ_MODULE_HANDLE_NULL);
 	assert(pModuleName != nullptr);
 
-	auto endianSwapBytecode = [&hVm](uint8_t* const pBytecode, const uint32_t offset)
+	auto endianSwapBytecode = [&hVm, &loader](uint8_t* const pBytecode, const uint32_t offsetStart, const uint32_t offsetEnd)
 	{
 		assert(pBytecode != nullptr);
 
 		HqDecoder decoder;
-		HqDecoder::Initialize(decoder, pBytecode, offset);
+		HqDecoder::Initialize(decoder, pBytecode, offsetStart, offsetEnd, loader.bytecodeEncoding);
 
-		// Iterate through each instruction in the bytecode.
-		for(;;)
+		// Iterate through each instruction in the function's bytecode. All of it needs to be swapped
+		// since the pre-decode pass will read every instruction, not just those before the first RETURN.
+		while(decoder.ip < decoder.pEnd && !decoder.invalid)
 		{
-			const uint8_t opCode = HqDecoder::EndianSwapUint8(decoder);
-
-			HqVm::EndianSwapOpCode(hVm, decoder, opCode);
-
-			if(opCode == HQ_OP_CODE_RETURN)
+			const uint32_t opCode = HqDecoder::EndianSwapOpCode(decoder);
+			if(opCode >= HQ_OP_CODE__TOTAL_COUNT)
 			{
-				// The RETURN opcode indicates the end of the function,
-				// so we don't care about any bytecode after this.
+				// We can't know the size of an invalid instruction, so nothing after it can be swapped.
 				break;
 			}
+
+			HqVm::EndianSwapOpCode(hVm, decoder, opCode);
 		}
 	};
 
@@ -240,6 +242,7 @@ inline bool HqModule::_init(HqVmHandle hVm, HqReportHandle hReport, HqModuleHand
 	hModule->hDll = HQ_DLL_HANDLE_NULL;
 	hModule->pDllEntryPoint = nullptr;
 	hModule->pName = pModuleName;
+	hModule->encoding = loader.bytecodeEncoding;
 
 	// Initialize the module data maps.
 	HqValue::StringToBoolMap::Allocate(hModule->dependencies);
@@ -251,6 +254,77 @@ inline bool HqModule::_init(HqVmHandle hVm, HqReportHandle hReport, HqModuleHand
 	StringArray::Initialize(hModule->strings);
 	HqByteHelper::Array::Initialize(hModule->code);
 
+	const uint32_t initOffsetStart = uint32_t(loader.bytecode.count);
+	const uint32_t initOffsetEnd = uint32_t(loader.bytecode.count + loader.initBytecode.count);
+
+	// Reserve enough space for both the general bytecode and init bytecode.
+	// This is so we can concatenate them together for the runtime code.
+	HqByteHelper::Array::Reserve(hModule->code, initOffsetEnd);
+
+	// Copy all bytecode into the module.
+	memcpy(hModule->code.pData, loader.bytecode.pData, loader.bytecode.count);
+	memcpy(hModule->code.pData + initOffsetStart, loader.initBytecode.pData, loader.initBytecode.count);
+
+	hModule->code.count = initOffsetEnd;
+
+	// Verify the bytecode of each script function is contained within the module's bytecode.
+	for(size_t funcIndex = 0; funcIndex < loader.functions.count; ++funcIndex)
+	{
+		const HqModuleLoader::Function& func = loader.functions.pData[funcIndex];
+
+		if(!func.isNative && uint64_t(func.offset) + uint64_t(func.length) > uint64_t(loader.bytecode.count))
+		{
+			HqReportMessage(
+				hReport,
+				HQ_MESSAGE_TYPE_ERROR,
+				"Function bytecode is out of range: module='%s', function='%s', offset=%" PRIu32 ", length=%" PRIu32 ", bytecodeLength=%zu",
+				pModuleName->data,
+				func.pSignature->data,
+				func.offset,
+				func.length,
+				loader.bytecode.count
+			);
+			return false;
+		}
+	}
+
+	if(needEndianSwap)
+	{
+		uint8_t* const pBytecode = hModule->code.pData;
+
+		// Endian swap the init function.
+		endianSwapBytecode(pBytecode, initOffsetStart, initOffsetEnd);
+
+		// Endian swap each non-native function.
+		for(size_t funcIndex = 0; funcIndex < loader.functions.count; ++funcIndex)
+		{
+			const HqModuleLoader::Function& func = loader.functions.pData[funcIndex];
+
+			if(!func.isNative)
+			{
+				endianSwapBytecode(pBytecode, func.offset, func.offset + func.length);
+			}
+		}
+	}
+
+	// Make sure every instruction fits inside its function before anything from the module is added to the VM.
+	{
+		if(!_validateBytecode(hVm, hReport, hModule, initOffsetStart, initOffsetEnd))
+		{
+			return false;
+		}
+
+		for(size_t funcIndex = 0; funcIndex < loader.functions.count; ++funcIndex)
+		{
+			const HqModuleLoader::Function& func = loader.functions.pData[funcIndex];
+
+			if(!func.isNative && !_validateBytecode(hVm, hReport, hModule, func.offset, func.offset + func.length))
+			{
+				return false;
+			}
+		}
+	}
+
 	// This block needs to lock the garbage collector since we'll be manipulating
 	// the VM and adding garbage collected resources.
 	{
@@ -314,9 +388,9 @@ inline bool HqModule::_init(HqVmHandle hVm, HqReportHandle hReport, HqModuleHand
 				HqValue::StringToBoolMap::Insert(hModule->globals, pVarName, false);
 				HqString::AddRef(pVarName);
 
-				// Add the global variable to the VM.
-				HqValue::StringToHandleMap::Insert(hVm->globals, pVarName, HQ_VALUE_HANDLE_NULL);
-				HqString::AddRef(pVarName);
+				// Add the global variable to the VM. This assigns it a permanent slot in the
+				// VM's global value table that instructions can reference directly.
+				HqVm::RegisterGlobalVariable(hVm, pVarName);
 			}
 		}
 
@@ -342,7 +416,11 @@ inline bool HqModule::_init(HqVmHandle hVm, HqReportHandle hReport, HqModuleHand
 
 			// Create the new object schema. This call will internally add a reference to the object type name
 			// and each member name. This means we don't need to explicitly add references to those strings here.
-			HqScriptObject* const pObjSchema = HqScriptObject::CreateSchema(type.pName, objMemberDefs);
+			HqScriptObject* const pObjSchema = HqScriptObject::CreateSchema(
+				hVm->pSlabAllocator,
+				type.pName,
+				objMemberDefs
+			);
 
 			// Dispose of the object member map since it's no longer needed.
 			HqScriptObject::MemberDefinitionMap::Dispose(objMemberDefs);
@@ -370,53 +448,67 @@ inline bool HqModule::_init(HqVmHandle hVm, HqReportHandle hReport, HqModuleHand
 			}
 			else
 			{
-				HqGuardedBlock::PtrArray guardedBlocks;
-				HqGuardedBlock::PtrArray::Initialize(guardedBlocks);
-				HqGuardedBlock::PtrArray::Reserve(guardedBlocks, func.guardedBlocks.count);
+				HqExceptionTable exceptionTable;
+				HqExceptionTable::Initialize(exceptionTable);
+
+				HqExceptionTable::RangeArray::Reserve(exceptionTable.ranges, func.exceptionRanges.count);
+				HqExceptionTable::HandlerArray::Reserve(exceptionTable.handlers, func.exceptionHandlers.count);
 
-				guardedBlocks.count = func.guardedBlocks.count;
+				exceptionTable.ranges.count = func.exceptionRanges.count;
+				exceptionTable.handlers.count = func.exceptionHandlers.count;
 
-				// Construct the guarded blocks for the function.
-				for(size_t blockIndex = 0; blockIndex < func.guardedBlocks.count; ++blockIndex)
+				// Copy the exception ranges that were flattened by the module loader.
+				for(size_t rangeIndex = 0; rangeIndex < func.exceptionRanges.count; ++rangeIndex)
 				{
-					const HqModuleLoader::Function::GuardedBlock& block = func.guardedBlocks.pData[blockIndex];
+					const HqModuleLoader::Function::ExceptionRange& inputRange = func.exceptionRanges.pData[rangeIndex];
+					HqExceptionTable::Range& outputRange = exceptionTable.ranges.pData[rangeIndex];
 
-					HqGuardedBlock::ExceptionHandlerArray exceptionHandlers;
-					HqGuardedBlock::ExceptionHandlerArray::Initialize(exceptionHandlers);
-					HqGuardedBlock::ExceptionHandlerArray::Reserve(exceptionHandlers, block.exceptionHandlers.count);
+					outputRange.bytecodeOffsetStart = inputRange.offsetStart;
+					outputRange.bytecodeOffsetEnd = inputRange.offsetEnd;
+					outputRange.firstHandler = inputRange.firstHandler;
+					outputRange.handlerCount = inputRange.handlerCount;
+				}
+
+				// Setup the exception handlers, resolving the schema of each handled object type that has already
+				// been loaded into the VM. This includes the object types from the current module.
+				for(size_t handlerIndex = 0; handlerIndex < func.exceptionHandlers.count; ++handlerIndex)
+				{
+					const HqModuleLoader::Function::GuardedBlock::ExceptionHandler& inputHandler = func.exceptionHandlers.pData[handlerIndex];
+					HqExceptionTable::Handler& outputHandler = exceptionTable.handlers.pData[handlerIndex];
 
-					exceptionHandlers.count = block.exceptionHandlers.count;
+					outputHandler.pClassName = inputHandler.pClassName;
+					outputHandler.pSchema = nullptr;
+					outputHandler.offset = inputHandler.offset;
+					outputHandler.type = inputHandler.type;
 
-					// Setup the exception handlers for the current guarded block.
-					for(size_t handlerIndex = 0; handlerIndex < block.exceptionHandlers.count; ++handlerIndex)
+					if(outputHandler.pClassName)
 					{
-						const HqModuleLoader::Function::GuardedBlock::ExceptionHandler& inputHandler = block.exceptionHandlers.pData[handlerIndex];
-						HqGuardedBlock::ExceptionHandler& outputHandler = exceptionHandlers.pData[handlerIndex];
+						HqString::AddRef(outputHandler.pClassName);
 
-						outputHandler.pClassName = inputHandler.pClassName;
-						outputHandler.offset = inputHandler.offset;
-						outputHandler.type = inputHandler.type;
+						int getSchemaResult = HQ_SUCCESS;
+						outputHandler.pSchema = HqVm::GetObjectSchema(hVm, outputHandler.pClassName, &getSchemaResult);
 					}
-
-					// Create the new guarded block. This will implicitly add a reference to each exception handler class name.
-					guardedBlocks.pData[blockIndex] = HqGuardedBlock::Create(exceptionHandlers, block.offset, block.length);
-
-					HqGuardedBlock::ExceptionHandlerArray::Dispose(exceptionHandlers);
 				}
 
-				// Create the new script function. This will implicitly add a reference to
-				// the signature and copy all guarded blocks to its own internal array.
+				// Create the new script function. This will implicitly add a reference
+				// to the signature and take ownership of the exception table.
+				HqFunction::FrameSize frameSize;
+				frameSize.gpRegisterCount = func.gpRegisterCount;
+				frameSize.vrRegisterCount = func.vrRegisterCount;
+				frameSize.stackSize = func.stackSize;
+
 				hFunc = HqFunction::CreateScript(
 					hModule, 
 					func.pSignature, 
-					guardedBlocks, 
+					exceptionTable, 
 					func.offset, 
-					func.offset + func.length, 
+					func.length, 
 					func.numInputs, 
-					func.numOutputs
+					func.numOutputs,
+					frameSize
 				);
 
-				HqGuardedBlock::PtrArray::Dispose(guardedBlocks);
+				hFunc->usesRegisterWindow = (loader.callingConvention == HQ_CALLING_CONVENTION_REGISTER_WINDOW);
 			}
 
 			// Add the function to the module.
@@ -427,24 +519,15 @@ inline bool HqModule::_init(HqVmHandle hVm, HqReportHandle hReport, HqModuleHand
 			HqFunction::StringToHandleMap::Insert(hVm->functions, func.pSignature, hFunc);
 			HqString::AddRef(func.pSignature);
 		}
-	}
 
-	// Reserve enough space for both the general bytecode and init bytecode.
-	// This is so we can concatenate them together for the runtime code.
-	HqByteHelper::Array::Reserve(hModule->code, loader.bytecode.count + loader.initBytecode.count);
-
-	// Copy all bytecode into the module.
-	memcpy(hModule->code.pData, loader.bytecode.pData, loader.bytecode.count);
-	memcpy(hModule->code.pData + loader.bytecode.count, loader.initBytecode.pData, loader.initBytecode.count);
+		// The VM function table has changed, so any function lookups cached by call sites are no longer valid.
+		HqAtomic::StoreRelease(&hVm->functionGeneration, hVm->functionGeneration + 1);
+	}
 
-	if(needEndianSwap)
+	// Translate the bytecode of each function into its pre-decoded instruction stream.
 	{
-		uint8_t* const pBytecode = hModule->code.pData;
+		_decodeFunction(hVm, hModule, hModule->hInitFunction);
 
-		// Endian swap the init function.
-		endianSwapBytecode(pBytecode, hModule->hInitFunction->bytecodeOffsetStart);
-
-		// Endian swap each non-native function.
 		HqFunction::StringToHandleMap::Iterator iter;
 		while(HqFunction::StringToHandleMap::IterateNext(hModule->functions, iter))
 		{
@@ -452,7 +535,7 @@ inline bool HqModule::_init(HqVmHandle hVm, HqReportHandle hReport, HqModuleHand
 
 			if(hFunc->type != HqFunction::Type::Native)
 			{
-				endianSwapBytecode(pBytecode, hFunc->bytecodeOffsetStart);
+				_decodeFunction(hVm, hModule, hFunc);
 			}
 		}
 	}
@@ -599,7 +682,7 @@ inline bool HqModule::_verify(HqVmHandle hVm, HqReportHandle hReport, HqModuleLo
 	{
 		HqString* const pVarName = loader.globals.pData[varIndex];
 
-		if(HqValue::StringToHandleMap::Contains(hVm->globals, pVarName))
+		if(HqVm::GetGlobalSlot(hVm, pVarName) != HQ_VM_GLOBAL_SLOT_INVALID)
 		{
 			HqReportMessage(
 				hReport,
@@ -653,6 +736,146 @@ inline bool HqModule::_verify(HqVmHandle hVm, HqReportHandle hReport, HqModuleLo
 
 //----------------------------------------------------------------------------------------------------------------------
 
+bool HqModule::_validateBytecode(
+	HqVmHandle hVm,
+	HqReportHandle hReport,
+	HqModuleHandle hModule,
+	const uint32_t offsetStart,
+	const uint32_t offsetEnd)
+{
+	assert(hVm != HQ_VM_HANDLE_NULL);
+	assert(hModule != HQ_MODULE_HANDLE_NULL);
+
+	uint8_t* const pBytecode = hModule->code.pData;
+
+	HqDecoder decoder;
+	HqDecoder::Initialize(decoder, pBytecode, offsetStart, offsetEnd, hModule->encoding);
+
+	// Decode each instruction without keeping the result. This is only done to catch operands
+	// that would be read from outside the function before the real decode pass happens.
+	while(decoder.ip < decoder.pEnd)
+	{
+		const uint32_t instrOffset = uint32_t(decoder.ip - pBytecode);
+
+		HqInstruction instr;
+		memset(&instr, 0, sizeof(instr));
+
+		instr.opCode = HqDecoder::LoadOpCode(decoder);
+
+		if(!decoder.invalid && instr.opCode < HQ_OP_CODE__TOTAL_COUNT)
+		{
+			HqVm::DecodeOpCode(hVm, instr, decoder, hModule);
+		}
+
+		if(decoder.invalid)
+		{
+			HqReportMessage(
+				hReport,
+				HQ_MESSAGE_TYPE_ERROR,
+				"Malformed instruction: module='%s', offset=%" PRIu32 ", functionOffsetEnd=%" PRIu32,
+				hModule->pName->data,
+				instrOffset,
+				offsetEnd
+			);
+			return false;
+		}
+
+		if(instr.opCode >= HQ_OP_CODE__TOTAL_COUNT)
+		{
+			// Nothing after an invalid opcode is decoded.
+			break;
+		}
+	}
+
+	return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqModule::_decodeFunction(HqVmHandle hVm, HqModuleHandle hModule, HqFunctionHandle hFunction)
+{
+	assert(hVm != HQ_VM_HANDLE_NULL);
+	assert(hModule != HQ_MODULE_HANDLE_NULL);
+	assert(hFunction != HQ_FUNCTION_HANDLE_NULL);
+
+	uint8_t* const pBytecode = hModule->code.pData;
+
+	HqDecoder decoder;
+	HqDecoder::Initialize(decoder, pBytecode, hFunction->bytecodeOffsetStart, hFunction->bytecodeOffsetEnd, hModule->encoding);
+
+	HqInstruction::Array& instructions = hFunction->instructions;
+	HqInstruction::Array::Initialize(instructions);
+
+	auto pushInstruction = [&instructions](const HqInstruction& instr)
+	{
+		HqInstruction::Array::Reserve(instructions, instructions.count + 1);
+
+		instructions.pData[instructions.count] = instr;
+		++instructions.count;
+	};
+
+	while(decoder.ip < decoder.pEnd)
+	{
+		HqInstruction instr;
+		memset(&instr, 0, sizeof(instr));
+
+		instr.offset = uint32_t(decoder.ip - pBytecode);
+		instr.opCode = HqDecoder::LoadOpCode(decoder);
+
+		if(instr.opCode >= HQ_OP_CODE__TOTAL_COUNT)
+		{
+			// Invalid opcodes are left without a handler so they raise an exception if they're ever reached.
+			// Since the size of an invalid instruction is unknown, there is nothing more we can decode.
+			pushInstruction(instr);
+			break;
+		}
+
+		HqVm::DecodeOpCode(hVm, instr, decoder, hModule);
+		pushInstruction(instr);
+	}
+
+	// The bytecode was validated before the module was initialized.
+	assert(!decoder.invalid);
+
+	// Terminate the stream with an invalid instruction to catch execution falling off the end of the function.
+	{
+		HqInstruction instr;
+		memset(&instr, 0, sizeof(instr));
+
+		instr.offset = hFunction->bytecodeOffsetEnd;
+		instr.opCode = HQ_OP_CODE__TOTAL_COUNT;
+
+		pushInstruction(instr);
+	}
+
+	// Now that the instruction array will no longer be resized, resolve the targets of all jump instructions.
+	for(size_t i = 0; i < instructions.count; ++i)
+	{
+		HqInstruction& instr = instructions.pData[i];
+
+		size_t operandIndex;
+		switch(instr.opCode)
+		{
+			case HQ_OP_CODE_JMP:       operandIndex = 0; break;
+			case HQ_OP_CODE_JMP_TRUE:  operandIndex = 1; break;
+			case HQ_OP_CODE_JMP_FALSE: operandIndex = 1; break;
+
+			default:
+				continue;
+		}
+
+		const int64_t targetOffset = int64_t(instr.offset) + int64_t(instr.operands[operandIndex].offset);
+
+		// Jumps that leave the function or land in the middle of an instruction are left unresolved
+		// so the jump will raise an exception when it executes.
+		instr.operands[operandIndex + 1].pTarget = (targetOffset >= hFunction->bytecodeOffsetStart && targetOffset < hFunction->bytecodeOffsetEnd)
+			? HqFunction::FindInstruction(hFunction, uint32_t(targetOffset))
+			: nullptr;
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 void* HqModule::operator new(const size_t sizeInBytes)
 {
 	return HqMemAlloc(sizeInBytes);
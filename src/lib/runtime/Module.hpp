@@ -58,6 +58,8 @@ struct HqModule
 
 	static bool _init(HqVmHandle, HqReportHandle, HqModuleHandle, HqModuleLoader&, HqString*);
 	static bool _verify(HqVmHandle, HqReportHandle, HqModuleLoader&, HqString*);
+	static bool _validateBytecode(HqVmHandle, HqReportHandle, HqModuleHandle, uint32_t, uint32_t);
+	static void _decodeFunction(HqVmHandle, HqModuleHandle, HqFunctionHandle);
 
 	void* operator new(const size_t sizeInBytes);
 	void operator delete(void* const pObject);
@@ -78,6 +80,8 @@ struct HqModule
 	HqDllEntryPoint pDllEntryPoint;
 
 	HqString* pName;
+
+	int encoding;
 };
 
 //----------------------------------------------------------------------------------------------------------------------
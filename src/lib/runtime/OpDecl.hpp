@@ -23,6 +23,7 @@
 #include "../Harlequin.h"
 
 #include "Decoder.hpp"
+#include "Instruction.hpp"
 
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -43,7 +44,8 @@ struct HqDisassemble
 #define HQ_DECLARE_OP_CODE_FN(op_name) \
 	void OpCodeExec_ ## op_name(HqExecutionHandle); \
 	void OpCodeDisasm_ ## op_name(HqDisassemble&); \
-	void OpCodeEndian_ ## op_name(HqDecoder&)
+	void OpCodeEndian_ ## op_name(HqDecoder&); \
+	void OpCodeDecode_ ## op_name(HqInstruction&, HqDecoder&, HqModuleHandle)
 
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -142,6 +144,10 @@ HQ_DECLARE_OP_CODE_FN(Test);
 HQ_DECLARE_OP_CODE_FN(Move);
 HQ_DECLARE_OP_CODE_FN(Copy);
 
+HQ_DECLARE_OP_CODE_FN(CallWindow);
+HQ_DECLARE_OP_CODE_FN(TailCall);
+HQ_DECLARE_OP_CODE_FN(TailCallValue);
+
 //----------------------------------------------------------------------------------------------------------------------
 
 }
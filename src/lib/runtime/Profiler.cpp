@@ -0,0 +1,116 @@
+//
+// Copyright (c) 2021, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include "Profiler.hpp"
+
+#include <assert.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+HqProfiler* HqProfiler::Create()
+{
+	HqProfiler* const pOutput = new HqProfiler();
+	assert(pOutput != nullptr);
+
+	FunctionIndexMap::Initialize(pOutput->functionIndices);
+	FunctionEntryArray::Initialize(pOutput->functions);
+
+	FunctionIndexMap::Allocate(pOutput->functionIndices);
+
+	Reset(pOutput);
+
+	return pOutput;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqProfiler::Dispose(HqProfiler* const pProfiler)
+{
+	assert(pProfiler != nullptr);
+
+	FunctionIndexMap::Dispose(pProfiler->functionIndices);
+	FunctionEntryArray::Dispose(pProfiler->functions);
+
+	delete pProfiler;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqProfiler::Reset(HqProfiler* const pProfiler)
+{
+	assert(pProfiler != nullptr);
+
+	memset(pProfiler->opCodes, 0, sizeof(pProfiler->opCodes));
+
+	FunctionIndexMap::Clear(pProfiler->functionIndices);
+
+	pProfiler->functions.count = 0;
+	pProfiler->hLastFunction = HQ_FUNCTION_HANDLE_NULL;
+	pProfiler->lastFunctionIndex = 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+HqProfileCounter* HqProfiler::_getFunctionCounter(HqProfiler* const pProfiler, HqFunctionHandle hFunction)
+{
+	// Consecutive instructions almost always belong to the same function, so only
+	// changing functions through a call or return will need to go through the map.
+	if(hFunction != pProfiler->hLastFunction)
+	{
+		size_t index = 0;
+
+		if(!FunctionIndexMap::Get(pProfiler->functionIndices, hFunction, index))
+		{
+			index = pProfiler->functions.count;
+
+			FunctionEntryArray::Reserve(pProfiler->functions, index + 1);
+
+			FunctionEntry& entry = pProfiler->functions.pData[index];
+
+			entry.hFunction = hFunction;
+			entry.counter.count = 0;
+			entry.counter.time = 0;
+
+			++pProfiler->functions.count;
+
+			FunctionIndexMap::Insert(pProfiler->functionIndices, hFunction, index);
+		}
+
+		pProfiler->hLastFunction = hFunction;
+		pProfiler->lastFunctionIndex = index;
+	}
+
+	return &pProfiler->functions.pData[pProfiler->lastFunctionIndex].counter;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void* HqProfiler::operator new(const size_t sizeInBytes)
+{
+	return HqMemAlloc(sizeInBytes);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqProfiler::operator delete(void* const pObject)
+{
+	HqMemFree(pObject);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
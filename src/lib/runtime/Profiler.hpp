@@ -0,0 +1,85 @@
+//
+// Copyright (c) 2021, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#pragma once
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#include "../Harlequin.h"
+
+#include "../common/Array.hpp"
+#include "../common/HashMap.hpp"
+#include "../common/OpCodeEnum.hpp"
+
+#include <stdint.h>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct HqProfiler
+{
+	struct FunctionEntry
+	{
+		HqFunctionHandle hFunction;
+		HqProfileCounter counter;
+	};
+
+	typedef HqHashMap<HqFunctionHandle, size_t> FunctionIndexMap;
+	typedef HqArray<FunctionEntry> FunctionEntryArray;
+
+	static HqProfiler* Create();
+	static void Dispose(HqProfiler* pProfiler);
+
+	static void Reset(HqProfiler* pProfiler);
+	static void Record(HqProfiler* pProfiler, HqFunctionHandle hFunction, uint32_t opCode, uint64_t time);
+
+	static HqProfileCounter* _getFunctionCounter(HqProfiler*, HqFunctionHandle);
+
+	void* operator new(const size_t sizeInBytes);
+	void operator delete(void* const pObject);
+
+	HqProfileCounter opCodes[HQ_OP_CODE__TOTAL_COUNT];
+
+	FunctionIndexMap functionIndices;
+	FunctionEntryArray functions;
+
+	HqFunctionHandle hLastFunction;
+	size_t lastFunctionIndex;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline void HqProfiler::Record(
+	HqProfiler* const pProfiler,
+	HqFunctionHandle hFunction,
+	const uint32_t opCode,
+	const uint64_t time
+)
+{
+	if(opCode < HQ_OP_CODE__TOTAL_COUNT)
+	{
+		++pProfiler->opCodes[opCode].count;
+		pProfiler->opCodes[opCode].time += time;
+	}
+
+	HqProfileCounter* const pCounter = _getFunctionCounter(pProfiler, hFunction);
+
+	++pCounter->count;
+	pCounter->time += time;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
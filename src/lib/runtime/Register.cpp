@@ -0,0 +1,112 @@
+//
+// Copyright (c) 2021, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include "Register.hpp"
+#include "Value.hpp"
+
+#include <assert.h>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqRegister::SetValue(HqRegister& reg, HqValueHandle hValue)
+{
+	reg.hValue = hValue;
+
+	if(hValue && hValue->type <= HQ_VALUE_TYPE_BOOL)
+	{
+		// Primitive values are immutable, so it's safe to copy them directly into the register.
+		// This allows instructions that operate on primitives to skip dereferencing the value.
+		reg.as.uint64 = hValue->as.uint64;
+		reg.type = hValue->type;
+	}
+	else
+	{
+		reg.as.uint64 = 0;
+		reg.type = HQ_REGISTER_TYPE_BOXED;
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+HqValueHandle HqRegister::GetValue(HqRegister& reg, HqVmHandle hVm)
+{
+	assert(hVm != HQ_VM_HANDLE_NULL);
+
+	if(reg.hValue || reg.type == HQ_REGISTER_TYPE_BOXED)
+	{
+		return reg.hValue;
+	}
+
+	HqValueHandle hOutput = HQ_VALUE_HANDLE_NULL;
+
+	switch(reg.type)
+	{
+		case HQ_VALUE_TYPE_INT8:    hOutput = HqValue::CreateInt8(hVm, reg.as.int8);       break;
+		case HQ_VALUE_TYPE_INT16:   hOutput = HqValue::CreateInt16(hVm, reg.as.int16);     break;
+		case HQ_VALUE_TYPE_INT32:   hOutput = HqValue::CreateInt32(hVm, reg.as.int32);     break;
+		case HQ_VALUE_TYPE_INT64:   hOutput = HqValue::CreateInt64(hVm, reg.as.int64);     break;
+		case HQ_VALUE_TYPE_UINT8:   hOutput = HqValue::CreateUint8(hVm, reg.as.uint8);     break;
+		case HQ_VALUE_TYPE_UINT16:  hOutput = HqValue::CreateUint16(hVm, reg.as.uint16);   break;
+		case HQ_VALUE_TYPE_UINT32:  hOutput = HqValue::CreateUint32(hVm, reg.as.uint32);   break;
+		case HQ_VALUE_TYPE_UINT64:  hOutput = HqValue::CreateUint64(hVm, reg.as.uint64);   break;
+		case HQ_VALUE_TYPE_FLOAT32: hOutput = HqValue::CreateFloat32(hVm, reg.as.float32); break;
+		case HQ_VALUE_TYPE_FLOAT64: hOutput = HqValue::CreateFloat64(hVm, reg.as.float64); break;
+		case HQ_VALUE_TYPE_BOOL:    hOutput = HqValue::CreateBool(hVm, reg.as.boolean);    break;
+
+		default:
+			assert(false);
+			break;
+	}
+
+	if(hOutput)
+	{
+		// The register now references the boxed value, so it no longer needs to be auto-marked.
+		HqValue::SetAutoMark(hOutput, false);
+
+		reg.hValue = hOutput;
+	}
+
+	return hOutput;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+bool HqRegister::EvaluateAsBoolean(const HqRegister& reg)
+{
+	switch(reg.type)
+	{
+		case HQ_VALUE_TYPE_INT8:    return reg.as.int8 != 0;
+		case HQ_VALUE_TYPE_INT16:   return reg.as.int16 != 0;
+		case HQ_VALUE_TYPE_INT32:   return reg.as.int32 != 0;
+		case HQ_VALUE_TYPE_INT64:   return reg.as.int64 != 0;
+		case HQ_VALUE_TYPE_UINT8:   return reg.as.uint8 != 0;
+		case HQ_VALUE_TYPE_UINT16:  return reg.as.uint16 != 0;
+		case HQ_VALUE_TYPE_UINT32:  return reg.as.uint32 != 0;
+		case HQ_VALUE_TYPE_UINT64:  return reg.as.uint64 != 0;
+		case HQ_VALUE_TYPE_FLOAT32: return reg.as.float32 != 0.0f;
+		case HQ_VALUE_TYPE_FLOAT64: return reg.as.float64 != 0.0;
+		case HQ_VALUE_TYPE_BOOL:    return reg.as.boolean;
+
+		default:
+			break;
+	}
+
+	return HqValue::EvaluateAsBoolean(reg.hValue);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,102 @@
+//
+// Copyright (c) 2021, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#pragma once
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#include "../Harlequin.h"
+
+#include "../common/Array.hpp"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#define HQ_REGISTER_TYPE_BOXED -1
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct HqRegister
+{
+	typedef HqArray<HqRegister> Array;
+
+	union Primitive
+	{
+		double float64;
+		uint64_t uint64;
+		int64_t int64;
+
+		float float32;
+		uint32_t uint32;
+		int32_t int32;
+
+		uint16_t uint16;
+		int16_t int16;
+
+		uint8_t uint8;
+		int8_t int8;
+
+		bool boolean;
+	};
+
+	static void Clear(HqRegister& reg);
+	static void SetPrimitive(HqRegister& reg, const int type, const Primitive& value);
+	static void SetValue(HqRegister& reg, HqValueHandle hValue);
+
+	static HqValueHandle GetValue(HqRegister& reg, HqVmHandle hVm);
+
+	static bool IsPrimitive(const HqRegister& reg);
+	static bool EvaluateAsBoolean(const HqRegister& reg);
+
+	// Boxed value for this register. Primitive values are stored directly in the register and
+	// are only boxed when something needs them as a value handle. When that happens, the box
+	// is cached here so the register continues to resolve to the same handle.
+	HqValueHandle hValue;
+
+	Primitive as;
+
+	// Value type of the primitive stored in the register or HQ_REGISTER_TYPE_BOXED
+	// when the register is either empty or holds a non-primitive value.
+	int type;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline void HqRegister::Clear(HqRegister& reg)
+{
+	reg.hValue = HQ_VALUE_HANDLE_NULL;
+	reg.as.uint64 = 0;
+	reg.type = HQ_REGISTER_TYPE_BOXED;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline void HqRegister::SetPrimitive(HqRegister& reg, const int type, const Primitive& value)
+{
+	reg.hValue = HQ_VALUE_HANDLE_NULL;
+	reg.as = value;
+	reg.type = type;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline bool HqRegister::IsPrimitive(const HqRegister& reg)
+{
+	return reg.type != HQ_REGISTER_TYPE_BOXED;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,268 @@
+//
+// Copyright (c) 2021, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include "SampleProfiler.hpp"
+#include "Execution.hpp"
+#include "Vm.hpp"
+
+#include "../common/Atomic.hpp"
+
+#include <assert.h>
+#include <inttypes.h>
+#include <stdio.h>
+
+#include <algorithm>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// Longest folded stack that will be recorded for a single sample. Anything deeper is cut off at the last frame that fits.
+#define _HQ_SAMPLE_PROFILER_MAX_STACK_LENGTH 4096
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqSampleProfiler::Initialize(HqSampleProfiler& output, HqVmHandle hVm)
+{
+	assert(hVm != HQ_VM_HANDLE_NULL);
+
+	output.hVm = hVm;
+	output.intervalMs = 0;
+	output.isRunning = false;
+	output.includeOffsets = false;
+
+	HqMutex::Create(output.lock);
+
+	StackCountMap::Initialize(output.stacks);
+	StackCountMap::Allocate(output.stacks);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqSampleProfiler::Dispose(HqSampleProfiler& profiler)
+{
+	Stop(profiler);
+	Clear(profiler);
+
+	StackCountMap::Dispose(profiler.stacks);
+
+	HqMutex::Dispose(profiler.lock);
+
+	profiler.hVm = HQ_VM_HANDLE_NULL;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqSampleProfiler::Start(HqSampleProfiler& profiler, const uint32_t intervalMs, const bool includeOffsets)
+{
+	assert(!profiler.isRunning);
+
+	if(includeOffsets != profiler.includeOffsets)
+	{
+		// Stacks recorded with and without offsets can't be mixed, so start over.
+		Clear(profiler);
+	}
+
+	profiler.intervalMs = intervalMs;
+	profiler.includeOffsets = includeOffsets;
+	profiler.isRunning = true;
+
+	HqThreadConfig threadConfig;
+	threadConfig.mainFn = _threadMain;
+	threadConfig.pArg = &profiler;
+	threadConfig.stackSize = HQ_VM_THREAD_MINIMUM_STACK_SIZE;
+	snprintf(threadConfig.name, sizeof(threadConfig.name), "%s", "HqSampleProfiler");
+
+	HqThread::Create(profiler.thread, threadConfig);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqSampleProfiler::Stop(HqSampleProfiler& profiler)
+{
+	if(!profiler.isRunning)
+	{
+		return;
+	}
+
+	profiler.isRunning = false;
+
+	int32_t threadReturnValue = 0;
+	HqThread::Join(profiler.thread, &threadReturnValue);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqSampleProfiler::Clear(HqSampleProfiler& profiler)
+{
+	HqScopedMutex lock(profiler.lock);
+
+	StackCountMap::Iterator iter;
+	while(StackCountMap::IterateNext(profiler.stacks, iter))
+	{
+		HqString::Release(iter.pData->key);
+	}
+
+	StackCountMap::Clear(profiler.stacks);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqSampleProfiler::Write(HqSampleProfiler& profiler, HqCallbackIterateString onLineFn, void* const pUserData)
+{
+	assert(onLineFn != nullptr);
+
+	HqScopedMutex lock(profiler.lock);
+
+	char line[_HQ_SAMPLE_PROFILER_MAX_STACK_LENGTH + 32];
+
+	// Each line is a folded stack followed by the number of times it was sampled, which is the
+	// format expected by flamegraph.pl and most of the tools that read its input.
+	StackCountMap::Iterator iter;
+	while(StackCountMap::IterateNext(profiler.stacks, iter))
+	{
+		snprintf(line, sizeof(line), "%s %" PRIu64, iter.pData->key->data, iter.pData->value);
+
+		if(!onLineFn(pUserData, line))
+		{
+			break;
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int32_t HqSampleProfiler::_threadMain(void* const pArg)
+{
+	HqSampleProfiler* const pProfiler = reinterpret_cast<HqSampleProfiler*>(pArg);
+	assert(pProfiler != nullptr);
+
+	while(pProfiler->isRunning)
+	{
+		HqThread::Sleep(pProfiler->intervalMs);
+
+		_takeSamples(*pProfiler);
+	}
+
+	return HQ_SUCCESS;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqSampleProfiler::_takeSamples(HqSampleProfiler& profiler)
+{
+	HqVmHandle hVm = profiler.hVm;
+
+	// Scripts are sampled while they keep running rather than being stopped at a safepoint. Stopping them would
+	// add a pause to every script on each interval, and it would also bias every sample toward the instructions
+	// that poll for safepoints (calls, backward jumps, and allocations) since scripts can only stop on those.
+	//
+	// Holding the VM lock keeps execution contexts from being created or disposed while they're sampled. The
+	// frames, functions, and instructions reachable from an execution context all stay allocated for as long as
+	// the execution context exists, so reading them while the script changes them can only produce a stack that
+	// is slightly out of date, never an invalid one.
+	//
+	// The VM lock is held while the sampler is being stopped, so this interval is skipped rather than waiting on it.
+	if(!HqMutex::TryLock(hVm->lock))
+	{
+		return;
+	}
+
+	{
+		HqScopedMutex lock(profiler.lock);
+
+		for(size_t i = 0; i < hVm->executionContexts.count; ++i)
+		{
+			HqExecutionHandle hExec = hVm->executionContexts.pData[i];
+
+			// Only executions that are in the middle of running a script are of any interest. The fiber itself can't
+			// be queried here since its owning thread may be disposing and re-creating it at the same time.
+			if(HqAtomic::Load(&hExec->isRunning))
+			{
+				_recordStack(profiler, hExec);
+			}
+		}
+	}
+
+	HqMutex::Unlock(hVm->lock);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqSampleProfiler::_recordStack(HqSampleProfiler& profiler, HqExecutionHandle hExec)
+{
+	char stack[_HQ_SAMPLE_PROFILER_MAX_STACK_LENGTH];
+	size_t length = 0;
+
+	stack[0] = '\0';
+
+	// The script may be pushing and popping frames as they're read, so the depth is only read once and every
+	// field is read a single time with relaxed atomic loads. The frame stack's memory is allocated up front
+	// and never moves, so the depth only needs to be kept within its capacity.
+	const size_t stackDepth = std::min<size_t>(HqAtomic::Load(&hExec->frameStack.nextIndex), hExec->frameStack.memory.count);
+
+	// Folded stacks are written from the root frame to the leaf frame with a semicolon between each one.
+	for(size_t frameIndex = 0; frameIndex < stackDepth; ++frameIndex)
+	{
+		HqFrameHandle hFrame = HqAtomic::Load(&hExec->frameStack.memory.pData[frameIndex]);
+		HqFunctionHandle hFunction = hFrame ? HqAtomic::Load(&hFrame->hFunction) : HQ_FUNCTION_HANDLE_NULL;
+
+		if(!hFunction)
+		{
+			// The frame was popped while the stack was being read, so there's nothing left above it.
+			break;
+		}
+
+		const HqInstruction* const pInstruction = HqAtomic::Load(&hFrame->pInstruction);
+
+		const char* const separator = (frameIndex > 0) ? ";" : "";
+		const size_t remaining = sizeof(stack) - length;
+
+		const int written = (profiler.includeOffsets && hFunction->type != HqFunction::Type::Native && pInstruction)
+			? snprintf(stack + length, remaining, "%s%s+0x%" PRIX32, separator, hFunction->pSignature->data, pInstruction->offset)
+			: snprintf(stack + length, remaining, "%s%s", separator, hFunction->pSignature->data);
+
+		if(written < 0 || size_t(written) >= remaining)
+		{
+			// Drop the partially written frame.
+			stack[length] = '\0';
+			break;
+		}
+
+		length += size_t(written);
+	}
+
+	if(length == 0)
+	{
+		// The script finished before any of its stack could be read.
+		return;
+	}
+
+	HqString* const pStack = HqString::Create(stack);
+
+	uint64_t count = 0;
+	if(StackCountMap::Get(profiler.stacks, pStack, count))
+	{
+		StackCountMap::Set(profiler.stacks, pStack, count + 1);
+		HqString::Release(pStack);
+	}
+	else
+	{
+		StackCountMap::Insert(profiler.stacks, pStack, 1);
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
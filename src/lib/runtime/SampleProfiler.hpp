@@ -0,0 +1,69 @@
+//
+// Copyright (c) 2021, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#pragma once
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#include "../Harlequin.h"
+
+#include "../base/Mutex.hpp"
+#include "../base/String.hpp"
+#include "../base/Thread.hpp"
+
+#include "../common/HashMap.hpp"
+
+#include <stdint.h>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct HqSampleProfiler
+{
+	typedef HqHashMap<
+		HqString*,
+		uint64_t,
+		HqString::StlHash,
+		HqString::StlCompare
+	> StackCountMap;
+
+	static void Initialize(HqSampleProfiler& output, HqVmHandle hVm);
+	static void Dispose(HqSampleProfiler& profiler);
+
+	static void Start(HqSampleProfiler& profiler, uint32_t intervalMs, bool includeOffsets);
+	static void Stop(HqSampleProfiler& profiler);
+	static void Clear(HqSampleProfiler& profiler);
+	static void Write(HqSampleProfiler& profiler, HqCallbackIterateString onLineFn, void* pUserData);
+
+	static int32_t _threadMain(void*);
+	static void _takeSamples(HqSampleProfiler&);
+	static void _recordStack(HqSampleProfiler&, HqExecutionHandle);
+
+	HqVmHandle hVm;
+
+	HqThread thread;
+	HqMutex lock;
+
+	StackCountMap stacks;
+
+	uint32_t intervalMs;
+
+	volatile bool isRunning;
+	bool includeOffsets;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
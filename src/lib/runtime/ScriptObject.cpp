@@ -18,18 +18,26 @@
 
 #include "ScriptObject.hpp"
 
+#include "../base/SlabAllocator.hpp"
+
 #include <assert.h>
 #include <string.h>
 
 //----------------------------------------------------------------------------------------------------------------------
 
-HqScriptObject* HqScriptObject::CreateSchema(HqString* const pTypeName, const MemberDefinitionMap& definitions)
+HqScriptObject* HqScriptObject::CreateSchema(
+	HqSlabAllocator* const pAllocator,
+	HqString* const pTypeName,
+	const MemberDefinitionMap& definitions
+)
 {
 	assert(pTypeName != nullptr);
 
-	HqScriptObject* const pOutput = new HqScriptObject();
+	HqScriptObject* const pOutput = new(pAllocator) HqScriptObject();
 	assert(pOutput != nullptr);
 
+	// Every object created from the schema will use the same allocator.
+	pOutput->pAllocator = pAllocator;
 	pOutput->pTypeName = pTypeName;
 	pOutput->pSchema = nullptr;
 
@@ -110,7 +118,7 @@ void HqScriptObject::Dispose(HqScriptObject* const pObject)
 	HqValue::HandleArray::Dispose(pObject->members);
 	HqString::Release(pObject->pTypeName);
 
-	delete pObject;
+	HqScriptObject::operator delete(pObject, pObject->pAllocator);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -169,7 +177,7 @@ int HqScriptObject::SetMemberValue(HqScriptObject* const pObject, const uint32_t
 
 	if(memberIndex < uint32_t(pObject->members.count))
 	{
-		pObject->members.pData[memberIndex] = hValue;
+		HqValue::StoreElement(&pObject->members.pData[memberIndex], hValue);
 		return HQ_SUCCESS;
 	}
 
@@ -182,9 +190,10 @@ HqScriptObject* HqScriptObject::_createObject(HqScriptObject* const pOriginalObj
 {
 	assert(pOriginalObject != nullptr);
 
-	HqScriptObject* const pOutput = new HqScriptObject();
+	HqScriptObject* const pOutput = new(pOriginalObject->pAllocator) HqScriptObject();
 	assert(pOutput != nullptr);
 
+	pOutput->pAllocator = pOriginalObject->pAllocator;
 	pOutput->pTypeName = pOriginalObject->pTypeName;
 
 	// The schema's definition map will be used instead to save memory.
@@ -212,16 +221,16 @@ HqScriptObject* HqScriptObject::_createObject(HqScriptObject* const pOriginalObj
 
 //----------------------------------------------------------------------------------------------------------------------
 
-void* HqScriptObject::operator new(const size_t sizeInBytes)
+void* HqScriptObject::operator new(const size_t sizeInBytes, HqSlabAllocator* const pAllocator)
 {
-	return HqMemAlloc(sizeInBytes);
+	return HqSlabAllocator::Alloc(pAllocator, sizeInBytes);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
-void HqScriptObject::operator delete(void* const pObject)
+void HqScriptObject::operator delete(void* const pObject, HqSlabAllocator* const pAllocator)
 {
-	HqMemFree(pObject);
+	HqSlabAllocator::Free(pAllocator, pObject, sizeof(HqScriptObject));
 }
 
 //----------------------------------------------------------------------------------------------------------------------
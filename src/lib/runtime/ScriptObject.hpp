@@ -50,7 +50,11 @@ struct HqScriptObject
 		HqString::StlCompare
 	> StringToPtrMap;
 
-	static HqScriptObject* CreateSchema(HqString* pTypeName, const MemberDefinitionMap& definitions);
+	static HqScriptObject* CreateSchema(
+		HqSlabAllocator* pAllocator,
+		HqString* pTypeName,
+		const MemberDefinitionMap& definitions
+	);
 	static HqScriptObject* CreateInstance(HqScriptObject* const pSchema);
 	static HqScriptObject* CreateCopy(HqScriptObject* const pObject);
 	static void Dispose(HqScriptObject* const pObject);
@@ -62,8 +66,10 @@ struct HqScriptObject
 
 	static HqScriptObject* _createObject(HqScriptObject*);
 
-	void* operator new(const size_t sizeInBytes);
-	void operator delete(void* const pObject);
+	void* operator new(const size_t sizeInBytes, HqSlabAllocator* const pAllocator);
+	void operator delete(void* const pObject, HqSlabAllocator* const pAllocator);
+
+	HqSlabAllocator* pAllocator;
 
 	HqString* pTypeName;
 	HqScriptObject* pSchema;
@@ -21,6 +21,8 @@
 #include "ScriptObject.hpp"
 #include "Vm.hpp"
 
+#include "../base/SlabAllocator.hpp"
+
 #include <assert.h>
 #include <inttypes.h>
 #include <stdio.h>
@@ -232,7 +234,7 @@ HqValueHandle HqValue::CreateString(HqVmHandle hVm, const char* const string)
 	pOutput->as.pString = HqString::Create(string);
 	if(!pOutput->as.pString)
 	{
-		delete pOutput;
+		HqValue::operator delete(pOutput, hVm->pSlabAllocator);
 		return HQ_VALUE_HANDLE_NULL;
 	}
 
@@ -275,6 +277,8 @@ HqValueHandle HqValue::CreateObject(HqVmHandle hVm, HqScriptObject* const pObjec
 	// Make a copy of the input object template for this value.
 	pOutput->as.pObject = HqScriptObject::CreateInstance(pObjectSchema);
 
+	_onStorageAllocated(pOutput);
+
 	return pOutput;
 }
 
@@ -324,6 +328,8 @@ HqValueHandle HqValue::CreateArray(HqVmHandle hVm, const size_t count)
 		memset(pOutput->as.array.pData, 0, sizeof(HqValueHandle) * count);
 	}
 
+	_onStorageAllocated(pOutput);
+
 	return pOutput;
 }
 
@@ -359,6 +365,8 @@ HqValueHandle HqValue::CreateGrid(HqVmHandle hVm, const size_t lengthX, const si
 		memset(pOutput->as.grid.array.pData, 0, sizeof(HqValueHandle) * totalCount);
 	}
 
+	_onStorageAllocated(pOutput);
+
 	return pOutput;
 }
 
@@ -518,10 +526,18 @@ HqValueHandle HqValue::Copy(HqVmHandle hVm, HqValueHandle hValue)
 		default:
 			// This should never happen. If it does, it indicates an unimplemented type here.
 			assert(false);
-			delete pOutput;
+			HqValue::operator delete(pOutput, pOutput->hVm->pSlabAllocator);
 			return HQ_VALUE_HANDLE_NULL;
 	}
 
+	_onStorageAllocated(pOutput);
+
+	if(pOutput->gcProxy.discover)
+	{
+		// The copy now holds references that the collector may not have seen yet.
+		HqGarbageCollector::WriteBarrier(hVm->gc, &pOutput->gcProxy);
+	}
+
 	return pOutput;
 }
 
@@ -648,6 +664,12 @@ void HqValue::SetAutoMark(HqValueHandle hValue, const bool autoMark)
 	if(hValue)
 	{
 		hValue->gcProxy.autoMark = autoMark;
+
+		if(autoMark && hValue->hVm->gc.isMajorCycle)
+		{
+			// The auto-mark phase may have already run, so make sure the value is seen by the remark phase.
+			HqGarbageCollector::WriteBarrier(hValue->hVm->gc, &hValue->gcProxy);
+		}
 	}
 }
 
@@ -728,7 +750,7 @@ HqValue* HqValue::_onCreate(const int valueType, HqVmHandle hVm)
 	assert(valueType >= 0);
 	assert(valueType <= HQ_VALUE_TYPE__MAX_VALUE);
 
-	HqValue* const pOutput = new HqValue();
+	HqValue* const pOutput = new(hVm->pSlabAllocator) HqValue();
 	assert(pOutput != HQ_VALUE_HANDLE_NULL);
 
 	pOutput->hVm = hVm;
@@ -742,8 +764,7 @@ HqValue* HqValue::_onCreate(const int valueType, HqVmHandle hVm)
 	HqGcProxy::Initialize(
 		pOutput->gcProxy,
 		hVm->gc,
-		_onGcDiscovery,
-		_onGcDestruct,
+		HqGcProxy::Type::Value,
 		pOutput,
 		true,
 		needsDiscovery
@@ -768,7 +789,7 @@ void HqValue::_onGcDiscovery(HqGarbageCollector& gc, void* const pOpaque)
 			// Mark each member inside the object.
 			for(size_t i = 0; i < pScriptObject->members.count; ++i)
 			{
-				HqValueHandle hMemberValue = pScriptObject->members.pData[i];
+				HqValueHandle hMemberValue = LoadElement(&pScriptObject->members.pData[i]);
 				if(hMemberValue)
 				{
 					HqGarbageCollector::MarkObject(gc, &hMemberValue->gcProxy);
@@ -785,7 +806,7 @@ void HqValue::_onGcDiscovery(HqGarbageCollector& gc, void* const pOpaque)
 			// Mark each element in the array.
 			for(size_t i = 0; i < array.count; ++i)
 			{
-				HqValueHandle hIndexValue = array.pData[i];
+				HqValueHandle hIndexValue = LoadElement(&array.pData[i]);
 				if(hIndexValue)
 				{
 					HqGarbageCollector::MarkObject(gc, &hIndexValue->gcProxy);
@@ -802,7 +823,7 @@ void HqValue::_onGcDiscovery(HqGarbageCollector& gc, void* const pOpaque)
 			// Mark each element in the array.
 			for(size_t i = 0; i < array.count; ++i)
 			{
-				HqValueHandle hIndexValue = array.pData[i];
+				HqValueHandle hIndexValue = LoadElement(&array.pData[i]);
 				if(hIndexValue)
 				{
 					HqGarbageCollector::MarkObject(gc, &hIndexValue->gcProxy);
@@ -854,21 +875,65 @@ void HqValue::_onGcDestruct(void* const pOpaqueValue)
 			break;
 	}
 
-	delete hValue;
+	HqValue::operator delete(hValue, hValue->hVm->pSlabAllocator);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+size_t HqValue::_onGcGetStorageSize(void* const pOpaqueValue)
+{
+	assert(pOpaqueValue != nullptr);
+
+	HqValueHandle hValue = reinterpret_cast<HqValueHandle>(pOpaqueValue);
+
+	// Containers never resize after they're created, so this is the same
+	// size that was added to the heap when their storage was allocated.
+	switch(hValue->type)
+	{
+		case HQ_VALUE_TYPE_OBJECT:
+			return hValue->as.pObject
+				? sizeof(HqScriptObject) + (sizeof(HqValueHandle) * hValue->as.pObject->members.capacity)
+				: 0;
+
+		case HQ_VALUE_TYPE_ARRAY:
+			return sizeof(HqValueHandle) * hValue->as.array.capacity;
+
+		case HQ_VALUE_TYPE_GRID:
+			return sizeof(HqValueHandle) * hValue->as.grid.array.capacity;
+
+		default:
+			break;
+	}
+
+	return 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void HqValue::_onStorageAllocated(HqValue* const pValue)
+{
+	assert(pValue != nullptr);
+
+	const size_t storageSize = HqGcProxy::GetStorageSize(&pValue->gcProxy);
+	if(storageSize > 0)
+	{
+		// Count the storage toward the heap size so the collector is paced by how much memory is really in use.
+		HqGarbageCollector::AddStorageSize(pValue->hVm->gc, storageSize);
+	}
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
-void* HqValue::operator new(const size_t sizeInBytes)
+void* HqValue::operator new(const size_t sizeInBytes, HqSlabAllocator* const pAllocator)
 {
-	return HqMemAlloc(sizeInBytes);
+	return HqSlabAllocator::Alloc(pAllocator, sizeInBytes);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
-void HqValue::operator delete(void* const pObject)
+void HqValue::operator delete(void* const pObject, HqSlabAllocator* const pAllocator)
 {
-	HqMemFree(pObject);
+	HqSlabAllocator::Free(pAllocator, pObject, sizeof(HqValue));
 }
 
 //----------------------------------------------------------------------------------------------------------------------
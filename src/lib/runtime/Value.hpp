@@ -27,6 +27,7 @@
 #include "../base/String.hpp"
 
 #include "../common/Array.hpp"
+#include "../common/Atomic.hpp"
 #include "../common/HashMap.hpp"
 #include "../common/Stack.hpp"
 
@@ -108,12 +109,17 @@ struct HqValue
 		size_t indexY,
 		size_t indexZ);
 
+	static HqValueHandle LoadElement(const HqValueHandle* pElement);
+	static void StoreElement(HqValueHandle* pElement, HqValueHandle hValue);
+
 	static HqValue* _onCreate(int, HqVmHandle);
 	static void _onGcDiscovery(HqGarbageCollector&, void*);
 	static void _onGcDestruct(void*);
+	static size_t _onGcGetStorageSize(void*);
+	static void _onStorageAllocated(HqValue*);
 
-	void* operator new(size_t sizeInBytes);
-	void operator delete(void* pObject);
+	void* operator new(size_t sizeInBytes, HqSlabAllocator* pAllocator);
+	void operator delete(void* pObject, HqSlabAllocator* pAllocator);
 
 	HqVmHandle hVm;
 
@@ -163,4 +169,21 @@ inline size_t HqValue::CalculateGridIndex(
 	return (indexZ * lengthX * lengthY) + (indexY * lengthX) + indexX;
 }
 
+//----------------------------------------------------------------------------------------------------------------------
+
+// The collector reads the elements of arrays, grids, and objects while scripts are still running, so any element
+// in a container that may already be visible to it has to be written and read through these. Containers that were
+// just created don't need them since the collector won't look inside anything created during a concurrent mark.
+inline HqValueHandle HqValue::LoadElement(const HqValueHandle* const pElement)
+{
+	return HqAtomic::LoadAcquire(pElement);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+inline void HqValue::StoreElement(HqValueHandle* const pElement, HqValueHandle hValue)
+{
+	HqAtomic::StoreRelease(pElement, hValue);
+}
+
 //----------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
@@ -19,6 +19,7 @@
 #include "Vm.hpp"
 
 #include "../base/Clock.hpp"
+#include "../base/SlabAllocator.hpp"
 #include "../common/OpCodeEnum.hpp"
 
 #include <assert.h>
@@ -31,12 +32,17 @@ HqVmHandle HqVm::Create(const HqVmInit& init)
 	HqVm* const pOutput = new HqVm();
 	assert(pOutput != HQ_VM_HANDLE_NULL);
 
+	// The slab allocator needs to exist before anything owned by the VM is created.
+	pOutput->pSlabAllocator = init.useSlabAllocator
+		? HqSlabAllocator::Create()
+		: nullptr;
+
 	pOutput->report.onMessageFn = init.common.report.onMessageFn;
 	pOutput->report.pUserData = init.common.report.pUserData;
 	pOutput->report.level = init.common.report.reportLevel;
 
 	// Initialize the garbage collector.
-	HqGarbageCollector::Initialize(pOutput->gc, pOutput, init.gcTimeSliceMs);
+	HqGarbageCollector::Initialize(pOutput->gc, pOutput, init.gcTimeSliceMs, init.gcMarkThreadCount, init.gcThreadStackSize, init.gcHeapGrowthPercent, init.gcMinTriggerHeapSize);
 
 	// Initialize the opcode array.
 	OpCodeArray::Initialize(pOutput->opCodes);
@@ -47,11 +53,14 @@ HqVmHandle HqVm::Create(const HqVmInit& init)
 	// Initialize the execution context array.
 	HqExecution::HandleArray::Initialize(pOutput->executionContexts);
 
+	// Initialize the global variable slot array.
+	HqValue::HandleArray::Initialize(pOutput->globalValues);
+
 	// Allocate the VM data maps.
 	EmbeddedExceptionMap::Allocate(pOutput->embeddedExceptions);
 	HqModule::StringToHandleMap::Allocate(pOutput->modules);
 	HqFunction::StringToHandleMap::Allocate(pOutput->functions);
-	HqValue::StringToHandleMap::Allocate(pOutput->globals);
+	GlobalSlotMap::Allocate(pOutput->globalSlots);
 	HqScriptObject::StringToPtrMap::Allocate(pOutput->objectSchemas);
 
 	_setupOpCodes(pOutput);
@@ -59,7 +68,10 @@ HqVmHandle HqVm::Create(const HqVmInit& init)
 
 	HqMutex::Create(pOutput->lock);
 
+	HqSampleProfiler::Initialize(pOutput->sampleProfiler, pOutput);
+
 	pOutput->gcTimeWaitMs = init.gcTimeWaitMs;
+	pOutput->functionGeneration = 0;
 	pOutput->isGcThreadEnabled = init.gcEnableThread;
 	pOutput->isShuttingDown = false;
 
@@ -90,6 +102,9 @@ void HqVm::Dispose(HqVmHandle hVm)
 
 		hVm->isShuttingDown = true;
 
+		// The sample profiler needs to be stopped before anything it might be looking at gets disposed.
+		HqSampleProfiler::Dispose(hVm->sampleProfiler);
+
 		if(hVm->isGcThreadEnabled)
 		{
 			int32_t threadReturnValue = 0;
@@ -136,13 +151,14 @@ void HqVm::Dispose(HqVmHandle hVm)
 
 		// Clean up each loaded global.
 		{
-			HqValue::StringToHandleMap::Iterator iter;
-			while(HqValue::StringToHandleMap::IterateNext(hVm->globals, iter))
+			GlobalSlotMap::Iterator iter;
+			while(GlobalSlotMap::IterateNext(hVm->globalSlots, iter))
 			{
 				HqString::Release(iter.pData->key);
 			}
 
-			HqValue::StringToHandleMap::Dispose(hVm->globals);
+			GlobalSlotMap::Dispose(hVm->globalSlots);
+			HqValue::HandleArray::Dispose(hVm->globalValues);
 		}
 
 		// Clean up each loaded object schema.
@@ -182,7 +198,15 @@ void HqVm::Dispose(HqVmHandle hVm)
 	// Dispose of the VM mutex after it has been unlocked.
 	HqMutex::Dispose(hVm->lock);
 
+	HqSlabAllocator* const pSlabAllocator = hVm->pSlabAllocator;
+
 	delete hVm;
+
+	if(pSlabAllocator)
+	{
+		// Anything still holding memory from the VM's slabs will keep them alive until it's freed.
+		HqSlabAllocator::Release(pSlabAllocator);
+	}
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -235,17 +259,47 @@ void HqVm::DetachExec(HqVmHandle hVm, HqExecutionHandle hExec)
 
 //----------------------------------------------------------------------------------------------------------------------
 
+uint32_t HqVm::RegisterGlobalVariable(HqVmHandle hVm, HqString* const pVariableName)
+{
+	assert(hVm != HQ_VM_HANDLE_NULL);
+	assert(pVariableName != nullptr);
+
+	uint32_t slot = HQ_VM_GLOBAL_SLOT_INVALID;
+	if(GlobalSlotMap::Get(hVm->globalSlots, pVariableName, slot))
+	{
+		return slot;
+	}
+
+	// Global variables are never removed while the VM is alive, so the next slot
+	// is always at the end of the array. Once assigned, a slot will never change.
+	slot = uint32_t(hVm->globalValues.count);
+
+	HqValue::HandleArray::Reserve(hVm->globalValues, hVm->globalValues.count + 1);
+	hVm->globalValues.pData[slot] = HQ_VALUE_HANDLE_NULL;
+	++hVm->globalValues.count;
+
+	GlobalSlotMap::Insert(hVm->globalSlots, pVariableName, slot);
+	HqString::AddRef(pVariableName);
+
+	return slot;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 int HqVm::SetGlobalVariable(HqVmHandle hVm, HqValueHandle hValue, HqString* const pVariableName)
 {
 	assert(hVm != HQ_VM_HANDLE_NULL);
 	assert(hValue != HQ_VALUE_HANDLE_NULL);
 	assert(pVariableName != nullptr);
 
-	if(!HqValue::StringToHandleMap::Set(hVm->globals, pVariableName, hValue))
+	const uint32_t slot = GetGlobalSlot(hVm, pVariableName);
+	if(slot == HQ_VM_GLOBAL_SLOT_INVALID)
 	{
 		return HQ_ERROR_KEY_DOES_NOT_EXIST;
 	}
 
+	hVm->globalValues.pData[slot] = hValue;
+
 	return HQ_SUCCESS;
 }
 
@@ -295,15 +349,28 @@ HqValueHandle HqVm::GetGlobalVariable(HqVmHandle hVm, HqString* const pVariableN
 	assert(pVariableName != nullptr);
 	assert(pOutResult != nullptr);
 
-	HqValueHandle hOutput = HQ_VALUE_HANDLE_NULL;
-	if(!HqValue::StringToHandleMap::Get(hVm->globals, pVariableName, hOutput))
+	const uint32_t slot = GetGlobalSlot(hVm, pVariableName);
+	if(slot == HQ_VM_GLOBAL_SLOT_INVALID)
 	{
 		(*pOutResult) = HQ_ERROR_KEY_DOES_NOT_EXIST;
 		return HQ_VALUE_HANDLE_NULL;
 	}
 
 	(*pOutResult) = HQ_SUCCESS;
-	return hOutput;
+	return hVm->globalValues.pData[slot];
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+uint32_t HqVm::GetGlobalSlot(HqVmHandle hVm, HqString* const pVariableName)
+{
+	assert(hVm != HQ_VM_HANDLE_NULL);
+	assert(pVariableName != nullptr);
+
+	uint32_t slot = HQ_VM_GLOBAL_SLOT_INVALID;
+	GlobalSlotMap::Get(hVm->globalSlots, pVariableName, slot);
+
+	return slot;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -392,6 +459,22 @@ void HqVm::EndianSwapOpCode(HqVmHandle hVm, HqDecoder& decoder, const uint32_t o
 
 //----------------------------------------------------------------------------------------------------------------------
 
+void HqVm::DecodeOpCode(HqVmHandle hVm, HqInstruction& output, HqDecoder& decoder, HqModuleHandle hModule)
+{
+	assert(hVm != HQ_VM_HANDLE_NULL);
+	assert(hModule != HQ_MODULE_HANDLE_NULL);
+	assert(decoder.ip != nullptr);
+	assert(output.opCode < HQ_OP_CODE__TOTAL_COUNT);
+
+	const OpCode& opCodeData = hVm->opCodes.pData[output.opCode];
+
+	output.execFn = opCodeData.execFn;
+
+	opCodeData.decodeFn(output, decoder, hModule);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 int32_t HqVm::_gcThreadMain(void* const pArg)
 {
 	HqVmHandle hVm = reinterpret_cast<HqVmHandle>(pArg);
@@ -402,8 +485,11 @@ int32_t HqVm::_gcThreadMain(void* const pArg)
 		// Force a very small sleep to deprioritize the GC thread.
 		HqThread::Sleep(hVm->gcTimeWaitMs);
 
-		// Run a step of the garbage collector.
-		HqGarbageCollector::RunStep(hVm->gc);
+		// Run a step of the garbage collector, but only when the pacer says there's something worth collecting.
+		if(HqGarbageCollector::ShouldRunStep(hVm->gc))
+		{
+			HqGarbageCollector::RunStep(hVm->gc);
+		}
 	}
 
 	return HQ_SUCCESS;
@@ -24,8 +24,10 @@
 #include "Execution.hpp"
 #include "Function.hpp"
 #include "GarbageCollector.hpp"
+#include "Instruction.hpp"
 #include "OpDecl.hpp"
 #include "Module.hpp"
+#include "SampleProfiler.hpp"
 #include "ScriptObject.hpp"
 #include "Value.hpp"
 
@@ -37,6 +39,10 @@
 
 //----------------------------------------------------------------------------------------------------------------------
 
+#define HQ_VM_GLOBAL_SLOT_INVALID UINT32_MAX
+
+//----------------------------------------------------------------------------------------------------------------------
+
 struct HqVm
 {
 	typedef HqHashMap<
@@ -44,15 +50,26 @@ struct HqVm
 		HqScriptObject*
 	> EmbeddedExceptionMap;
 
+	typedef HqHashMap<
+		HqString*,
+		uint32_t,
+		HqString::StlHash,
+		HqString::StlCompare
+	> GlobalSlotMap;
+
 	struct OpCode
 	{
 		typedef void (*ExecuteCallback)(HqExecutionHandle);
 		typedef void (*DisassembleCallback)(HqDisassemble&);
 		typedef void (*EndianSwapCallback)(HqDecoder&);
+		typedef void (*DecodeCallback)(HqInstruction&, HqDecoder&, HqModuleHandle);
 
 		ExecuteCallback execFn;
 		DisassembleCallback disasmFn;
 		EndianSwapCallback endianFn;
+		DecodeCallback decodeFn;
+
+		const char* mnemonic;
 	};
 
 	typedef HqArray<OpCode> OpCodeArray;
@@ -64,11 +81,14 @@ struct HqVm
 	static bool AttachExec(HqVmHandle hVm, HqExecutionHandle hExec);
 	static void DetachExec(HqVmHandle hVm, HqExecutionHandle hExec);
 
+	static uint32_t RegisterGlobalVariable(HqVmHandle hVm, HqString* const pVariableName);
+
 	static int SetGlobalVariable(HqVmHandle hVm, HqValueHandle hValue, HqString* const pVariableName);
 
 	static HqModuleHandle GetModule(HqVmHandle hVm, HqString* const pModuleName, int* const pOutResult);
 	static HqFunctionHandle GetFunction(HqVmHandle hVm, HqString* const pFunctionSignature, int* const pOutResult);
 	static HqValueHandle GetGlobalVariable(HqVmHandle hVm, HqString* const pVariableName, int* const pOutResult);
+	static uint32_t GetGlobalSlot(HqVmHandle hVm, HqString* const pVariableName);
 	static HqScriptObject* GetObjectSchema(HqVmHandle hVm, HqString* const pTypeName, int* const pOutResult);
 
 	static HqValueHandle CreateStandardException(HqVmHandle hVm, const int exceptionType, const char* const message);
@@ -76,6 +96,7 @@ struct HqVm
 	static void ExecuteOpCode(HqVmHandle hVm, HqExecutionHandle hExec, const uint32_t opCode);
 	static void DisassembleOpCode(HqVmHandle hVm, HqDisassemble& disasm, const uint32_t opCode);
 	static void EndianSwapOpCode(HqVmHandle hVm, HqDecoder& decoder, const uint32_t opCode);
+	static void DecodeOpCode(HqVmHandle hVm, HqInstruction& output, HqDecoder& decoder, HqModuleHandle hModule);
 
 	static void _setupOpCodes(HqVmHandle);
 	static void _setupEmbeddedExceptions(HqVmHandle);
@@ -90,16 +111,21 @@ struct HqVm
 
 	HqModule::StringToHandleMap modules;
 	HqFunction::StringToHandleMap functions;
-	HqValue::StringToHandleMap globals;
+	GlobalSlotMap globalSlots;
+	HqValue::HandleArray globalValues;
 	HqScriptObject::StringToPtrMap objectSchemas;
 	HqExecution::HandleArray executionContexts;
 
 	HqReport report;
 	HqGarbageCollector gc;
 	HqThread gcThread;
+	HqSampleProfiler sampleProfiler;
 	HqMutex lock;
 
+	HqSlabAllocator* pSlabAllocator;
+
 	uint32_t gcTimeWaitMs;
+	uint32_t functionGeneration;
 
 	bool isGcThreadEnabled;
 	bool isShuttingDown;
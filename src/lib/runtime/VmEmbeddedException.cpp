@@ -43,7 +43,7 @@ void HqVm::_setupEmbeddedExceptions(HqVmHandle hVm)
 #define HQ_EMBEDDED_EXCEPTION(type, name) \
 	{ \
 		HqString* const pTypeName = HqString::Create("Harlequin.System.Exception." name); \
-		HqScriptObject* const pSchema = HqScriptObject::CreateSchema(pTypeName, memberDefs); \
+		HqScriptObject* const pSchema = HqScriptObject::CreateSchema(hVm->pSlabAllocator, pTypeName, memberDefs); \
 		HqString::Release(pTypeName); \
 		EmbeddedExceptionMap::Insert(hVm->embeddedExceptions, HQ_STANDARD_EXCEPTION_ ## type, pSchema); \
 	}
@@ -28,7 +28,9 @@ void HqVm::_setupOpCodes(HqVmHandle hVm)
 	#define _HQ_BIND_OP_CODE(op_code, name) \
 		hVm->opCodes.pData[HQ_OP_CODE_ ## op_code].execFn = OpCodeExec_ ## name; \
 		hVm->opCodes.pData[HQ_OP_CODE_ ## op_code].disasmFn = OpCodeDisasm_ ## name; \
-		hVm->opCodes.pData[HQ_OP_CODE_ ## op_code].endianFn = OpCodeEndian_ ## name
+		hVm->opCodes.pData[HQ_OP_CODE_ ## op_code].endianFn = OpCodeEndian_ ## name; \
+		hVm->opCodes.pData[HQ_OP_CODE_ ## op_code].decodeFn = OpCodeDecode_ ## name; \
+		hVm->opCodes.pData[HQ_OP_CODE_ ## op_code].mnemonic = #op_code
 
 	_HQ_BIND_OP_CODE(NOP,    Nop);
 	_HQ_BIND_OP_CODE(ABORT,  Abort);
@@ -121,6 +123,10 @@ void HqVm::_setupOpCodes(HqVmHandle hVm)
 	_HQ_BIND_OP_CODE(MOVE,  Move);
 	_HQ_BIND_OP_CODE(COPY, Copy);
 
+	_HQ_BIND_OP_CODE(CALL_WINDOW,     CallWindow);
+	_HQ_BIND_OP_CODE(TAIL_CALL,       TailCall);
+	_HQ_BIND_OP_CODE(TAIL_CALL_VALUE, TailCallValue);
+
 	#undef _HQ_BIND_OP_CODE
 }
 
@@ -54,3 +54,9 @@ extern "C" void OpCodeEndian_Abort(HqDecoder& /*decoder*/)
 }
 
 //----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_Abort(HqInstruction& /*output*/, HqDecoder& /*decoder*/, HqModuleHandle /*hModule*/)
+{
+}
+
+//----------------------------------------------------------------------------------------------------------------------
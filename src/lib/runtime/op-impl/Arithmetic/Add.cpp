@@ -20,6 +20,9 @@
 
 #include "../../Decoder.hpp"
 #include "../../Execution.hpp"
+#include "../../Vm.hpp"
+
+#include "ArithUtil.hpp"
 
 #include <inttypes.h>
 #include <stdio.h>
@@ -40,9 +43,15 @@ extern "C" void OpCodeExec_Add(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t gpDstRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t gpSrcLeftRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t gpSrcRightRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
+	const uint32_t gpDstRegIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
+	const uint32_t gpSrcLeftRegIndex = hExec->hCurrentFrame->pInstruction->operands[1].index;
+	const uint32_t gpSrcRightRegIndex = hExec->hCurrentFrame->pInstruction->operands[2].index;
+
+	// Primitive operands are computed directly in the registers without allocating a new value.
+	if(ArithUtil::TryPrimitive<ArithUtil::AddOperation>(hExec->hCurrentFrame, gpDstRegIndex, gpSrcLeftRegIndex, gpSrcRightRegIndex))
+	{
+		return;
+	}
 
 	HqValueHandle hLeft = HqFrame::GetGpRegister(hExec->hCurrentFrame, gpSrcLeftRegIndex, &result);
 	if(hLeft)
@@ -97,6 +106,8 @@ extern "C" void OpCodeExec_Add(HqExecutionHandle hExec)
 						{
 							hOutput->as.array.pData[index] = hRight->as.array.pData[index - leftCount];
 						}
+
+						HqGarbageCollector::WriteBarrier(hExec->hVm->gc, &hOutput->gcProxy);
 						break;
 					}
 
@@ -179,9 +190,9 @@ extern "C" void OpCodeExec_Add(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_Add(HqDisassemble& disasm)
 {
-	const uint32_t gpDstRegIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t gpSrcLeftRegIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t gpSrcRightRegIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t gpDstRegIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t gpSrcLeftRegIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t gpSrcRightRegIndex = HqDecoder::LoadRegister(disasm.decoder);
 
 	char str[256];
 	snprintf(str, sizeof(str), "ADD r(%" PRIu32 "), r(%" PRIu32 "), r(%" PRIu32 ")", gpDstRegIndex, gpSrcLeftRegIndex, gpSrcRightRegIndex);
@@ -192,9 +203,18 @@ extern "C" void OpCodeDisasm_Add(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_Add(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r# [first]
-	HqDecoder::EndianSwapUint32(decoder); // r# [second]
-	HqDecoder::EndianSwapUint32(decoder); // r# [third]
+	HqDecoder::EndianSwapRegister(decoder); // r# [first]
+	HqDecoder::EndianSwapRegister(decoder); // r# [second]
+	HqDecoder::EndianSwapRegister(decoder); // r# [third]
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_Add(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].index = HqDecoder::LoadRegister(decoder);
+	output.operands[2].index = HqDecoder::LoadRegister(decoder);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,165 @@
+//
+// Copyright (c) 2021, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#pragma once
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#include "../../Execution.hpp"
+
+#include <math.h>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace ArithUtil
+{
+	struct AddOperation
+	{
+		template <typename T>
+		static bool Apply(T& output, const T left, const T right)
+		{
+			output = T(left + right);
+			return true;
+		}
+	};
+
+	struct SubOperation
+	{
+		template <typename T>
+		static bool Apply(T& output, const T left, const T right)
+		{
+			output = T(left - right);
+			return true;
+		}
+	};
+
+	struct MulOperation
+	{
+		template <typename T>
+		static bool Apply(T& output, const T left, const T right)
+		{
+			output = T(left * right);
+			return true;
+		}
+	};
+
+	struct DivOperation
+	{
+		template <typename T>
+		static bool Apply(T& output, const T left, const T right)
+		{
+			if(right == T(0))
+			{
+				// Leave the divide-by-zero error to be reported by the boxed path.
+				return false;
+			}
+
+			output = T(left / right);
+			return true;
+		}
+	};
+
+	struct ModOperation
+	{
+		template <typename T>
+		static bool Apply(T& output, const T left, const T right)
+		{
+			if(right == T(0))
+			{
+				return false;
+			}
+
+			output = T(left % right);
+			return true;
+		}
+
+		static bool Apply(float& output, const float left, const float right)
+		{
+			output = fmodf(left, right);
+			return true;
+		}
+
+		static bool Apply(double& output, const double left, const double right)
+		{
+			output = fmod(left, right);
+			return true;
+		}
+
+		static bool Apply(bool&, const bool, const bool)
+		{
+			// Modulo is not supported for boolean values.
+			return false;
+		}
+	};
+
+	// Attempt to run an arithmetic operation directly on the primitive values held in the operand registers,
+	// storing the unboxed result in the destination register. This returns false without modifying anything
+	// when the operands are not primitives of the same type or when the operation itself refuses them (such
+	// as dividing by zero). The caller is expected to fall back to the boxed implementation in that case,
+	// which is responsible for all other value types and for reporting errors.
+	template <typename TOperation>
+	inline bool TryPrimitive(
+		HqFrameHandle hFrame,
+		const uint32_t gpDstRegIndex,
+		const uint32_t gpSrcLeftRegIndex,
+		const uint32_t gpSrcRightRegIndex)
+	{
+		HqRegister* const pDst = HqFrame::GetGpRegisterSlot(hFrame, gpDstRegIndex);
+		const HqRegister* const pLeft = HqFrame::GetGpRegisterSlot(hFrame, gpSrcLeftRegIndex);
+		const HqRegister* const pRight = HqFrame::GetGpRegisterSlot(hFrame, gpSrcRightRegIndex);
+
+		if(!pDst
+			|| !pLeft
+			|| !pRight
+			|| !HqRegister::IsPrimitive(*pLeft)
+			|| pLeft->type != pRight->type)
+		{
+			return false;
+		}
+
+		HqRegister::Primitive output;
+		bool success = false;
+
+		switch(pLeft->type)
+		{
+			case HQ_VALUE_TYPE_INT8:    success = TOperation::Apply(output.int8, pLeft->as.int8, pRight->as.int8);          break;
+			case HQ_VALUE_TYPE_INT16:   success = TOperation::Apply(output.int16, pLeft->as.int16, pRight->as.int16);       break;
+			case HQ_VALUE_TYPE_INT32:   success = TOperation::Apply(output.int32, pLeft->as.int32, pRight->as.int32);       break;
+			case HQ_VALUE_TYPE_INT64:   success = TOperation::Apply(output.int64, pLeft->as.int64, pRight->as.int64);       break;
+			case HQ_VALUE_TYPE_UINT8:   success = TOperation::Apply(output.uint8, pLeft->as.uint8, pRight->as.uint8);       break;
+			case HQ_VALUE_TYPE_UINT16:  success = TOperation::Apply(output.uint16, pLeft->as.uint16, pRight->as.uint16);    break;
+			case HQ_VALUE_TYPE_UINT32:  success = TOperation::Apply(output.uint32, pLeft->as.uint32, pRight->as.uint32);    break;
+			case HQ_VALUE_TYPE_UINT64:  success = TOperation::Apply(output.uint64, pLeft->as.uint64, pRight->as.uint64);    break;
+			case HQ_VALUE_TYPE_FLOAT32: success = TOperation::Apply(output.float32, pLeft->as.float32, pRight->as.float32); break;
+			case HQ_VALUE_TYPE_FLOAT64: success = TOperation::Apply(output.float64, pLeft->as.float64, pRight->as.float64); break;
+			case HQ_VALUE_TYPE_BOOL:    success = TOperation::Apply(output.boolean, pLeft->as.boolean, pRight->as.boolean); break;
+
+			default:
+				break;
+		}
+
+		if(success)
+		{
+			HqRegister::SetPrimitive(*pDst, pLeft->type, output);
+		}
+
+		return success;
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -21,6 +21,8 @@
 #include "../../Decoder.hpp"
 #include "../../Execution.hpp"
 
+#include "ArithUtil.hpp"
+
 #include <inttypes.h>
 #include <stdio.h>
 
@@ -40,9 +42,15 @@ extern "C" void OpCodeExec_Div(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t gpDstRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t gpSrcLeftRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t gpSrcRightRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
+	const uint32_t gpDstRegIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
+	const uint32_t gpSrcLeftRegIndex = hExec->hCurrentFrame->pInstruction->operands[1].index;
+	const uint32_t gpSrcRightRegIndex = hExec->hCurrentFrame->pInstruction->operands[2].index;
+
+	// Primitive operands are computed directly in the registers without allocating a new value.
+	if(ArithUtil::TryPrimitive<ArithUtil::DivOperation>(hExec->hCurrentFrame, gpDstRegIndex, gpSrcLeftRegIndex, gpSrcRightRegIndex))
+	{
+		return;
+	}
 
 	HqValueHandle hLeft = HqFrame::GetGpRegister(hExec->hCurrentFrame, gpSrcLeftRegIndex, &result);
 	if(hLeft)
@@ -311,9 +319,9 @@ extern "C" void OpCodeExec_Div(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_Div(HqDisassemble& disasm)
 {
-	const uint32_t gpDstRegIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t gpSrcLeftRegIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t gpSrcRightRegIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t gpDstRegIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t gpSrcLeftRegIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t gpSrcRightRegIndex = HqDecoder::LoadRegister(disasm.decoder);
 
 	char str[256];
 	snprintf(str, sizeof(str), "DIV r(%" PRIu32 "), r(%" PRIu32 "), r(%" PRIu32 ")", gpDstRegIndex, gpSrcLeftRegIndex, gpSrcRightRegIndex);
@@ -324,9 +332,18 @@ extern "C" void OpCodeDisasm_Div(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_Div(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r# [first]
-	HqDecoder::EndianSwapUint32(decoder); // r# [second]
-	HqDecoder::EndianSwapUint32(decoder); // r# [third]
+	HqDecoder::EndianSwapRegister(decoder); // r# [first]
+	HqDecoder::EndianSwapRegister(decoder); // r# [second]
+	HqDecoder::EndianSwapRegister(decoder); // r# [third]
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_Div(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].index = HqDecoder::LoadRegister(decoder);
+	output.operands[2].index = HqDecoder::LoadRegister(decoder);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -77,9 +77,9 @@ extern "C" void OpCodeExec_Exp(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t gpDstRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t gpSrcLeftRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t gpSrcRightRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
+	const uint32_t gpDstRegIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
+	const uint32_t gpSrcLeftRegIndex = hExec->hCurrentFrame->pInstruction->operands[1].index;
+	const uint32_t gpSrcRightRegIndex = hExec->hCurrentFrame->pInstruction->operands[2].index;
 
 	HqValueHandle hLeft = HqFrame::GetGpRegister(hExec->hCurrentFrame, gpSrcLeftRegIndex, &result);
 	if(hLeft)
@@ -184,9 +184,9 @@ extern "C" void OpCodeExec_Exp(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_Exp(HqDisassemble& disasm)
 {
-	const uint32_t gpDstRegIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t gpSrcLeftRegIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t gpSrcRightRegIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t gpDstRegIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t gpSrcLeftRegIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t gpSrcRightRegIndex = HqDecoder::LoadRegister(disasm.decoder);
 
 	char str[256];
 	snprintf(str, sizeof(str), "EXP r(%" PRIu32 "), r(%" PRIu32 "), r(%" PRIu32 ")", gpDstRegIndex, gpSrcLeftRegIndex, gpSrcRightRegIndex);
@@ -197,9 +197,18 @@ extern "C" void OpCodeDisasm_Exp(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_Exp(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r# [first]
-	HqDecoder::EndianSwapUint32(decoder); // r# [second]
-	HqDecoder::EndianSwapUint32(decoder); // r# [third]
+	HqDecoder::EndianSwapRegister(decoder); // r# [first]
+	HqDecoder::EndianSwapRegister(decoder); // r# [second]
+	HqDecoder::EndianSwapRegister(decoder); // r# [third]
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_Exp(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].index = HqDecoder::LoadRegister(decoder);
+	output.operands[2].index = HqDecoder::LoadRegister(decoder);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,236 @@
+//
+// Copyright (c) 2021, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#pragma once
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#include "../../Execution.hpp"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace BitwiseUtil
+{
+	struct AndOperation
+	{
+		template <typename T>
+		static bool Apply(T& output, const T left, const T right)
+		{
+			output = T(left & right);
+			return true;
+		}
+	};
+
+	struct OrOperation
+	{
+		template <typename T>
+		static bool Apply(T& output, const T left, const T right)
+		{
+			output = T(left | right);
+			return true;
+		}
+	};
+
+	struct XorOperation
+	{
+		template <typename T>
+		static bool Apply(T& output, const T left, const T right)
+		{
+			output = T(left ^ right);
+			return true;
+		}
+	};
+
+	struct LeftShiftOperation
+	{
+		template <typename T>
+		static bool Apply(T& output, const T left, const T right)
+		{
+			output = T(left << right);
+			return true;
+		}
+
+		static bool Apply(bool&, const bool, const bool)
+		{
+			// Shifting is not supported for boolean values.
+			return false;
+		}
+	};
+
+	struct RightShiftOperation
+	{
+		template <typename T>
+		static bool Apply(T& output, const T left, const T right)
+		{
+			output = T(left >> right);
+			return true;
+		}
+
+		static bool Apply(bool&, const bool, const bool)
+		{
+			return false;
+		}
+	};
+
+	struct LeftRotateOperation
+	{
+		template <typename T>
+		static bool Apply(T& output, const T left, const T right)
+		{
+			constexpr T bitCount = T(sizeof(T) * 8);
+			const T shiftAmount = T(right % bitCount);
+			const T rotateAmount = T(bitCount - shiftAmount);
+
+			output = T((left << shiftAmount) | (left >> rotateAmount));
+			return true;
+		}
+
+		static bool Apply(bool&, const bool, const bool)
+		{
+			// Rotating is not supported for boolean values.
+			return false;
+		}
+	};
+
+	struct RightRotateOperation
+	{
+		template <typename T>
+		static bool Apply(T& output, const T left, const T right)
+		{
+			constexpr T bitCount = T(sizeof(T) * 8);
+			const T shiftAmount = T(right % bitCount);
+			const T rotateAmount = T(bitCount - shiftAmount);
+
+			output = T((left >> shiftAmount) | (left << rotateAmount));
+			return true;
+		}
+
+		static bool Apply(bool&, const bool, const bool)
+		{
+			return false;
+		}
+	};
+
+	struct NotOperation
+	{
+		template <typename T>
+		static bool Apply(T& output, const T value)
+		{
+			output = T(~value);
+			return true;
+		}
+
+		static bool Apply(bool& output, const bool value)
+		{
+			output = !value;
+			return true;
+		}
+	};
+
+	// Attempt to run a bitwise operation directly on the primitive values held in the operand registers, storing
+	// the unboxed result in the destination register. This returns false without modifying anything when the
+	// operands are not integer or boolean primitives of the same type, or when the operation doesn't support
+	// them. The caller is expected to fall back to the boxed implementation, which reports any errors.
+	template <typename TOperation>
+	inline bool TryPrimitive(
+		HqFrameHandle hFrame,
+		const uint32_t gpDstRegIndex,
+		const uint32_t gpSrcLeftRegIndex,
+		const uint32_t gpSrcRightRegIndex)
+	{
+		HqRegister* const pDst = HqFrame::GetGpRegisterSlot(hFrame, gpDstRegIndex);
+		const HqRegister* const pLeft = HqFrame::GetGpRegisterSlot(hFrame, gpSrcLeftRegIndex);
+		const HqRegister* const pRight = HqFrame::GetGpRegisterSlot(hFrame, gpSrcRightRegIndex);
+
+		if(!pDst
+			|| !pLeft
+			|| !pRight
+			|| !HqRegister::IsPrimitive(*pLeft)
+			|| pLeft->type != pRight->type)
+		{
+			return false;
+		}
+
+		HqRegister::Primitive output;
+		bool success = false;
+
+		switch(pLeft->type)
+		{
+			case HQ_VALUE_TYPE_INT8:   success = TOperation::Apply(output.int8, pLeft->as.int8, pRight->as.int8);          break;
+			case HQ_VALUE_TYPE_INT16:  success = TOperation::Apply(output.int16, pLeft->as.int16, pRight->as.int16);       break;
+			case HQ_VALUE_TYPE_INT32:  success = TOperation::Apply(output.int32, pLeft->as.int32, pRight->as.int32);       break;
+			case HQ_VALUE_TYPE_INT64:  success = TOperation::Apply(output.int64, pLeft->as.int64, pRight->as.int64);       break;
+			case HQ_VALUE_TYPE_UINT8:  success = TOperation::Apply(output.uint8, pLeft->as.uint8, pRight->as.uint8);       break;
+			case HQ_VALUE_TYPE_UINT16: success = TOperation::Apply(output.uint16, pLeft->as.uint16, pRight->as.uint16);    break;
+			case HQ_VALUE_TYPE_UINT32: success = TOperation::Apply(output.uint32, pLeft->as.uint32, pRight->as.uint32);    break;
+			case HQ_VALUE_TYPE_UINT64: success = TOperation::Apply(output.uint64, pLeft->as.uint64, pRight->as.uint64);    break;
+			case HQ_VALUE_TYPE_BOOL:   success = TOperation::Apply(output.boolean, pLeft->as.boolean, pRight->as.boolean); break;
+
+			default:
+				break;
+		}
+
+		if(success)
+		{
+			HqRegister::SetPrimitive(*pDst, pLeft->type, output);
+		}
+
+		return success;
+	}
+
+	// Same as TryPrimitive(), but for operations that take a single operand.
+	template <typename TOperation>
+	inline bool TryPrimitiveUnary(HqFrameHandle hFrame, const uint32_t gpDstRegIndex, const uint32_t gpSrcRegIndex)
+	{
+		HqRegister* const pDst = HqFrame::GetGpRegisterSlot(hFrame, gpDstRegIndex);
+		const HqRegister* const pSrc = HqFrame::GetGpRegisterSlot(hFrame, gpSrcRegIndex);
+
+		if(!pDst || !pSrc || !HqRegister::IsPrimitive(*pSrc))
+		{
+			return false;
+		}
+
+		HqRegister::Primitive output;
+		bool success = false;
+
+		switch(pSrc->type)
+		{
+			case HQ_VALUE_TYPE_INT8:   success = TOperation::Apply(output.int8, pSrc->as.int8);       break;
+			case HQ_VALUE_TYPE_INT16:  success = TOperation::Apply(output.int16, pSrc->as.int16);     break;
+			case HQ_VALUE_TYPE_INT32:  success = TOperation::Apply(output.int32, pSrc->as.int32);     break;
+			case HQ_VALUE_TYPE_INT64:  success = TOperation::Apply(output.int64, pSrc->as.int64);     break;
+			case HQ_VALUE_TYPE_UINT8:  success = TOperation::Apply(output.uint8, pSrc->as.uint8);     break;
+			case HQ_VALUE_TYPE_UINT16: success = TOperation::Apply(output.uint16, pSrc->as.uint16);   break;
+			case HQ_VALUE_TYPE_UINT32: success = TOperation::Apply(output.uint32, pSrc->as.uint32);   break;
+			case HQ_VALUE_TYPE_UINT64: success = TOperation::Apply(output.uint64, pSrc->as.uint64);   break;
+			case HQ_VALUE_TYPE_BOOL:   success = TOperation::Apply(output.boolean, pSrc->as.boolean); break;
+
+			default:
+				break;
+		}
+
+		if(success)
+		{
+			HqRegister::SetPrimitive(*pDst, pSrc->type, output);
+		}
+
+		return success;
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -21,6 +21,8 @@
 #include "../../Decoder.hpp"
 #include "../../Execution.hpp"
 
+#include "BitwiseUtil.hpp"
+
 #include <inttypes.h>
 #include <stdio.h>
 
@@ -39,8 +41,14 @@ extern "C" void OpCodeExec_BitNot(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t gpDstRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t gpSrcRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
+	const uint32_t gpDstRegIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
+	const uint32_t gpSrcRegIndex = hExec->hCurrentFrame->pInstruction->operands[1].index;
+
+	// A primitive operand is computed directly in the registers without allocating a new value.
+	if(BitwiseUtil::TryPrimitiveUnary<BitwiseUtil::NotOperation>(hExec->hCurrentFrame, gpDstRegIndex, gpSrcRegIndex))
+	{
+		return;
+	}
 
 	HqValueHandle hSrc = HqFrame::GetGpRegister(hExec->hCurrentFrame, gpSrcRegIndex, &result);
 	if(hSrc)
@@ -115,8 +123,8 @@ extern "C" void OpCodeExec_BitNot(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_BitNot(HqDisassemble& disasm)
 {
-	const uint32_t gpDstRegIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t gpSrcRegIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t gpDstRegIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t gpSrcRegIndex = HqDecoder::LoadRegister(disasm.decoder);
 
 	char str[64];
 	snprintf(str, sizeof(str), "NOT r(%" PRIu32 "), r(%" PRIu32 ")", gpDstRegIndex, gpSrcRegIndex);
@@ -127,8 +135,16 @@ extern "C" void OpCodeDisasm_BitNot(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_BitNot(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r# [first]
-	HqDecoder::EndianSwapUint32(decoder); // r# [second]
+	HqDecoder::EndianSwapRegister(decoder); // r# [first]
+	HqDecoder::EndianSwapRegister(decoder); // r# [second]
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_BitNot(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].index = HqDecoder::LoadRegister(decoder);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -24,6 +24,8 @@
 #include "../Module.hpp"
 #include "../Vm.hpp"
 
+#include "../../common/Atomic.hpp"
+
 #include <assert.h>
 #include <inttypes.h>
 #include <stdio.h>
@@ -40,72 +42,202 @@
 //
 //   r# = Register containing the function value to call.
 //
+// 0x: CALL_WINDOW s#, r#
+//
+//   s# = String table index to the name of the function to be called.
+//   r# = First register of the argument window.
+//
+//   The arguments are placed in the window registers starting at r# and the return values are found in
+//   the same registers once the call completes. A register window function uses the window as its own
+//   leading registers, so everything from r# onward should be considered clobbered by the call.
+//
+// 0x: TAIL_CALL s#
+//
+//   s# = String table index to the name of the function to be called.
+//
+// 0x: TAIL_CALL_VALUE r#
+//
+//   r# = Register containing the function value to call.
+//
+//   Tail calls replace the current frame with the called function rather than pushing a new frame, so the
+//   called function returns directly to the current function's caller. Arguments are passed through the
+//   I/O registers, and any exception handlers in the current function no longer apply once the call is made.
+//
+//----------------------------------------------------------------------------------------------------------------------
+
+static bool InvokeNativeFunction(HqExecutionHandle hExec, HqFunctionHandle hFunction)
+{
+	assert(hExec != HQ_EXECUTION_HANDLE_NULL);
+	assert(hFunction != HQ_FUNCTION_HANDLE_NULL);
+	assert(hFunction->type == HqFunction::Type::Native);
+
+	if(!hFunction->nativeFn)
+	{
+		// Raise a fatal script exception.
+		HqExecution::RaiseOpCodeException(
+			hExec,
+			HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
+			"Script native function pointer is null: \"%s\"",
+			hFunction->pSignature->data
+		);
+		return false;
+	}
+
+	// Native functions are free to create objects from any thread or run the garbage collector
+	// directly, so they always go through the shared pending list.
+	HqScopedGcNursery nursery(nullptr);
+
+	if(hExec->hVm->isGcThreadEnabled)
+	{
+		// We can't predict what native calls are going to do and since recursive locks on RwLocks
+		// are not allowed, we unlock the GC RwLock here to prevent possible deadlocks. We'll put
+		// the lock back on it immediately after the call is finished, but during this time, the
+		// garbage collector will likely be running.
+		HqRwLock::ReadUnlock(hExec->hVm->gc.rwLock);
+	}
+
+	// Call the native function.
+	hFunction->nativeFn(hExec, hFunction, hFunction->pNativeUserData);
+
+	if(hExec->hVm->isGcThreadEnabled)
+	{
+		HqRwLock::ReadLock(hExec->hVm->gc.rwLock);
+	}
+
+	return true;
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 
-static void CallScriptFunction(HqExecutionHandle hExec, HqFunctionHandle hFunction)
+static void CallScriptFunction(HqExecutionHandle hExec, HqFunctionHandle hFunction, const uint32_t windowBase)
 {
 	assert(hExec != HQ_EXECUTION_HANDLE_NULL);
 	assert(hFunction != HQ_FUNCTION_HANDLE_NULL);
 
+	// Function calls are a safepoint for the garbage collector.
+	HqGarbageCollector::PollSafepoint(hExec->hVm->gc);
+
+	if(windowBase != HQ_FRAME_NO_WINDOW && !hFunction->usesRegisterWindow)
+	{
+		// Functions that don't use register windows expect their arguments in the I/O registers.
+		HqExecution::_copyFrameToIoRegisters(hExec, hExec->hCurrentFrame, windowBase, hFunction->numParameters);
+	}
+
 	// A new frame gets pushed for all functions, even native functions.
 	// But for native functions, it's just a dummy frame for the sake of
 	// any code that would wish to resolve the frame stack if a script
 	// exception were to occur within the native function.
-	HqExecution::PushFrame(hExec, hFunction);
+	const int pushResult = HqExecution::PushFrame(hExec, hFunction, windowBase);
+	if(pushResult != HQ_SUCCESS)
+	{
+		// Raise a fatal script exception.
+		HqExecution::RaiseOpCodeException(
+			hExec,
+			HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
+			"Failed to push frame: error=%d",
+			pushResult
+		);
+		return;
+	}
 
-	if(hFunction->type == HqFunction::Type::Native)
+	if(windowBase == HQ_FRAME_NO_WINDOW && hFunction->usesRegisterWindow)
 	{
-		// Native functions are called immediately.
-		if(hFunction->nativeFn)
+		// The arguments were passed through the I/O registers, so they need to be moved into the window.
+		HqExecution::_copyIoRegistersToFrame(hExec, hExec->hCurrentFrame, 0, hFunction->numParameters);
+	}
+
+	// Native functions are called immediately.
+	if(hFunction->type == HqFunction::Type::Native && InvokeNativeFunction(hExec, hFunction))
+	{
+		// Pop the dummy frame from the frame stack now that it's no longer needed.
+		HqExecution::PopFrame(hExec);
+
+		if(windowBase != HQ_FRAME_NO_WINDOW)
 		{
-			if(hExec->hVm->isGcThreadEnabled)
-			{
-				// We can't predict what native calls are going to do and since recursive locks on RwLocks
-				// are not allowed, we unlock the GC RwLock here to prevent possible deadlocks. We'll put
-				// the lock back on it immediately after the call is finished, but during this time, the
-				// garbage collector will likely be running.
-				HqRwLock::ReadUnlock(hExec->hVm->gc.rwLock);
-			}
-
-			// Call the native function.
-			hFunction->nativeFn(hExec, hFunction, hFunction->pNativeUserData);
-
-			if(hExec->hVm->isGcThreadEnabled)
-			{
-				HqRwLock::ReadLock(hExec->hVm->gc.rwLock);
-			}
-
-			// Pop the dummy frame from the frame stack now that it's no longer needed.
-			HqExecution::PopFrame(hExec);
+			HqExecution::_copyIoRegistersToFrame(hExec, hExec->hCurrentFrame, windowBase, hFunction->numReturnValues);
 		}
-		else
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static void TailCallFunction(HqExecutionHandle hExec, HqFunctionHandle hFunction)
+{
+	assert(hExec != HQ_EXECUTION_HANDLE_NULL);
+	assert(hFunction != HQ_FUNCTION_HANDLE_NULL);
+
+	// Function calls are a safepoint for the garbage collector.
+	HqGarbageCollector::PollSafepoint(hExec->hVm->gc);
+
+	// Reuse the current frame for the called function. It keeps the current frame's register window,
+	// so the called function's return values end up wherever the current function's caller expects them.
+	const int replaceResult = HqExecution::ReplaceFrame(hExec, hFunction);
+	if(replaceResult != HQ_SUCCESS)
+	{
+		// Raise a fatal script exception.
+		HqExecution::RaiseOpCodeException(
+			hExec,
+			HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
+			"Failed to replace frame: error=%d",
+			replaceResult
+		);
+		return;
+	}
+
+	if(hFunction->type == HqFunction::Type::Native)
+	{
+		// Native functions still get a dummy frame which is returned from just like a script function's frame.
+		if(InvokeNativeFunction(hExec, hFunction))
 		{
-			// Raise a fatal script exception.
-			HqExecution::RaiseOpCodeException(
-				hExec,
-				HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
-				"Script native function pointer is null: \"%s\"",
-				hFunction->pSignature->data
-			);
+			OpCodeExec_Return(hExec);
 		}
 	}
+	else if(hFunction->usesRegisterWindow)
+	{
+		HqExecution::_copyIoRegistersToFrame(hExec, hExec->hCurrentFrame, 0, hFunction->numParameters);
+	}
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
-extern "C" void OpCodeExec_Call(HqExecutionHandle hExec)
+static HqFunctionHandle ResolveNamedFunction(HqExecutionHandle hExec, HqOperand* const pOperands)
 {
 	int result;
 
-	const uint32_t stringIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
+	const uint32_t stringIndex = pOperands[0].index;
 
-	HqString* const pFuncName = HqModule::GetString(hExec->hCurrentFrame->hFunction->hModule, stringIndex, &result);
-	if(pFuncName)
+	HqString* const pFuncName = pOperands[1].pString;
+	if(!pFuncName)
 	{
-		HqFunctionHandle hFunction = HqVm::GetFunction(hExec->hVm, pFuncName, &result);
+		// Raise a fatal script exception.
+		HqExecution::RaiseOpCodeException(
+			hExec,
+			HQ_STANDARD_EXCEPTION_TYPE_ERROR,
+			"String does not exist at index: s(%" PRIu32 ")",
+			stringIndex
+		);
+		return HQ_FUNCTION_HANDLE_NULL;
+	}
+
+	const uint32_t functionGeneration = HqAtomic::LoadAcquire(&hExec->hVm->functionGeneration);
+
+	// Use the function cached at this call site as long as the VM function table hasn't changed since it was resolved.
+	// Instructions are shared by every execution context running the function, so the cache may be filled in from
+	// another thread at any time. The generation is always read first and written last so a matching generation
+	// guarantees the function written before it is visible.
+	HqFunctionHandle hFunction = (HqAtomic::LoadAcquire(&pOperands[3].uint32) == functionGeneration)
+		? HqAtomic::Load(&pOperands[2].hFunction)
+		: HQ_FUNCTION_HANDLE_NULL;
+
+	if(!hFunction)
+	{
+		hFunction = HqVm::GetFunction(hExec->hVm, pFuncName, &result);
 		if(hFunction)
 		{
-			CallScriptFunction(hExec, hFunction);
+			// Two threads racing to fill in the cache will both have resolved the same function since functions are
+			// never removed or replaced while the VM is alive, so the last writer winning is harmless.
+			HqAtomic::Store(&pOperands[2].hFunction, hFunction);
+			HqAtomic::StoreRelease(&pOperands[3].uint32, functionGeneration);
 		}
 		else
 		{
@@ -118,15 +250,40 @@ extern "C" void OpCodeExec_Call(HqExecutionHandle hExec)
 			);
 		}
 	}
-	else
+
+	return hFunction;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static HqFunctionHandle ResolveFunctionValue(HqExecutionHandle hExec, const uint32_t registerIndex)
+{
+	int result;
+
+	HqValueHandle hValue = HqFrame::GetGpRegister(hExec->hCurrentFrame, registerIndex, &result);
+	if(!HqValueIsFunction(hValue))
 	{
 		// Raise a fatal script exception.
 		HqExecution::RaiseOpCodeException(
 			hExec,
 			HQ_STANDARD_EXCEPTION_TYPE_ERROR,
-			"String does not exist at index: s(%" PRIu32 ")",
-			stringIndex
+			"Type mismatch; expected function value: r(%" PRIu32 ")",
+			registerIndex
 		);
+		return HQ_FUNCTION_HANDLE_NULL;
+	}
+
+	return hValue->as.hFunction;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeExec_Call(HqExecutionHandle hExec)
+{
+	HqFunctionHandle hFunction = ResolveNamedFunction(hExec, hExec->hCurrentFrame->pInstruction->operands);
+	if(hFunction)
+	{
+		CallScriptFunction(hExec, hFunction, HQ_FRAME_NO_WINDOW);
 	}
 }
 
@@ -134,7 +291,7 @@ extern "C" void OpCodeExec_Call(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_Call(HqDisassemble& disasm)
 {
-	const uint32_t stringIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t stringIndex = HqDecoder::LoadIndex(disasm.decoder);
 
 	char str[256];
 	snprintf(str, sizeof(str), "CALL s(%" PRIu32 ")", stringIndex);
@@ -145,50 +302,188 @@ extern "C" void OpCodeDisasm_Call(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_Call(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder);
+	HqDecoder::EndianSwapIndex(decoder);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
-extern "C" void OpCodeExec_CallValue(HqExecutionHandle hExec)
+extern "C" void OpCodeDecode_Call(HqInstruction& output, HqDecoder& decoder, HqModuleHandle hModule)
 {
 	int result;
 
-	const uint32_t registerIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
+	output.operands[0].index = HqDecoder::LoadIndex(decoder);
 
-	HqValueHandle hValue = HqFrame::GetGpRegister(hExec->hCurrentFrame, registerIndex, &result);
-	if(HqValueIsFunction(hValue))
+	// Resolve the string operand up front so it doesn't need to be looked up each time the instruction runs.
+	output.operands[1].pString = HqModule::GetString(hModule, output.operands[0].index, &result);
+
+	// Clear the call site's function cache. It gets filled in the first time the instruction runs.
+	output.operands[2].hFunction = HQ_FUNCTION_HANDLE_NULL;
+	output.operands[3].uint32 = 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeExec_CallValue(HqExecutionHandle hExec)
+{
+	HqFunctionHandle hFunction = ResolveFunctionValue(hExec, hExec->hCurrentFrame->pInstruction->operands[0].index);
+	if(hFunction)
 	{
-		CallScriptFunction(hExec, hValue->as.hFunction);
+		CallScriptFunction(hExec, hFunction, HQ_FRAME_NO_WINDOW);
 	}
-	else
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDisasm_CallValue(HqDisassemble& disasm)
+{
+	const uint32_t registerIndex = HqDecoder::LoadRegister(disasm.decoder);
+
+	char str[256];
+	snprintf(str, sizeof(str), "CALL_VALUE r(%" PRIu32 ")", registerIndex);
+	disasm.onDisasmFn(disasm.pUserData, str, disasm.opcodeOffset);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeEndian_CallValue(HqDecoder& decoder)
+{
+	HqDecoder::EndianSwapRegister(decoder);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_CallValue(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeExec_CallWindow(HqExecutionHandle hExec)
+{
+	HqOperand* const pOperands = hExec->hCurrentFrame->pInstruction->operands;
+
+	const uint32_t windowBase = pOperands[4].index;
+
+	if(windowBase >= hExec->hCurrentFrame->registers.count)
 	{
 		// Raise a fatal script exception.
 		HqExecution::RaiseOpCodeException(
 			hExec,
-			HQ_STANDARD_EXCEPTION_TYPE_ERROR,
-			"Type mismatch; expected function value: r(%" PRIu32 ")",
-			registerIndex
+			HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
+			"Invalid register window: r(%" PRIu32 ")",
+			windowBase
 		);
+		return;
+	}
+
+	HqFunctionHandle hFunction = ResolveNamedFunction(hExec, pOperands);
+	if(hFunction)
+	{
+		CallScriptFunction(hExec, hFunction, windowBase);
 	}
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
-extern "C" void OpCodeDisasm_CallValue(HqDisassemble& disasm)
+extern "C" void OpCodeDisasm_CallWindow(HqDisassemble& disasm)
 {
-	const uint32_t registerIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t stringIndex = HqDecoder::LoadIndex(disasm.decoder);
+	const uint32_t registerIndex = HqDecoder::LoadRegister(disasm.decoder);
 
 	char str[256];
-	snprintf(str, sizeof(str), "CALL_VALUE r(%" PRIu32 ")", registerIndex);
+	snprintf(str, sizeof(str), "CALL_WINDOW s(%" PRIu32 "), r(%" PRIu32 ")", stringIndex, registerIndex);
 	disasm.onDisasmFn(disasm.pUserData, str, disasm.opcodeOffset);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
-extern "C" void OpCodeEndian_CallValue(HqDecoder& decoder)
+extern "C" void OpCodeEndian_CallWindow(HqDecoder& decoder)
+{
+	HqDecoder::EndianSwapIndex(decoder);
+	HqDecoder::EndianSwapRegister(decoder);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_CallWindow(HqInstruction& output, HqDecoder& decoder, HqModuleHandle hModule)
+{
+	// The first four operands are laid out exactly the same as CALL so both can share the call site cache.
+	OpCodeDecode_Call(output, decoder, hModule);
+
+	output.operands[4].index = HqDecoder::LoadRegister(decoder);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeExec_TailCall(HqExecutionHandle hExec)
+{
+	HqFunctionHandle hFunction = ResolveNamedFunction(hExec, hExec->hCurrentFrame->pInstruction->operands);
+	if(hFunction)
+	{
+		TailCallFunction(hExec, hFunction);
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDisasm_TailCall(HqDisassemble& disasm)
+{
+	const uint32_t stringIndex = HqDecoder::LoadIndex(disasm.decoder);
+
+	char str[256];
+	snprintf(str, sizeof(str), "TAIL_CALL s(%" PRIu32 ")", stringIndex);
+	disasm.onDisasmFn(disasm.pUserData, str, disasm.opcodeOffset);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeEndian_TailCall(HqDecoder& decoder)
+{
+	HqDecoder::EndianSwapIndex(decoder);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_TailCall(HqInstruction& output, HqDecoder& decoder, HqModuleHandle hModule)
+{
+	OpCodeDecode_Call(output, decoder, hModule);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeExec_TailCallValue(HqExecutionHandle hExec)
+{
+	HqFunctionHandle hFunction = ResolveFunctionValue(hExec, hExec->hCurrentFrame->pInstruction->operands[0].index);
+	if(hFunction)
+	{
+		TailCallFunction(hExec, hFunction);
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDisasm_TailCallValue(HqDisassemble& disasm)
+{
+	const uint32_t registerIndex = HqDecoder::LoadRegister(disasm.decoder);
+
+	char str[256];
+	snprintf(str, sizeof(str), "TAIL_CALL_VALUE r(%" PRIu32 ")", registerIndex);
+	disasm.onDisasmFn(disasm.pUserData, str, disasm.opcodeOffset);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeEndian_TailCallValue(HqDecoder& decoder)
+{
+	HqDecoder::EndianSwapRegister(decoder);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_TailCallValue(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
 {
-	HqDecoder::EndianSwapUint32(decoder);
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
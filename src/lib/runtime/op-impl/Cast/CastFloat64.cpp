@@ -23,6 +23,8 @@
 #include "../../Function.hpp"
 #include "../../Module.hpp"
 
+#include "CastUtil.hpp"
+
 #include <inttypes.h>
 #include <stdio.h>
 
@@ -41,8 +43,14 @@ extern "C" void OpCodeExec_CastFloat64(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t gpDstRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t gpSrcRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
+	const uint32_t gpDstRegIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
+	const uint32_t gpSrcRegIndex = hExec->hCurrentFrame->pInstruction->operands[1].index;
+
+	// A primitive source is cast directly in the registers without allocating a new value.
+	if(CastUtil::TryPrimitive<double>(hExec->hCurrentFrame, HQ_VALUE_TYPE_FLOAT64, gpDstRegIndex, gpSrcRegIndex))
+	{
+		return;
+	}
 
 	HqValueHandle hSource = HqFrame::GetGpRegister(hExec->hCurrentFrame, gpSrcRegIndex, &result);
 	if(hSource)
@@ -122,8 +130,8 @@ extern "C" void OpCodeExec_CastFloat64(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_CastFloat64(HqDisassemble& disasm)
 {
-	const uint32_t gpDstRegIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t gpSrcRegIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t gpDstRegIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t gpSrcRegIndex = HqDecoder::LoadRegister(disasm.decoder);
 
 	char str[256];
 	snprintf(str, sizeof(str), "CAST_F64 r(%" PRIu32 "), r(%" PRIu32 ")", gpDstRegIndex, gpSrcRegIndex);
@@ -134,8 +142,16 @@ extern "C" void OpCodeDisasm_CastFloat64(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_CastFloat64(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r# [first]
-	HqDecoder::EndianSwapUint32(decoder); // r# [second]
+	HqDecoder::EndianSwapRegister(decoder); // r# [first]
+	HqDecoder::EndianSwapRegister(decoder); // r# [second]
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_CastFloat64(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].index = HqDecoder::LoadRegister(decoder);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
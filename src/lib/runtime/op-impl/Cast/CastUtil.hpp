@@ -0,0 +1,85 @@
+//
+// Copyright (c) 2021, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#pragma once
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#include "../../Execution.hpp"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace CastUtil
+{
+	inline void Store(HqRegister::Primitive& output, const int8_t value)   { output.int8 = value; }
+	inline void Store(HqRegister::Primitive& output, const int16_t value)  { output.int16 = value; }
+	inline void Store(HqRegister::Primitive& output, const int32_t value)  { output.int32 = value; }
+	inline void Store(HqRegister::Primitive& output, const int64_t value)  { output.int64 = value; }
+	inline void Store(HqRegister::Primitive& output, const uint8_t value)  { output.uint8 = value; }
+	inline void Store(HqRegister::Primitive& output, const uint16_t value) { output.uint16 = value; }
+	inline void Store(HqRegister::Primitive& output, const uint32_t value) { output.uint32 = value; }
+	inline void Store(HqRegister::Primitive& output, const uint64_t value) { output.uint64 = value; }
+	inline void Store(HqRegister::Primitive& output, const float value)    { output.float32 = value; }
+	inline void Store(HqRegister::Primitive& output, const double value)   { output.float64 = value; }
+	inline void Store(HqRegister::Primitive& output, const bool value)     { output.boolean = value; }
+
+	// Attempt to cast the primitive value held in the source register directly to the output type, storing the
+	// unboxed result in the destination register. This returns false without modifying anything when the source
+	// register doesn't hold a primitive. The caller is expected to fall back to the boxed implementation in that
+	// case, which is responsible for reporting errors.
+	template <typename TOutput>
+	inline bool TryPrimitive(
+		HqFrameHandle hFrame,
+		const int outputType,
+		const uint32_t gpDstRegIndex,
+		const uint32_t gpSrcRegIndex)
+	{
+		HqRegister* const pDst = HqFrame::GetGpRegisterSlot(hFrame, gpDstRegIndex);
+		const HqRegister* const pSrc = HqFrame::GetGpRegisterSlot(hFrame, gpSrcRegIndex);
+
+		if(!pDst || !pSrc || !HqRegister::IsPrimitive(*pSrc))
+		{
+			return false;
+		}
+
+		HqRegister::Primitive output;
+
+		switch(pSrc->type)
+		{
+			case HQ_VALUE_TYPE_INT8:    Store(output, TOutput(pSrc->as.int8));    break;
+			case HQ_VALUE_TYPE_INT16:   Store(output, TOutput(pSrc->as.int16));   break;
+			case HQ_VALUE_TYPE_INT32:   Store(output, TOutput(pSrc->as.int32));   break;
+			case HQ_VALUE_TYPE_INT64:   Store(output, TOutput(pSrc->as.int64));   break;
+			case HQ_VALUE_TYPE_UINT8:   Store(output, TOutput(pSrc->as.uint8));   break;
+			case HQ_VALUE_TYPE_UINT16:  Store(output, TOutput(pSrc->as.uint16));  break;
+			case HQ_VALUE_TYPE_UINT32:  Store(output, TOutput(pSrc->as.uint32));  break;
+			case HQ_VALUE_TYPE_UINT64:  Store(output, TOutput(pSrc->as.uint64));  break;
+			case HQ_VALUE_TYPE_FLOAT32: Store(output, TOutput(pSrc->as.float32)); break;
+			case HQ_VALUE_TYPE_FLOAT64: Store(output, TOutput(pSrc->as.float64)); break;
+			case HQ_VALUE_TYPE_BOOL:    Store(output, pSrc->as.boolean ? TOutput(1) : TOutput(0)); break;
+
+			default:
+				return false;
+		}
+
+		HqRegister::SetPrimitive(*pDst, outputType, output);
+		return true;
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -22,42 +22,174 @@
 
 #include "../../Execution.hpp"
 
+#include <assert.h>
 #include <inttypes.h>
 
 //----------------------------------------------------------------------------------------------------------------------
 
 namespace CmpUtil
 {
-	inline void SetResult(HqExecutionHandle hExec, const uint32_t gpDstRegIndex, const bool cmpResult)
+	struct EqualComparison
 	{
-		HqValueHandle hOutput = HqValue::CreateBool(hExec->hVm, cmpResult);
-		if(hOutput)
+		// Result given when both operands resolve to the same value.
+		static constexpr bool identityResult = true;
+
+		template <typename T>
+		static bool Apply(const T left, const T right)
 		{
-			// Remove the auto-mark from the output value so it can be cleaned up when it's no longer referenced.
-			HqValue::SetAutoMark(hOutput, false);
+			return left == right;
+		}
+	};
 
-			const int result = HqFrame::SetGpRegister(hExec->hCurrentFrame, hOutput, gpDstRegIndex);
-			if(result != HQ_SUCCESS)
-			{
-				// Raise a fatal script exception.
-				HqExecution::RaiseOpCodeException(
-					hExec,
-					HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
-					"Failed to set general-purpose register: r(%" PRIu32 ")",
-					gpDstRegIndex
-				);
-			}
+	struct NotEqualComparison
+	{
+		// Result given when both operands resolve to the same value.
+		static constexpr bool identityResult = false;
+
+		template <typename T>
+		static bool Apply(const T left, const T right)
+		{
+			return left != right;
+		}
+	};
+
+	struct GreaterComparison
+	{
+		// Result given when both operands resolve to the same value.
+		static constexpr bool identityResult = false;
+
+		template <typename T>
+		static bool Apply(const T left, const T right)
+		{
+			return left > right;
+		}
+	};
+
+	struct GreaterEqualComparison
+	{
+		// Result given when both operands resolve to the same value.
+		static constexpr bool identityResult = true;
+
+		template <typename T>
+		static bool Apply(const T left, const T right)
+		{
+			return left >= right;
+		}
+	};
+
+	struct LessComparison
+	{
+		// Result given when both operands resolve to the same value.
+		static constexpr bool identityResult = false;
+
+		template <typename T>
+		static bool Apply(const T left, const T right)
+		{
+			return left < right;
+		}
+	};
+
+	struct LessEqualComparison
+	{
+		// Result given when both operands resolve to the same value.
+		static constexpr bool identityResult = true;
+
+		template <typename T>
+		static bool Apply(const T left, const T right)
+		{
+			return left <= right;
 		}
-		else
+	};
+
+	inline void SetResult(HqExecutionHandle hExec, const uint32_t gpDstRegIndex, const bool cmpResult)
+	{
+		HqRegister::Primitive output;
+		output.boolean = cmpResult;
+
+		// Boolean results are stored directly in the register without being boxed.
+		const int result = HqFrame::SetGpRegisterPrimitive(hExec->hCurrentFrame, HQ_VALUE_TYPE_BOOL, output, gpDstRegIndex);
+		if(result != HQ_SUCCESS)
 		{
 			// Raise a fatal script exception.
 			HqExecution::RaiseOpCodeException(
-				hExec, 
-				HQ_STANDARD_EXCEPTION_RUNTIME_ERROR, 
-				"Failed to create output value"
+				hExec,
+				HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
+				"Failed to set general-purpose register: r(%" PRIu32 ")",
+				gpDstRegIndex
 			);
 		}
 	}
+
+	// Attempt to compare the primitive values held directly in the operand registers. This returns false
+	// when the operands are not primitives of the same type, in which case the caller falls back to
+	// comparing the boxed values.
+	template <typename TComparison>
+	inline bool TryCompare(
+		HqFrameHandle hFrame,
+		const uint32_t gpSrcLeftRegIndex,
+		const uint32_t gpSrcRightRegIndex,
+		bool& cmpResult)
+	{
+		const HqRegister* const pLeft = HqFrame::GetGpRegisterSlot(hFrame, gpSrcLeftRegIndex);
+		const HqRegister* const pRight = HqFrame::GetGpRegisterSlot(hFrame, gpSrcRightRegIndex);
+
+		if(!pLeft
+			|| !pRight
+			|| !HqRegister::IsPrimitive(*pLeft)
+			|| pLeft->type != pRight->type)
+		{
+			return false;
+		}
+
+		cmpResult = TComparison::identityResult;
+
+		// Operands that resolve to the same value keep the same result the boxed comparison would give them.
+		if(pLeft != pRight && (!pLeft->hValue || pLeft->hValue != pRight->hValue))
+		{
+			switch(pLeft->type)
+			{
+				case HQ_VALUE_TYPE_INT8:    cmpResult = TComparison::Apply(pLeft->as.int8, pRight->as.int8);       break;
+				case HQ_VALUE_TYPE_INT16:   cmpResult = TComparison::Apply(pLeft->as.int16, pRight->as.int16);     break;
+				case HQ_VALUE_TYPE_INT32:   cmpResult = TComparison::Apply(pLeft->as.int32, pRight->as.int32);     break;
+				case HQ_VALUE_TYPE_INT64:   cmpResult = TComparison::Apply(pLeft->as.int64, pRight->as.int64);     break;
+				case HQ_VALUE_TYPE_UINT8:   cmpResult = TComparison::Apply(pLeft->as.uint8, pRight->as.uint8);     break;
+				case HQ_VALUE_TYPE_UINT16:  cmpResult = TComparison::Apply(pLeft->as.uint16, pRight->as.uint16);   break;
+				case HQ_VALUE_TYPE_UINT32:  cmpResult = TComparison::Apply(pLeft->as.uint32, pRight->as.uint32);   break;
+				case HQ_VALUE_TYPE_UINT64:  cmpResult = TComparison::Apply(pLeft->as.uint64, pRight->as.uint64);   break;
+				case HQ_VALUE_TYPE_FLOAT32: cmpResult = TComparison::Apply(pLeft->as.float32, pRight->as.float32); break;
+				case HQ_VALUE_TYPE_FLOAT64: cmpResult = TComparison::Apply(pLeft->as.float64, pRight->as.float64); break;
+				case HQ_VALUE_TYPE_BOOL:    cmpResult = TComparison::Apply(pLeft->as.boolean, pRight->as.boolean); break;
+
+				default:
+					// This should never happen.
+					assert(false);
+					break;
+			}
+		}
+
+		return true;
+	}
+
+	// Compare the primitive operand registers and store the result, leaving everything untouched when
+	// the operands need to be compared as boxed values instead.
+	template <typename TComparison>
+	inline bool TryPrimitive(
+		HqExecutionHandle hExec,
+		const uint32_t gpDstRegIndex,
+		const uint32_t gpSrcLeftRegIndex,
+		const uint32_t gpSrcRightRegIndex)
+	{
+		bool cmpResult;
+
+		if(!TryCompare<TComparison>(hExec->hCurrentFrame, gpSrcLeftRegIndex, gpSrcRightRegIndex, cmpResult))
+		{
+			return false;
+		}
+
+		SetResult(hExec, gpDstRegIndex, cmpResult);
+
+		return true;
+	}
 }
 
 //----------------------------------------------------------------------------------------------------------------------
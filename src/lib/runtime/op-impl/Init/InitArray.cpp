@@ -42,8 +42,11 @@ extern "C" void OpCodeExec_InitArray(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t registerIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t count = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
+	// Allocations are a safepoint for the garbage collector.
+	HqGarbageCollector::PollSafepoint(hExec->hVm->gc);
+
+	const uint32_t registerIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
+	const uint32_t count = hExec->hCurrentFrame->pInstruction->operands[1].index;
 
 	HqValueHandle hArray = HqValue::CreateArray(hExec->hVm, size_t(count));
 	if(HqValueIsArray(hArray))
@@ -78,8 +81,8 @@ extern "C" void OpCodeExec_InitArray(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_InitArray(HqDisassemble& disasm)
 {
-	const uint32_t registerIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t initialCount = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t registerIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t initialCount = HqDecoder::LoadIndex(disasm.decoder);
 
 	char instr[512];
 	snprintf(instr, sizeof(instr), "INIT_ARRAY r(%" PRIu32 "), %" PRIu32, registerIndex, initialCount);
@@ -90,8 +93,16 @@ extern "C" void OpCodeDisasm_InitArray(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_InitArray(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r#
-	HqDecoder::EndianSwapUint32(decoder); // ##
+	HqDecoder::EndianSwapRegister(decoder); // r#
+	HqDecoder::EndianSwapIndex(decoder); // ##
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_InitArray(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].index = HqDecoder::LoadIndex(decoder);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
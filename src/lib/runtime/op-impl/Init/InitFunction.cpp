@@ -42,10 +42,13 @@ extern "C" void OpCodeExec_InitFunction(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t registerIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t stringIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
+	// Allocations are a safepoint for the garbage collector.
+	HqGarbageCollector::PollSafepoint(hExec->hVm->gc);
 
-	HqString* const pFuncName = HqModule::GetString(hExec->hCurrentFrame->hFunction->hModule, stringIndex, &result);
+	const uint32_t registerIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
+	const uint32_t stringIndex = hExec->hCurrentFrame->pInstruction->operands[1].index;
+
+	HqString* const pFuncName = hExec->hCurrentFrame->pInstruction->operands[2].pString;
 	if(pFuncName)
 	{
 		HqFunctionHandle hFunction = HqVm::GetFunction(hExec->hVm, pFuncName, &result);
@@ -96,8 +99,8 @@ extern "C" void OpCodeExec_InitFunction(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_InitFunction(HqDisassemble& disasm)
 {
-	const uint32_t registerIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t stringIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t registerIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t stringIndex = HqDecoder::LoadIndex(disasm.decoder);
 
 	char instr[64];
 	snprintf(instr, sizeof(instr), "INIT_FUNC r(%" PRIu32 "), s(%" PRIu32 ")", registerIndex, stringIndex);
@@ -108,8 +111,21 @@ extern "C" void OpCodeDisasm_InitFunction(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_InitFunction(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r#
-	HqDecoder::EndianSwapUint32(decoder); // s#
+	HqDecoder::EndianSwapRegister(decoder); // r#
+	HqDecoder::EndianSwapIndex(decoder); // s#
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_InitFunction(HqInstruction& output, HqDecoder& decoder, HqModuleHandle hModule)
+{
+	int result;
+
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].index = HqDecoder::LoadIndex(decoder);
+
+	// Resolve the string operand up front so it doesn't need to be looked up each time the instruction runs.
+	output.operands[2].pString = HqModule::GetString(hModule, output.operands[1].index, &result);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -44,10 +44,13 @@ extern "C" void OpCodeExec_InitGrid(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t registerIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t lengthX = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t lengthY = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t lengthZ = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
+	// Allocations are a safepoint for the garbage collector.
+	HqGarbageCollector::PollSafepoint(hExec->hVm->gc);
+
+	const uint32_t registerIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
+	const uint32_t lengthX = hExec->hCurrentFrame->pInstruction->operands[1].index;
+	const uint32_t lengthY = hExec->hCurrentFrame->pInstruction->operands[2].index;
+	const uint32_t lengthZ = hExec->hCurrentFrame->pInstruction->operands[3].index;
 
 	HqValueHandle hGrid = HqValue::CreateGrid(hExec->hVm, size_t(lengthX), size_t(lengthY), size_t(lengthZ));
 	if(HqValueIsGrid(hGrid))
@@ -82,10 +85,10 @@ extern "C" void OpCodeExec_InitGrid(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_InitGrid(HqDisassemble& disasm)
 {
-	const uint32_t registerIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t lengthX = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t lengthY = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t lengthZ = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t registerIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t lengthX = HqDecoder::LoadIndex(disasm.decoder);
+	const uint32_t lengthY = HqDecoder::LoadIndex(disasm.decoder);
+	const uint32_t lengthZ = HqDecoder::LoadIndex(disasm.decoder);
 
 	char instr[512];
 	snprintf(instr, sizeof(instr), "INIT_GRID r(%" PRIu32 "), %" PRIu32 ", %" PRIu32 ", %" PRIu32, registerIndex, lengthX, lengthY, lengthZ);
@@ -96,10 +99,20 @@ extern "C" void OpCodeDisasm_InitGrid(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_InitGrid(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r#
-	HqDecoder::EndianSwapUint32(decoder); // ##
-	HqDecoder::EndianSwapUint32(decoder); // ##
-	HqDecoder::EndianSwapUint32(decoder); // ##
+	HqDecoder::EndianSwapRegister(decoder); // r#
+	HqDecoder::EndianSwapIndex(decoder); // ##
+	HqDecoder::EndianSwapIndex(decoder); // ##
+	HqDecoder::EndianSwapIndex(decoder); // ##
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_InitGrid(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].index = HqDecoder::LoadIndex(decoder);
+	output.operands[2].index = HqDecoder::LoadIndex(decoder);
+	output.operands[3].index = HqDecoder::LoadIndex(decoder);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -42,10 +42,13 @@ extern "C" void OpCodeExec_InitObject(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t registerIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t stringIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
+	// Allocations are a safepoint for the garbage collector.
+	HqGarbageCollector::PollSafepoint(hExec->hVm->gc);
 
-	HqString* const pObjectTypeName= HqModule::GetString(hExec->hCurrentFrame->hFunction->hModule, stringIndex, &result);
+	const uint32_t registerIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
+	const uint32_t stringIndex = hExec->hCurrentFrame->pInstruction->operands[1].index;
+
+	HqString* const pObjectTypeName= hExec->hCurrentFrame->pInstruction->operands[2].pString;
 	if(pObjectTypeName)
 	{
 		// Get the object schema matching the type name.
@@ -109,8 +112,8 @@ extern "C" void OpCodeExec_InitObject(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_InitObject(HqDisassemble& disasm)
 {
-	const uint32_t registerIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t stringIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t registerIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t stringIndex = HqDecoder::LoadIndex(disasm.decoder);
 
 	char instr[512];
 	snprintf(instr, sizeof(instr), "INIT_OBJECT r(%" PRIu32 "), s(%" PRIu32 ")", registerIndex, stringIndex);
@@ -121,8 +124,21 @@ extern "C" void OpCodeDisasm_InitObject(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_InitObject(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r#
-	HqDecoder::EndianSwapUint32(decoder); // s#
+	HqDecoder::EndianSwapRegister(decoder); // r#
+	HqDecoder::EndianSwapIndex(decoder); // s#
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_InitObject(HqInstruction& output, HqDecoder& decoder, HqModuleHandle hModule)
+{
+	int result;
+
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].index = HqDecoder::LoadIndex(decoder);
+
+	// Resolve the string operand up front so it doesn't need to be looked up each time the instruction runs.
+	output.operands[2].pString = HqModule::GetString(hModule, output.operands[1].index, &result);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -22,6 +22,7 @@
 #include "../Execution.hpp"
 #include "../Function.hpp"
 #include "../Module.hpp"
+#include "../Vm.hpp"
 
 #include <assert.h>
 #include <inttypes.h>
@@ -45,34 +46,38 @@
 //
 //----------------------------------------------------------------------------------------------------------------------
 
-static inline void _MoveInstructionPointer(HqExecutionHandle hExec, const int32_t relativeOffset)
+static inline void _MoveInstructionPointer(HqExecutionHandle hExec, const HqOperand& offsetOperand, const HqOperand& targetOperand)
 {
 	HqFunctionHandle hFunction = hExec->hCurrentFrame->hFunction;
-	HqModuleHandle hModule = hExec->hCurrentFrame->hFunction->hModule;
 
-	uint8_t* const pNewIp = hExec->hCurrentFrame->decoder.cachedIp + relativeOffset;
-
-	const uint8_t* const pFunctionStart = hModule->code.pData + hFunction->bytecodeOffsetStart;
-	const uint8_t* const pFunctionEnd = hModule->code.pData + hFunction->bytecodeOffsetEnd;
-
-	// Verify the new instruction pointer falls within the bounds of the current function.
-	if(pNewIp < pFunctionStart || pNewIp >= pFunctionEnd)
+	// The jump target is resolved when the module is loaded and will only be null
+	// when the offset does not land on an instruction within the current function.
+	if(!targetOperand.pTarget)
 	{
 		// Raise a fatal script exception.
 		HqExecution::RaiseOpCodeException(
 			hExec, 
 			HQ_STANDARD_EXCEPTION_RUNTIME_ERROR, 
 			"Invalid jump offset: offset=%" PRId32 ", currentPosition=0x%" PRIXPTR ", functionStart=0x%" PRIXPTR ", functionEnd=0x%" PRIXPTR,
-			relativeOffset,
-			uintptr_t(hExec->hCurrentFrame->decoder.cachedIp),
-			uintptr_t(pFunctionStart),
-			uintptr_t(pFunctionEnd)
+			offsetOperand.offset,
+			uintptr_t(hExec->hCurrentFrame->pInstruction->offset),
+			uintptr_t(hFunction->bytecodeOffsetStart),
+			uintptr_t(hFunction->bytecodeOffsetEnd)
 		);
 	}
 	else
 	{
-		hExec->hCurrentFrame->decoder.cachedIp = pNewIp;
-		hExec->hCurrentFrame->decoder.ip = pNewIp;
+		const bool isBackwardJump = (targetOperand.pTarget <= hExec->hCurrentFrame->pInstruction);
+
+		hExec->hCurrentFrame->pInstruction = targetOperand.pTarget;
+		hExec->hCurrentFrame->pNextInstruction = targetOperand.pTarget;
+
+		if(isBackwardJump)
+		{
+			// Loops are the only way a script can run indefinitely without calling
+			// a function, so backward jumps need to give the GC a chance to run.
+			HqGarbageCollector::PollSafepoint(hExec->hVm->gc);
+		}
 	}
 }
 
@@ -92,17 +97,17 @@ static inline void _RaiseFatalException_NoValueAtGpRegister(HqExecutionHandle hE
 
 extern "C" void OpCodeExec_Jump(HqExecutionHandle hExec)
 {
-	const int32_t offset = HqDecoder::LoadInt32(hExec->hCurrentFrame->decoder);
+	const HqOperand* const pOperands = hExec->hCurrentFrame->pInstruction->operands;
 
 	// No condition, just move the instruction pointer.
-	_MoveInstructionPointer(hExec, offset);
+	_MoveInstructionPointer(hExec, pOperands[0], pOperands[1]);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
 extern "C" void OpCodeDisasm_Jump(HqDisassemble& disasm)
 {
-	const int32_t offset = HqDecoder::LoadInt32(disasm.decoder);
+	const int32_t offset = HqDecoder::LoadOffset(disasm.decoder);
 	const uintptr_t position = uintptr_t(intptr_t(disasm.opcodeOffset) + offset);
 
 	char str[64];
@@ -114,25 +119,34 @@ extern "C" void OpCodeDisasm_Jump(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_Jump(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapInt32(decoder);
+	HqDecoder::EndianSwapOffset(decoder);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_Jump(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].offset = HqDecoder::LoadOffset(decoder);
+
+	// The jump target is resolved after all instructions in the function have been decoded.
+	output.operands[1].pTarget = nullptr;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
 extern "C" void OpCodeExec_JumpIfTrue(HqExecutionHandle hExec)
 {
-	int result;
+	const HqOperand* const pOperands = hExec->hCurrentFrame->pInstruction->operands;
 
-	const uint32_t registerIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const int32_t offset = HqDecoder::LoadInt32(hExec->hCurrentFrame->decoder);
+	const uint32_t registerIndex = pOperands[0].index;
 
-	HqValueHandle hValue = HqFrame::GetGpRegister(hExec->hCurrentFrame, registerIndex, &result);
-	if(result == HQ_SUCCESS)
+	const HqRegister* const pRegister = HqFrame::GetGpRegisterSlot(hExec->hCurrentFrame, registerIndex);
+	if(pRegister)
 	{
-		const bool pass = HqValue::EvaluateAsBoolean(hValue);
+		const bool pass = HqRegister::EvaluateAsBoolean(*pRegister);
 		if(pass)
 		{
-			_MoveInstructionPointer(hExec, offset);
+			_MoveInstructionPointer(hExec, pOperands[1], pOperands[2]);
 		}
 	}
 	else
@@ -146,8 +160,8 @@ extern "C" void OpCodeExec_JumpIfTrue(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_JumpIfTrue(HqDisassemble& disasm)
 {
-	const uint32_t registerIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const int32_t offset = HqDecoder::LoadInt32(disasm.decoder);
+	const uint32_t registerIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const int32_t offset = HqDecoder::LoadOffset(disasm.decoder);
 	const uintptr_t position = uintptr_t(intptr_t(disasm.opcodeOffset) + offset);
 
 	char str[64];
@@ -159,26 +173,36 @@ extern "C" void OpCodeDisasm_JumpIfTrue(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_JumpIfTrue(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder);
-	HqDecoder::EndianSwapInt32(decoder);
+	HqDecoder::EndianSwapRegister(decoder);
+	HqDecoder::EndianSwapOffset(decoder);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_JumpIfTrue(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].offset = HqDecoder::LoadOffset(decoder);
+
+	// The jump target is resolved after all instructions in the function have been decoded.
+	output.operands[2].pTarget = nullptr;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
 extern "C" void OpCodeExec_JumpIfFalse(HqExecutionHandle hExec)
 {
-	int result;
+	const HqOperand* const pOperands = hExec->hCurrentFrame->pInstruction->operands;
 
-	const uint32_t registerIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const int32_t offset = HqDecoder::LoadInt32(hExec->hCurrentFrame->decoder);
+	const uint32_t registerIndex = pOperands[0].index;
 
-	HqValueHandle hValue = HqFrame::GetGpRegister(hExec->hCurrentFrame, registerIndex, &result);
-	if(result == HQ_SUCCESS)
+	const HqRegister* const pRegister = HqFrame::GetGpRegisterSlot(hExec->hCurrentFrame, registerIndex);
+	if(pRegister)
 	{
-		const bool pass = !HqValue::EvaluateAsBoolean(hValue);
+		const bool pass = !HqRegister::EvaluateAsBoolean(*pRegister);
 		if(pass)
 		{
-			_MoveInstructionPointer(hExec, offset);
+			_MoveInstructionPointer(hExec, pOperands[1], pOperands[2]);
 		}
 	}
 	else
@@ -192,8 +216,8 @@ extern "C" void OpCodeExec_JumpIfFalse(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_JumpIfFalse(HqDisassemble& disasm)
 {
-	const uint32_t registerIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const int32_t offset = HqDecoder::LoadInt32(disasm.decoder);
+	const uint32_t registerIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const int32_t offset = HqDecoder::LoadOffset(disasm.decoder);
 	const uintptr_t position = uintptr_t(intptr_t(disasm.opcodeOffset) + offset);
 
 	char str[64];
@@ -205,8 +229,19 @@ extern "C" void OpCodeDisasm_JumpIfFalse(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_JumpIfFalse(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder);
-	HqDecoder::EndianSwapInt32(decoder);
+	HqDecoder::EndianSwapRegister(decoder);
+	HqDecoder::EndianSwapOffset(decoder);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_JumpIfFalse(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].offset = HqDecoder::LoadOffset(decoder);
+
+	// The jump target is resolved after all instructions in the function have been decoded.
+	output.operands[2].pTarget = nullptr;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -42,9 +42,9 @@ extern "C" void OpCodeExec_LoadArray(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t gpDstRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t gpSrcRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t gpArrIdxRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
+	const uint32_t gpDstRegIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
+	const uint32_t gpSrcRegIndex = hExec->hCurrentFrame->pInstruction->operands[1].index;
+	const uint32_t gpArrIdxRegIndex = hExec->hCurrentFrame->pInstruction->operands[2].index;
 
 	// Load the array value from the source register.
 	HqValueHandle hSource = HqFrame::GetGpRegister(hExec->hCurrentFrame, gpSrcRegIndex, &result);
@@ -149,9 +149,9 @@ extern "C" void OpCodeExec_LoadArray(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_LoadArray(HqDisassemble& disasm)
 {
-	const uint32_t gpDstRegIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t gpSrcRegIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t arrayIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t gpDstRegIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t gpSrcRegIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t arrayIndex = HqDecoder::LoadRegister(disasm.decoder);
 
 	char str[64];
 	snprintf(str, sizeof(str), "LOAD_ARRAY r(%" PRIu32 "), r(%" PRIu32 "), r(%" PRIu32 ")", gpDstRegIndex, gpSrcRegIndex, arrayIndex);
@@ -162,9 +162,18 @@ extern "C" void OpCodeDisasm_LoadArray(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_LoadArray(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r#
-	HqDecoder::EndianSwapUint32(decoder); // r#
-	HqDecoder::EndianSwapUint32(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // r#
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_LoadArray(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].index = HqDecoder::LoadRegister(decoder);
+	output.operands[2].index = HqDecoder::LoadRegister(decoder);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
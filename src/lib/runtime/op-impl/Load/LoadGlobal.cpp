@@ -23,6 +23,8 @@
 #include "../../Module.hpp"
 #include "../../Vm.hpp"
 
+#include "../../../common/Atomic.hpp"
+
 #include <assert.h>
 #include <inttypes.h>
 #include <stdio.h>
@@ -42,15 +44,30 @@ extern "C" void OpCodeExec_LoadGlobal(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t registerIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t stringIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
+	HqInstruction* const pInstruction = hExec->hCurrentFrame->pInstruction;
+
+	const uint32_t registerIndex = pInstruction->operands[0].index;
+	const uint32_t stringIndex = pInstruction->operands[1].index;
 
-	HqString* const pVarName = HqModule::GetString(hExec->hCurrentFrame->hFunction->hModule, stringIndex, &result);
+	HqString* const pVarName = pInstruction->operands[2].pString;
 	if(pVarName)
 	{
-		HqValueHandle hGlobalVariable = HqVm::GetGlobalVariable(hExec->hVm, pVarName, &result);
-		if(result == HQ_SUCCESS)
+		// Instructions are shared by every execution context running the function, so the cached slot is accessed
+		// atomically. Every thread resolves a name to the same slot, so racing to cache it is harmless.
+		uint32_t slot = HqAtomic::Load(&pInstruction->operands[3].index);
+		if(slot == HQ_VM_GLOBAL_SLOT_INVALID)
+		{
+			// The global variable wasn't registered yet when this instruction was decoded (it may belong
+			// to a module that was loaded later), so resolve it now. A slot never changes after it's been
+			// assigned, so it's safe to cache it on the instruction for subsequent runs.
+			slot = HqVm::GetGlobalSlot(hExec->hVm, pVarName);
+			HqAtomic::Store(&pInstruction->operands[3].index, slot);
+		}
+
+		if(slot != HQ_VM_GLOBAL_SLOT_INVALID)
 		{
+			HqValueHandle hGlobalVariable = hExec->hVm->globalValues.pData[slot];
+
 			result = HqFrame::SetGpRegister(hExec->hCurrentFrame, hGlobalVariable, registerIndex);
 			if(result != HQ_SUCCESS)
 			{
@@ -90,8 +107,8 @@ extern "C" void OpCodeExec_LoadGlobal(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_LoadGlobal(HqDisassemble& disasm)
 {
-	const uint32_t registerIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t stringIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t registerIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t stringIndex = HqDecoder::LoadIndex(disasm.decoder);
 
 	char str[256];
 	snprintf(str, sizeof(str), "LOAD_GLOBAL r(%" PRIu32 "), s(%" PRIu32 ")", registerIndex, stringIndex);
@@ -102,8 +119,26 @@ extern "C" void OpCodeDisasm_LoadGlobal(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_LoadGlobal(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r#
-	HqDecoder::EndianSwapUint32(decoder); // s#
+	HqDecoder::EndianSwapRegister(decoder); // r#
+	HqDecoder::EndianSwapIndex(decoder); // s#
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_LoadGlobal(HqInstruction& output, HqDecoder& decoder, HqModuleHandle hModule)
+{
+	int result;
+
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].index = HqDecoder::LoadIndex(decoder);
+
+	// Resolve the string operand up front so it doesn't need to be looked up each time the instruction runs.
+	output.operands[2].pString = HqModule::GetString(hModule, output.operands[1].index, &result);
+
+	// Resolve the global variable's slot so the value can be accessed directly.
+	output.operands[3].index = output.operands[2].pString
+		? HqVm::GetGlobalSlot(hModule->hVm, output.operands[2].pString)
+		: HQ_VM_GLOBAL_SLOT_INVALID;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -107,11 +107,11 @@ extern "C" void OpCodeExec_LoadGrid(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t gpDstRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t gpSrcRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t gpGridIdxXRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t gpGridIdxYRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t gpGridIdxZRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
+	const uint32_t gpDstRegIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
+	const uint32_t gpSrcRegIndex = hExec->hCurrentFrame->pInstruction->operands[1].index;
+	const uint32_t gpGridIdxXRegIndex = hExec->hCurrentFrame->pInstruction->operands[2].index;
+	const uint32_t gpGridIdxYRegIndex = hExec->hCurrentFrame->pInstruction->operands[3].index;
+	const uint32_t gpGridIdxZRegIndex = hExec->hCurrentFrame->pInstruction->operands[4].index;
 
 	// Load the grid value from the source register.
 	HqValueHandle hSource = HqFrame::GetGpRegister(hExec->hCurrentFrame, gpSrcRegIndex, &result);
@@ -180,11 +180,11 @@ extern "C" void OpCodeExec_LoadGrid(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_LoadGrid(HqDisassemble& disasm)
 {
-	const uint32_t gpDstRegIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t gpSrcRegIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t gpGridIdxXRegIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t gpGridIdxYRegIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t gpGridIdxZRegIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t gpDstRegIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t gpSrcRegIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t gpGridIdxXRegIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t gpGridIdxYRegIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t gpGridIdxZRegIndex = HqDecoder::LoadRegister(disasm.decoder);
 
 	char str[96];
 	snprintf(str, sizeof(str), "LOAD_GRID r(%" PRIu32 "), r(%" PRIu32 "), r(%" PRIu32 "), r(%" PRIu32 "), r(%" PRIu32 ")", gpDstRegIndex, gpSrcRegIndex, gpGridIdxXRegIndex, gpGridIdxYRegIndex, gpGridIdxZRegIndex);
@@ -195,11 +195,22 @@ extern "C" void OpCodeDisasm_LoadGrid(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_LoadGrid(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r#
-	HqDecoder::EndianSwapUint32(decoder); // r#
-	HqDecoder::EndianSwapUint32(decoder); // r#
-	HqDecoder::EndianSwapUint32(decoder); // r#
-	HqDecoder::EndianSwapUint32(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // r#
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_LoadGrid(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].index = HqDecoder::LoadRegister(decoder);
+	output.operands[2].index = HqDecoder::LoadRegister(decoder);
+	output.operands[3].index = HqDecoder::LoadRegister(decoder);
+	output.operands[4].index = HqDecoder::LoadRegister(decoder);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
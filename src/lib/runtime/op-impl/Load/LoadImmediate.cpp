@@ -54,13 +54,15 @@
 //   r# = General-purpose register index
 //   s# = String table index
 //
+// NOTE: Boolean and numeric constants are stored directly in the register without being boxed.
+//
 //----------------------------------------------------------------------------------------------------------------------
 
 extern "C" void OpCodeExec_LoadImmNull(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t registerIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
+	const uint32_t registerIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
 
 	// Upload the constant to the destination register.
 	result = HqFrame::SetGpRegister(hExec->hCurrentFrame, HQ_VALUE_HANDLE_NULL, registerIndex);
@@ -80,7 +82,7 @@ extern "C" void OpCodeExec_LoadImmNull(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_LoadImmNull(HqDisassemble& disasm)
 {
-	const uint32_t registerIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t registerIndex = HqDecoder::LoadRegister(disasm.decoder);
 
 	char instr[512];
 	snprintf(instr, sizeof(instr), "LOAD_IMM_NULL r(%" PRIu32 ")", registerIndex);
@@ -91,7 +93,14 @@ extern "C" void OpCodeDisasm_LoadImmNull(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_LoadImmNull(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // r#
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_LoadImmNull(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -100,34 +109,22 @@ extern "C" void OpCodeExec_LoadImmBool(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t registerIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const bool rawValue = HqDecoder::LoadBool(hExec->hCurrentFrame->decoder);
+	const uint32_t registerIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
+	const bool rawValue = hExec->hCurrentFrame->pInstruction->operands[1].boolean;
 
-	HqValueHandle hValue = HqValue::CreateBool(hExec->hVm, rawValue);
-	if(hValue)
-	{
-		HqValue::SetAutoMark(hValue, false);
+	HqRegister::Primitive value;
+	value.boolean = rawValue;
 
-		// Upload the constant to the destination register.
-		result = HqFrame::SetGpRegister(hExec->hCurrentFrame, hValue, registerIndex);
-		if(result != HQ_SUCCESS)
-		{
-			// Raise a fatal script exception.
-			HqExecution::RaiseOpCodeException(
-				hExec,
-				HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
-				"Failed to set general-purpose register: r(%" PRIu32 ")",
-				registerIndex
-			);
-		}
-	}
-	else
+	// Upload the constant to the destination register.
+	result = HqFrame::SetGpRegisterPrimitive(hExec->hCurrentFrame, HQ_VALUE_TYPE_BOOL, value, registerIndex);
+	if(result != HQ_SUCCESS)
 	{
 		// Raise a fatal script exception.
 		HqExecution::RaiseOpCodeException(
 			hExec,
 			HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
-			"Failed to create immediate bool value"
+			"Failed to set general-purpose register: r(%" PRIu32 ")",
+			registerIndex
 		);
 	}
 }
@@ -136,7 +133,7 @@ extern "C" void OpCodeExec_LoadImmBool(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_LoadImmBool(HqDisassemble& disasm)
 {
-	const uint32_t registerIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t registerIndex = HqDecoder::LoadRegister(disasm.decoder);
 	const bool rawValue = HqDecoder::LoadBool(disasm.decoder);
 
 	char instr[512];
@@ -148,44 +145,40 @@ extern "C" void OpCodeDisasm_LoadImmBool(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_LoadImmBool(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // r#
 	HqDecoder::EndianSwapBool(decoder); // ##
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
+extern "C" void OpCodeDecode_LoadImmBool(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].boolean = HqDecoder::LoadBool(decoder);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 extern "C" void OpCodeExec_LoadImmI8(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t registerIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const int8_t rawValue = HqDecoder::LoadInt8(hExec->hCurrentFrame->decoder);
+	const uint32_t registerIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
+	const int8_t rawValue = hExec->hCurrentFrame->pInstruction->operands[1].int8;
 
-	HqValueHandle hValue = HqValue::CreateInt8(hExec->hVm, rawValue);
-	if(hValue)
-	{
-		HqValue::SetAutoMark(hValue, false);
+	HqRegister::Primitive value;
+	value.int8 = rawValue;
 
-		// Upload the constant to the destination register.
-		result = HqFrame::SetGpRegister(hExec->hCurrentFrame, hValue, registerIndex);
-		if(result != HQ_SUCCESS)
-		{
-			// Raise a fatal script exception.
-			HqExecution::RaiseOpCodeException(
-				hExec,
-				HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
-				"Failed to set general-purpose register: r(%" PRIu32 ")",
-				registerIndex
-			);
-		}
-	}
-	else
+	// Upload the constant to the destination register.
+	result = HqFrame::SetGpRegisterPrimitive(hExec->hCurrentFrame, HQ_VALUE_TYPE_INT8, value, registerIndex);
+	if(result != HQ_SUCCESS)
 	{
 		// Raise a fatal script exception.
 		HqExecution::RaiseOpCodeException(
 			hExec,
 			HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
-			"Failed to create immediate int8 value"
+			"Failed to set general-purpose register: r(%" PRIu32 ")",
+			registerIndex
 		);
 	}
 }
@@ -194,7 +187,7 @@ extern "C" void OpCodeExec_LoadImmI8(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_LoadImmI8(HqDisassemble& disasm)
 {
-	const uint32_t registerIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t registerIndex = HqDecoder::LoadRegister(disasm.decoder);
 	const int8_t rawValue = HqDecoder::LoadInt8(disasm.decoder);
 
 	char instr[512];
@@ -206,44 +199,40 @@ extern "C" void OpCodeDisasm_LoadImmI8(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_LoadImmI8(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // r#
 	HqDecoder::EndianSwapInt8(decoder); // r#
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
+extern "C" void OpCodeDecode_LoadImmI8(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].int8 = HqDecoder::LoadInt8(decoder);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 extern "C" void OpCodeExec_LoadImmI16(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t registerIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const int16_t rawValue = HqDecoder::LoadInt16(hExec->hCurrentFrame->decoder);
+	const uint32_t registerIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
+	const int16_t rawValue = hExec->hCurrentFrame->pInstruction->operands[1].int16;
 
-	HqValueHandle hValue = HqValue::CreateInt16(hExec->hVm, rawValue);
-	if(hValue)
-	{
-		HqValue::SetAutoMark(hValue, false);
+	HqRegister::Primitive value;
+	value.int16 = rawValue;
 
-		// Upload the constant to the destination register.
-		result = HqFrame::SetGpRegister(hExec->hCurrentFrame, hValue, registerIndex);
-		if(result != HQ_SUCCESS)
-		{
-			// Raise a fatal script exception.
-			HqExecution::RaiseOpCodeException(
-				hExec,
-				HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
-				"Failed to set general-purpose register: r(%" PRIu32 ")",
-				registerIndex
-			);
-		}
-	}
-	else
+	// Upload the constant to the destination register.
+	result = HqFrame::SetGpRegisterPrimitive(hExec->hCurrentFrame, HQ_VALUE_TYPE_INT16, value, registerIndex);
+	if(result != HQ_SUCCESS)
 	{
 		// Raise a fatal script exception.
 		HqExecution::RaiseOpCodeException(
 			hExec,
 			HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
-			"Failed to create immediate int16 value"
+			"Failed to set general-purpose register: r(%" PRIu32 ")",
+			registerIndex
 		);
 	}
 }
@@ -252,7 +241,7 @@ extern "C" void OpCodeExec_LoadImmI16(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_LoadImmI16(HqDisassemble& disasm)
 {
-	const uint32_t registerIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t registerIndex = HqDecoder::LoadRegister(disasm.decoder);
 	const int16_t rawValue = HqDecoder::LoadInt16(disasm.decoder);
 
 	char instr[512];
@@ -264,44 +253,40 @@ extern "C" void OpCodeDisasm_LoadImmI16(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_LoadImmI16(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // r#
 	HqDecoder::EndianSwapInt16(decoder); // ##
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
+extern "C" void OpCodeDecode_LoadImmI16(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].int16 = HqDecoder::LoadInt16(decoder);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 extern "C" void OpCodeExec_LoadImmI32(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t registerIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const int32_t rawValue = HqDecoder::LoadInt32(hExec->hCurrentFrame->decoder);
+	const uint32_t registerIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
+	const int32_t rawValue = hExec->hCurrentFrame->pInstruction->operands[1].int32;
 
-	HqValueHandle hValue = HqValue::CreateInt32(hExec->hVm, rawValue);
-	if(hValue)
-	{
-		HqValue::SetAutoMark(hValue, false);
+	HqRegister::Primitive value;
+	value.int32 = rawValue;
 
-		// Upload the constant to the destination register.
-		result = HqFrame::SetGpRegister(hExec->hCurrentFrame, hValue, registerIndex);
-		if(result != HQ_SUCCESS)
-		{
-			// Raise a fatal script exception.
-			HqExecution::RaiseOpCodeException(
-				hExec,
-				HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
-				"Failed to set general-purpose register: r(%" PRIu32 ")",
-				registerIndex
-			);
-		}
-	}
-	else
+	// Upload the constant to the destination register.
+	result = HqFrame::SetGpRegisterPrimitive(hExec->hCurrentFrame, HQ_VALUE_TYPE_INT32, value, registerIndex);
+	if(result != HQ_SUCCESS)
 	{
 		// Raise a fatal script exception.
 		HqExecution::RaiseOpCodeException(
 			hExec,
 			HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
-			"Failed to create immediate int32 value"
+			"Failed to set general-purpose register: r(%" PRIu32 ")",
+			registerIndex
 		);
 	}
 }
@@ -310,7 +295,7 @@ extern "C" void OpCodeExec_LoadImmI32(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_LoadImmI32(HqDisassemble& disasm)
 {
-	const uint32_t registerIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t registerIndex = HqDecoder::LoadRegister(disasm.decoder);
 	const int32_t rawValue = HqDecoder::LoadInt32(disasm.decoder);
 
 	char instr[512];
@@ -322,44 +307,40 @@ extern "C" void OpCodeDisasm_LoadImmI32(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_LoadImmI32(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // r#
 	HqDecoder::EndianSwapInt32(decoder); // ##
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
+extern "C" void OpCodeDecode_LoadImmI32(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].int32 = HqDecoder::LoadInt32(decoder);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 extern "C" void OpCodeExec_LoadImmI64(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t registerIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const int64_t rawValue = HqDecoder::LoadInt64(hExec->hCurrentFrame->decoder);
+	const uint32_t registerIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
+	const int64_t rawValue = hExec->hCurrentFrame->pInstruction->operands[1].int64;
 
-	HqValueHandle hValue = HqValue::CreateInt64(hExec->hVm, rawValue);
-	if(hValue)
-	{
-		HqValue::SetAutoMark(hValue, false);
+	HqRegister::Primitive value;
+	value.int64 = rawValue;
 
-		// Upload the constant to the destination register.
-		result = HqFrame::SetGpRegister(hExec->hCurrentFrame, hValue, registerIndex);
-		if(result != HQ_SUCCESS)
-		{
-			// Raise a fatal script exception.
-			HqExecution::RaiseOpCodeException(
-				hExec,
-				HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
-				"Failed to set general-purpose register: r(%" PRIu32 ")",
-				registerIndex
-			);
-		}
-	}
-	else
+	// Upload the constant to the destination register.
+	result = HqFrame::SetGpRegisterPrimitive(hExec->hCurrentFrame, HQ_VALUE_TYPE_INT64, value, registerIndex);
+	if(result != HQ_SUCCESS)
 	{
 		// Raise a fatal script exception.
 		HqExecution::RaiseOpCodeException(
 			hExec,
 			HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
-			"Failed to create immediate int64 value"
+			"Failed to set general-purpose register: r(%" PRIu32 ")",
+			registerIndex
 		);
 	}
 }
@@ -368,7 +349,7 @@ extern "C" void OpCodeExec_LoadImmI64(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_LoadImmI64(HqDisassemble& disasm)
 {
-	const uint32_t registerIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t registerIndex = HqDecoder::LoadRegister(disasm.decoder);
 	const int64_t rawValue = HqDecoder::LoadInt64(disasm.decoder);
 
 	char instr[512];
@@ -380,44 +361,40 @@ extern "C" void OpCodeDisasm_LoadImmI64(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_LoadImmI64(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // r#
 	HqDecoder::EndianSwapInt64(decoder); // ##
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
+extern "C" void OpCodeDecode_LoadImmI64(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].int64 = HqDecoder::LoadInt64(decoder);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 extern "C" void OpCodeExec_LoadImmU8(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t registerIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint8_t rawValue = HqDecoder::LoadUint8(hExec->hCurrentFrame->decoder);
+	const uint32_t registerIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
+	const uint8_t rawValue = hExec->hCurrentFrame->pInstruction->operands[1].uint8;
 
-	HqValueHandle hValue = HqValue::CreateUint8(hExec->hVm, rawValue);
-	if(hValue)
-	{
-		HqValue::SetAutoMark(hValue, false);
+	HqRegister::Primitive value;
+	value.uint8 = rawValue;
 
-		// Upload the constant to the destination register.
-		result = HqFrame::SetGpRegister(hExec->hCurrentFrame, hValue, registerIndex);
-		if(result != HQ_SUCCESS)
-		{
-			// Raise a fatal script exception.
-			HqExecution::RaiseOpCodeException(
-				hExec,
-				HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
-				"Failed to set general-purpose register: r(%" PRIu32 ")",
-				registerIndex
-			);
-		}
-	}
-	else
+	// Upload the constant to the destination register.
+	result = HqFrame::SetGpRegisterPrimitive(hExec->hCurrentFrame, HQ_VALUE_TYPE_UINT8, value, registerIndex);
+	if(result != HQ_SUCCESS)
 	{
 		// Raise a fatal script exception.
 		HqExecution::RaiseOpCodeException(
 			hExec,
 			HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
-			"Failed to create immediate uint8 value"
+			"Failed to set general-purpose register: r(%" PRIu32 ")",
+			registerIndex
 		);
 	}
 }
@@ -426,7 +403,7 @@ extern "C" void OpCodeExec_LoadImmU8(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_LoadImmU8(HqDisassemble& disasm)
 {
-	const uint32_t registerIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t registerIndex = HqDecoder::LoadRegister(disasm.decoder);
 	const uint8_t rawValue = HqDecoder::LoadUint8(disasm.decoder);
 
 	char instr[512];
@@ -438,44 +415,40 @@ extern "C" void OpCodeDisasm_LoadImmU8(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_LoadImmU8(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // r#
 	HqDecoder::EndianSwapUint8(decoder); // ##
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
+extern "C" void OpCodeDecode_LoadImmU8(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].uint8 = HqDecoder::LoadUint8(decoder);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 extern "C" void OpCodeExec_LoadImmU16(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t registerIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint16_t rawValue = HqDecoder::LoadUint16(hExec->hCurrentFrame->decoder);
+	const uint32_t registerIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
+	const uint16_t rawValue = hExec->hCurrentFrame->pInstruction->operands[1].uint16;
 
-	HqValueHandle hValue = HqValue::CreateUint16(hExec->hVm, rawValue);
-	if(hValue)
-	{
-		HqValue::SetAutoMark(hValue, false);
+	HqRegister::Primitive value;
+	value.uint16 = rawValue;
 
-		// Upload the constant to the destination register.
-		result = HqFrame::SetGpRegister(hExec->hCurrentFrame, hValue, registerIndex);
-		if(result != HQ_SUCCESS)
-		{
-			// Raise a fatal script exception.
-			HqExecution::RaiseOpCodeException(
-				hExec,
-				HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
-				"Failed to set general-purpose register: r(%" PRIu32 ")",
-				registerIndex
-			);
-		}
-	}
-	else
+	// Upload the constant to the destination register.
+	result = HqFrame::SetGpRegisterPrimitive(hExec->hCurrentFrame, HQ_VALUE_TYPE_UINT16, value, registerIndex);
+	if(result != HQ_SUCCESS)
 	{
 		// Raise a fatal script exception.
 		HqExecution::RaiseOpCodeException(
 			hExec,
 			HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
-			"Failed to create immediate uint16 value"
+			"Failed to set general-purpose register: r(%" PRIu32 ")",
+			registerIndex
 		);
 	}
 }
@@ -484,7 +457,7 @@ extern "C" void OpCodeExec_LoadImmU16(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_LoadImmU16(HqDisassemble& disasm)
 {
-	const uint32_t registerIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t registerIndex = HqDecoder::LoadRegister(disasm.decoder);
 	const uint16_t rawValue = HqDecoder::LoadUint16(disasm.decoder);
 
 	char instr[512];
@@ -496,44 +469,40 @@ extern "C" void OpCodeDisasm_LoadImmU16(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_LoadImmU16(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // r#
 	HqDecoder::EndianSwapUint16(decoder); // ##
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
+extern "C" void OpCodeDecode_LoadImmU16(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].uint16 = HqDecoder::LoadUint16(decoder);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 extern "C" void OpCodeExec_LoadImmU32(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t registerIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t rawValue = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
+	const uint32_t registerIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
+	const uint32_t rawValue = hExec->hCurrentFrame->pInstruction->operands[1].uint32;
 
-	HqValueHandle hValue = HqValue::CreateUint32(hExec->hVm, rawValue);
-	if(hValue)
-	{
-		HqValue::SetAutoMark(hValue, false);
+	HqRegister::Primitive value;
+	value.uint32 = rawValue;
 
-		// Upload the constant to the destination register.
-		result = HqFrame::SetGpRegister(hExec->hCurrentFrame, hValue, registerIndex);
-		if(result != HQ_SUCCESS)
-		{
-			// Raise a fatal script exception.
-			HqExecution::RaiseOpCodeException(
-				hExec,
-				HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
-				"Failed to set general-purpose register: r(%" PRIu32 ")",
-				registerIndex
-			);
-		}
-	}
-	else
+	// Upload the constant to the destination register.
+	result = HqFrame::SetGpRegisterPrimitive(hExec->hCurrentFrame, HQ_VALUE_TYPE_UINT32, value, registerIndex);
+	if(result != HQ_SUCCESS)
 	{
 		// Raise a fatal script exception.
 		HqExecution::RaiseOpCodeException(
 			hExec,
 			HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
-			"Failed to create immediate uint32 value"
+			"Failed to set general-purpose register: r(%" PRIu32 ")",
+			registerIndex
 		);
 	}
 }
@@ -542,7 +511,7 @@ extern "C" void OpCodeExec_LoadImmU32(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_LoadImmU32(HqDisassemble& disasm)
 {
-	const uint32_t registerIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t registerIndex = HqDecoder::LoadRegister(disasm.decoder);
 	const uint32_t rawValue = HqDecoder::LoadUint32(disasm.decoder);
 
 	char instr[512];
@@ -554,44 +523,40 @@ extern "C" void OpCodeDisasm_LoadImmU32(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_LoadImmU32(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // r#
 	HqDecoder::EndianSwapUint32(decoder); // ##
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
+extern "C" void OpCodeDecode_LoadImmU32(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].uint32 = HqDecoder::LoadUint32(decoder);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 extern "C" void OpCodeExec_LoadImmU64(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t registerIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint64_t rawValue = HqDecoder::LoadUint64(hExec->hCurrentFrame->decoder);
+	const uint32_t registerIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
+	const uint64_t rawValue = hExec->hCurrentFrame->pInstruction->operands[1].uint64;
 
-	HqValueHandle hValue = HqValue::CreateUint64(hExec->hVm, rawValue);
-	if(hValue)
-	{
-		HqValue::SetAutoMark(hValue, false);
+	HqRegister::Primitive value;
+	value.uint64 = rawValue;
 
-		// Upload the constant to the destination register.
-		result = HqFrame::SetGpRegister(hExec->hCurrentFrame, hValue, registerIndex);
-		if(result != HQ_SUCCESS)
-		{
-			// Raise a fatal script exception.
-			HqExecution::RaiseOpCodeException(
-				hExec,
-				HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
-				"Failed to set general-purpose register: r(%" PRIu32 ")",
-				registerIndex
-			);
-		}
-	}
-	else
+	// Upload the constant to the destination register.
+	result = HqFrame::SetGpRegisterPrimitive(hExec->hCurrentFrame, HQ_VALUE_TYPE_UINT64, value, registerIndex);
+	if(result != HQ_SUCCESS)
 	{
 		// Raise a fatal script exception.
 		HqExecution::RaiseOpCodeException(
 			hExec,
 			HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
-			"Failed to create immediate uint64 value"
+			"Failed to set general-purpose register: r(%" PRIu32 ")",
+			registerIndex
 		);
 	}
 }
@@ -600,7 +565,7 @@ extern "C" void OpCodeExec_LoadImmU64(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_LoadImmU64(HqDisassemble& disasm)
 {
-	const uint32_t registerIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t registerIndex = HqDecoder::LoadRegister(disasm.decoder);
 	const uint64_t rawValue = HqDecoder::LoadUint64(disasm.decoder);
 
 	char instr[512];
@@ -612,44 +577,40 @@ extern "C" void OpCodeDisasm_LoadImmU64(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_LoadImmU64(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // r#
 	HqDecoder::EndianSwapUint64(decoder); // ##
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
+extern "C" void OpCodeDecode_LoadImmU64(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].uint64 = HqDecoder::LoadUint64(decoder);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 extern "C" void OpCodeExec_LoadImmF32(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t registerIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const float rawValue = HqDecoder::LoadFloat32(hExec->hCurrentFrame->decoder);
+	const uint32_t registerIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
+	const float rawValue = hExec->hCurrentFrame->pInstruction->operands[1].float32;
 
-	HqValueHandle hValue = HqValue::CreateFloat32(hExec->hVm, rawValue);
-	if(hValue)
-	{
-		HqValue::SetAutoMark(hValue, false);
+	HqRegister::Primitive value;
+	value.float32 = rawValue;
 
-		// Upload the constant to the destination register.
-		result = HqFrame::SetGpRegister(hExec->hCurrentFrame, hValue, registerIndex);
-		if(result != HQ_SUCCESS)
-		{
-			// Raise a fatal script exception.
-			HqExecution::RaiseOpCodeException(
-				hExec,
-				HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
-				"Failed to set general-purpose register: r(%" PRIu32 ")",
-				registerIndex
-			);
-		}
-	}
-	else
+	// Upload the constant to the destination register.
+	result = HqFrame::SetGpRegisterPrimitive(hExec->hCurrentFrame, HQ_VALUE_TYPE_FLOAT32, value, registerIndex);
+	if(result != HQ_SUCCESS)
 	{
 		// Raise a fatal script exception.
 		HqExecution::RaiseOpCodeException(
 			hExec,
 			HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
-			"Failed to create immediate float32 value"
+			"Failed to set general-purpose register: r(%" PRIu32 ")",
+			registerIndex
 		);
 	}
 }
@@ -658,7 +619,7 @@ extern "C" void OpCodeExec_LoadImmF32(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_LoadImmF32(HqDisassemble& disasm)
 {
-	const uint32_t registerIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t registerIndex = HqDecoder::LoadRegister(disasm.decoder);
 	const float rawValue = HqDecoder::LoadFloat32(disasm.decoder);
 
 	char instr[512];
@@ -670,44 +631,40 @@ extern "C" void OpCodeDisasm_LoadImmF32(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_LoadImmF32(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // r#
 	HqDecoder::EndianSwapFloat32(decoder); // ##
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
+extern "C" void OpCodeDecode_LoadImmF32(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].float32 = HqDecoder::LoadFloat32(decoder);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 extern "C" void OpCodeExec_LoadImmF64(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t registerIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const double rawValue = HqDecoder::LoadFloat64(hExec->hCurrentFrame->decoder);
+	const uint32_t registerIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
+	const double rawValue = hExec->hCurrentFrame->pInstruction->operands[1].float64;
 
-	HqValueHandle hValue = HqValue::CreateFloat64(hExec->hVm, rawValue);
-	if(hValue)
-	{
-		HqValue::SetAutoMark(hValue, false);
+	HqRegister::Primitive value;
+	value.float64 = rawValue;
 
-		// Upload the constant to the destination register.
-		result = HqFrame::SetGpRegister(hExec->hCurrentFrame, hValue, registerIndex);
-		if(result != HQ_SUCCESS)
-		{
-			// Raise a fatal script exception.
-			HqExecution::RaiseOpCodeException(
-				hExec,
-				HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
-				"Failed to set general-purpose register: r(%" PRIu32 ")",
-				registerIndex
-			);
-		}
-	}
-	else
+	// Upload the constant to the destination register.
+	result = HqFrame::SetGpRegisterPrimitive(hExec->hCurrentFrame, HQ_VALUE_TYPE_FLOAT64, value, registerIndex);
+	if(result != HQ_SUCCESS)
 	{
 		// Raise a fatal script exception.
 		HqExecution::RaiseOpCodeException(
 			hExec,
 			HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
-			"Failed to create immediate float64 value"
+			"Failed to set general-purpose register: r(%" PRIu32 ")",
+			registerIndex
 		);
 	}
 }
@@ -716,7 +673,7 @@ extern "C" void OpCodeExec_LoadImmF64(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_LoadImmF64(HqDisassemble& disasm)
 {
-	const uint32_t registerIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t registerIndex = HqDecoder::LoadRegister(disasm.decoder);
 	const double rawValue = HqDecoder::LoadFloat64(disasm.decoder);
 
 	char instr[512];
@@ -728,20 +685,28 @@ extern "C" void OpCodeDisasm_LoadImmF64(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_LoadImmF64(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // r#
 	HqDecoder::EndianSwapFloat64(decoder); // ##
 }
 
 //----------------------------------------------------------------------------------------------------------------------
 
+extern "C" void OpCodeDecode_LoadImmF64(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].float64 = HqDecoder::LoadFloat64(decoder);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 extern "C" void OpCodeExec_LoadImmStr(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t registerIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t stringIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
+	const uint32_t registerIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
+	const uint32_t stringIndex = hExec->hCurrentFrame->pInstruction->operands[1].index;
 
-	HqString* const pString = HqModule::GetString(hExec->hCurrentFrame->hFunction->hModule, stringIndex, &result);
+	HqString* const pString = hExec->hCurrentFrame->pInstruction->operands[2].pString;
 	if(pString)
 	{
 		HqValueHandle hValue = HqValue::CreateString(hExec->hVm, pString);
@@ -789,8 +754,8 @@ extern "C" void OpCodeExec_LoadImmStr(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_LoadImmStr(HqDisassemble& disasm)
 {
-	const uint32_t registerIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t stringIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t registerIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t stringIndex = HqDecoder::LoadIndex(disasm.decoder);
 
 	char instr[512];
 	snprintf(instr, sizeof(instr), "LOAD_IMM_STR r(%" PRIu32 "), s(%" PRIu32 ")", registerIndex, stringIndex);
@@ -801,8 +766,21 @@ extern "C" void OpCodeDisasm_LoadImmStr(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_LoadImmStr(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r#
-	HqDecoder::EndianSwapUint32(decoder); // s#
+	HqDecoder::EndianSwapRegister(decoder); // r#
+	HqDecoder::EndianSwapIndex(decoder); // s#
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_LoadImmStr(HqInstruction& output, HqDecoder& decoder, HqModuleHandle hModule)
+{
+	int result;
+
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].index = HqDecoder::LoadIndex(decoder);
+
+	// Resolve the string operand up front so it doesn't need to be looked up each time the instruction runs.
+	output.operands[2].pString = HqModule::GetString(hModule, output.operands[1].index, &result);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -42,9 +42,9 @@ extern "C" void OpCodeExec_LoadObject(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t gpDstRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t gpSrcRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t memberIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
+	const uint32_t gpDstRegIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
+	const uint32_t gpSrcRegIndex = hExec->hCurrentFrame->pInstruction->operands[1].index;
+	const uint32_t memberIndex = hExec->hCurrentFrame->pInstruction->operands[2].index;
 
 	// Load the object value from the source register.
 	HqValueHandle hSource = HqFrame::GetGpRegister(hExec->hCurrentFrame, gpSrcRegIndex, &result);
@@ -110,9 +110,9 @@ extern "C" void OpCodeExec_LoadObject(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_LoadObject(HqDisassemble& disasm)
 {
-	const uint32_t gpDstRegIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t gpSrcRegIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t memberIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t gpDstRegIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t gpSrcRegIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t memberIndex = HqDecoder::LoadIndex(disasm.decoder);
 
 	char str[64];
 	snprintf(str, sizeof(str), "LOAD_OBJECT r(%" PRIu32 "), r(%" PRIu32 "), %" PRIu32, gpDstRegIndex, gpSrcRegIndex, memberIndex);
@@ -123,9 +123,18 @@ extern "C" void OpCodeDisasm_LoadObject(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_LoadObject(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r#
-	HqDecoder::EndianSwapUint32(decoder); // r#
-	HqDecoder::EndianSwapUint32(decoder); // ##
+	HqDecoder::EndianSwapRegister(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // r#
+	HqDecoder::EndianSwapIndex(decoder); // ##
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_LoadObject(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].index = HqDecoder::LoadRegister(decoder);
+	output.operands[2].index = HqDecoder::LoadIndex(decoder);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
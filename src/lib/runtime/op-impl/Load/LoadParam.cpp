@@ -40,8 +40,8 @@ extern "C" void OpCodeExec_LoadParam(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t gpRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t ioRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
+	const uint32_t gpRegIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
+	const uint32_t ioRegIndex = hExec->hCurrentFrame->pInstruction->operands[1].index;
 
 	// Load the value from the I/O register.
 	HqValueHandle hValue = HqExecution::GetIoRegister(hExec, ioRegIndex, &result);
@@ -76,8 +76,8 @@ extern "C" void OpCodeExec_LoadParam(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_LoadParam(HqDisassemble& disasm)
 {
-	const uint32_t gpRegIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t ioRegIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t gpRegIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t ioRegIndex = HqDecoder::LoadRegister(disasm.decoder);
 
 	char str[64];
 	snprintf(str, sizeof(str), "LOAD_PARAM r(%" PRIu32 "), p(%" PRIu32 ")", gpRegIndex, ioRegIndex);
@@ -88,8 +88,16 @@ extern "C" void OpCodeDisasm_LoadParam(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_LoadParam(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r#
-	HqDecoder::EndianSwapUint32(decoder); // p#
+	HqDecoder::EndianSwapRegister(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // p#
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_LoadParam(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].index = HqDecoder::LoadRegister(decoder);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
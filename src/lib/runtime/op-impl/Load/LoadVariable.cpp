@@ -40,8 +40,8 @@ extern "C" void OpCodeExec_LoadVariable(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t gpRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t vrRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
+	const uint32_t gpRegIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
+	const uint32_t vrRegIndex = hExec->hCurrentFrame->pInstruction->operands[1].index;
 
 	// Load the value from the variable register.
 	HqValueHandle hValue = HqFrame::GetVrRegister(hExec->hCurrentFrame, vrRegIndex, &result);
@@ -76,8 +76,8 @@ extern "C" void OpCodeExec_LoadVariable(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_LoadVariable(HqDisassemble& disasm)
 {
-	const uint32_t gpRegIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t vrRegIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t gpRegIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t vrRegIndex = HqDecoder::LoadRegister(disasm.decoder);
 
 	char str[64];
 	snprintf(str, sizeof(str), "LOAD_VAR r(%" PRIu32 "), v(%" PRIu32 ")", gpRegIndex, vrRegIndex);
@@ -88,8 +88,16 @@ extern "C" void OpCodeDisasm_LoadVariable(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_LoadVariable(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r#
-	HqDecoder::EndianSwapUint32(decoder); // v#
+	HqDecoder::EndianSwapRegister(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // v#
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_LoadVariable(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].index = HqDecoder::LoadRegister(decoder);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -37,16 +37,20 @@
 
 extern "C" void OpCodeExec_Move(HqExecutionHandle hExec)
 {
-	int result;
+	const uint32_t gpDstRegIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
+	const uint32_t gpSrcRegIndex = hExec->hCurrentFrame->pInstruction->operands[1].index;
 
-	const uint32_t gpDstRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t gpSrcRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-
-	HqValueHandle hSource = HqFrame::GetGpRegister(hExec->hCurrentFrame, gpSrcRegIndex, &result);
-	if(result == HQ_SUCCESS)
+	HqRegister* const pSource = HqFrame::GetGpRegisterSlot(hExec->hCurrentFrame, gpSrcRegIndex);
+	if(pSource)
 	{
-		result = HqFrame::SetGpRegister(hExec->hCurrentFrame, hSource, gpDstRegIndex);
-		if(result != HQ_SUCCESS)
+		HqRegister* const pDest = HqFrame::GetGpRegisterSlot(hExec->hCurrentFrame, gpDstRegIndex);
+		if(pDest)
+		{
+			// Primitives can't be modified in place, so copying the register as-is gives the destination
+			// an equal value without having to box it first.
+			(*pDest) = (*pSource);
+		}
+		else
 		{
 			// Raise a fatal script exception.
 			HqExecution::RaiseOpCodeException(
@@ -73,8 +77,8 @@ extern "C" void OpCodeExec_Move(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_Move(HqDisassemble& disasm)
 {
-	const uint32_t gpDstRegIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t gpSrcRegIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t gpDstRegIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t gpSrcRegIndex = HqDecoder::LoadRegister(disasm.decoder);
 
 	char str[64];
 	snprintf(str, sizeof(str), "MOV r(%" PRIu32 "), r(%" PRIu32 ")", gpDstRegIndex, gpSrcRegIndex);
@@ -85,8 +89,16 @@ extern "C" void OpCodeDisasm_Move(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_Move(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r# [first]
-	HqDecoder::EndianSwapUint32(decoder); // r# [second]
+	HqDecoder::EndianSwapRegister(decoder); // r# [first]
+	HqDecoder::EndianSwapRegister(decoder); // r# [second]
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_Move(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].index = HqDecoder::LoadRegister(decoder);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -49,3 +49,9 @@ extern "C" void OpCodeEndian_Nop(HqDecoder& /*decoder*/)
 }
 
 //----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_Nop(HqInstruction& /*output*/, HqDecoder& /*decoder*/, HqModuleHandle /*hModule*/)
+{
+}
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -38,7 +38,7 @@ extern "C" void OpCodeExec_Pop(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t registerIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
+	const uint32_t registerIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
 
 	HqValueHandle hValue = HQ_VALUE_HANDLE_NULL;
 
@@ -65,7 +65,7 @@ extern "C" void OpCodeExec_Pop(HqExecutionHandle hExec)
 			HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
 			"Failed to pop value from stack at frame: \"%s\", offset(0x%" PRIXPTR ")",
 			hExec->hCurrentFrame->hFunction->pSignature->data,
-			uintptr_t(hExec->hCurrentFrame->decoder.cachedIp)
+			uintptr_t(hExec->hCurrentFrame->pInstruction->offset)
 		);
 	}
 }
@@ -74,7 +74,7 @@ extern "C" void OpCodeExec_Pop(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_Pop(HqDisassemble& disasm)
 {
-	const uint32_t registerIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t registerIndex = HqDecoder::LoadRegister(disasm.decoder);
 
 	char str[16];
 	snprintf(str, sizeof(str), "POP r(%" PRIu32 ")", registerIndex);
@@ -85,7 +85,14 @@ extern "C" void OpCodeDisasm_Pop(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_Pop(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder);
+	HqDecoder::EndianSwapRegister(decoder);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_Pop(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
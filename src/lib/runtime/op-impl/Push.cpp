@@ -38,7 +38,7 @@ extern "C" void OpCodeExec_Push(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t registerIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
+	const uint32_t registerIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
 
 	HqValueHandle hValue = HqFrame::GetGpRegister(hExec->hCurrentFrame, registerIndex, &result);
 	if(result == HQ_SUCCESS)
@@ -52,7 +52,7 @@ extern "C" void OpCodeExec_Push(HqExecutionHandle hExec)
 				HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
 				"Failed to push value onto stack at frame: \"%s\", offset(0x%" PRIXPTR ")",
 				hExec->hCurrentFrame->hFunction->pSignature->data,
-				uintptr_t(hExec->hCurrentFrame->decoder.cachedIp)
+				uintptr_t(hExec->hCurrentFrame->pInstruction->offset)
 			);
 		}
 	}
@@ -72,7 +72,7 @@ extern "C" void OpCodeExec_Push(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_Push(HqDisassemble& disasm)
 {
-	const uint32_t registerIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t registerIndex = HqDecoder::LoadRegister(disasm.decoder);
 
 	char str[16];
 	snprintf(str, sizeof(str), "PUSH r(%" PRIu32 ")", registerIndex);
@@ -83,7 +83,14 @@ extern "C" void OpCodeDisasm_Push(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_Push(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder);
+	HqDecoder::EndianSwapRegister(decoder);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_Push(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -38,7 +38,7 @@ extern "C" void OpCodeExec_Raise(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t registerIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
+	const uint32_t registerIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
 
 	HqValueHandle hValue = HqFrame::GetGpRegister(hExec->hCurrentFrame, registerIndex, &result);
 	if(result == HQ_SUCCESS)
@@ -62,7 +62,7 @@ extern "C" void OpCodeExec_Raise(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_Raise(HqDisassemble& disasm)
 {
-	const uint32_t registerIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t registerIndex = HqDecoder::LoadRegister(disasm.decoder);
 
 	char str[24];
 	snprintf(str, sizeof(str), "RAISE r(%" PRIu32 ")", registerIndex);
@@ -73,7 +73,14 @@ extern "C" void OpCodeDisasm_Raise(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_Raise(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder);
+	HqDecoder::EndianSwapRegister(decoder);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_Raise(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -34,6 +34,36 @@
 
 extern "C" void OpCodeExec_Return(HqExecutionHandle hExec)
 {
+	// Function returns are a safepoint for the garbage collector.
+	HqGarbageCollector::PollSafepoint(hExec->hVm->gc);
+
+	HqFrameHandle hFrame = hExec->hCurrentFrame;
+	HqFunctionHandle hFunction = hFrame->hFunction;
+
+	const uint32_t windowBase = hFrame->windowBase;
+	const bool sharesWindow = hFunction->usesRegisterWindow && windowBase != HQ_FRAME_NO_WINDOW;
+
+	if(hFunction->usesRegisterWindow && windowBase == HQ_FRAME_NO_WINDOW)
+	{
+		// The caller expects the return values in the I/O registers.
+		HqExecution::_copyFrameToIoRegisters(hExec, hFrame, 0, hFunction->numReturnValues);
+	}
+	else if(sharesWindow && hFunction->numReturnValues > hFrame->gpRegisterHighWaterMark)
+	{
+		const uint32_t returnRegisterCount = (hFunction->numReturnValues < hFrame->registers.count)
+			? uint32_t(hFunction->numReturnValues)
+			: uint32_t(hFrame->registers.count);
+
+		// Clear any return registers the callee never wrote so the caller doesn't pick up stale values.
+		if(returnRegisterCount > 0)
+		{
+			HqFrame::_raiseGpHighWaterMark(hFrame, returnRegisterCount - 1);
+		}
+	}
+
+	// Registers touched by a callee sharing the caller's window remain valid in the caller after returning.
+	const uint32_t windowRegisterCount = hFrame->gpRegisterHighWaterMark;
+
 	const int result = HqExecution::PopFrame(hExec);
 
 	if(result != HQ_SUCCESS)
@@ -51,6 +81,17 @@ extern "C" void OpCodeExec_Return(HqExecutionHandle hExec)
 		// The entry point function was popped from the frame stack meaning execution is complete.
 		hExec->state.finished = true;
 	}
+	else if(sharesWindow)
+	{
+		// The return values were written directly into the caller's window, so its high-water mark
+		// needs to cover them for the caller to read them and for the GC to scan them.
+		HqFrame::_adoptWindowRegisters(hExec->hCurrentFrame, windowBase, windowRegisterCount);
+	}
+	else if(windowBase != HQ_FRAME_NO_WINDOW)
+	{
+		// The caller expects the return values in its register window.
+		HqExecution::_copyIoRegistersToFrame(hExec, hExec->hCurrentFrame, windowBase, hFunction->numReturnValues);
+	}
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -67,3 +108,9 @@ extern "C" void OpCodeEndian_Return(HqDecoder& /*decoder*/)
 }
 
 //----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_Return(HqInstruction& /*output*/, HqDecoder& /*decoder*/, HqModuleHandle /*hModule*/)
+{
+}
+
+//----------------------------------------------------------------------------------------------------------------------
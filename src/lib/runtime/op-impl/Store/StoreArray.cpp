@@ -22,6 +22,7 @@
 #include "../../Execution.hpp"
 #include "../../Frame.hpp"
 #include "../../ScriptObject.hpp"
+#include "../../Vm.hpp"
 
 #include <inttypes.h>
 #include <stdio.h>
@@ -42,9 +43,9 @@ extern "C" void OpCodeExec_StoreArray(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t gpDstRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t gpSrcRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t gpArrIdxRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
+	const uint32_t gpDstRegIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
+	const uint32_t gpSrcRegIndex = hExec->hCurrentFrame->pInstruction->operands[1].index;
+	const uint32_t gpArrIdxRegIndex = hExec->hCurrentFrame->pInstruction->operands[2].index;
 
 	// Load the array from the destination register.
 	HqValueHandle hDestination = HqFrame::GetGpRegister(hExec->hCurrentFrame, gpDstRegIndex, &result);
@@ -86,7 +87,9 @@ extern "C" void OpCodeExec_StoreArray(HqExecutionHandle hExec)
 					HqValueHandle hSource = HqFrame::GetGpRegister(hExec->hCurrentFrame, gpSrcRegIndex, &result);
 					if(result == HQ_SUCCESS)
 					{
-						hDestination->as.array.pData[arrayIndex] = hSource;
+						HqGarbageCollector::WriteBarrier(hExec->hVm->gc, &hDestination->gcProxy);
+
+						HqValue::StoreElement(&hDestination->as.array.pData[arrayIndex], hSource);
 					}
 					else
 					{
@@ -140,9 +143,9 @@ extern "C" void OpCodeExec_StoreArray(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_StoreArray(HqDisassemble& disasm)
 {
-	const uint32_t gpDstRegIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t gpSrcRegIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t gpArrIdxRegIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t gpDstRegIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t gpSrcRegIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t gpArrIdxRegIndex = HqDecoder::LoadRegister(disasm.decoder);
 
 	char str[64];
 	snprintf(str, sizeof(str), "STORE_ARRAY r(%" PRIu32 "), r(%" PRIu32 "), r(%" PRIu32 ")", gpDstRegIndex, gpSrcRegIndex, gpArrIdxRegIndex);
@@ -153,9 +156,18 @@ extern "C" void OpCodeDisasm_StoreArray(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_StoreArray(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r#
-	HqDecoder::EndianSwapUint32(decoder); // r#
-	HqDecoder::EndianSwapUint32(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // r#
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_StoreArray(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].index = HqDecoder::LoadRegister(decoder);
+	output.operands[2].index = HqDecoder::LoadRegister(decoder);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
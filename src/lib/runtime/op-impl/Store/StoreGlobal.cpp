@@ -23,6 +23,8 @@
 #include "../../Module.hpp"
 #include "../../Vm.hpp"
 
+#include "../../../common/Atomic.hpp"
+
 #include <assert.h>
 #include <inttypes.h>
 #include <stdio.h>
@@ -42,17 +44,32 @@ extern "C" void OpCodeExec_StoreGlobal(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t stringIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t registerIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
+	HqInstruction* const pInstruction = hExec->hCurrentFrame->pInstruction;
+
+	const uint32_t stringIndex = pInstruction->operands[0].index;
+	const uint32_t registerIndex = pInstruction->operands[1].index;
 
-	HqString* const pVarName = HqModule::GetString(hExec->hCurrentFrame->hFunction->hModule, stringIndex, &result);
+	HqString* const pVarName = pInstruction->operands[2].pString;
 	if(pVarName)
 	{
 		HqValueHandle hRegisterValue = HqFrame::GetGpRegister(hExec->hCurrentFrame, registerIndex, &result);
 		if(result == HQ_SUCCESS)
 		{
-			result = HqVm::SetGlobalVariable(hExec->hVm, hRegisterValue, pVarName);
-			if(result != HQ_SUCCESS)
+			// The cached slot is shared with other execution contexts (see LOAD_GLOBAL).
+			uint32_t slot = HqAtomic::Load(&pInstruction->operands[3].index);
+			if(slot == HQ_VM_GLOBAL_SLOT_INVALID)
+			{
+				// The global variable wasn't registered yet when this instruction was decoded,
+				// so resolve it now and cache the slot on the instruction.
+				slot = HqVm::GetGlobalSlot(hExec->hVm, pVarName);
+				HqAtomic::Store(&pInstruction->operands[3].index, slot);
+			}
+
+			if(slot != HQ_VM_GLOBAL_SLOT_INVALID)
+			{
+				hExec->hVm->globalValues.pData[slot] = hRegisterValue;
+			}
+			else
 			{
 				// Raise a fatal script exception.
 				HqExecution::RaiseOpCodeException(
@@ -90,8 +107,8 @@ extern "C" void OpCodeExec_StoreGlobal(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_StoreGlobal(HqDisassemble& disasm)
 {
-	const uint32_t stringIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t registerIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t stringIndex = HqDecoder::LoadIndex(disasm.decoder);
+	const uint32_t registerIndex = HqDecoder::LoadRegister(disasm.decoder);
 
 	char str[256];
 	snprintf(str, sizeof(str), "STORE_GLOBAL s(%" PRIu32 "), r(%" PRIu32 ")", stringIndex, registerIndex);
@@ -102,8 +119,26 @@ extern "C" void OpCodeDisasm_StoreGlobal(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_StoreGlobal(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // s#
-	HqDecoder::EndianSwapUint32(decoder); // r#
+	HqDecoder::EndianSwapIndex(decoder); // s#
+	HqDecoder::EndianSwapRegister(decoder); // r#
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_StoreGlobal(HqInstruction& output, HqDecoder& decoder, HqModuleHandle hModule)
+{
+	int result;
+
+	output.operands[0].index = HqDecoder::LoadIndex(decoder);
+	output.operands[1].index = HqDecoder::LoadRegister(decoder);
+
+	// Resolve the string operand up front so it doesn't need to be looked up each time the instruction runs.
+	output.operands[2].pString = HqModule::GetString(hModule, output.operands[0].index, &result);
+
+	// Resolve the global variable's slot so the value can be accessed directly.
+	output.operands[3].index = output.operands[2].pString
+		? HqVm::GetGlobalSlot(hModule->hVm, output.operands[2].pString)
+		: HQ_VM_GLOBAL_SLOT_INVALID;
 }
 
 //----------------------------------------------------------------------------------------------------------------------
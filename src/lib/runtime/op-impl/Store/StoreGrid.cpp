@@ -22,6 +22,7 @@
 #include "../../Execution.hpp"
 #include "../../Frame.hpp"
 #include "../../ScriptObject.hpp"
+#include "../../Vm.hpp"
 
 #include <inttypes.h>
 #include <stdio.h>
@@ -107,11 +108,11 @@ extern "C" void OpCodeExec_StoreGrid(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t gpDstRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t gpSrcRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t gpGridIdxXRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t gpGridIdxYRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t gpGridIdxZRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
+	const uint32_t gpDstRegIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
+	const uint32_t gpSrcRegIndex = hExec->hCurrentFrame->pInstruction->operands[1].index;
+	const uint32_t gpGridIdxXRegIndex = hExec->hCurrentFrame->pInstruction->operands[2].index;
+	const uint32_t gpGridIdxYRegIndex = hExec->hCurrentFrame->pInstruction->operands[3].index;
+	const uint32_t gpGridIdxZRegIndex = hExec->hCurrentFrame->pInstruction->operands[4].index;
 
 	// Load the grid from the destination register.
 	HqValueHandle hDestination = HqFrame::GetGpRegister(hExec->hCurrentFrame, gpDstRegIndex, &result);
@@ -140,7 +141,9 @@ extern "C" void OpCodeExec_StoreGrid(HqExecutionHandle hExec)
 						gridIndexY,
 						gridIndexZ);
 
-					hDestination->as.grid.array.pData[finalIndex] = hSource;
+					HqGarbageCollector::WriteBarrier(hExec->hVm->gc, &hDestination->gcProxy);
+
+					HqValue::StoreElement(&hDestination->as.grid.array.pData[finalIndex], hSource);
 				}
 				else
 				{
@@ -181,11 +184,11 @@ extern "C" void OpCodeExec_StoreGrid(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_StoreGrid(HqDisassemble& disasm)
 {
-	const uint32_t gpDstRegIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t gpSrcRegIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t gpGridIdxXRegIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t gpGridIdxYRegIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t gpGridIdxZRegIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t gpDstRegIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t gpSrcRegIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t gpGridIdxXRegIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t gpGridIdxYRegIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t gpGridIdxZRegIndex = HqDecoder::LoadRegister(disasm.decoder);
 
 	char str[96];
 	snprintf(str, sizeof(str), "STORE_GRID r(%" PRIu32 "), r(%" PRIu32 "), r(%" PRIu32 "), r(%" PRIu32 "), r(%" PRIu32 ")", gpDstRegIndex, gpSrcRegIndex, gpGridIdxXRegIndex, gpGridIdxYRegIndex, gpGridIdxZRegIndex);
@@ -196,11 +199,22 @@ extern "C" void OpCodeDisasm_StoreGrid(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_StoreGrid(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r#
-	HqDecoder::EndianSwapUint32(decoder); // r#
-	HqDecoder::EndianSwapUint32(decoder); // r#
-	HqDecoder::EndianSwapUint32(decoder); // r#
-	HqDecoder::EndianSwapUint32(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // r#
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_StoreGrid(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].index = HqDecoder::LoadRegister(decoder);
+	output.operands[2].index = HqDecoder::LoadRegister(decoder);
+	output.operands[3].index = HqDecoder::LoadRegister(decoder);
+	output.operands[4].index = HqDecoder::LoadRegister(decoder);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
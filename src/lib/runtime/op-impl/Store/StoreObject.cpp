@@ -22,6 +22,7 @@
 #include "../../Execution.hpp"
 #include "../../Frame.hpp"
 #include "../../ScriptObject.hpp"
+#include "../../Vm.hpp"
 
 #include <inttypes.h>
 #include <stdio.h>
@@ -42,9 +43,9 @@ extern "C" void OpCodeExec_StoreObject(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t gpDstRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t gpSrcRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t memberIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
+	const uint32_t gpDstRegIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
+	const uint32_t gpSrcRegIndex = hExec->hCurrentFrame->pInstruction->operands[1].index;
+	const uint32_t memberIndex = hExec->hCurrentFrame->pInstruction->operands[2].index;
 
 	HqValueHandle hDestination = HqFrame::GetGpRegister(hExec->hCurrentFrame, gpDstRegIndex, &result);
 	if(result == HQ_SUCCESS)
@@ -56,6 +57,8 @@ extern "C" void OpCodeExec_StoreObject(HqExecutionHandle hExec)
 			HqValueHandle hSource = HqFrame::GetGpRegister(hExec->hCurrentFrame, gpSrcRegIndex, &result);
 			if(result == HQ_SUCCESS)
 			{
+				HqGarbageCollector::WriteBarrier(hExec->hVm->gc, &hDestination->gcProxy);
+
 				result = HqScriptObject::SetMemberValue(pScriptObject, memberIndex, hSource);
 				if(result != HQ_SUCCESS)
 				{
@@ -106,9 +109,9 @@ extern "C" void OpCodeExec_StoreObject(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_StoreObject(HqDisassemble& disasm)
 {
-	const uint32_t gpDstRegIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t gpSrcRegIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t memberIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t gpDstRegIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t gpSrcRegIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t memberIndex = HqDecoder::LoadIndex(disasm.decoder);
 
 	char str[64];
 	snprintf(str, sizeof(str), "STORE_OBJECT r(%" PRIu32 "), r(%" PRIu32 "), %" PRIu32, gpDstRegIndex, gpSrcRegIndex, memberIndex);
@@ -119,9 +122,18 @@ extern "C" void OpCodeDisasm_StoreObject(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_StoreObject(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r#
-	HqDecoder::EndianSwapUint32(decoder); // r#
-	HqDecoder::EndianSwapUint32(decoder); // ##
+	HqDecoder::EndianSwapRegister(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // r#
+	HqDecoder::EndianSwapIndex(decoder); // ##
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_StoreObject(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].index = HqDecoder::LoadRegister(decoder);
+	output.operands[2].index = HqDecoder::LoadIndex(decoder);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -40,8 +40,8 @@ extern "C" void OpCodeExec_StoreVariable(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t vrRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t gpRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
+	const uint32_t vrRegIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
+	const uint32_t gpRegIndex = hExec->hCurrentFrame->pInstruction->operands[1].index;
 
 	HqValueHandle hValue = HqFrame::GetGpRegister(hExec->hCurrentFrame, gpRegIndex, &result);
 	if(result == HQ_SUCCESS)
@@ -74,8 +74,8 @@ extern "C" void OpCodeExec_StoreVariable(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_StoreVariable(HqDisassemble& disasm)
 {
-	const uint32_t vrRegIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t gpRegIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t vrRegIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t gpRegIndex = HqDecoder::LoadRegister(disasm.decoder);
 
 	char str[64];
 	snprintf(str, sizeof(str), "STORE_VAR v(%" PRIu32 "), r(%" PRIu32 ")", vrRegIndex, gpRegIndex);
@@ -86,8 +86,16 @@ extern "C" void OpCodeDisasm_StoreVariable(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_StoreVariable(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // v#
-	HqDecoder::EndianSwapUint32(decoder); // r#
+	HqDecoder::EndianSwapRegister(decoder); // v#
+	HqDecoder::EndianSwapRegister(decoder); // r#
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_StoreVariable(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].index = HqDecoder::LoadRegister(decoder);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -39,39 +39,24 @@ extern "C" void OpCodeExec_Test(HqExecutionHandle hExec)
 {
 	int result;
 
-	const uint32_t gpDstRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
-	const uint32_t gpSrcRegIndex = HqDecoder::LoadUint32(hExec->hCurrentFrame->decoder);
+	const uint32_t gpDstRegIndex = hExec->hCurrentFrame->pInstruction->operands[0].index;
+	const uint32_t gpSrcRegIndex = hExec->hCurrentFrame->pInstruction->operands[1].index;
 
-	HqValueHandle hSource = HqFrame::GetGpRegister(hExec->hCurrentFrame, gpSrcRegIndex, &result);
-	if(result == HQ_SUCCESS)
+	const HqRegister* const pSource = HqFrame::GetGpRegisterSlot(hExec->hCurrentFrame, gpSrcRegIndex);
+	if(pSource)
 	{
-		const bool pass = HqValue::EvaluateAsBoolean(hSource);
+		HqRegister::Primitive output;
+		output.boolean = HqRegister::EvaluateAsBoolean(*pSource);
 
-		HqValueHandle hOutput = HqValue::CreateBool(hExec->hVm, pass);
-		if(hOutput)
-		{
-			// Remove the auto-mark from the output value so it can be cleaned up when it's no longer referenced.
-			HqValue::SetAutoMark(hOutput, false);
-
-			result = HqFrame::SetGpRegister(hExec->hCurrentFrame, hOutput, gpDstRegIndex);
-			if(result != HQ_SUCCESS)
-			{
-				// Raise a fatal script exception.
-				HqExecution::RaiseOpCodeException(
-					hExec,
-					HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
-					"Failed to set general-purpose register: r(%" PRIu32 ")",
-					gpDstRegIndex
-				);
-			}
-		}
-		else
+		result = HqFrame::SetGpRegisterPrimitive(hExec->hCurrentFrame, HQ_VALUE_TYPE_BOOL, output, gpDstRegIndex);
+		if(result != HQ_SUCCESS)
 		{
 			// Raise a fatal script exception.
 			HqExecution::RaiseOpCodeException(
-				hExec, 
-				HQ_STANDARD_EXCEPTION_RUNTIME_ERROR, 
-				"Failed to create output value"
+				hExec,
+				HQ_STANDARD_EXCEPTION_RUNTIME_ERROR,
+				"Failed to set general-purpose register: r(%" PRIu32 ")",
+				gpDstRegIndex
 			);
 		}
 	}
@@ -91,8 +76,8 @@ extern "C" void OpCodeExec_Test(HqExecutionHandle hExec)
 
 extern "C" void OpCodeDisasm_Test(HqDisassemble& disasm)
 {
-	const uint32_t gpDstRegIndex = HqDecoder::LoadUint32(disasm.decoder);
-	const uint32_t gpSrcRegIndex = HqDecoder::LoadUint32(disasm.decoder);
+	const uint32_t gpDstRegIndex = HqDecoder::LoadRegister(disasm.decoder);
+	const uint32_t gpSrcRegIndex = HqDecoder::LoadRegister(disasm.decoder);
 
 	char str[64];
 	snprintf(str, sizeof(str), "TEST r(%" PRIu32 "), r(%" PRIu32 ")", gpDstRegIndex, gpSrcRegIndex);
@@ -103,8 +88,16 @@ extern "C" void OpCodeDisasm_Test(HqDisassemble& disasm)
 
 extern "C" void OpCodeEndian_Test(HqDecoder& decoder)
 {
-	HqDecoder::EndianSwapUint32(decoder); // r# [first]
-	HqDecoder::EndianSwapUint32(decoder); // r# [second]
+	HqDecoder::EndianSwapRegister(decoder); // r# [first]
+	HqDecoder::EndianSwapRegister(decoder); // r# [second]
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_Test(HqInstruction& output, HqDecoder& decoder, HqModuleHandle /*hModule*/)
+{
+	output.operands[0].index = HqDecoder::LoadRegister(decoder);
+	output.operands[1].index = HqDecoder::LoadRegister(decoder);
 }
 
 //----------------------------------------------------------------------------------------------------------------------
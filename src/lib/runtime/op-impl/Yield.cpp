@@ -54,3 +54,9 @@ extern "C" void OpCodeEndian_Yield(HqDecoder& /*decoder*/)
 }
 
 //----------------------------------------------------------------------------------------------------------------------
+
+extern "C" void OpCodeDecode_Yield(HqInstruction& /*output*/, HqDecoder& /*decoder*/, HqModuleHandle /*hModule*/)
+{
+}
+
+//----------------------------------------------------------------------------------------------------------------------
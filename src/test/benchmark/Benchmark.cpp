@@ -0,0 +1,610 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include "Benchmark.hpp"
+
+#include "../common/Util.h"
+#include "../../app/common/MemoryHandler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static constexpr const char* const _mainFunctionSignature = "void main()";
+
+static std::atomic<uint64_t> _allocCount(0);
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct _BenchmarkSample
+{
+	double time;
+	uint64_t allocCount;
+};
+
+struct _WorkloadSample
+{
+	HqGcStats gcStats;
+
+	double time;
+	size_t peakMemorySize;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Bench::InitializeAllocator()
+{
+	// Pass everything straight through to the CRT, only counting the calls. This keeps the
+	// allocator overhead as close as possible to what the VM sees when running normally.
+	auto mallocFn = [](const size_t memSize) -> void*
+	{
+		_allocCount.fetch_add(1, std::memory_order_relaxed);
+		return malloc(memSize);
+	};
+	auto reallocFn = [](void* const pMem, const size_t memSize) -> void*
+	{
+		_allocCount.fetch_add(1, std::memory_order_relaxed);
+		return realloc(pMem, memSize);
+	};
+	auto freeFn = [](void* const pMem)
+	{
+		free(pMem);
+	};
+
+	HqMemAllocator allocator;
+	allocator.allocFn = mallocFn;
+	allocator.reallocFn = reallocFn;
+	allocator.freeFn = freeFn;
+
+	HqMemSetAllocator(allocator);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+void Bench::ShutdownAllocator()
+{
+	HqMemSetAllocator(HqMemGetDefaultAllocator());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _finalizeFunction(
+	BenchmarkBuilder& builder,
+	const uint16_t numParameters,
+	const uint16_t numReturnValues)
+{
+	BENCH_CHECK(
+		HqModuleWriterAddFunction(
+			builder.hModuleWriter,
+			builder.functionSignature,
+			HqSerializerGetRawStreamPointer(builder.hSerializer),
+			HqSerializerGetStreamLength(builder.hSerializer),
+			numParameters,
+			numReturnValues
+		)
+	);
+
+	for(const BenchmarkGuardedBlock& block : builder.guardedBlocks)
+	{
+		uint32_t blockId = 0;
+
+		BENCH_CHECK(
+			HqModuleWriterAddGuardedBlock(
+				builder.hModuleWriter,
+				builder.functionSignature,
+				block.offset,
+				block.length,
+				&blockId
+			)
+		);
+		BENCH_CHECK(
+			HqModuleWriterAddExceptionHandler(
+				builder.hModuleWriter,
+				builder.functionSignature,
+				blockId,
+				block.handlerOffset,
+				block.handledType,
+				block.className
+			)
+		);
+	}
+
+	return HQ_SUCCESS;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int Bench::AddString(BenchmarkBuilder& builder, const char* const value, uint32_t& outIndex)
+{
+	return HqModuleWriterAddString(builder.hModuleWriter, value, &outIndex);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int Bench::AddFunction(
+	BenchmarkBuilder& builder,
+	const char* const signature,
+	const uint16_t numParameters,
+	const uint16_t numReturnValues,
+	BenchmarkEmitCallback onEmitFn)
+{
+	BenchmarkBuilder funcBuilder;
+	funcBuilder.hModuleWriter = builder.hModuleWriter;
+	funcBuilder.hSerializer = HQ_SERIALIZER_HANDLE_NULL;
+	funcBuilder.functionSignature = signature;
+	funcBuilder.pUserData = builder.pUserData;
+
+	BENCH_CHECK(HqSerializerCreate(&funcBuilder.hSerializer, HQ_SERIALIZER_MODE_WRITER));
+
+	int result = HqSerializerSetEndianness(funcBuilder.hSerializer, HQ_ENDIAN_ORDER_NATIVE);
+
+	if(result == HQ_SUCCESS && onEmitFn)
+	{
+		result = onEmitFn(funcBuilder);
+	}
+
+	if(result == HQ_SUCCESS)
+	{
+		result = HqBytecodeEmitReturn(funcBuilder.hSerializer);
+	}
+
+	if(result == HQ_SUCCESS)
+	{
+		result = _finalizeFunction(funcBuilder, numParameters, numReturnValues);
+	}
+
+	HqSerializerDispose(&funcBuilder.hSerializer);
+
+	return result;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct _OpCodeLoop
+{
+	const Benchmark* pBenchmark;
+	const BenchmarkConfig* pConfig;
+	bool emitBody;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _emitOpCodeLoop(BenchmarkBuilder& builder)
+{
+	const _OpCodeLoop& loop = *reinterpret_cast<const _OpCodeLoop*>(builder.pUserData);
+
+	if(loop.pBenchmark->onSetupFn)
+	{
+		BENCH_CHECK(loop.pBenchmark->onSetupFn(builder));
+	}
+
+	BENCH_CHECK(HqBytecodeEmitLoadImmI32(builder.hSerializer, BENCH_REG_LOOP_COUNTER, int32_t(loop.pConfig->iterations)));
+	BENCH_CHECK(HqBytecodeEmitLoadImmI32(builder.hSerializer, BENCH_REG_LOOP_STEP, 1));
+
+	const size_t loopStart = HqSerializerGetStreamPosition(builder.hSerializer);
+
+	if(loop.emitBody)
+	{
+		for(uint32_t i = 0; i < loop.pConfig->unrollCount; ++i)
+		{
+			BENCH_CHECK(loop.pBenchmark->onEmitOpFn(builder));
+		}
+	}
+
+	BENCH_CHECK(HqBytecodeEmitSub(builder.hSerializer, BENCH_REG_LOOP_COUNTER, BENCH_REG_LOOP_COUNTER, BENCH_REG_LOOP_STEP));
+
+	const size_t loopEnd = HqSerializerGetStreamPosition(builder.hSerializer);
+
+	return HqBytecodeEmitJumpIfTrue(builder.hSerializer, BENCH_REG_LOOP_COUNTER, int32_t(loopStart) - int32_t(loopEnd));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _compileModule(
+	std::vector<uint8_t>& outBytecode,
+	BenchmarkEmitCallback onEmitMainFn,
+	void* const pUserData)
+{
+	const HqDevContextInit init = GetDefaultHqDevContextInit(nullptr, DefaultMessageCallback, HQ_MESSAGE_TYPE_WARNING);
+
+	HqDevContextHandle hCtx = HQ_DEV_CONTEXT_HANDLE_NULL;
+	BENCH_CHECK(HqDevContextCreate(&hCtx, init));
+
+	HqModuleWriterHandle hModuleWriter = HQ_MODULE_WRITER_HANDLE_NULL;
+	HqSerializerHandle hFileSerializer = HQ_SERIALIZER_HANDLE_NULL;
+
+	int result = HqModuleWriterCreate(&hModuleWriter, hCtx);
+
+	if(result == HQ_SUCCESS)
+	{
+		BenchmarkBuilder builder;
+		builder.hModuleWriter = hModuleWriter;
+		builder.hSerializer = HQ_SERIALIZER_HANDLE_NULL;
+		builder.functionSignature = nullptr;
+		builder.pUserData = pUserData;
+
+		result = Bench::AddFunction(builder, _mainFunctionSignature, 0, 0, onEmitMainFn);
+	}
+
+	if(result == HQ_SUCCESS)
+	{
+		result = HqSerializerCreate(&hFileSerializer, HQ_SERIALIZER_MODE_WRITER);
+	}
+
+	if(result == HQ_SUCCESS)
+	{
+		result = HqSerializerSetEndianness(hFileSerializer, HQ_ENDIAN_ORDER_NATIVE);
+	}
+
+	if(result == HQ_SUCCESS)
+	{
+		result = HqModuleWriterSerialize(hModuleWriter, hFileSerializer);
+	}
+
+	if(result == HQ_SUCCESS)
+	{
+		const uint8_t* const pModuleData = reinterpret_cast<const uint8_t*>(HqSerializerGetRawStreamPointer(hFileSerializer));
+		const size_t moduleLength = HqSerializerGetStreamLength(hFileSerializer);
+
+		outBytecode.assign(pModuleData, pModuleData + moduleLength);
+	}
+
+	if(hFileSerializer)
+	{
+		HqSerializerDispose(&hFileSerializer);
+	}
+
+	if(hModuleWriter)
+	{
+		HqModuleWriterDispose(&hModuleWriter);
+	}
+
+	HqDevContextDispose(&hCtx);
+
+	return result;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _runSamples(
+	std::vector<_BenchmarkSample>& outSamples,
+	const Benchmark& benchmark,
+	const BenchmarkConfig& config,
+	const std::vector<uint8_t>& bytecode)
+{
+	const HqVmInit init = GetDefaultHqVmInit(nullptr, DefaultMessageCallback, HQ_MESSAGE_TYPE_WARNING);
+
+	HqVmHandle hVm = HQ_VM_HANDLE_NULL;
+	BENCH_CHECK(HqVmCreate(&hVm, init));
+
+	HqExecutionHandle hExec = HQ_EXECUTION_HANDLE_NULL;
+	HqFunctionHandle hFunction = HQ_FUNCTION_HANDLE_NULL;
+
+	int result = HqVmLoadModule(hVm, "Benchmark", bytecode.data(), bytecode.size());
+
+	if(result == HQ_SUCCESS && benchmark.onBindFn)
+	{
+		result = benchmark.onBindFn(hVm);
+	}
+
+	if(result == HQ_SUCCESS)
+	{
+		result = HqVmInitializeModules(hVm, &hExec);
+	}
+
+	if(result == HQ_SUCCESS)
+	{
+		result = HqVmGetFunction(hVm, &hFunction, _mainFunctionSignature);
+	}
+
+	const double timerFrequency = double(HqClockGetFrequency());
+
+	outSamples.clear();
+
+	// The first run is a warm-up and is always discarded.
+	for(uint32_t sampleIndex = 0; result == HQ_SUCCESS && sampleIndex <= config.sampleCount; ++sampleIndex)
+	{
+		hExec = HQ_EXECUTION_HANDLE_NULL;
+
+		result = HqExecutionCreate(&hExec, hVm);
+
+		if(result == HQ_SUCCESS)
+		{
+			result = HqExecutionInitialize(hExec, hFunction);
+		}
+
+		if(result == HQ_SUCCESS)
+		{
+			const uint64_t allocCountStart = _allocCount.load(std::memory_order_relaxed);
+			const uint64_t timeStart = HqClockGetTimestamp();
+
+			result = HqExecutionRun(hExec, HQ_RUN_FULL);
+
+			const uint64_t timeEnd = HqClockGetTimestamp();
+			const uint64_t allocCountEnd = _allocCount.load(std::memory_order_relaxed);
+
+			bool complete = false;
+			bool exception = false;
+
+			HqExecutionGetStatus(hExec, HQ_EXEC_STATUS_COMPLETE, &complete);
+			HqExecutionGetStatus(hExec, HQ_EXEC_STATUS_EXCEPTION, &exception);
+
+			if(result == HQ_SUCCESS && (!complete || exception))
+			{
+				result = HQ_ERROR_UNSPECIFIED_FAILURE;
+			}
+
+			if(result == HQ_SUCCESS && sampleIndex > 0)
+			{
+				_BenchmarkSample sample;
+				sample.time = double(timeEnd - timeStart) * 1000000000.0 / timerFrequency;
+				sample.allocCount = allocCountEnd - allocCountStart;
+
+				outSamples.push_back(sample);
+			}
+		}
+
+		if(hExec)
+		{
+			HqExecutionDispose(&hExec);
+		}
+
+		// Keep garbage from one sample from being collected on the clock of the next.
+		HqVmRunGarbageCollector(hVm, HQ_RUN_FULL);
+	}
+
+	HqVmDispose(&hVm);
+
+	if(result == HQ_SUCCESS)
+	{
+		std::sort(
+			outSamples.begin(),
+			outSamples.end(),
+			[](const _BenchmarkSample& left, const _BenchmarkSample& right) { return left.time < right.time; }
+		);
+	}
+
+	return result;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int Bench::Run(BenchmarkResult& output, const Benchmark& benchmark, const BenchmarkConfig& config)
+{
+	if(!benchmark.onEmitOpFn
+		|| config.iterations == 0
+		|| config.iterations > uint32_t(INT32_MAX)
+		|| config.unrollCount == 0
+		|| config.sampleCount == 0)
+	{
+		return HQ_ERROR_INVALID_ARG;
+	}
+
+	std::vector<uint8_t> baselineBytecode;
+	std::vector<uint8_t> bytecode;
+
+	// The baseline is the same module with an empty loop body, so its cost (loop overhead and setup)
+	// can be subtracted out to leave only the cost of the operations being measured.
+	_OpCodeLoop baselineLoop = { &benchmark, &config, false };
+	_OpCodeLoop loop = { &benchmark, &config, true };
+
+	BENCH_CHECK(_compileModule(baselineBytecode, _emitOpCodeLoop, &baselineLoop));
+	BENCH_CHECK(_compileModule(bytecode, _emitOpCodeLoop, &loop));
+
+	std::vector<_BenchmarkSample> baselineSamples;
+	std::vector<_BenchmarkSample> samples;
+
+	BENCH_CHECK(_runSamples(baselineSamples, benchmark, config, baselineBytecode));
+	BENCH_CHECK(_runSamples(samples, benchmark, config, bytecode));
+
+	const double opCount = double(config.iterations) * double(config.unrollCount);
+	const size_t medianIndex = samples.size() / 2;
+
+	output.minNsPerOp = std::max(samples[0].time - baselineSamples[0].time, 0.0) / opCount;
+	output.medianNsPerOp = std::max(samples[medianIndex].time - baselineSamples[medianIndex].time, 0.0) / opCount;
+	output.allocsPerOp = (samples[medianIndex].allocCount > baselineSamples[medianIndex].allocCount)
+		? double(samples[medianIndex].allocCount - baselineSamples[medianIndex].allocCount) / opCount
+		: 0.0;
+
+	return HQ_SUCCESS;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _loadWorkload(
+	HqVmHandle& outVm,
+	HqExecutionHandle& outExec,
+	const std::vector<uint8_t>& bytecode,
+	const bool enableGcThread)
+{
+	HqVmInit init = GetDefaultHqVmInit(nullptr, DefaultMessageCallback, HQ_MESSAGE_TYPE_WARNING);
+	init.gcEnableThread = enableGcThread;
+
+	BENCH_CHECK(HqVmCreate(&outVm, init));
+
+	HqFunctionHandle hFunction = HQ_FUNCTION_HANDLE_NULL;
+
+	int result = HqVmLoadModule(outVm, "Workload", bytecode.data(), bytecode.size());
+
+	if(result == HQ_SUCCESS)
+	{
+		result = HqVmInitializeModules(outVm, &outExec);
+	}
+
+	if(result == HQ_SUCCESS)
+	{
+		result = HqVmGetFunction(outVm, &hFunction, _mainFunctionSignature);
+	}
+
+	if(result == HQ_SUCCESS)
+	{
+		outExec = HQ_EXECUTION_HANDLE_NULL;
+		result = HqExecutionCreate(&outExec, outVm);
+	}
+
+	if(result == HQ_SUCCESS)
+	{
+		result = HqExecutionInitialize(outExec, hFunction);
+	}
+
+	if(result != HQ_SUCCESS)
+	{
+		if(outExec)
+		{
+			HqExecutionDispose(&outExec);
+		}
+
+		HqVmDispose(&outVm);
+	}
+
+	return result;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _runWorkloadExecution(HqExecutionHandle hExec)
+{
+	BENCH_CHECK(HqExecutionRun(hExec, HQ_RUN_FULL));
+
+	bool complete = false;
+	bool exception = false;
+
+	HqExecutionGetStatus(hExec, HQ_EXEC_STATUS_COMPLETE, &complete);
+	HqExecutionGetStatus(hExec, HQ_EXEC_STATUS_EXCEPTION, &exception);
+
+	return (complete && !exception) ? HQ_SUCCESS : HQ_ERROR_UNSPECIFIED_FAILURE;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _countWorkloadInstructions(
+	uint64_t& outCount,
+	const std::vector<uint8_t>& bytecode,
+	const bool enableGcThread)
+{
+	HqVmHandle hVm = HQ_VM_HANDLE_NULL;
+	HqExecutionHandle hExec = HQ_EXECUTION_HANDLE_NULL;
+
+	BENCH_CHECK(_loadWorkload(hVm, hExec, bytecode, enableGcThread));
+
+	auto onOpCode = [](void* const pUserData, const char*, const HqProfileCounter* const pCounter) -> bool
+	{
+		(*reinterpret_cast<uint64_t*>(pUserData)) += pCounter->count;
+		return true;
+	};
+
+	outCount = 0;
+
+	int result = HqExecutionSetProfilingEnabled(hExec, true);
+
+	if(result == HQ_SUCCESS)
+	{
+		result = _runWorkloadExecution(hExec);
+	}
+
+	if(result == HQ_SUCCESS)
+	{
+		result = HqExecutionGetProfile(hExec, onOpCode, nullptr, &outCount);
+	}
+
+	HqExecutionDispose(&hExec);
+	HqVmDispose(&hVm);
+
+	return result;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int Bench::RunWorkload(
+	WorkloadResult& output,
+	const Workload& workload,
+	const uint32_t sampleCount,
+	const bool enableGcThread)
+{
+	if(!workload.onEmitMainFn || sampleCount == 0)
+	{
+		return HQ_ERROR_INVALID_ARG;
+	}
+
+	std::vector<uint8_t> bytecode;
+	BENCH_CHECK(_compileModule(bytecode, workload.onEmitMainFn, nullptr));
+
+	// Instructions are counted on a separate, untimed run so the profiler doesn't skew the wall times.
+	BENCH_CHECK(_countWorkloadInstructions(output.instructionCount, bytecode, enableGcThread));
+
+	const double timerFrequency = double(HqClockGetFrequency());
+
+	std::vector<_WorkloadSample> samples;
+
+	// Every sample gets a fresh VM so the GC stats and peak memory only cover that one run.
+	// The first run is a warm-up and is always discarded.
+	for(uint32_t sampleIndex = 0; sampleIndex <= sampleCount; ++sampleIndex)
+	{
+		MemoryHandler::Instance.ResetPeakSize();
+
+		HqVmHandle hVm = HQ_VM_HANDLE_NULL;
+		HqExecutionHandle hExec = HQ_EXECUTION_HANDLE_NULL;
+
+		BENCH_CHECK(_loadWorkload(hVm, hExec, bytecode, enableGcThread));
+
+		const uint64_t timeStart = HqClockGetTimestamp();
+		const int result = _runWorkloadExecution(hExec);
+		const uint64_t timeEnd = HqClockGetTimestamp();
+
+		_WorkloadSample sample;
+		sample.time = double(timeEnd - timeStart) * 1000.0 / timerFrequency;
+		sample.peakMemorySize = MemoryHandler::Instance.GetPeakSize();
+
+		HqVmGetGcStats(hVm, &sample.gcStats);
+		HqExecutionDispose(&hExec);
+		HqVmDispose(&hVm);
+
+		if(result != HQ_SUCCESS)
+		{
+			return result;
+		}
+
+		if(sampleIndex > 0)
+		{
+			samples.push_back(sample);
+		}
+	}
+
+	std::sort(
+		samples.begin(),
+		samples.end(),
+		[](const _WorkloadSample& left, const _WorkloadSample& right) { return left.time < right.time; }
+	);
+
+	const _WorkloadSample& medianSample = samples[samples.size() / 2];
+
+	output.gcStats = medianSample.gcStats;
+	output.minWallTimeMs = samples[0].time;
+	output.medianWallTimeMs = medianSample.time;
+	output.peakMemorySize = medianSample.peakMemorySize;
+
+	return HQ_SUCCESS;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,149 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#pragma once
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#include <Harlequin.h>
+
+#include <stdint.h>
+
+#include <vector>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#define BENCH_CHECK(expr) \
+	{ \
+		const int _benchResult = (expr); \
+		if(_benchResult != HQ_SUCCESS) \
+		{ \
+			return _benchResult; \
+		} \
+	}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// GP registers reserved by the benchmark loop; op emitters are free to use anything above these.
+#define BENCH_REG_LOOP_COUNTER 0
+#define BENCH_REG_LOOP_STEP    1
+#define BENCH_REG_FIRST_FREE   2
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct BenchmarkGuardedBlock
+{
+	size_t offset;
+	size_t length;
+	size_t handlerOffset;
+	int handledType;
+	const char* className;
+};
+
+struct BenchmarkBuilder
+{
+	// Guarded blocks can only be added once the function exists in the module writer,
+	// so they are collected while emitting and registered after the function is finalized.
+	std::vector<BenchmarkGuardedBlock> guardedBlocks;
+
+	HqModuleWriterHandle hModuleWriter;
+	HqSerializerHandle hSerializer;
+	const char* functionSignature;
+
+	void* pUserData;
+};
+
+typedef int (*BenchmarkEmitCallback)(BenchmarkBuilder&);
+typedef int (*BenchmarkBindCallback)(HqVmHandle);
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Benchmark
+{
+	const char* family;
+	const char* name;
+
+	// Emits module data and the instructions that run once before the loop (operand setup, etc).
+	BenchmarkEmitCallback onSetupFn;
+
+	// Emits a single instance of the operation being measured; called once per unrolled op in the loop body.
+	BenchmarkEmitCallback onEmitOpFn;
+
+	// Optional callback for binding native functions after the module has been loaded.
+	BenchmarkBindCallback onBindFn;
+};
+
+struct BenchmarkResult
+{
+	double minNsPerOp;
+	double medianNsPerOp;
+	double allocsPerOp;
+};
+
+struct BenchmarkConfig
+{
+	uint32_t iterations;
+	uint32_t unrollCount;
+	uint32_t sampleCount;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Workload
+{
+	const char* name;
+
+	// Emits the module data and the body of the workload's entry point, "void main()".
+	BenchmarkEmitCallback onEmitMainFn;
+};
+
+struct WorkloadResult
+{
+	HqGcStats gcStats;
+
+	double minWallTimeMs;
+	double medianWallTimeMs;
+
+	uint64_t instructionCount;
+	size_t peakMemorySize;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace Bench
+{
+	void InitializeAllocator();
+	void ShutdownAllocator();
+
+	int Run(BenchmarkResult& output, const Benchmark& benchmark, const BenchmarkConfig& config);
+	int RunWorkload(WorkloadResult& output, const Workload& workload, uint32_t sampleCount, bool enableGcThread);
+
+	int AddString(BenchmarkBuilder& builder, const char* value, uint32_t& outIndex);
+	int AddFunction(
+		BenchmarkBuilder& builder,
+		const char* signature,
+		uint16_t numParameters,
+		uint16_t numReturnValues,
+		BenchmarkEmitCallback onEmitFn
+	);
+
+	const Benchmark* GetOpCodeBenchmarks(size_t& outCount);
+	const Workload* GetWorkloads(size_t& outCount);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
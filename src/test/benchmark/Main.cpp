@@ -0,0 +1,361 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include "Benchmark.hpp"
+
+#include "../../app/common/MemoryHandler.hpp"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#define APPLICATION_RESULT_SUCCESS 0
+#define APPLICATION_RESULT_FAILURE 1
+
+#define BENCH_DEFAULT_ITERATIONS 20000
+#define BENCH_DEFAULT_UNROLL_COUNT 16
+#define BENCH_DEFAULT_SAMPLE_COUNT 5
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static void PrintUsage(const char* const appName)
+{
+	printf(
+		"Usage: %s [options...]\n"
+		"  -h          Display this help text\n"
+		"  -l          List the available benchmarks, then exit\n"
+		"  -f <text>   Only run benchmarks whose family or name contains <text>\n"
+		"  -n <count>  Loop iterations per sample (default: %d)\n"
+		"  -u <count>  Copies of the measured op in each loop iteration (default: %d)\n"
+		"  -s <count>  Timed samples per benchmark (default: %d)\n"
+		"  -w          Run the end-to-end workloads instead of the opcode benchmarks, reporting results as JSON\n"
+		"  -o <file>   Write the workload JSON results to <file> instead of stdout\n",
+		appName,
+		BENCH_DEFAULT_ITERATIONS,
+		BENCH_DEFAULT_UNROLL_COUNT,
+		BENCH_DEFAULT_SAMPLE_COUNT
+	);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static bool ParseCount(uint32_t& output, const char* const arg)
+{
+	if(!arg)
+	{
+		return false;
+	}
+
+	char* pEnd = nullptr;
+	const unsigned long value = strtoul(arg, &pEnd, 10);
+
+	if(pEnd == arg || *pEnd != '\0' || value == 0 || value > INT32_MAX)
+	{
+		return false;
+	}
+
+	output = uint32_t(value);
+	return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static double TicksToMs(const uint64_t ticks)
+{
+	return double(ticks) * 1000.0 / double(HqClockGetFrequency());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static void WriteWorkloadResult(
+	FILE* const pOutput,
+	const char* const workloadName,
+	const bool enableGcThread,
+	const uint32_t sampleCount,
+	const WorkloadResult& result)
+{
+	const HqGcStats& gc = result.gcStats;
+
+	fprintf(pOutput, "\t\t{\n");
+	fprintf(pOutput, "\t\t\t\"workload\": \"%s\",\n", workloadName);
+	fprintf(pOutput, "\t\t\t\"gcThread\": %s,\n", enableGcThread ? "true" : "false");
+	fprintf(pOutput, "\t\t\t\"samples\": %" PRIu32 ",\n", sampleCount);
+	fprintf(pOutput, "\t\t\t\"wallTimeMs\": { \"min\": %.3f, \"median\": %.3f },\n", result.minWallTimeMs, result.medianWallTimeMs);
+	fprintf(pOutput, "\t\t\t\"instructions\": %" PRIu64 ",\n", result.instructionCount);
+	fprintf(pOutput, "\t\t\t\"peakMemoryBytes\": %zu,\n", result.peakMemorySize);
+	fprintf(pOutput, "\t\t\t\"gc\": {\n");
+	fprintf(pOutput, "\t\t\t\t\"cycleCount\": %" PRIu64 ",\n", gc.cycleCount);
+	fprintf(pOutput, "\t\t\t\t\"majorCycleCount\": %" PRIu64 ",\n", gc.majorCycleCount);
+	fprintf(pOutput, "\t\t\t\t\"pauseCount\": %" PRIu64 ",\n", gc.pauseCount);
+	fprintf(pOutput, "\t\t\t\t\"totalPauseMs\": %.3f,\n", TicksToMs(gc.totalPauseTime));
+	fprintf(pOutput, "\t\t\t\t\"maxPauseMs\": %.3f,\n", TicksToMs(gc.maxPauseTime));
+	fprintf(pOutput, "\t\t\t\t\"safepointWaitMs\": %.3f,\n", TicksToMs(gc.safepointWaitTime));
+	fprintf(pOutput, "\t\t\t\t\"scriptParkMs\": %.3f,\n", TicksToMs(gc.scriptParkTime));
+	fprintf(pOutput, "\t\t\t\t\"disposedObjectCount\": %" PRIu64 ",\n", gc.disposedObjectCount);
+	fprintf(pOutput, "\t\t\t\t\"disposedBytes\": %" PRIu64 ",\n", gc.disposedSize);
+	fprintf(pOutput, "\t\t\t\t\"heapObjectCount\": %" PRIu64 ",\n", gc.heapObjectCount);
+	fprintf(pOutput, "\t\t\t\t\"heapBytes\": %" PRIu64 "\n", gc.heapSize);
+	fprintf(pOutput, "\t\t\t}\n");
+	fprintf(pOutput, "\t\t}");
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int RunWorkloads(const char* const outputPath, const char* const filter, const uint32_t sampleCount)
+{
+	FILE* pOutput = stdout;
+
+	if(outputPath)
+	{
+		pOutput = fopen(outputPath, "w");
+
+		if(!pOutput)
+		{
+			fprintf(stderr, "Failed to open output file: %s\n", outputPath);
+			return APPLICATION_RESULT_FAILURE;
+		}
+	}
+
+	HqSysVersion version;
+	HqSysGetVersion(&version);
+
+	fprintf(pOutput, "{\n");
+	fprintf(pOutput, "\t\"version\": \"%" PRIu16 ".%" PRIu16 ".%" PRIu16 "\",\n", version.major, version.minor, version.patch);
+	fprintf(pOutput, "\t\"results\": [\n");
+
+	size_t workloadCount = 0;
+	const Workload* const pWorkloads = Bench::GetWorkloads(workloadCount);
+
+	int appResult = APPLICATION_RESULT_SUCCESS;
+	bool firstResult = true;
+
+	for(size_t workloadIndex = 0; workloadIndex < workloadCount; ++workloadIndex)
+	{
+		const Workload& workload = pWorkloads[workloadIndex];
+
+		if(filter && !strstr(workload.name, filter))
+		{
+			continue;
+		}
+
+		// Each workload runs once on the script thread alone and once with the background GC thread enabled.
+		for(int gcThreadPass = 0; gcThreadPass < 2; ++gcThreadPass)
+		{
+			const bool enableGcThread = (gcThreadPass == 1);
+
+			WorkloadResult result;
+			const int runResult = Bench::RunWorkload(result, workload, sampleCount, enableGcThread);
+
+			if(runResult != HQ_SUCCESS)
+			{
+				fprintf(
+					stderr,
+					"Workload '%s' (gcThread=%s) failed: %s\n",
+					workload.name,
+					enableGcThread ? "true" : "false",
+					HqGetErrorCodeString(runResult)
+				);
+				appResult = APPLICATION_RESULT_FAILURE;
+				continue;
+			}
+
+			if(!firstResult)
+			{
+				fprintf(pOutput, ",\n");
+			}
+
+			WriteWorkloadResult(pOutput, workload.name, enableGcThread, sampleCount, result);
+			fflush(pOutput);
+
+			firstResult = false;
+		}
+	}
+
+	fprintf(pOutput, "\n\t]\n}\n");
+
+	if(pOutput != stdout)
+	{
+		fclose(pOutput);
+	}
+
+	return appResult;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+	BenchmarkConfig config;
+	config.iterations = BENCH_DEFAULT_ITERATIONS;
+	config.unrollCount = BENCH_DEFAULT_UNROLL_COUNT;
+	config.sampleCount = BENCH_DEFAULT_SAMPLE_COUNT;
+
+	const char* filter = nullptr;
+	const char* outputPath = nullptr;
+	bool listOnly = false;
+	bool runWorkloads = false;
+
+	for(int argIndex = 1; argIndex < argc; ++argIndex)
+	{
+		const char* const arg = argv[argIndex];
+		const char* const nextArg = (argIndex + 1 < argc) ? argv[argIndex + 1] : nullptr;
+
+		bool valid = true;
+
+		if(strcmp(arg, "-h") == 0)
+		{
+			PrintUsage(argv[0]);
+			return APPLICATION_RESULT_SUCCESS;
+		}
+		else if(strcmp(arg, "-l") == 0)
+		{
+			listOnly = true;
+		}
+		else if(strcmp(arg, "-w") == 0)
+		{
+			runWorkloads = true;
+		}
+		else if(strcmp(arg, "-o") == 0)
+		{
+			outputPath = nextArg;
+			valid = (outputPath != nullptr);
+			++argIndex;
+		}
+		else if(strcmp(arg, "-f") == 0)
+		{
+			filter = nextArg;
+			valid = (filter != nullptr);
+			++argIndex;
+		}
+		else if(strcmp(arg, "-n") == 0)
+		{
+			valid = ParseCount(config.iterations, nextArg);
+			++argIndex;
+		}
+		else if(strcmp(arg, "-u") == 0)
+		{
+			valid = ParseCount(config.unrollCount, nextArg);
+			++argIndex;
+		}
+		else if(strcmp(arg, "-s") == 0)
+		{
+			valid = ParseCount(config.sampleCount, nextArg);
+			++argIndex;
+		}
+		else
+		{
+			valid = false;
+		}
+
+		if(!valid)
+		{
+			fprintf(stderr, "Invalid argument: %s\n\n", arg);
+			PrintUsage(argv[0]);
+			return APPLICATION_RESULT_FAILURE;
+		}
+	}
+
+	if(runWorkloads && listOnly)
+	{
+		size_t workloadCount = 0;
+		const Workload* const pWorkloads = Bench::GetWorkloads(workloadCount);
+
+		for(size_t workloadIndex = 0; workloadIndex < workloadCount; ++workloadIndex)
+		{
+			printf("%s\n", pWorkloads[workloadIndex].name);
+		}
+
+		return APPLICATION_RESULT_SUCCESS;
+	}
+	else if(runWorkloads)
+	{
+		// Workloads go through the tracking allocator so their peak memory usage can be reported.
+		MemoryHandler::Instance.Initialize();
+
+		const int appResult = RunWorkloads(outputPath, filter, config.sampleCount);
+
+		MemoryHandler::Instance.Shutdown();
+
+		return appResult;
+	}
+
+	Bench::InitializeAllocator();
+
+	size_t benchmarkCount = 0;
+	const Benchmark* const pBenchmarks = Bench::GetOpCodeBenchmarks(benchmarkCount);
+
+	int appResult = APPLICATION_RESULT_SUCCESS;
+
+	if(!listOnly)
+	{
+		printf(
+			"Iterations: %" PRIu32 ", Unroll: %" PRIu32 ", Samples: %" PRIu32 "\n\n",
+			config.iterations,
+			config.unrollCount,
+			config.sampleCount
+		);
+		printf("%-12s %-20s %12s %12s %12s\n", "Family", "Benchmark", "ns/op (min)", "ns/op (med)", "allocs/op");
+	}
+
+	for(size_t benchmarkIndex = 0; benchmarkIndex < benchmarkCount; ++benchmarkIndex)
+	{
+		const Benchmark& benchmark = pBenchmarks[benchmarkIndex];
+
+		if(filter && !strstr(benchmark.family, filter) && !strstr(benchmark.name, filter))
+		{
+			continue;
+		}
+
+		if(listOnly)
+		{
+			printf("%s/%s\n", benchmark.family, benchmark.name);
+			continue;
+		}
+
+		BenchmarkResult result;
+		const int runResult = Bench::Run(result, benchmark, config);
+
+		if(runResult == HQ_SUCCESS)
+		{
+			printf(
+				"%-12s %-20s %12.2f %12.2f %12.2f\n",
+				benchmark.family,
+				benchmark.name,
+				result.minNsPerOp,
+				result.medianNsPerOp,
+				result.allocsPerOp
+			);
+		}
+		else
+		{
+			printf("%-12s %-20s FAILED (%s)\n", benchmark.family, benchmark.name, HqGetErrorCodeString(runResult));
+			appResult = APPLICATION_RESULT_FAILURE;
+		}
+
+		fflush(stdout);
+	}
+
+	Bench::ShutdownAllocator();
+
+	return appResult;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
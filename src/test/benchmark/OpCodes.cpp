@@ -0,0 +1,522 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include "Benchmark.hpp"
+
+//----------------------------------------------------------------------------------------------------------------------
+
+typedef int (*EmitUnaryFn)(HqSerializerHandle, uint32_t, uint32_t);
+typedef int (*EmitBinaryFn)(HqSerializerHandle, uint32_t, uint32_t, uint32_t);
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace Symbol
+{
+	static constexpr const char* const stringValue = "benchmark";
+	static constexpr const char* const globalName = "benchGlobal";
+	static constexpr const char* const objTypeName = "BenchObject";
+	static constexpr const char* const objMemberName = "value";
+	static constexpr const char* const scriptCallee = "void benchScriptCallee()";
+	static constexpr const char* const nativeCallee = "void benchNativeCallee()";
+}
+
+// Register layout shared by the op emitters below.
+enum Reg : uint32_t
+{
+	REG_SRC_LEFT = BENCH_REG_FIRST_FREE,
+	REG_SRC_RIGHT,
+	REG_DST,
+	REG_INDEX_X,
+	REG_INDEX_Y,
+	REG_INDEX_Z,
+	REG_CONTAINER,
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// Loads a pair of operands of the given type into the left and right source registers.
+template <int valueType>
+static int _setupOperands(BenchmarkBuilder& builder)
+{
+	const HqSerializerHandle hSerializer = builder.hSerializer;
+
+	switch(valueType)
+	{
+		case HQ_VALUE_TYPE_INT32:
+			BENCH_CHECK(HqBytecodeEmitLoadImmI32(hSerializer, REG_SRC_LEFT, 123456));
+			return HqBytecodeEmitLoadImmI32(hSerializer, REG_SRC_RIGHT, 789);
+
+		case HQ_VALUE_TYPE_INT64:
+			BENCH_CHECK(HqBytecodeEmitLoadImmI64(hSerializer, REG_SRC_LEFT, 123456789012ll));
+			return HqBytecodeEmitLoadImmI64(hSerializer, REG_SRC_RIGHT, 789);
+
+		case HQ_VALUE_TYPE_FLOAT32:
+			BENCH_CHECK(HqBytecodeEmitLoadImmF32(hSerializer, REG_SRC_LEFT, 1234.5f));
+			return HqBytecodeEmitLoadImmF32(hSerializer, REG_SRC_RIGHT, 6.789f);
+
+		case HQ_VALUE_TYPE_FLOAT64:
+			BENCH_CHECK(HqBytecodeEmitLoadImmF64(hSerializer, REG_SRC_LEFT, 1234.5));
+			return HqBytecodeEmitLoadImmF64(hSerializer, REG_SRC_RIGHT, 6.789);
+
+		case HQ_VALUE_TYPE_STRING:
+		{
+			uint32_t stringIndex = 0;
+			BENCH_CHECK(Bench::AddString(builder, Symbol::stringValue, stringIndex));
+			BENCH_CHECK(HqBytecodeEmitLoadImmStr(hSerializer, REG_SRC_LEFT, stringIndex));
+			return HqBytecodeEmitLoadImmStr(hSerializer, REG_SRC_RIGHT, stringIndex);
+		}
+
+		default:
+			break;
+	}
+
+	return HQ_ERROR_INVALID_TYPE;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+template <EmitUnaryFn emitFn>
+static int _emitUnaryOp(BenchmarkBuilder& builder)
+{
+	return emitFn(builder.hSerializer, REG_DST, REG_SRC_LEFT);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+template <EmitBinaryFn emitFn>
+static int _emitBinaryOp(BenchmarkBuilder& builder)
+{
+	return emitFn(builder.hSerializer, REG_DST, REG_SRC_LEFT, REG_SRC_RIGHT);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _setupString(BenchmarkBuilder& builder)
+{
+	return _setupOperands<HQ_VALUE_TYPE_STRING>(builder);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _setupGlobal(BenchmarkBuilder& builder)
+{
+	BENCH_CHECK(HqModuleWriterAddGlobal(builder.hModuleWriter, Symbol::globalName));
+	return _setupOperands<HQ_VALUE_TYPE_INT32>(builder);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _setupVariable(BenchmarkBuilder& builder)
+{
+	BENCH_CHECK(_setupOperands<HQ_VALUE_TYPE_INT32>(builder));
+	return HqBytecodeEmitStoreVariable(builder.hSerializer, 0, REG_SRC_LEFT);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _setupParam(BenchmarkBuilder& builder)
+{
+	BENCH_CHECK(_setupOperands<HQ_VALUE_TYPE_INT32>(builder));
+	return HqBytecodeEmitStoreParam(builder.hSerializer, 0, REG_SRC_LEFT);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _setupObject(BenchmarkBuilder& builder)
+{
+	uint32_t memberIndex = 0;
+	uint32_t stringIndex = 0;
+
+	BENCH_CHECK(HqModuleWriterAddObjectType(builder.hModuleWriter, Symbol::objTypeName));
+	BENCH_CHECK(
+		HqModuleWriterAddObjectMember(
+			builder.hModuleWriter,
+			Symbol::objTypeName,
+			Symbol::objMemberName,
+			HQ_VALUE_TYPE_INT32,
+			&memberIndex
+		)
+	);
+	BENCH_CHECK(Bench::AddString(builder, Symbol::objTypeName, stringIndex));
+	BENCH_CHECK(_setupOperands<HQ_VALUE_TYPE_INT32>(builder));
+
+	return HqBytecodeEmitInitObject(builder.hSerializer, REG_CONTAINER, stringIndex);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _setupArray(BenchmarkBuilder& builder)
+{
+	BENCH_CHECK(_setupOperands<HQ_VALUE_TYPE_INT32>(builder));
+	BENCH_CHECK(HqBytecodeEmitLoadImmI32(builder.hSerializer, REG_INDEX_X, 5));
+
+	return HqBytecodeEmitInitArray(builder.hSerializer, REG_CONTAINER, 16);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _setupGrid(BenchmarkBuilder& builder)
+{
+	BENCH_CHECK(_setupOperands<HQ_VALUE_TYPE_INT32>(builder));
+	BENCH_CHECK(HqBytecodeEmitLoadImmI32(builder.hSerializer, REG_INDEX_X, 1));
+	BENCH_CHECK(HqBytecodeEmitLoadImmI32(builder.hSerializer, REG_INDEX_Y, 2));
+	BENCH_CHECK(HqBytecodeEmitLoadImmI32(builder.hSerializer, REG_INDEX_Z, 3));
+
+	return HqBytecodeEmitInitGrid(builder.hSerializer, REG_CONTAINER, 4, 4, 4);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _setupScriptCallee(BenchmarkBuilder& builder)
+{
+	return Bench::AddFunction(builder, Symbol::scriptCallee, 0, 0, nullptr);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _setupNativeCallee(BenchmarkBuilder& builder)
+{
+	return HqModuleWriterAddNativeFunction(builder.hModuleWriter, Symbol::nativeCallee, 0, 0);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _bindNativeCallee(HqVmHandle hVm)
+{
+	auto nativeFn = [](HqExecutionHandle, HqFunctionHandle, void*) {};
+
+	HqFunctionHandle hFunction = HQ_FUNCTION_HANDLE_NULL;
+	BENCH_CHECK(HqVmGetFunction(hVm, &hFunction, Symbol::nativeCallee));
+
+	return HqFunctionSetNativeBinding(hFunction, nativeFn, nullptr);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _setupFunctionValue(BenchmarkBuilder& builder)
+{
+	uint32_t stringIndex = 0;
+
+	BENCH_CHECK(_setupScriptCallee(builder));
+	BENCH_CHECK(Bench::AddString(builder, Symbol::scriptCallee, stringIndex));
+
+	return HqBytecodeEmitInitFunction(builder.hSerializer, REG_SRC_LEFT, stringIndex);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _emitNop(BenchmarkBuilder& builder)
+{
+	return HqBytecodeEmitNop(builder.hSerializer);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _emitLoadImmNull(BenchmarkBuilder& builder)
+{
+	return HqBytecodeEmitLoadImmNull(builder.hSerializer, REG_DST);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _emitLoadImmI32(BenchmarkBuilder& builder)
+{
+	return HqBytecodeEmitLoadImmI32(builder.hSerializer, REG_DST, 12345);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _emitLoadImmF64(BenchmarkBuilder& builder)
+{
+	return HqBytecodeEmitLoadImmF64(builder.hSerializer, REG_DST, 1.2345);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _emitLoadImmStr(BenchmarkBuilder& builder)
+{
+	uint32_t stringIndex = 0;
+	BENCH_CHECK(Bench::AddString(builder, Symbol::stringValue, stringIndex));
+
+	return HqBytecodeEmitLoadImmStr(builder.hSerializer, REG_DST, stringIndex);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _emitLoadGlobal(BenchmarkBuilder& builder)
+{
+	uint32_t stringIndex = 0;
+	BENCH_CHECK(Bench::AddString(builder, Symbol::globalName, stringIndex));
+
+	return HqBytecodeEmitLoadGlobal(builder.hSerializer, REG_DST, stringIndex);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _emitStoreGlobal(BenchmarkBuilder& builder)
+{
+	uint32_t stringIndex = 0;
+	BENCH_CHECK(Bench::AddString(builder, Symbol::globalName, stringIndex));
+
+	return HqBytecodeEmitStoreGlobal(builder.hSerializer, stringIndex, REG_SRC_LEFT);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _emitLoadVariable(BenchmarkBuilder& builder)
+{
+	return HqBytecodeEmitLoadVariable(builder.hSerializer, REG_DST, 0);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _emitStoreVariable(BenchmarkBuilder& builder)
+{
+	return HqBytecodeEmitStoreVariable(builder.hSerializer, 0, REG_SRC_LEFT);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _emitLoadParam(BenchmarkBuilder& builder)
+{
+	return HqBytecodeEmitLoadParam(builder.hSerializer, REG_DST, 0);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _emitStoreParam(BenchmarkBuilder& builder)
+{
+	return HqBytecodeEmitStoreParam(builder.hSerializer, 0, REG_SRC_LEFT);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _emitPushPop(BenchmarkBuilder& builder)
+{
+	BENCH_CHECK(HqBytecodeEmitPush(builder.hSerializer, REG_SRC_LEFT));
+	return HqBytecodeEmitPop(builder.hSerializer, REG_DST);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _emitCallScript(BenchmarkBuilder& builder)
+{
+	uint32_t stringIndex = 0;
+	BENCH_CHECK(Bench::AddString(builder, Symbol::scriptCallee, stringIndex));
+
+	return HqBytecodeEmitCall(builder.hSerializer, stringIndex);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _emitCallNative(BenchmarkBuilder& builder)
+{
+	uint32_t stringIndex = 0;
+	BENCH_CHECK(Bench::AddString(builder, Symbol::nativeCallee, stringIndex));
+
+	return HqBytecodeEmitCall(builder.hSerializer, stringIndex);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _emitCallValue(BenchmarkBuilder& builder)
+{
+	return HqBytecodeEmitCallValue(builder.hSerializer, REG_SRC_LEFT);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _emitInitObject(BenchmarkBuilder& builder)
+{
+	uint32_t stringIndex = 0;
+	BENCH_CHECK(Bench::AddString(builder, Symbol::objTypeName, stringIndex));
+
+	return HqBytecodeEmitInitObject(builder.hSerializer, REG_DST, stringIndex);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _emitLoadObject(BenchmarkBuilder& builder)
+{
+	return HqBytecodeEmitLoadObject(builder.hSerializer, REG_DST, REG_CONTAINER, 0);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _emitStoreObject(BenchmarkBuilder& builder)
+{
+	return HqBytecodeEmitStoreObject(builder.hSerializer, REG_CONTAINER, REG_SRC_LEFT, 0);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _emitInitArray(BenchmarkBuilder& builder)
+{
+	return HqBytecodeEmitInitArray(builder.hSerializer, REG_DST, 16);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _emitLoadArray(BenchmarkBuilder& builder)
+{
+	return HqBytecodeEmitLoadArray(builder.hSerializer, REG_DST, REG_CONTAINER, REG_INDEX_X);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _emitStoreArray(BenchmarkBuilder& builder)
+{
+	return HqBytecodeEmitStoreArray(builder.hSerializer, REG_CONTAINER, REG_SRC_LEFT, REG_INDEX_X);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _emitLength(BenchmarkBuilder& builder)
+{
+	return HqBytecodeEmitLength(builder.hSerializer, REG_DST, REG_CONTAINER);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _emitInitGrid(BenchmarkBuilder& builder)
+{
+	return HqBytecodeEmitInitGrid(builder.hSerializer, REG_DST, 4, 4, 4);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _emitLoadGrid(BenchmarkBuilder& builder)
+{
+	return HqBytecodeEmitLoadGrid(builder.hSerializer, REG_DST, REG_CONTAINER, REG_INDEX_X, REG_INDEX_Y, REG_INDEX_Z);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _emitStoreGrid(BenchmarkBuilder& builder)
+{
+	return HqBytecodeEmitStoreGrid(builder.hSerializer, REG_CONTAINER, REG_SRC_LEFT, REG_INDEX_X, REG_INDEX_Y, REG_INDEX_Z);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _emitRaiseHandled(BenchmarkBuilder& builder)
+{
+	BenchmarkGuardedBlock block;
+	block.offset = HqSerializerGetStreamPosition(builder.hSerializer);
+	block.handledType = HQ_VALUE_TYPE_INT32;
+	block.className = nullptr;
+
+	BENCH_CHECK(HqBytecodeEmitRaise(builder.hSerializer, REG_SRC_LEFT));
+
+	// The handler picks up immediately after the guarded RAISE, so execution falls through to the next op.
+	block.handlerOffset = HqSerializerGetStreamPosition(builder.hSerializer);
+	block.length = block.handlerOffset - block.offset;
+
+	builder.guardedBlocks.push_back(block);
+
+	return HQ_SUCCESS;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#define _BENCH_ARITH(opName, emitFn) \
+	{ "arithmetic", opName "_i32", _setupOperands<HQ_VALUE_TYPE_INT32>, _emitBinaryOp<emitFn>, nullptr }, \
+	{ "arithmetic", opName "_i64", _setupOperands<HQ_VALUE_TYPE_INT64>, _emitBinaryOp<emitFn>, nullptr }, \
+	{ "arithmetic", opName "_f32", _setupOperands<HQ_VALUE_TYPE_FLOAT32>, _emitBinaryOp<emitFn>, nullptr }, \
+	{ "arithmetic", opName "_f64", _setupOperands<HQ_VALUE_TYPE_FLOAT64>, _emitBinaryOp<emitFn>, nullptr }
+
+#define _BENCH_CAST(opName, emitFn) \
+	{ "cast", "i32_" opName, _setupOperands<HQ_VALUE_TYPE_INT32>, _emitUnaryOp<emitFn>, nullptr }, \
+	{ "cast", "f64_" opName, _setupOperands<HQ_VALUE_TYPE_FLOAT64>, _emitUnaryOp<emitFn>, nullptr }
+
+#define _BENCH_COMPARE(opName, emitFn) \
+	{ "compare", opName "_i32", _setupOperands<HQ_VALUE_TYPE_INT32>, _emitBinaryOp<emitFn>, nullptr }, \
+	{ "compare", opName "_f64", _setupOperands<HQ_VALUE_TYPE_FLOAT64>, _emitBinaryOp<emitFn>, nullptr }
+
+static const Benchmark _opCodeBenchmarks[] =
+{
+	{ "dispatch", "nop", nullptr, _emitNop, nullptr },
+
+	{ "load_store", "load_imm_null", nullptr, _emitLoadImmNull, nullptr },
+	{ "load_store", "load_imm_i32", nullptr, _emitLoadImmI32, nullptr },
+	{ "load_store", "load_imm_f64", nullptr, _emitLoadImmF64, nullptr },
+	{ "load_store", "load_imm_str", nullptr, _emitLoadImmStr, nullptr },
+	{ "load_store", "load_global", _setupGlobal, _emitLoadGlobal, nullptr },
+	{ "load_store", "store_global", _setupGlobal, _emitStoreGlobal, nullptr },
+	{ "load_store", "load_variable", _setupVariable, _emitLoadVariable, nullptr },
+	{ "load_store", "store_variable", _setupVariable, _emitStoreVariable, nullptr },
+	{ "load_store", "load_param", _setupParam, _emitLoadParam, nullptr },
+	{ "load_store", "store_param", _setupParam, _emitStoreParam, nullptr },
+	{ "load_store", "push_pop", _setupOperands<HQ_VALUE_TYPE_INT32>, _emitPushPop, nullptr },
+	{ "load_store", "move", _setupOperands<HQ_VALUE_TYPE_INT32>, _emitUnaryOp<HqBytecodeEmitMove>, nullptr },
+	{ "load_store", "copy_i32", _setupOperands<HQ_VALUE_TYPE_INT32>, _emitUnaryOp<HqBytecodeEmitCopy>, nullptr },
+	{ "load_store", "copy_str", _setupString, _emitUnaryOp<HqBytecodeEmitCopy>, nullptr },
+
+	_BENCH_ARITH("add", HqBytecodeEmitAdd),
+	_BENCH_ARITH("sub", HqBytecodeEmitSub),
+	_BENCH_ARITH("mul", HqBytecodeEmitMul),
+	_BENCH_ARITH("div", HqBytecodeEmitDiv),
+	{ "arithmetic", "add_str", _setupString, _emitBinaryOp<HqBytecodeEmitAdd>, nullptr },
+	{ "arithmetic", "mod_i32", _setupOperands<HQ_VALUE_TYPE_INT32>, _emitBinaryOp<HqBytecodeEmitMod>, nullptr },
+	{ "arithmetic", "bit_and_i32", _setupOperands<HQ_VALUE_TYPE_INT32>, _emitBinaryOp<HqBytecodeEmitBitAnd>, nullptr },
+	{ "arithmetic", "left_shift_i32", _setupOperands<HQ_VALUE_TYPE_INT32>, _emitBinaryOp<HqBytecodeEmitLeftShift>, nullptr },
+
+	_BENCH_CAST("to_i32", HqBytecodeEmitCastInt32),
+	_BENCH_CAST("to_i64", HqBytecodeEmitCastInt64),
+	_BENCH_CAST("to_f64", HqBytecodeEmitCastFloat64),
+	_BENCH_CAST("to_bool", HqBytecodeEmitCastBool),
+	_BENCH_CAST("to_str", HqBytecodeEmitCastString),
+
+	_BENCH_COMPARE("equal", HqBytecodeEmitCompareEqual),
+	_BENCH_COMPARE("less", HqBytecodeEmitCompareLess),
+	{ "compare", "equal_str", _setupString, _emitBinaryOp<HqBytecodeEmitCompareEqual>, nullptr },
+	{ "compare", "test_i32", _setupOperands<HQ_VALUE_TYPE_INT32>, _emitUnaryOp<HqBytecodeEmitTest>, nullptr },
+
+	{ "call", "call_script", _setupScriptCallee, _emitCallScript, nullptr },
+	{ "call", "call_native", _setupNativeCallee, _emitCallNative, _bindNativeCallee },
+	{ "call", "call_value", _setupFunctionValue, _emitCallValue, nullptr },
+
+	{ "object", "init_object", _setupObject, _emitInitObject, nullptr },
+	{ "object", "load_object", _setupObject, _emitLoadObject, nullptr },
+	{ "object", "store_object", _setupObject, _emitStoreObject, nullptr },
+
+	{ "array", "init_array", _setupArray, _emitInitArray, nullptr },
+	{ "array", "load_array", _setupArray, _emitLoadArray, nullptr },
+	{ "array", "store_array", _setupArray, _emitStoreArray, nullptr },
+	{ "array", "length", _setupArray, _emitLength, nullptr },
+
+	{ "grid", "init_grid", _setupGrid, _emitInitGrid, nullptr },
+	{ "grid", "load_grid", _setupGrid, _emitLoadGrid, nullptr },
+	{ "grid", "store_grid", _setupGrid, _emitStoreGrid, nullptr },
+
+	{ "exception", "raise_handled", _setupOperands<HQ_VALUE_TYPE_INT32>, _emitRaiseHandled, nullptr },
+};
+
+#undef _BENCH_ARITH
+#undef _BENCH_CAST
+#undef _BENCH_COMPARE
+
+//----------------------------------------------------------------------------------------------------------------------
+
+const Benchmark* Bench::GetOpCodeBenchmarks(size_t& outCount)
+{
+	outCount = sizeof(_opCodeBenchmarks) / sizeof(_opCodeBenchmarks[0]);
+	return _opCodeBenchmarks;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,770 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include "Benchmark.hpp"
+
+#include <develop/compiler/ControlFlow.hpp>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct _LoopRegs
+{
+	uint32_t counter;
+	uint32_t limit;
+	uint32_t step;
+	uint32_t cond;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// Emits the head of "for(counter = 0; counter < limit; ++counter)". The body follows, closed by _endCountedLoop().
+static int _beginCountedLoop(
+	BenchmarkBuilder& builder,
+	ControlFlow& loop,
+	const _LoopRegs& regs,
+	const int32_t limit)
+{
+	const HqSerializerHandle hSerializer = builder.hSerializer;
+
+	BENCH_CHECK(HqBytecodeEmitLoadImmI32(hSerializer, regs.counter, 0));
+	BENCH_CHECK(HqBytecodeEmitLoadImmI32(hSerializer, regs.limit, limit));
+	BENCH_CHECK(HqBytecodeEmitLoadImmI32(hSerializer, regs.step, 1));
+	BENCH_CHECK(HqBytecodeEmitCompareLess(hSerializer, regs.cond, regs.counter, regs.limit));
+
+	loop.Begin(hSerializer, ControlFlow::Behavior::While, ControlFlow::Condition::False, regs.cond);
+
+	return HQ_SUCCESS;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _endCountedLoop(BenchmarkBuilder& builder, ControlFlow& loop, const _LoopRegs& regs)
+{
+	BENCH_CHECK(HqBytecodeEmitAdd(builder.hSerializer, regs.counter, regs.counter, regs.step));
+	BENCH_CHECK(HqBytecodeEmitCompareLess(builder.hSerializer, regs.cond, regs.counter, regs.limit));
+
+	loop.End();
+
+	return HQ_SUCCESS;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace Covariance
+{
+	enum
+	{
+		MATRIX_00, MATRIX_01, MATRIX_02,
+		MATRIX_10, MATRIX_11, MATRIX_12,
+		MATRIX_20, MATRIX_21, MATRIX_22,
+
+		MATRIX__COUNT,
+	};
+
+	enum
+	{
+		VECTOR_X,
+		VECTOR_Y,
+		VECTOR_Z,
+
+		VECTOR__COUNT,
+	};
+
+	static constexpr const char* const funcSig = "(matrix, vector) covarianceMatrix(vector[])";
+	static constexpr const char* const matrixTypeName = "matrix";
+	static constexpr const char* const vectorTypeName = "vector";
+
+	static constexpr const char* const matrixMemberName[MATRIX__COUNT] =
+	{
+		"m00", "m01", "m02",
+		"m10", "m11", "m12",
+		"m20", "m21", "m22",
+	};
+
+	static constexpr const char* const vectorMemberName[VECTOR__COUNT] =
+	{
+		"x", "y", "z",
+	};
+
+	static constexpr int32_t pointCount = 4096;
+	static constexpr int32_t repeatCount = 8;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// Same algorithm as the ComputeCovarianceMatrix functional test sample.
+static int _emitCovarianceMatrix(BenchmarkBuilder& builder)
+{
+	using namespace Covariance;
+
+	const HqSerializerHandle hSerializer = builder.hSerializer;
+
+	uint32_t matrixTypeStrIdx = 0;
+	uint32_t vectorTypeStrIdx = 0;
+
+	BENCH_CHECK(Bench::AddString(builder, matrixTypeName, matrixTypeStrIdx));
+	BENCH_CHECK(Bench::AddString(builder, vectorTypeName, vectorTypeStrIdx));
+
+	enum : uint32_t
+	{
+		REG_OUT_MATRIX,
+		REG_OUT_CENTROID,
+		REG_INPUT,
+		REG_LEN_INT,
+		REG_LEN_FLT,
+		REG_INV_LEN,
+		REG_CENTROID_X,
+		REG_CENTROID_Y,
+		REG_CENTROID_Z,
+		REG_ITER,
+		REG_COND,
+		REG_INCR,
+		REG_POINT,
+		REG_POINT_X,
+		REG_POINT_Y,
+		REG_POINT_Z,
+		REG_REL_X,
+		REG_REL_Y,
+		REG_REL_Z,
+		REG_TEMP,
+		REG_M00,
+		REG_M01,
+		REG_M02,
+		REG_M11,
+		REG_M12,
+		REG_M22,
+	};
+
+	// The member indices follow the order the members were added to each type.
+	BENCH_CHECK(HqBytecodeEmitInitObject(hSerializer, REG_OUT_MATRIX, matrixTypeStrIdx));
+	BENCH_CHECK(HqBytecodeEmitInitObject(hSerializer, REG_OUT_CENTROID, vectorTypeStrIdx));
+	BENCH_CHECK(HqBytecodeEmitLoadParam(hSerializer, REG_INPUT, 0));
+
+	// float32 invPointCount = 1.0f / len(points)
+	BENCH_CHECK(HqBytecodeEmitLength(hSerializer, REG_LEN_INT, REG_INPUT));
+	BENCH_CHECK(HqBytecodeEmitCastFloat32(hSerializer, REG_LEN_FLT, REG_LEN_INT));
+	BENCH_CHECK(HqBytecodeEmitLoadImmF32(hSerializer, REG_INV_LEN, 1.0f));
+	BENCH_CHECK(HqBytecodeEmitDiv(hSerializer, REG_INV_LEN, REG_INV_LEN, REG_LEN_FLT));
+
+	// Calculate the centroid from the input points.
+	{
+		BENCH_CHECK(HqBytecodeEmitLoadImmU32(hSerializer, REG_ITER, 0));
+		BENCH_CHECK(HqBytecodeEmitLoadImmU32(hSerializer, REG_INCR, 1));
+		BENCH_CHECK(HqBytecodeEmitCompareLess(hSerializer, REG_COND, REG_ITER, REG_LEN_INT));
+		BENCH_CHECK(HqBytecodeEmitLoadImmF32(hSerializer, REG_CENTROID_X, 0.0f));
+		BENCH_CHECK(HqBytecodeEmitLoadImmF32(hSerializer, REG_CENTROID_Y, 0.0f));
+		BENCH_CHECK(HqBytecodeEmitLoadImmF32(hSerializer, REG_CENTROID_Z, 0.0f));
+
+		ControlFlow loop;
+		loop.Begin(hSerializer, ControlFlow::Behavior::While, ControlFlow::Condition::False, REG_COND);
+		{
+			BENCH_CHECK(HqBytecodeEmitLoadArray(hSerializer, REG_POINT, REG_INPUT, REG_ITER));
+			BENCH_CHECK(HqBytecodeEmitLoadObject(hSerializer, REG_POINT_X, REG_POINT, VECTOR_X));
+			BENCH_CHECK(HqBytecodeEmitLoadObject(hSerializer, REG_POINT_Y, REG_POINT, VECTOR_Y));
+			BENCH_CHECK(HqBytecodeEmitLoadObject(hSerializer, REG_POINT_Z, REG_POINT, VECTOR_Z));
+			BENCH_CHECK(HqBytecodeEmitAdd(hSerializer, REG_CENTROID_X, REG_CENTROID_X, REG_POINT_X));
+			BENCH_CHECK(HqBytecodeEmitAdd(hSerializer, REG_CENTROID_Y, REG_CENTROID_Y, REG_POINT_Y));
+			BENCH_CHECK(HqBytecodeEmitAdd(hSerializer, REG_CENTROID_Z, REG_CENTROID_Z, REG_POINT_Z));
+			BENCH_CHECK(HqBytecodeEmitAdd(hSerializer, REG_ITER, REG_ITER, REG_INCR));
+			BENCH_CHECK(HqBytecodeEmitCompareLess(hSerializer, REG_COND, REG_ITER, REG_LEN_INT));
+		}
+		loop.End();
+
+		BENCH_CHECK(HqBytecodeEmitMul(hSerializer, REG_CENTROID_X, REG_CENTROID_X, REG_INV_LEN));
+		BENCH_CHECK(HqBytecodeEmitMul(hSerializer, REG_CENTROID_Y, REG_CENTROID_Y, REG_INV_LEN));
+		BENCH_CHECK(HqBytecodeEmitMul(hSerializer, REG_CENTROID_Z, REG_CENTROID_Z, REG_INV_LEN));
+		BENCH_CHECK(HqBytecodeEmitStoreObject(hSerializer, REG_OUT_CENTROID, REG_CENTROID_X, VECTOR_X));
+		BENCH_CHECK(HqBytecodeEmitStoreObject(hSerializer, REG_OUT_CENTROID, REG_CENTROID_Y, VECTOR_Y));
+		BENCH_CHECK(HqBytecodeEmitStoreObject(hSerializer, REG_OUT_CENTROID, REG_CENTROID_Z, VECTOR_Z));
+	}
+
+	// Calculate the upper triangle and diagonal of the covariance matrix.
+	{
+		BENCH_CHECK(HqBytecodeEmitLoadImmU32(hSerializer, REG_ITER, 0));
+		BENCH_CHECK(HqBytecodeEmitCompareLess(hSerializer, REG_COND, REG_ITER, REG_LEN_INT));
+		BENCH_CHECK(HqBytecodeEmitLoadImmF32(hSerializer, REG_M00, 1.0f));
+		BENCH_CHECK(HqBytecodeEmitLoadImmF32(hSerializer, REG_M01, 0.0f));
+		BENCH_CHECK(HqBytecodeEmitLoadImmF32(hSerializer, REG_M02, 0.0f));
+		BENCH_CHECK(HqBytecodeEmitLoadImmF32(hSerializer, REG_M11, 1.0f));
+		BENCH_CHECK(HqBytecodeEmitLoadImmF32(hSerializer, REG_M12, 0.0f));
+		BENCH_CHECK(HqBytecodeEmitLoadImmF32(hSerializer, REG_M22, 1.0f));
+
+		ControlFlow loop;
+		loop.Begin(hSerializer, ControlFlow::Behavior::While, ControlFlow::Condition::False, REG_COND);
+		{
+			BENCH_CHECK(HqBytecodeEmitLoadArray(hSerializer, REG_POINT, REG_INPUT, REG_ITER));
+			BENCH_CHECK(HqBytecodeEmitLoadObject(hSerializer, REG_POINT_X, REG_POINT, VECTOR_X));
+			BENCH_CHECK(HqBytecodeEmitLoadObject(hSerializer, REG_POINT_Y, REG_POINT, VECTOR_Y));
+			BENCH_CHECK(HqBytecodeEmitLoadObject(hSerializer, REG_POINT_Z, REG_POINT, VECTOR_Z));
+			BENCH_CHECK(HqBytecodeEmitSub(hSerializer, REG_REL_X, REG_POINT_X, REG_CENTROID_X));
+			BENCH_CHECK(HqBytecodeEmitSub(hSerializer, REG_REL_Y, REG_POINT_Y, REG_CENTROID_Y));
+			BENCH_CHECK(HqBytecodeEmitSub(hSerializer, REG_REL_Z, REG_POINT_Z, REG_CENTROID_Z));
+
+			BENCH_CHECK(HqBytecodeEmitMul(hSerializer, REG_TEMP, REG_REL_X, REG_REL_X));
+			BENCH_CHECK(HqBytecodeEmitAdd(hSerializer, REG_M00, REG_M00, REG_TEMP));
+			BENCH_CHECK(HqBytecodeEmitMul(hSerializer, REG_TEMP, REG_REL_Y, REG_REL_Y));
+			BENCH_CHECK(HqBytecodeEmitAdd(hSerializer, REG_M11, REG_M11, REG_TEMP));
+			BENCH_CHECK(HqBytecodeEmitMul(hSerializer, REG_TEMP, REG_REL_Z, REG_REL_Z));
+			BENCH_CHECK(HqBytecodeEmitAdd(hSerializer, REG_M22, REG_M22, REG_TEMP));
+			BENCH_CHECK(HqBytecodeEmitMul(hSerializer, REG_TEMP, REG_REL_X, REG_REL_Y));
+			BENCH_CHECK(HqBytecodeEmitAdd(hSerializer, REG_M01, REG_M01, REG_TEMP));
+			BENCH_CHECK(HqBytecodeEmitMul(hSerializer, REG_TEMP, REG_REL_X, REG_REL_Z));
+			BENCH_CHECK(HqBytecodeEmitAdd(hSerializer, REG_M02, REG_M02, REG_TEMP));
+			BENCH_CHECK(HqBytecodeEmitMul(hSerializer, REG_TEMP, REG_REL_Y, REG_REL_Z));
+			BENCH_CHECK(HqBytecodeEmitAdd(hSerializer, REG_M12, REG_M12, REG_TEMP));
+
+			BENCH_CHECK(HqBytecodeEmitAdd(hSerializer, REG_ITER, REG_ITER, REG_INCR));
+			BENCH_CHECK(HqBytecodeEmitCompareLess(hSerializer, REG_COND, REG_ITER, REG_LEN_INT));
+		}
+		loop.End();
+
+		const uint32_t matrixRegs[MATRIX__COUNT] =
+		{
+			REG_M00, REG_M01, REG_M02,
+			REG_M01, REG_M11, REG_M12,
+			REG_M02, REG_M12, REG_M22,
+		};
+
+		for(uint32_t i = 0; i < MATRIX__COUNT; ++i)
+		{
+			BENCH_CHECK(HqBytecodeEmitMul(hSerializer, REG_TEMP, matrixRegs[i], REG_INV_LEN));
+			BENCH_CHECK(HqBytecodeEmitStoreObject(hSerializer, REG_OUT_MATRIX, REG_TEMP, i));
+		}
+	}
+
+	BENCH_CHECK(HqBytecodeEmitStoreParam(hSerializer, 0, REG_OUT_MATRIX));
+	return HqBytecodeEmitStoreParam(hSerializer, 1, REG_OUT_CENTROID);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _workloadCovarianceMatrix(BenchmarkBuilder& builder)
+{
+	using namespace Covariance;
+
+	const HqSerializerHandle hSerializer = builder.hSerializer;
+
+	uint32_t vectorTypeStrIdx = 0;
+	uint32_t funcStrIdx = 0;
+	uint32_t memberIdx = 0;
+
+	BENCH_CHECK(HqModuleWriterAddObjectType(builder.hModuleWriter, matrixTypeName));
+	BENCH_CHECK(HqModuleWriterAddObjectType(builder.hModuleWriter, vectorTypeName));
+
+	for(uint32_t i = 0; i < MATRIX__COUNT; ++i)
+	{
+		BENCH_CHECK(
+			HqModuleWriterAddObjectMember(
+				builder.hModuleWriter,
+				matrixTypeName,
+				matrixMemberName[i],
+				HQ_VALUE_TYPE_FLOAT32,
+				&memberIdx
+			)
+		);
+	}
+
+	for(uint32_t i = 0; i < VECTOR__COUNT; ++i)
+	{
+		BENCH_CHECK(
+			HqModuleWriterAddObjectMember(
+				builder.hModuleWriter,
+				vectorTypeName,
+				vectorMemberName[i],
+				HQ_VALUE_TYPE_FLOAT32,
+				&memberIdx
+			)
+		);
+	}
+
+	BENCH_CHECK(Bench::AddString(builder, vectorTypeName, vectorTypeStrIdx));
+	BENCH_CHECK(Bench::AddString(builder, funcSig, funcStrIdx));
+	BENCH_CHECK(Bench::AddFunction(builder, funcSig, 1, 2, _emitCovarianceMatrix));
+
+	enum : uint32_t
+	{
+		REG_POINTS,
+		REG_POINT,
+		REG_VALUE,
+		REG_SCALE,
+		REG_MOD,
+		REG_REMAINDER,
+		REG_LOOP,
+	};
+
+	const _LoopRegs loopRegs = { REG_LOOP, REG_LOOP + 1, REG_LOOP + 2, REG_LOOP + 3 };
+
+	// Build the input points: (i, i * 0.5, i % 7)
+	BENCH_CHECK(HqBytecodeEmitInitArray(hSerializer, REG_POINTS, pointCount));
+	BENCH_CHECK(HqBytecodeEmitLoadImmF32(hSerializer, REG_SCALE, 0.5f));
+	BENCH_CHECK(HqBytecodeEmitLoadImmI32(hSerializer, REG_MOD, 7));
+	{
+		ControlFlow loop;
+		BENCH_CHECK(_beginCountedLoop(builder, loop, loopRegs, pointCount));
+		{
+			BENCH_CHECK(HqBytecodeEmitInitObject(hSerializer, REG_POINT, vectorTypeStrIdx));
+			BENCH_CHECK(HqBytecodeEmitCastFloat32(hSerializer, REG_VALUE, loopRegs.counter));
+			BENCH_CHECK(HqBytecodeEmitStoreObject(hSerializer, REG_POINT, REG_VALUE, VECTOR_X));
+			BENCH_CHECK(HqBytecodeEmitMul(hSerializer, REG_VALUE, REG_VALUE, REG_SCALE));
+			BENCH_CHECK(HqBytecodeEmitStoreObject(hSerializer, REG_POINT, REG_VALUE, VECTOR_Y));
+			BENCH_CHECK(HqBytecodeEmitMod(hSerializer, REG_REMAINDER, loopRegs.counter, REG_MOD));
+			BENCH_CHECK(HqBytecodeEmitCastFloat32(hSerializer, REG_VALUE, REG_REMAINDER));
+			BENCH_CHECK(HqBytecodeEmitStoreObject(hSerializer, REG_POINT, REG_VALUE, VECTOR_Z));
+			BENCH_CHECK(HqBytecodeEmitStoreArray(hSerializer, REG_POINTS, REG_POINT, loopRegs.counter));
+		}
+		BENCH_CHECK(_endCountedLoop(builder, loop, loopRegs));
+	}
+
+	// Run the covariance calculation over the points several times.
+	{
+		ControlFlow loop;
+		BENCH_CHECK(_beginCountedLoop(builder, loop, loopRegs, repeatCount));
+		{
+			BENCH_CHECK(HqBytecodeEmitStoreParam(hSerializer, 0, REG_POINTS));
+			BENCH_CHECK(HqBytecodeEmitCall(hSerializer, funcStrIdx));
+		}
+		BENCH_CHECK(_endCountedLoop(builder, loop, loopRegs));
+	}
+
+	return HQ_SUCCESS;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace Fibonacci
+{
+	static constexpr const char* const funcSig = "int32_t fib(int32_t)";
+	static constexpr int32_t input = 24;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _emitFibonacci(BenchmarkBuilder& builder)
+{
+	const HqSerializerHandle hSerializer = builder.hSerializer;
+
+	uint32_t funcStrIdx = 0;
+	BENCH_CHECK(Bench::AddString(builder, Fibonacci::funcSig, funcStrIdx));
+
+	enum : uint32_t
+	{
+		REG_N,
+		REG_ONE,
+		REG_TWO,
+		REG_COND,
+		REG_ARG,
+		REG_LEFT,
+		REG_RIGHT,
+	};
+
+	BENCH_CHECK(HqBytecodeEmitLoadParam(hSerializer, REG_N, 0));
+	BENCH_CHECK(HqBytecodeEmitLoadImmI32(hSerializer, REG_ONE, 1));
+	BENCH_CHECK(HqBytecodeEmitLoadImmI32(hSerializer, REG_TWO, 2));
+
+	// if(n < 2) return n;
+	BENCH_CHECK(HqBytecodeEmitCompareLess(hSerializer, REG_COND, REG_N, REG_TWO));
+	{
+		ControlFlow branch;
+		branch.Begin(hSerializer, ControlFlow::Behavior::If, ControlFlow::Condition::False, REG_COND);
+		BENCH_CHECK(HqBytecodeEmitReturn(hSerializer));
+		branch.End();
+	}
+
+	// return fib(n - 1) + fib(n - 2);
+	BENCH_CHECK(HqBytecodeEmitSub(hSerializer, REG_ARG, REG_N, REG_ONE));
+	BENCH_CHECK(HqBytecodeEmitStoreParam(hSerializer, 0, REG_ARG));
+	BENCH_CHECK(HqBytecodeEmitCall(hSerializer, funcStrIdx));
+	BENCH_CHECK(HqBytecodeEmitLoadParam(hSerializer, REG_LEFT, 0));
+	BENCH_CHECK(HqBytecodeEmitSub(hSerializer, REG_ARG, REG_N, REG_TWO));
+	BENCH_CHECK(HqBytecodeEmitStoreParam(hSerializer, 0, REG_ARG));
+	BENCH_CHECK(HqBytecodeEmitCall(hSerializer, funcStrIdx));
+	BENCH_CHECK(HqBytecodeEmitLoadParam(hSerializer, REG_RIGHT, 0));
+	BENCH_CHECK(HqBytecodeEmitAdd(hSerializer, REG_LEFT, REG_LEFT, REG_RIGHT));
+
+	return HqBytecodeEmitStoreParam(hSerializer, 0, REG_LEFT);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _workloadFibonacci(BenchmarkBuilder& builder)
+{
+	uint32_t funcStrIdx = 0;
+
+	BENCH_CHECK(Bench::AddString(builder, Fibonacci::funcSig, funcStrIdx));
+	BENCH_CHECK(Bench::AddFunction(builder, Fibonacci::funcSig, 1, 1, _emitFibonacci));
+
+	BENCH_CHECK(HqBytecodeEmitLoadImmI32(builder.hSerializer, 0, Fibonacci::input));
+	BENCH_CHECK(HqBytecodeEmitStoreParam(builder.hSerializer, 0, 0));
+
+	return HqBytecodeEmitCall(builder.hSerializer, funcStrIdx);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _workloadStringBuild(BenchmarkBuilder& builder)
+{
+	static constexpr int32_t lineCount = 2000;
+	static constexpr int32_t fieldCount = 32;
+
+	const HqSerializerHandle hSerializer = builder.hSerializer;
+
+	uint32_t prefixStrIdx = 0;
+	uint32_t separatorStrIdx = 0;
+
+	BENCH_CHECK(Bench::AddString(builder, "line:", prefixStrIdx));
+	BENCH_CHECK(Bench::AddString(builder, ",", separatorStrIdx));
+
+	enum : uint32_t
+	{
+		REG_LINE,
+		REG_SEPARATOR,
+		REG_FIELD,
+		REG_OUTER_LOOP,
+		REG_INNER_LOOP = REG_OUTER_LOOP + 4,
+	};
+
+	const _LoopRegs outerRegs = { REG_OUTER_LOOP, REG_OUTER_LOOP + 1, REG_OUTER_LOOP + 2, REG_OUTER_LOOP + 3 };
+	const _LoopRegs innerRegs = { REG_INNER_LOOP, REG_INNER_LOOP + 1, REG_INNER_LOOP + 2, REG_INNER_LOOP + 3 };
+
+	BENCH_CHECK(HqBytecodeEmitLoadImmStr(hSerializer, REG_SEPARATOR, separatorStrIdx));
+
+	// Build each line by appending the field numbers one at a time: "line:0,1,2,..."
+	ControlFlow outerLoop;
+	BENCH_CHECK(_beginCountedLoop(builder, outerLoop, outerRegs, lineCount));
+	{
+		BENCH_CHECK(HqBytecodeEmitLoadImmStr(hSerializer, REG_LINE, prefixStrIdx));
+
+		ControlFlow innerLoop;
+		BENCH_CHECK(_beginCountedLoop(builder, innerLoop, innerRegs, fieldCount));
+		{
+			BENCH_CHECK(HqBytecodeEmitCastString(hSerializer, REG_FIELD, innerRegs.counter));
+			BENCH_CHECK(HqBytecodeEmitAdd(hSerializer, REG_LINE, REG_LINE, REG_FIELD));
+			BENCH_CHECK(HqBytecodeEmitAdd(hSerializer, REG_LINE, REG_LINE, REG_SEPARATOR));
+		}
+		BENCH_CHECK(_endCountedLoop(builder, innerLoop, innerRegs));
+	}
+	return _endCountedLoop(builder, outerLoop, outerRegs);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _workloadArraySort(BenchmarkBuilder& builder)
+{
+	static constexpr int32_t elementCount = 1024;
+
+	const HqSerializerHandle hSerializer = builder.hSerializer;
+
+	enum : uint32_t
+	{
+		REG_ARRAY,
+		REG_SEED,
+		REG_MUL,
+		REG_INC,
+		REG_MOD,
+		REG_ZERO,
+		REG_ONE,
+		REG_KEY,
+		REG_PREV,
+		REG_POS,
+		REG_PREV_POS,
+		REG_COND,
+		REG_LOOP,
+	};
+
+	const _LoopRegs loopRegs = { REG_LOOP, REG_LOOP + 1, REG_LOOP + 2, REG_LOOP + 3 };
+
+	BENCH_CHECK(HqBytecodeEmitInitArray(hSerializer, REG_ARRAY, elementCount));
+	BENCH_CHECK(HqBytecodeEmitLoadImmI32(hSerializer, REG_SEED, 1));
+	BENCH_CHECK(HqBytecodeEmitLoadImmI32(hSerializer, REG_MUL, 75));
+	BENCH_CHECK(HqBytecodeEmitLoadImmI32(hSerializer, REG_INC, 74));
+	BENCH_CHECK(HqBytecodeEmitLoadImmI32(hSerializer, REG_MOD, 65537));
+	BENCH_CHECK(HqBytecodeEmitLoadImmI32(hSerializer, REG_ZERO, 0));
+	BENCH_CHECK(HqBytecodeEmitLoadImmI32(hSerializer, REG_ONE, 1));
+
+	// Fill the array with pseudo-random values: seed = (seed * 75 + 74) % 65537
+	{
+		ControlFlow loop;
+		BENCH_CHECK(_beginCountedLoop(builder, loop, loopRegs, elementCount));
+		{
+			BENCH_CHECK(HqBytecodeEmitMul(hSerializer, REG_SEED, REG_SEED, REG_MUL));
+			BENCH_CHECK(HqBytecodeEmitAdd(hSerializer, REG_SEED, REG_SEED, REG_INC));
+			BENCH_CHECK(HqBytecodeEmitMod(hSerializer, REG_SEED, REG_SEED, REG_MOD));
+			BENCH_CHECK(HqBytecodeEmitStoreArray(hSerializer, REG_ARRAY, REG_SEED, loopRegs.counter));
+		}
+		BENCH_CHECK(_endCountedLoop(builder, loop, loopRegs));
+	}
+
+	// Load the element just before 'pos' into 'prev', then check whether it still needs to shift up.
+	auto emitShiftCheck = [hSerializer]() -> int
+	{
+		BENCH_CHECK(HqBytecodeEmitCompareGreater(hSerializer, REG_COND, REG_POS, REG_ZERO));
+
+		ControlFlow branch;
+		branch.Begin(hSerializer, ControlFlow::Behavior::If, ControlFlow::Condition::False, REG_COND);
+		{
+			BENCH_CHECK(HqBytecodeEmitSub(hSerializer, REG_PREV_POS, REG_POS, REG_ONE));
+			BENCH_CHECK(HqBytecodeEmitLoadArray(hSerializer, REG_PREV, REG_ARRAY, REG_PREV_POS));
+			BENCH_CHECK(HqBytecodeEmitCompareGreater(hSerializer, REG_COND, REG_PREV, REG_KEY));
+		}
+		branch.End();
+
+		return HQ_SUCCESS;
+	};
+
+	// Insertion sort.
+	{
+		ControlFlow loop;
+		BENCH_CHECK(_beginCountedLoop(builder, loop, loopRegs, elementCount));
+		{
+			BENCH_CHECK(HqBytecodeEmitLoadArray(hSerializer, REG_KEY, REG_ARRAY, loopRegs.counter));
+			BENCH_CHECK(HqBytecodeEmitCopy(hSerializer, REG_POS, loopRegs.counter));
+			BENCH_CHECK(emitShiftCheck());
+
+			ControlFlow shiftLoop;
+			shiftLoop.Begin(hSerializer, ControlFlow::Behavior::While, ControlFlow::Condition::False, REG_COND);
+			{
+				BENCH_CHECK(HqBytecodeEmitStoreArray(hSerializer, REG_ARRAY, REG_PREV, REG_POS));
+				BENCH_CHECK(HqBytecodeEmitSub(hSerializer, REG_POS, REG_POS, REG_ONE));
+				BENCH_CHECK(emitShiftCheck());
+			}
+			shiftLoop.End();
+
+			BENCH_CHECK(HqBytecodeEmitStoreArray(hSerializer, REG_ARRAY, REG_KEY, REG_POS));
+		}
+		BENCH_CHECK(_endCountedLoop(builder, loop, loopRegs));
+	}
+
+	return HQ_SUCCESS;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _workloadObjectSimulation(BenchmarkBuilder& builder)
+{
+	static constexpr const char* const typeName = "particle";
+	static constexpr const char* const memberName[] = { "px", "py", "vx", "vy" };
+	static constexpr int32_t particleCount = 512;
+	static constexpr int32_t stepCount = 64;
+
+	enum : uint32_t
+	{
+		MEMBER_PX,
+		MEMBER_PY,
+		MEMBER_VX,
+		MEMBER_VY,
+	};
+
+	const HqSerializerHandle hSerializer = builder.hSerializer;
+
+	uint32_t typeStrIdx = 0;
+	uint32_t memberIdx = 0;
+
+	BENCH_CHECK(HqModuleWriterAddObjectType(builder.hModuleWriter, typeName));
+
+	for(const char* const name : memberName)
+	{
+		BENCH_CHECK(HqModuleWriterAddObjectMember(builder.hModuleWriter, typeName, name, HQ_VALUE_TYPE_FLOAT32, &memberIdx));
+	}
+
+	BENCH_CHECK(Bench::AddString(builder, typeName, typeStrIdx));
+
+	enum : uint32_t
+	{
+		REG_PARTICLES,
+		REG_OLD,
+		REG_NEW,
+		REG_POS,
+		REG_VEL,
+		REG_TEMP,
+		REG_DT,
+		REG_GRAVITY,
+		REG_STEP_LOOP,
+		REG_PARTICLE_LOOP = REG_STEP_LOOP + 4,
+	};
+
+	const _LoopRegs stepRegs = { REG_STEP_LOOP, REG_STEP_LOOP + 1, REG_STEP_LOOP + 2, REG_STEP_LOOP + 3 };
+	const _LoopRegs particleRegs = { REG_PARTICLE_LOOP, REG_PARTICLE_LOOP + 1, REG_PARTICLE_LOOP + 2, REG_PARTICLE_LOOP + 3 };
+
+	BENCH_CHECK(HqBytecodeEmitInitArray(hSerializer, REG_PARTICLES, particleCount));
+	BENCH_CHECK(HqBytecodeEmitLoadImmF32(hSerializer, REG_DT, 0.016f));
+	BENCH_CHECK(HqBytecodeEmitLoadImmF32(hSerializer, REG_GRAVITY, -9.8f));
+
+	// Spawn the particles.
+	{
+		ControlFlow loop;
+		BENCH_CHECK(_beginCountedLoop(builder, loop, particleRegs, particleCount));
+		{
+			BENCH_CHECK(HqBytecodeEmitInitObject(hSerializer, REG_NEW, typeStrIdx));
+			BENCH_CHECK(HqBytecodeEmitCastFloat32(hSerializer, REG_TEMP, particleRegs.counter));
+			BENCH_CHECK(HqBytecodeEmitStoreObject(hSerializer, REG_NEW, REG_TEMP, MEMBER_PX));
+			BENCH_CHECK(HqBytecodeEmitStoreObject(hSerializer, REG_NEW, REG_TEMP, MEMBER_PY));
+			BENCH_CHECK(HqBytecodeEmitStoreObject(hSerializer, REG_NEW, REG_DT, MEMBER_VX));
+			BENCH_CHECK(HqBytecodeEmitStoreObject(hSerializer, REG_NEW, REG_DT, MEMBER_VY));
+			BENCH_CHECK(HqBytecodeEmitStoreArray(hSerializer, REG_PARTICLES, REG_NEW, particleRegs.counter));
+		}
+		BENCH_CHECK(_endCountedLoop(builder, loop, particleRegs));
+	}
+
+	// Step the simulation, replacing every particle with a freshly allocated one each step.
+	ControlFlow stepLoop;
+	BENCH_CHECK(_beginCountedLoop(builder, stepLoop, stepRegs, stepCount));
+	{
+		ControlFlow particleLoop;
+		BENCH_CHECK(_beginCountedLoop(builder, particleLoop, particleRegs, particleCount));
+		{
+			BENCH_CHECK(HqBytecodeEmitLoadArray(hSerializer, REG_OLD, REG_PARTICLES, particleRegs.counter));
+			BENCH_CHECK(HqBytecodeEmitInitObject(hSerializer, REG_NEW, typeStrIdx));
+
+			// vx' = vx; px' = px + vx * dt
+			BENCH_CHECK(HqBytecodeEmitLoadObject(hSerializer, REG_VEL, REG_OLD, MEMBER_VX));
+			BENCH_CHECK(HqBytecodeEmitLoadObject(hSerializer, REG_POS, REG_OLD, MEMBER_PX));
+			BENCH_CHECK(HqBytecodeEmitMul(hSerializer, REG_TEMP, REG_VEL, REG_DT));
+			BENCH_CHECK(HqBytecodeEmitAdd(hSerializer, REG_POS, REG_POS, REG_TEMP));
+			BENCH_CHECK(HqBytecodeEmitStoreObject(hSerializer, REG_NEW, REG_POS, MEMBER_PX));
+			BENCH_CHECK(HqBytecodeEmitStoreObject(hSerializer, REG_NEW, REG_VEL, MEMBER_VX));
+
+			// vy' = vy + gravity * dt; py' = py + vy' * dt
+			BENCH_CHECK(HqBytecodeEmitLoadObject(hSerializer, REG_VEL, REG_OLD, MEMBER_VY));
+			BENCH_CHECK(HqBytecodeEmitMul(hSerializer, REG_TEMP, REG_GRAVITY, REG_DT));
+			BENCH_CHECK(HqBytecodeEmitAdd(hSerializer, REG_VEL, REG_VEL, REG_TEMP));
+			BENCH_CHECK(HqBytecodeEmitLoadObject(hSerializer, REG_POS, REG_OLD, MEMBER_PY));
+			BENCH_CHECK(HqBytecodeEmitMul(hSerializer, REG_TEMP, REG_VEL, REG_DT));
+			BENCH_CHECK(HqBytecodeEmitAdd(hSerializer, REG_POS, REG_POS, REG_TEMP));
+			BENCH_CHECK(HqBytecodeEmitStoreObject(hSerializer, REG_NEW, REG_POS, MEMBER_PY));
+			BENCH_CHECK(HqBytecodeEmitStoreObject(hSerializer, REG_NEW, REG_VEL, MEMBER_VY));
+
+			BENCH_CHECK(HqBytecodeEmitStoreArray(hSerializer, REG_PARTICLES, REG_NEW, particleRegs.counter));
+		}
+		BENCH_CHECK(_endCountedLoop(builder, particleLoop, particleRegs));
+	}
+	return _endCountedLoop(builder, stepLoop, stepRegs);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace Exceptions
+{
+	static constexpr const char* const typeName = "BenchError";
+	static constexpr const char* const funcSig = "void mayThrow(int32_t)";
+	static constexpr int32_t callCount = 20000;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// Raises a BenchError object for every fourth input value.
+static int _emitMayThrow(BenchmarkBuilder& builder)
+{
+	const HqSerializerHandle hSerializer = builder.hSerializer;
+
+	uint32_t typeStrIdx = 0;
+	BENCH_CHECK(Bench::AddString(builder, Exceptions::typeName, typeStrIdx));
+
+	enum : uint32_t
+	{
+		REG_INPUT,
+		REG_DIVISOR,
+		REG_ZERO,
+		REG_REMAINDER,
+		REG_COND,
+		REG_ERROR,
+	};
+
+	BENCH_CHECK(HqBytecodeEmitLoadParam(hSerializer, REG_INPUT, 0));
+	BENCH_CHECK(HqBytecodeEmitLoadImmI32(hSerializer, REG_DIVISOR, 4));
+	BENCH_CHECK(HqBytecodeEmitLoadImmI32(hSerializer, REG_ZERO, 0));
+	BENCH_CHECK(HqBytecodeEmitMod(hSerializer, REG_REMAINDER, REG_INPUT, REG_DIVISOR));
+	BENCH_CHECK(HqBytecodeEmitCompareEqual(hSerializer, REG_COND, REG_REMAINDER, REG_ZERO));
+
+	ControlFlow branch;
+	branch.Begin(hSerializer, ControlFlow::Behavior::If, ControlFlow::Condition::False, REG_COND);
+	{
+		BENCH_CHECK(HqBytecodeEmitInitObject(hSerializer, REG_ERROR, typeStrIdx));
+		BENCH_CHECK(HqBytecodeEmitStoreObject(hSerializer, REG_ERROR, REG_INPUT, 0));
+		BENCH_CHECK(HqBytecodeEmitRaise(hSerializer, REG_ERROR));
+	}
+	branch.End();
+
+	return HQ_SUCCESS;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _workloadExceptions(BenchmarkBuilder& builder)
+{
+	const HqSerializerHandle hSerializer = builder.hSerializer;
+
+	uint32_t funcStrIdx = 0;
+	uint32_t memberIdx = 0;
+
+	BENCH_CHECK(HqModuleWriterAddObjectType(builder.hModuleWriter, Exceptions::typeName));
+	BENCH_CHECK(
+		HqModuleWriterAddObjectMember(
+			builder.hModuleWriter,
+			Exceptions::typeName,
+			"code",
+			HQ_VALUE_TYPE_INT32,
+			&memberIdx
+		)
+	);
+	BENCH_CHECK(Bench::AddString(builder, Exceptions::funcSig, funcStrIdx));
+	BENCH_CHECK(Bench::AddFunction(builder, Exceptions::funcSig, 1, 0, _emitMayThrow));
+
+	const _LoopRegs loopRegs = { 0, 1, 2, 3 };
+
+	// Every call is guarded, so each raise unwinds the callee's frame and resumes right after the call.
+	ControlFlow loop;
+	BENCH_CHECK(_beginCountedLoop(builder, loop, loopRegs, Exceptions::callCount));
+	{
+		BENCH_CHECK(HqBytecodeEmitStoreParam(hSerializer, 0, loopRegs.counter));
+
+		BenchmarkGuardedBlock block;
+		block.offset = HqSerializerGetStreamPosition(hSerializer);
+		block.handledType = HQ_VALUE_TYPE_OBJECT;
+		block.className = Exceptions::typeName;
+
+		BENCH_CHECK(HqBytecodeEmitCall(hSerializer, funcStrIdx));
+
+		block.handlerOffset = HqSerializerGetStreamPosition(hSerializer);
+		block.length = block.handlerOffset - block.offset;
+
+		builder.guardedBlocks.push_back(block);
+	}
+	return _endCountedLoop(builder, loop, loopRegs);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static const Workload _workloads[] =
+{
+	{ "covariance_matrix", _workloadCovarianceMatrix },
+	{ "fib_recursive", _workloadFibonacci },
+	{ "string_build", _workloadStringBuild },
+	{ "array_sort", _workloadArraySort },
+	{ "object_simulation", _workloadObjectSimulation },
+	{ "exceptions", _workloadExceptions },
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+const Workload* Bench::GetWorkloads(size_t& outCount)
+{
+	outCount = sizeof(_workloads) / sizeof(_workloads[0]);
+	return _workloads;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -93,7 +93,11 @@ HqVmInit GetDefaultHqVmInit(void* const pUserData, HqMessageCallback onMessageFn
 	output.gcThreadStackSize = HQ_VM_THREAD_DEFAULT_STACK_SIZE;
 	output.gcTimeSliceMs = HQ_VM_GC_DEFAULT_TIME_SLICE_MS;
 	output.gcTimeWaitMs = HQ_VM_GC_DEFAULT_TIME_WAIT_MS;
+	output.gcMarkThreadCount = 0;
+	output.gcHeapGrowthPercent = HQ_VM_GC_DEFAULT_HEAP_GROWTH_PERCENT;
+	output.gcMinTriggerHeapSize = HQ_VM_GC_DEFAULT_MIN_TRIGGER_HEAP_SIZE;
 	output.gcEnableThread = false;
+	output.useSlabAllocator = false;
 
 	return output;
 }
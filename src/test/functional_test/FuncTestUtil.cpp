@@ -23,13 +23,14 @@
 
 //----------------------------------------------------------------------------------------------------------------------
 
-void Util::CompileBytecode(std::vector<uint8_t>& outBytecode, CompilerCallback callback)
+void Util::CompileBytecode(
+	std::vector<uint8_t>& outBytecode,
+	CompilerCallback callback,
+	const int endianness)
 {
 	// Set the memory context so we have a better idea of where to look when memory validation failures occur.
 	Memory::Instance.SetContext("dev-context");
 
-	constexpr int endianness = HQ_ENDIAN_ORDER_NATIVE;
-
 	const HqDevContextInit init = GetDefaultHqDevContextInit(nullptr, DefaultMessageCallback, HQ_MESSAGE_TYPE_WARNING);
 
 	// Create the develop context.
@@ -52,7 +53,7 @@ void Util::CompileBytecode(std::vector<uint8_t>& outBytecode, CompilerCallback c
 	const int createFileSerializerResult = HqSerializerCreate(&hFileSerializer, HQ_SERIALIZER_MODE_WRITER);
 	ASSERT_EQ(createFileSerializerResult, HQ_SUCCESS);
 
-	// Set the file serializer to the system's native endianness.
+	// Set the file serializer to the requested endianness.
 	const int setFileSerializerEndiannessResult = HqSerializerSetEndianness(hFileSerializer, endianness);
 	ASSERT_EQ(setFileSerializerEndiannessResult, HQ_SUCCESS);
 
@@ -22,12 +22,13 @@
 
 #include "../common/Util.h"
 
+#include <functional>
 #include <vector>
 
 //----------------------------------------------------------------------------------------------------------------------
 
-typedef void (*CompilerCallback)(HqModuleWriterHandle, int);
-typedef void (*RuntimeCallback)(HqVmHandle, HqExecutionHandle);
+typedef std::function<void(HqModuleWriterHandle, int)> CompilerCallback;
+typedef std::function<void(HqVmHandle, HqExecutionHandle)> RuntimeCallback;
 
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -44,7 +45,11 @@ struct ExecStatus
 
 namespace Util
 {
-	void CompileBytecode(std::vector<uint8_t>& outBytecode, CompilerCallback callback);
+	void CompileBytecode(
+		std::vector<uint8_t>& outBytecode,
+		CompilerCallback callback,
+		int endianness = HQ_ENDIAN_ORDER_NATIVE
+	);
 	void ProcessBytecode(
 		const char* moduleName,
 		const char* function,
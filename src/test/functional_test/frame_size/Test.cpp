@@ -0,0 +1,526 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include "../FuncTestUtil.hpp"
+#include "../Memory.hpp"
+
+#include <common/module-format/FileHeader.hpp>
+#include <develop/compiler/ControlFlow.hpp>
+#include <gtest/gtest.h>
+
+#include <string.h>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace Function
+{
+	static constexpr const char* const main = "void main()";
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class _HQ_TEST_NAME(TestFrameSize)
+	: public ::testing::Test
+{
+public:
+
+	virtual void TearDown() override
+	{
+		// Force the memory handler to reset after each test.
+		Memory::Instance.Reset();
+	}
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct FrameSizeTestData
+{
+	int encoding;
+	bool loop;
+	bool retryHandler;
+	bool invalidRegister;
+
+	uint32_t expectedGpRegisterCount;
+	uint32_t expectedVrRegisterCount;
+	uint32_t expectedStackSize;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static void _ConvertToLegacyLayout(std::vector<uint8_t>& module)
+{
+	// Byte offsets into the module file, based on the layout of the file header and table of contents.
+	static constexpr size_t formatFlagsOffset = 6;
+	static constexpr size_t functionTableOffset = 48;
+	static constexpr size_t functionTableLength = 52;
+	static constexpr size_t initBytecodeOffset = 56;
+
+	// Offset of the frame size fields within a script function's entry in the function table.
+	static constexpr size_t frameSizeOffset = 20;
+	static constexpr size_t frameSizeLength = sizeof(uint16_t) * 3;
+
+	auto readUint32 = [&module](const size_t offset) -> uint32_t
+	{
+		uint32_t value = 0;
+		memcpy(&value, module.data() + offset, sizeof(value));
+		return value;
+	};
+
+	ASSERT_GT(module.size(), initBytecodeOffset + sizeof(uint32_t));
+	ASSERT_EQ(module[formatFlagsOffset], HQ_MODULE_FORMAT_FLAG_FRAME_SIZES);
+	ASSERT_EQ(readUint32(functionTableLength), 1u);
+
+	const size_t frameSizeStart = readUint32(functionTableOffset) + frameSizeOffset;
+	const size_t initBytecodeStart = readUint32(initBytecodeOffset);
+
+	// Remove the frame sizes from the function table, then pad the end of the table
+	// by the same amount so the offsets of every section after it remain valid.
+	module[formatFlagsOffset] = 0;
+	module.erase(module.begin() + frameSizeStart, module.begin() + frameSizeStart + frameSizeLength);
+	module.insert(module.begin() + (initBytecodeStart - frameSizeLength), frameSizeLength, 0);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static void _RunFrameSizeTest(const FrameSizeTestData& testData, const int endianness, const bool legacyLayout = false)
+{
+	auto compilerCallback = [&testData](HqModuleWriterHandle hModuleWriter, int endianness)
+	{
+		HqSerializerHandle hFuncSerializer = HQ_SERIALIZER_HANDLE_NULL;
+
+		ASSERT_EQ(HqModuleWriterSetBytecodeEncoding(hModuleWriter, testData.encoding), HQ_SUCCESS);
+
+		// Set the function serializer.
+		Util::SetupFunctionSerializer(hFuncSerializer, endianness);
+		ASSERT_EQ(HqBytecodeSetEncoding(hFuncSerializer, testData.encoding), HQ_SUCCESS);
+
+		// Everything inside the branch is skipped at runtime, so it only contributes to the frame size
+		// calculated by the module writer. A 'while' branch adds a backward jump, making the PUSH
+		// instructions inside it unbounded.
+		ControlFlow ctrl;
+		ctrl.Begin(
+			hFuncSerializer,
+			testData.loop ? ControlFlow::Behavior::While : ControlFlow::Behavior::If,
+			ControlFlow::Condition::None,
+			0
+		);
+
+		const size_t handlerOffset = HqSerializerGetStreamPosition(hFuncSerializer);
+
+		ASSERT_EQ(HqBytecodeEmitStoreVariable(hFuncSerializer, 4, 2), HQ_SUCCESS);
+
+		const size_t guardOffsetStart = HqSerializerGetStreamPosition(hFuncSerializer);
+
+		ASSERT_EQ(HqBytecodeEmitPush(hFuncSerializer, 5), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitPush(hFuncSerializer, 5), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitPush(hFuncSerializer, 5), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitRaise(hFuncSerializer, 5), HQ_SUCCESS);
+
+		const size_t guardOffsetEnd = HqSerializerGetStreamPosition(hFuncSerializer);
+
+		if(testData.invalidRegister)
+		{
+			ASSERT_EQ(HqBytecodeEmitLoadImmNull(hFuncSerializer, HQ_VM_GP_REGISTER_COUNT), HQ_SUCCESS);
+		}
+
+		ctrl.End();
+
+		// Write a YIELD instruction so we can examine the frame.
+		ASSERT_EQ(HqBytecodeEmitYield(hFuncSerializer), HQ_SUCCESS);
+
+		// Finalize the serializer and add it to the module.
+		Util::FinalizeFunctionSerializer(hFuncSerializer, hModuleWriter, Function::main);
+
+		if(testData.retryHandler)
+		{
+			// Guard the PUSH instructions with a handler placed before them. Raising from inside the
+			// guarded block re-enters the PUSH instructions without ever taking a backward jump.
+			uint32_t guardBlockId = 0;
+			ASSERT_EQ(
+				HqModuleWriterAddGuardedBlock(
+					hModuleWriter,
+					Function::main,
+					guardOffsetStart,
+					guardOffsetEnd - guardOffsetStart,
+					&guardBlockId
+				),
+				HQ_SUCCESS
+			);
+			ASSERT_EQ(
+				HqModuleWriterAddExceptionHandler(
+					hModuleWriter,
+					Function::main,
+					guardBlockId,
+					handlerOffset,
+					HQ_VALUE_TYPE_INT32,
+					nullptr
+				),
+				HQ_SUCCESS
+			);
+		}
+	};
+
+	auto runtimeCallback = [&testData](HqVmHandle hVm, HqExecutionHandle hExec)
+	{
+		(void) hVm;
+
+		// Run the execution context.
+		ASSERT_EQ(HqExecutionRun(hExec, HQ_RUN_FULL), HQ_SUCCESS);
+
+		// Get the status of the execution context.
+		ExecStatus status;
+		Util::GetExecutionStatus(status, hExec);
+		ASSERT_TRUE(status.yield);
+		ASSERT_TRUE(status.running);
+		ASSERT_FALSE(status.complete);
+		ASSERT_FALSE(status.exception);
+		ASSERT_FALSE(status.abort);
+
+		HqFrameHandle hFrame = HQ_FRAME_HANDLE_NULL;
+		Util::GetCurrentFrame(hFrame, hExec);
+
+		HqValueHandle hValue = HQ_VALUE_HANDLE_NULL;
+
+		// The last register of each type must be addressable and the one past it must not be.
+		ASSERT_EQ(HqFrameGetGpRegister(hFrame, &hValue, testData.expectedGpRegisterCount - 1), HQ_SUCCESS);
+		ASSERT_NE(HqFrameGetGpRegister(hFrame, &hValue, testData.expectedGpRegisterCount), HQ_SUCCESS);
+		ASSERT_EQ(HqFrameGetVrRegister(hFrame, &hValue, testData.expectedVrRegisterCount - 1), HQ_SUCCESS);
+		ASSERT_NE(HqFrameGetVrRegister(hFrame, &hValue, testData.expectedVrRegisterCount), HQ_SUCCESS);
+
+		// Fill the value stack to verify its capacity.
+		for(uint32_t i = 0; i < testData.expectedStackSize; ++i)
+		{
+			ASSERT_EQ(HqFramePushValue(hFrame, HQ_VALUE_HANDLE_NULL), HQ_SUCCESS);
+		}
+
+		ASSERT_EQ(HqFramePushValue(hFrame, HQ_VALUE_HANDLE_NULL), HQ_ERROR_STACK_FULL);
+
+		// Run the execution context to completion.
+		ASSERT_EQ(HqExecutionRun(hExec, HQ_RUN_FULL), HQ_SUCCESS);
+
+		Util::GetExecutionStatus(status, hExec);
+		ASSERT_FALSE(status.yield);
+		ASSERT_FALSE(status.running);
+		ASSERT_TRUE(status.complete);
+		ASSERT_FALSE(status.exception);
+		ASSERT_FALSE(status.abort);
+	};
+
+	std::vector<uint8_t> bytecode;
+
+	// Construct the module bytecode for the test.
+	Util::CompileBytecode(bytecode, compilerCallback, endianness);
+	ASSERT_GT(bytecode.size(), 0u);
+
+	if(legacyLayout)
+	{
+		_ConvertToLegacyLayout(bytecode);
+	}
+
+	// Run the module bytecode.
+	Util::ProcessBytecode("TestFrameSize", Function::main, runtimeCallback, bytecode);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static int _GetOppositeEndianness()
+{
+	return (HqGetPlatformEndianness() == HQ_ENDIAN_ORDER_LITTLE)
+		? HQ_ENDIAN_ORDER_BIG
+		: HQ_ENDIAN_ORDER_LITTLE;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static constexpr FrameSizeTestData _straightLineData[] =
+{
+	{ HQ_BYTECODE_ENCODING_STANDARD, false, false, false, 6, 5, 3 },
+	{ HQ_BYTECODE_ENCODING_COMPACT, false, false, false, 6, 5, 3 },
+};
+
+static constexpr FrameSizeTestData _loopData[] =
+{
+	{ HQ_BYTECODE_ENCODING_STANDARD, true, false, false, 6, 5, HQ_VM_VALUE_STACK_SIZE },
+	{ HQ_BYTECODE_ENCODING_COMPACT, true, false, false, 6, 5, HQ_VM_VALUE_STACK_SIZE },
+};
+
+static constexpr FrameSizeTestData _retryHandlerData[] =
+{
+	{ HQ_BYTECODE_ENCODING_STANDARD, false, true, false, 6, 5, HQ_VM_VALUE_STACK_SIZE },
+	{ HQ_BYTECODE_ENCODING_COMPACT, false, true, false, 6, 5, HQ_VM_VALUE_STACK_SIZE },
+};
+
+static constexpr FrameSizeTestData _legacyLayoutData[] =
+{
+	{ HQ_BYTECODE_ENCODING_STANDARD, false, false, false, HQ_VM_GP_REGISTER_COUNT, HQ_VM_VR_REGISTER_COUNT, HQ_VM_VALUE_STACK_SIZE },
+	{ HQ_BYTECODE_ENCODING_COMPACT, false, false, false, HQ_VM_GP_REGISTER_COUNT, HQ_VM_VR_REGISTER_COUNT, HQ_VM_VALUE_STACK_SIZE },
+};
+
+static constexpr FrameSizeTestData _invalidRegisterData =
+{
+	HQ_BYTECODE_ENCODING_STANDARD,
+	false,
+	false,
+	true,
+	HQ_VM_GP_REGISTER_COUNT,
+	HQ_VM_VR_REGISTER_COUNT,
+	HQ_VM_VALUE_STACK_SIZE,
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_F(_HQ_TEST_NAME(TestFrameSize), StraightLinePush)
+{
+	for(const FrameSizeTestData& testData : _straightLineData)
+	{
+		_RunFrameSizeTest(testData, HQ_ENDIAN_ORDER_NATIVE);
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_F(_HQ_TEST_NAME(TestFrameSize), LoopPush)
+{
+	for(const FrameSizeTestData& testData : _loopData)
+	{
+		_RunFrameSizeTest(testData, HQ_ENDIAN_ORDER_NATIVE);
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_F(_HQ_TEST_NAME(TestFrameSize), RetryHandlerPush)
+{
+	for(const FrameSizeTestData& testData : _retryHandlerData)
+	{
+		_RunFrameSizeTest(testData, HQ_ENDIAN_ORDER_NATIVE);
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_F(_HQ_TEST_NAME(TestFrameSize), StackOverflowRejected)
+{
+	Memory::Instance.SetContext("dev-context");
+
+	const HqDevContextInit init = GetDefaultHqDevContextInit(nullptr, DefaultMessageCallback, HQ_MESSAGE_TYPE_WARNING);
+
+	HqDevContextHandle hCtx = HQ_DEV_CONTEXT_HANDLE_NULL;
+	ASSERT_EQ(HqDevContextCreate(&hCtx, init), HQ_SUCCESS);
+
+	HqModuleWriterHandle hModuleWriter = HQ_MODULE_WRITER_HANDLE_NULL;
+	ASSERT_EQ(HqModuleWriterCreate(&hModuleWriter, hCtx), HQ_SUCCESS);
+
+	// Write a function that pushes one more value than the value stack can hold.
+	{
+		HqSerializerHandle hFuncSerializer = HQ_SERIALIZER_HANDLE_NULL;
+		Util::SetupFunctionSerializer(hFuncSerializer, HQ_ENDIAN_ORDER_NATIVE);
+
+		for(uint32_t i = 0; i <= HQ_VM_VALUE_STACK_SIZE; ++i)
+		{
+			ASSERT_EQ(HqBytecodeEmitPush(hFuncSerializer, 0), HQ_SUCCESS);
+		}
+
+		ASSERT_EQ(HqBytecodeEmitReturn(hFuncSerializer), HQ_SUCCESS);
+
+		Util::FinalizeFunctionSerializer(hFuncSerializer, hModuleWriter, Function::main);
+	}
+
+	HqSerializerHandle hFileSerializer = HQ_SERIALIZER_HANDLE_NULL;
+	ASSERT_EQ(HqSerializerCreate(&hFileSerializer, HQ_SERIALIZER_MODE_WRITER), HQ_SUCCESS);
+
+	// The module writer must refuse the function rather than give it a value stack that's too small.
+	ASSERT_NE(HqModuleWriterSerialize(hModuleWriter, hFileSerializer), HQ_SUCCESS);
+
+	ASSERT_EQ(HqSerializerDispose(&hFileSerializer), HQ_SUCCESS);
+	ASSERT_EQ(HqModuleWriterDispose(&hModuleWriter), HQ_SUCCESS);
+	ASSERT_EQ(HqDevContextDispose(&hCtx), HQ_SUCCESS);
+
+	// Verify all memory has been freed.
+	Memory::Instance.Validate();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_F(_HQ_TEST_NAME(TestFrameSize), CrossEndian)
+{
+	const int endianness = _GetOppositeEndianness();
+
+	for(const FrameSizeTestData& testData : _straightLineData)
+	{
+		_RunFrameSizeTest(testData, endianness);
+	}
+
+	for(const FrameSizeTestData& testData : _loopData)
+	{
+		_RunFrameSizeTest(testData, endianness);
+	}
+
+	for(const FrameSizeTestData& testData : _retryHandlerData)
+	{
+		_RunFrameSizeTest(testData, endianness);
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_F(_HQ_TEST_NAME(TestFrameSize), InvalidRegisterFallback)
+{
+	// A register index the VM can't provide prevents an exact frame size from being
+	// calculated, so the function is given the largest possible frame instead.
+	_RunFrameSizeTest(_invalidRegisterData, HQ_ENDIAN_ORDER_NATIVE);
+	_RunFrameSizeTest(_invalidRegisterData, _GetOppositeEndianness());
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_F(_HQ_TEST_NAME(TestFrameSize), LegacyModuleLayout)
+{
+	// Modules written before frame sizes were recorded in the function table
+	// must still load, giving each of their functions the largest possible frame.
+	for(const FrameSizeTestData& testData : _legacyLayoutData)
+	{
+		_RunFrameSizeTest(testData, HQ_ENDIAN_ORDER_NATIVE, true);
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_F(_HQ_TEST_NAME(TestFrameSize), ReusedFrameHasNoStaleValues)
+{
+	static constexpr const char* const dirtyName = "void dirty()";
+	static constexpr const char* const cleanName = "void clean()";
+
+	auto compilerCallback = [](HqModuleWriterHandle hModuleWriter, int endianness)
+	{
+		HqSerializerHandle hFuncSerializer = HQ_SERIALIZER_HANDLE_NULL;
+
+		uint32_t dirtyIndex = 0;
+		uint32_t cleanIndex = 0;
+		ASSERT_EQ(HqModuleWriterAddString(hModuleWriter, dirtyName, &dirtyIndex), HQ_SUCCESS);
+		ASSERT_EQ(HqModuleWriterAddString(hModuleWriter, cleanName, &cleanIndex), HQ_SUCCESS);
+
+		// Main function
+		{
+			// Set the function serializer.
+			Util::SetupFunctionSerializer(hFuncSerializer, endianness);
+
+			// Yield once before anything is allocated so the host can take a baseline, then call both functions
+			// from the same frame so the second one is given the memory the first one just gave back.
+			ASSERT_EQ(HqBytecodeEmitYield(hFuncSerializer), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitCall(hFuncSerializer, dirtyIndex), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitCall(hFuncSerializer, cleanIndex), HQ_SUCCESS);
+
+			// Finalize the serializer and add it to the module.
+			Util::FinalizeFunctionSerializer(hFuncSerializer, hModuleWriter, Function::main);
+		}
+
+		// Leave an array behind in a register, a variable, and the value stack.
+		{
+			// Set the function serializer.
+			Util::SetupFunctionSerializer(hFuncSerializer, endianness);
+
+			ASSERT_EQ(HqBytecodeEmitInitArray(hFuncSerializer, 3, 4), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitStoreVariable(hFuncSerializer, 2, 3), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitPush(hFuncSerializer, 3), HQ_SUCCESS);
+
+			// Finalize the serializer and add it to the module.
+			Util::FinalizeFunctionSerializer(hFuncSerializer, hModuleWriter, dirtyName);
+		}
+
+		// Reference the same slots without ever writing them, then yield so the frame can be examined.
+		{
+			// Set the function serializer.
+			Util::SetupFunctionSerializer(hFuncSerializer, endianness);
+
+			ControlFlow ctrl;
+			ctrl.Begin(hFuncSerializer, ControlFlow::Behavior::If, ControlFlow::Condition::None, 0);
+
+			ASSERT_EQ(HqBytecodeEmitStoreVariable(hFuncSerializer, 2, 3), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitPush(hFuncSerializer, 3), HQ_SUCCESS);
+
+			ctrl.End();
+
+			ASSERT_EQ(HqBytecodeEmitYield(hFuncSerializer), HQ_SUCCESS);
+
+			// Finalize the serializer and add it to the module.
+			Util::FinalizeFunctionSerializer(hFuncSerializer, hModuleWriter, cleanName);
+		}
+	};
+
+	auto runtimeCallback = [](HqVmHandle hVm, HqExecutionHandle hExec)
+	{
+		// Run to the yield at the start of the main function.
+		ASSERT_EQ(HqExecutionRun(hExec, HQ_RUN_FULL), HQ_SUCCESS);
+
+		ExecStatus status;
+		Util::GetExecutionStatus(status, hExec);
+		ASSERT_TRUE(status.yield);
+
+		HqGcStats baseStats;
+		ASSERT_EQ(HqVmRunGarbageCollector(hVm, HQ_RUN_FULL), HQ_SUCCESS);
+		ASSERT_EQ(HqVmGetGcStats(hVm, &baseStats), HQ_SUCCESS);
+
+		// Run to the yield in the second function.
+		ASSERT_EQ(HqExecutionRun(hExec, HQ_RUN_FULL), HQ_SUCCESS);
+
+		Util::GetExecutionStatus(status, hExec);
+		ASSERT_TRUE(status.yield);
+		ASSERT_FALSE(status.exception);
+
+		// Nothing references the array anymore, so the collector must not find it through the reused frame.
+		HqGcStats stats;
+		ASSERT_EQ(HqVmRunGarbageCollector(hVm, HQ_RUN_FULL), HQ_SUCCESS);
+		ASSERT_EQ(HqVmGetGcStats(hVm, &stats), HQ_SUCCESS);
+		EXPECT_EQ(stats.heapObjectCount, baseStats.heapObjectCount);
+
+		HqFrameHandle hFrame = HQ_FRAME_HANDLE_NULL;
+		Util::GetCurrentFrame(hFrame, hExec);
+
+		HqValueHandle hValue = HQ_VALUE_HANDLE_NULL;
+
+		// None of the old values are visible through the new frame either.
+		ASSERT_EQ(HqFrameGetGpRegister(hFrame, &hValue, 3), HQ_SUCCESS);
+		EXPECT_EQ(hValue, HQ_VALUE_HANDLE_NULL);
+		ASSERT_EQ(HqFrameGetVrRegister(hFrame, &hValue, 2), HQ_SUCCESS);
+		EXPECT_EQ(hValue, HQ_VALUE_HANDLE_NULL);
+
+		// Peeking an empty value stack gives back a null value.
+		hValue = HQ_VALUE_HANDLE_NULL;
+		ASSERT_EQ(HqFramePeekValue(hFrame, &hValue, 0), HQ_SUCCESS);
+		EXPECT_EQ(hValue, HQ_VALUE_HANDLE_NULL);
+
+		// Run the execution context to completion.
+		ASSERT_EQ(HqExecutionRun(hExec, HQ_RUN_FULL), HQ_SUCCESS);
+
+		Util::GetExecutionStatus(status, hExec);
+		ASSERT_TRUE(status.complete);
+		ASSERT_FALSE(status.exception);
+	};
+
+	std::vector<uint8_t> bytecode;
+
+	// Construct the module bytecode for the test.
+	Util::CompileBytecode(bytecode, compilerCallback);
+	ASSERT_GT(bytecode.size(), 0u);
+
+	// Run the module bytecode.
+	Util::ProcessBytecode("TestFrameSize", Function::main, runtimeCallback, bytecode);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
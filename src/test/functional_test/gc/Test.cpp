@@ -0,0 +1,677 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include "../FuncTestUtil.hpp"
+#include "../Memory.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+namespace Function
+{
+	static constexpr const char* const main = "void main()";
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+class _HQ_TEST_NAME(TestGc)
+	: public ::testing::Test
+{
+public:
+
+	virtual void TearDown() override
+	{
+		// Force the memory handler to reset after each test.
+		Memory::Instance.Reset();
+	}
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static void _CreateScript(
+	HqVmHandle& outVm,
+	HqExecutionHandle& outExec,
+	const HqVmInit& init,
+	const std::vector<uint8_t>& bytecode)
+{
+	// Set the memory context so we have a better idea of where to look when memory validation failures occur.
+	Memory::Instance.SetContext("runtime");
+
+	// These tests need control over how the VM is created, so the module is loaded by hand
+	// rather than going through Util::ProcessBytecode().
+	HqVmHandle hVm = HQ_VM_HANDLE_NULL;
+	ASSERT_EQ(HqVmCreate(&hVm, init), HQ_SUCCESS);
+	ASSERT_EQ(HqVmLoadModule(hVm, "TestGc", bytecode.data(), bytecode.size()), HQ_SUCCESS);
+
+	HqExecutionHandle hExec = HQ_EXECUTION_HANDLE_NULL;
+	ASSERT_EQ(HqVmInitializeModules(hVm, &hExec), HQ_SUCCESS);
+
+	HqFunctionHandle hFunction = HQ_FUNCTION_HANDLE_NULL;
+	ASSERT_EQ(HqVmGetFunction(hVm, &hFunction, Function::main), HQ_SUCCESS);
+
+	hExec = HQ_EXECUTION_HANDLE_NULL;
+	ASSERT_EQ(HqExecutionCreate(&hExec, hVm), HQ_SUCCESS);
+	ASSERT_EQ(HqExecutionInitialize(hExec, hFunction), HQ_SUCCESS);
+
+	outVm = hVm;
+	outExec = hExec;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static void _DisposeScript(HqVmHandle& hVm, HqExecutionHandle& hExec)
+{
+	ASSERT_EQ(HqExecutionDispose(&hExec), HQ_SUCCESS);
+	ASSERT_EQ(HqVmDispose(&hVm), HQ_SUCCESS);
+
+	// Verify all memory has been freed.
+	Memory::Instance.Validate();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_F(_HQ_TEST_NAME(TestGc), Safepoint_ParksRunningScript)
+{
+	static constexpr const char* const stopName = "stop";
+
+	auto compilerCallback = [](HqModuleWriterHandle hModuleWriter, int endianness)
+	{
+		HqSerializerHandle hFuncSerializer = HQ_SERIALIZER_HANDLE_NULL;
+
+		uint32_t stringIndex = 0;
+		ASSERT_EQ(HqModuleWriterAddString(hModuleWriter, stopName, &stringIndex), HQ_SUCCESS);
+		ASSERT_EQ(HqModuleWriterAddGlobal(hModuleWriter, stopName), HQ_SUCCESS);
+
+		// Set the function serializer.
+		Util::SetupFunctionSerializer(hFuncSerializer, endianness);
+
+		// Spin until the host sets the global variable. The backward jump is the only safepoint in the loop.
+		const size_t loopStart = HqSerializerGetStreamPosition(hFuncSerializer);
+
+		ASSERT_EQ(HqBytecodeEmitLoadGlobal(hFuncSerializer, 0, stringIndex), HQ_SUCCESS);
+
+		const size_t loopEnd = HqSerializerGetStreamPosition(hFuncSerializer);
+
+		ASSERT_EQ(HqBytecodeEmitJumpIfFalse(hFuncSerializer, 0, int32_t(loopStart) - int32_t(loopEnd)), HQ_SUCCESS);
+
+		// Finalize the serializer and add it to the module.
+		Util::FinalizeFunctionSerializer(hFuncSerializer, hModuleWriter, Function::main);
+	};
+
+	std::vector<uint8_t> bytecode;
+
+	// Construct the module bytecode for the test.
+	Util::CompileBytecode(bytecode, compilerCallback);
+	ASSERT_GT(bytecode.size(), 0u);
+
+	// Scripts only hold the GC lock, and so only need to stop at safepoints, when the GC thread is enabled.
+	HqVmInit init = GetDefaultHqVmInit(nullptr, nullptr, HQ_MESSAGE_TYPE_FATAL);
+	init.gcEnableThread = true;
+
+	HqVmHandle hVm = HQ_VM_HANDLE_NULL;
+	HqExecutionHandle hExec = HQ_EXECUTION_HANDLE_NULL;
+	_CreateScript(hVm, hExec, init, bytecode);
+
+	HqValueHandle hStop = HqValueCreateBool(hVm, false);
+	ASSERT_EQ(HqVmSetGlobalVariable(hVm, hStop, stopName), HQ_SUCCESS);
+	ASSERT_EQ(HqValueGcExpose(hStop), HQ_SUCCESS);
+
+	HqGcStats baseStats;
+	ASSERT_EQ(HqVmGetGcStats(hVm, &baseStats), HQ_SUCCESS);
+
+	std::atomic<bool> finished(false);
+	int runResult = HQ_SUCCESS;
+
+	std::thread worker(
+		[hExec, &finished, &runResult]()
+		{
+			runResult = HqExecutionRun(hExec, HQ_RUN_FULL);
+			finished = true;
+		}
+	);
+
+	// The script holds the GC lock for as long as it's running, so every full collection started while it's
+	// spinning can only get through once the script parks at its backward jump. Keep collecting until the
+	// script has been seen parking; a collection that started before the script did won't count.
+	HqGcStats stats = baseStats;
+	for(int i = 0; i < 1000 && stats.scriptParkTime == baseStats.scriptParkTime; ++i)
+	{
+		ASSERT_EQ(HqVmRunGarbageCollector(hVm, HQ_RUN_FULL), HQ_SUCCESS);
+		ASSERT_EQ(HqVmGetGcStats(hVm, &stats), HQ_SUCCESS);
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	// The collections finished while the script was still stuck in its loop.
+	EXPECT_GT(stats.scriptParkTime, baseStats.scriptParkTime);
+	EXPECT_GT(stats.cycleCount, baseStats.cycleCount);
+	EXPECT_FALSE(finished);
+
+	// Let the script run to completion.
+	hStop = HqValueCreateBool(hVm, true);
+	ASSERT_EQ(HqVmSetGlobalVariable(hVm, hStop, stopName), HQ_SUCCESS);
+	ASSERT_EQ(HqValueGcExpose(hStop), HQ_SUCCESS);
+
+	worker.join();
+
+	ASSERT_EQ(runResult, HQ_SUCCESS);
+
+	ExecStatus status;
+	Util::GetExecutionStatus(status, hExec);
+	EXPECT_TRUE(status.complete);
+	EXPECT_FALSE(status.exception);
+
+	_DisposeScript(hVm, hExec);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+TEST_F(_HQ_TEST_NAME(TestGc), Nursery_SplicedAtYield)
+{
+	static constexpr uint32_t valueCount = 8;
+
+	auto compilerCallback = [](HqModuleWriterHandle hModuleWriter, int endianness)
+	{
+		HqSerializerHandle hFuncSerializer = HQ_SERIALIZER_HANDLE_NULL;
+
+		// Set the function serializer.
+		Util::SetupFunctionSerializer(hFuncSerializer, endianness);
+
+		// Each array is a new object, which goes into the execution's nursery.
+		for(uint32_t i = 0; i < valueCount; ++i)
+		{
+			ASSERT_EQ(HqBytecodeEmitInitArray(hFuncSerializer, i, i + 1), HQ_SUCCESS);
+		}
+
+		ASSERT_EQ(HqBytecodeEmitYield(hFuncSerializer), HQ_SUCCESS);
+
+		// Finalize the serializer and add it to the module.
+		Util::FinalizeFunctionSerializer(hFuncSerializer, hModuleWriter, Function::main);
+	};
+
+	std::vector<uint8_t> bytecode;
+
+	// Construct the module bytecode for the test.
+	Util::CompileBytecode(bytecode, compilerCallback);
+	ASSERT_GT(bytecode.size(), 0u);
+
+	const HqVmInit init = GetDefaultHqVmInit(nullptr, nullptr, HQ_MESSAGE_TYPE_FATAL);
+
+	HqVmHandle hVm = HQ_VM_HANDLE_NULL;
+	HqExecutionHandle hExec = HQ_EXECUTION_HANDLE_NULL;
+	_CreateScript(hVm, hExec, init, bytecode);
+
+	HqGcStats baseStats;
+	ASSERT_EQ(HqVmGetGcStats(hVm, &baseStats), HQ_SUCCESS);
+
+	ASSERT_EQ(HqExecutionRun(hExec, HQ_RUN_FULL), HQ_SUCCESS);
+
+	ExecStatus status;
+	Util::GetExecutionStatus(status, hExec);
+	ASSERT_TRUE(status.yield);
+
+	// Yielding hands the whole nursery to the collector, so everything the script created is pending now.
+	HqGcStats stats;
+	ASSERT_EQ(HqVmGetGcStats(hVm, &stats), HQ_SUCCESS);
+	EXPECT_GE(stats.linkedObjectCount, baseStats.linkedObjectCount + valueCount);
+	EXPECT_GE(stats.pendingObjectCount, baseStats.pendingObjectCount + valueCount);
+
+	// A full collection has to find every one of them through the script's registers.
+	ASSERT_EQ(HqVmRunGarbageCollector(hVm, HQ_RUN_FULL), HQ_SUCCESS);
+	ASSERT_EQ(HqVmGetGcStats(hVm, &stats), HQ_SUCCESS);
+	EXPECT_EQ(stats.pendingObjectCount, 0u);
+
+	for(uint32_t i = 0; i < valueCount; ++i)
+	{
+		HqValueHandle hValue = HQ_VALUE_HANDLE_NULL;
+		Util::GetGpRegister(hValue, hExec, i);
+		ASSERT_TRUE(HqValueIsArray(hValue));
+		EXPECT_EQ(HqValueGetArrayLength(hValue), size_t(i + 1));
+	}
+
+	ASSERT_EQ(HqExecutionRun(hExec, HQ_RUN_FULL), HQ_SUCCESS);
+	Util::GetExecutionStatus(status, hExec);
+	EXPECT_TRUE(status.complete);
+
+	_DisposeScript(hVm, hExec);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_F(_HQ_TEST_NAME(TestGc), Nursery_SplicedAtNativeCall)
+{
+	static constexpr const char* const nativeName = "void testGcNative()";
+	static constexpr uint32_t valueCount = 8;
+
+	auto compilerCallback = [](HqModuleWriterHandle hModuleWriter, int endianness)
+	{
+		HqSerializerHandle hFuncSerializer = HQ_SERIALIZER_HANDLE_NULL;
+
+		uint32_t stringIndex = 0;
+		ASSERT_EQ(HqModuleWriterAddString(hModuleWriter, nativeName, &stringIndex), HQ_SUCCESS);
+		ASSERT_EQ(HqModuleWriterAddNativeFunction(hModuleWriter, nativeName, 0, 0), HQ_SUCCESS);
+
+		// Set the function serializer.
+		Util::SetupFunctionSerializer(hFuncSerializer, endianness);
+
+		// Each array is a new object, which goes into the execution's nursery.
+		for(uint32_t i = 0; i < valueCount; ++i)
+		{
+			ASSERT_EQ(HqBytecodeEmitInitArray(hFuncSerializer, i, i + 1), HQ_SUCCESS);
+		}
+
+		ASSERT_EQ(HqBytecodeEmitCall(hFuncSerializer, stringIndex), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitYield(hFuncSerializer), HQ_SUCCESS);
+
+		// Finalize the serializer and add it to the module.
+		Util::FinalizeFunctionSerializer(hFuncSerializer, hModuleWriter, Function::main);
+	};
+
+	struct NativeCallData
+	{
+		HqGcStats baseStats;
+		HqGcStats stats;
+
+		bool called;
+	};
+
+	// The native function sees the collector's state from inside the script's run, then collects everything itself.
+	auto nativeFn = [](HqExecutionHandle hExec, HqFunctionHandle hFunction, void* const pUserData)
+	{
+		(void) hFunction;
+
+		NativeCallData& data = *reinterpret_cast<NativeCallData*>(pUserData);
+
+		HqVmHandle hVm = HQ_VM_HANDLE_NULL;
+		HqExecutionGetVm(hExec, &hVm);
+
+		HqVmGetGcStats(hVm, &data.stats);
+		HqVmRunGarbageCollector(hVm, HQ_RUN_FULL);
+
+		data.called = true;
+	};
+
+	std::vector<uint8_t> bytecode;
+
+	// Construct the module bytecode for the test.
+	Util::CompileBytecode(bytecode, compilerCallback);
+	ASSERT_GT(bytecode.size(), 0u);
+
+	const HqVmInit init = GetDefaultHqVmInit(nullptr, nullptr, HQ_MESSAGE_TYPE_FATAL);
+
+	HqVmHandle hVm = HQ_VM_HANDLE_NULL;
+	HqExecutionHandle hExec = HQ_EXECUTION_HANDLE_NULL;
+	_CreateScript(hVm, hExec, init, bytecode);
+
+	NativeCallData data = {};
+
+	HqFunctionHandle hNativeFunction = HQ_FUNCTION_HANDLE_NULL;
+	ASSERT_EQ(HqVmGetFunction(hVm, &hNativeFunction, nativeName), HQ_SUCCESS);
+	ASSERT_EQ(HqFunctionSetNativeBinding(hNativeFunction, nativeFn, &data), HQ_SUCCESS);
+
+	ASSERT_EQ(HqVmGetGcStats(hVm, &data.baseStats), HQ_SUCCESS);
+	ASSERT_EQ(HqExecutionRun(hExec, HQ_RUN_FULL), HQ_SUCCESS);
+
+	ExecStatus status;
+	Util::GetExecutionStatus(status, hExec);
+	ASSERT_TRUE(status.yield);
+	ASSERT_FALSE(status.exception);
+	ASSERT_TRUE(data.called);
+
+	// Calling the native function handed the nursery to the collector before the native function ran.
+	EXPECT_GE(data.stats.linkedObjectCount, data.baseStats.linkedObjectCount + valueCount);
+	EXPECT_GE(data.stats.pendingObjectCount, data.baseStats.pendingObjectCount + valueCount);
+
+	// The collection run by the native function must have kept everything the script is still using.
+	for(uint32_t i = 0; i < valueCount; ++i)
+	{
+		HqValueHandle hValue = HQ_VALUE_HANDLE_NULL;
+		Util::GetGpRegister(hValue, hExec, i);
+		ASSERT_TRUE(HqValueIsArray(hValue));
+		EXPECT_EQ(HqValueGetArrayLength(hValue), size_t(i + 1));
+	}
+
+	_DisposeScript(hVm, hExec);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_F(_HQ_TEST_NAME(TestGc), ConcurrentMark_KeepsMutatedContainers)
+{
+	static constexpr const char* const stopName = "stop";
+	static constexpr const char* const rootNames[] = { "root0", "root1" };
+	static constexpr uint32_t slotCount = 2048;
+	static constexpr uint32_t majorCycleCount = 16;
+
+	auto compilerCallback = [](HqModuleWriterHandle hModuleWriter, int endianness)
+	{
+		HqSerializerHandle hFuncSerializer = HQ_SERIALIZER_HANDLE_NULL;
+
+		uint32_t stringIndex = 0;
+		ASSERT_EQ(HqModuleWriterAddString(hModuleWriter, stopName, &stringIndex), HQ_SUCCESS);
+		ASSERT_EQ(HqModuleWriterAddGlobal(hModuleWriter, stopName), HQ_SUCCESS);
+
+		uint32_t rootStringIndices[2] = {};
+		for(uint32_t i = 0; i < 2; ++i)
+		{
+			ASSERT_EQ(HqModuleWriterAddString(hModuleWriter, rootNames[i], &rootStringIndices[i]), HQ_SUCCESS);
+			ASSERT_EQ(HqModuleWriterAddGlobal(hModuleWriter, rootNames[i]), HQ_SUCCESS);
+		}
+
+		// Set the function serializer.
+		Util::SetupFunctionSerializer(hFuncSerializer, endianness);
+
+		// Both roots are also held by global variables. Frames are only scanned once scripts have been stopped,
+		// so this is what lets the collector trace them while the script is still running.
+		ASSERT_EQ(HqBytecodeEmitInitArray(hFuncSerializer, 0, slotCount), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitInitArray(hFuncSerializer, 1, slotCount), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitStoreGlobal(hFuncSerializer, rootStringIndices[0], 0), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitStoreGlobal(hFuncSerializer, rootStringIndices[1], 1), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 2, 0), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 3, 1), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 4, int32_t(slotCount * 2)), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 5, int32_t(slotCount)), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 9, 0), HQ_SUCCESS);
+
+		const size_t loopStart = HqSerializerGetStreamPosition(hFuncSerializer);
+
+		// Build a new array holding another new array and the iteration it was created on.
+		ASSERT_EQ(HqBytecodeEmitMod(hFuncSerializer, 6, 2, 5), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitInitArray(hFuncSerializer, 7, 2), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitInitArray(hFuncSerializer, 8, 2), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitStoreArray(hFuncSerializer, 7, 8, 9), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitStoreArray(hFuncSerializer, 7, 2, 3), HQ_SUCCESS);
+
+		// Move the array currently in the first root over to the second root, then replace it with the new one.
+		// Whatever the collector has already scanned, each array must stay reachable through one of the roots.
+		// The array being moved has been sitting in the first root long enough to be older than the cycle.
+		ASSERT_EQ(HqBytecodeEmitLoadArray(hFuncSerializer, 10, 0, 6), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitStoreArray(hFuncSerializer, 1, 10, 6), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitStoreArray(hFuncSerializer, 0, 7, 6), HQ_SUCCESS);
+
+		// Drop every other reference so the containers are all that's left holding the arrays.
+		ASSERT_EQ(HqBytecodeEmitLoadImmNull(hFuncSerializer, 7), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitLoadImmNull(hFuncSerializer, 8), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitLoadImmNull(hFuncSerializer, 10), HQ_SUCCESS);
+
+		// Keep going until both roots have been filled and the host has set the global variable.
+		ASSERT_EQ(HqBytecodeEmitAdd(hFuncSerializer, 2, 2, 3), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitCompareLess(hFuncSerializer, 11, 2, 4), HQ_SUCCESS);
+
+		const size_t fillLoopEnd = HqSerializerGetStreamPosition(hFuncSerializer);
+
+		ASSERT_EQ(HqBytecodeEmitJumpIfTrue(hFuncSerializer, 11, int32_t(loopStart) - int32_t(fillLoopEnd)), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitLoadGlobal(hFuncSerializer, 11, stringIndex), HQ_SUCCESS);
+
+		const size_t loopEnd = HqSerializerGetStreamPosition(hFuncSerializer);
+
+		ASSERT_EQ(HqBytecodeEmitJumpIfFalse(hFuncSerializer, 11, int32_t(loopStart) - int32_t(loopEnd)), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitYield(hFuncSerializer), HQ_SUCCESS);
+
+		// Finalize the serializer and add it to the module.
+		Util::FinalizeFunctionSerializer(hFuncSerializer, hModuleWriter, Function::main);
+	};
+
+	// Returns the iteration each array in a root was created on. If an array had been disposed, its memory would
+	// have been handed to a newer value by now, so it wouldn't have the contents or iteration expected for its slot.
+	auto validateRoot = [](std::vector<int32_t>& outIterations, HqExecutionHandle hExec, const uint32_t gpRegIndex)
+	{
+		HqValueHandle hRoot = HQ_VALUE_HANDLE_NULL;
+		Util::GetGpRegister(hRoot, hExec, gpRegIndex);
+		ASSERT_TRUE(HqValueIsArray(hRoot));
+		ASSERT_EQ(HqValueGetArrayLength(hRoot), size_t(slotCount));
+
+		outIterations.resize(slotCount);
+
+		for(uint32_t i = 0; i < slotCount; ++i)
+		{
+			HqValueHandle hOuter = HqValueGetArrayElement(hRoot, i);
+			ASSERT_TRUE(HqValueIsArray(hOuter));
+			ASSERT_EQ(HqValueGetArrayLength(hOuter), 2u);
+
+			HqValueHandle hInner = HqValueGetArrayElement(hOuter, 0);
+			ASSERT_TRUE(HqValueIsArray(hInner));
+			ASSERT_EQ(HqValueGetArrayLength(hInner), 2u);
+
+			HqValueHandle hIteration = HqValueGetArrayElement(hOuter, 1);
+			ASSERT_TRUE(HqValueIsInt32(hIteration));
+			ASSERT_EQ(uint32_t(HqValueGetInt32(hIteration)) % slotCount, i);
+
+			outIterations[i] = HqValueGetInt32(hIteration);
+		}
+	};
+
+	std::vector<uint8_t> bytecode;
+
+	// Construct the module bytecode for the test.
+	Util::CompileBytecode(bytecode, compilerCallback);
+	ASSERT_GT(bytecode.size(), 0u);
+
+	// Discovery runs on the GC thread alone and with the mark workers.
+	for(const uint32_t markThreadCount : { 0u, 2u })
+	{
+		// Keep the GC thread collecting back to back so major cycles keep marking while the script is running.
+		HqVmInit init = GetDefaultHqVmInit(nullptr, nullptr, HQ_MESSAGE_TYPE_FATAL);
+		init.gcEnableThread = true;
+		init.gcTimeWaitMs = 0;
+		init.gcHeapGrowthPercent = 0;
+		init.gcMarkThreadCount = markThreadCount;
+
+		HqVmHandle hVm = HQ_VM_HANDLE_NULL;
+		HqExecutionHandle hExec = HQ_EXECUTION_HANDLE_NULL;
+		_CreateScript(hVm, hExec, init, bytecode);
+
+		HqValueHandle hStop = HqValueCreateBool(hVm, false);
+		ASSERT_EQ(HqVmSetGlobalVariable(hVm, hStop, stopName), HQ_SUCCESS);
+		ASSERT_EQ(HqValueGcExpose(hStop), HQ_SUCCESS);
+
+		HqGcStats baseStats;
+		ASSERT_EQ(HqVmGetGcStats(hVm, &baseStats), HQ_SUCCESS);
+
+		int runResult = HQ_SUCCESS;
+
+		std::thread worker(
+			[hExec, &runResult]()
+			{
+				runResult = HqExecutionRun(hExec, HQ_RUN_FULL);
+			}
+		);
+
+		// Let the script keep allocating and moving arrays around until several major cycles have run alongside it.
+		HqGcStats stats = baseStats;
+		for(int i = 0; i < 10000 && stats.majorCycleCount < baseStats.majorCycleCount + majorCycleCount; ++i)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			ASSERT_EQ(HqVmGetGcStats(hVm, &stats), HQ_SUCCESS);
+		}
+
+		hStop = HqValueCreateBool(hVm, true);
+		ASSERT_EQ(HqVmSetGlobalVariable(hVm, hStop, stopName), HQ_SUCCESS);
+		ASSERT_EQ(HqValueGcExpose(hStop), HQ_SUCCESS);
+
+		worker.join();
+
+		ASSERT_EQ(runResult, HQ_SUCCESS);
+		EXPECT_GE(stats.majorCycleCount, baseStats.majorCycleCount + majorCycleCount);
+
+		ExecStatus status;
+		Util::GetExecutionStatus(status, hExec);
+		ASSERT_TRUE(status.yield);
+		ASSERT_FALSE(status.exception);
+
+		ASSERT_EQ(HqVmGetGcStats(hVm, &stats), HQ_SUCCESS);
+		EXPECT_GT(stats.disposedObjectCount, baseStats.disposedObjectCount);
+
+		// Nothing either root can still reach may have been disposed. Each slot in the second root holds the array
+		// that was in the same slot of the first root before it was replaced.
+		std::vector<int32_t> newIterations;
+		std::vector<int32_t> oldIterations;
+		validateRoot(newIterations, hExec, 0);
+		validateRoot(oldIterations, hExec, 1);
+
+		for(uint32_t i = 0; i < slotCount; ++i)
+		{
+			EXPECT_EQ(oldIterations[i] + int32_t(slotCount), newIterations[i]);
+		}
+
+		ASSERT_EQ(HqExecutionRun(hExec, HQ_RUN_FULL), HQ_SUCCESS);
+		Util::GetExecutionStatus(status, hExec);
+		EXPECT_TRUE(status.complete);
+
+		_DisposeScript(hVm, hExec);
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_F(_HQ_TEST_NAME(TestGc), SlabCache_ExecutionsOnSeparateThreads)
+{
+	static constexpr int32_t iterationCount = 100000;
+
+	auto compilerCallback = [](HqModuleWriterHandle hModuleWriter, int endianness)
+	{
+		HqSerializerHandle hFuncSerializer = HQ_SERIALIZER_HANDLE_NULL;
+
+		// Set the function serializer.
+		Util::SetupFunctionSerializer(hFuncSerializer, endianness);
+
+		ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 0, 0), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 1, 1), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 2, iterationCount), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 6, 0), HQ_SUCCESS);
+
+		const size_t loopStart = HqSerializerGetStreamPosition(hFuncSerializer);
+
+		// Every iteration throws away the arrays from the last one, so the collector keeps freeing blocks
+		// back to the slabs while both scripts are allocating from them.
+		ASSERT_EQ(HqBytecodeEmitInitArray(hFuncSerializer, 3, 4), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitInitArray(hFuncSerializer, 4, 1), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitStoreArray(hFuncSerializer, 3, 4, 6), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitStoreArray(hFuncSerializer, 4, 0, 6), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitAdd(hFuncSerializer, 0, 0, 1), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitCompareLess(hFuncSerializer, 5, 0, 2), HQ_SUCCESS);
+
+		const size_t loopEnd = HqSerializerGetStreamPosition(hFuncSerializer);
+
+		ASSERT_EQ(HqBytecodeEmitJumpIfTrue(hFuncSerializer, 5, int32_t(loopStart) - int32_t(loopEnd)), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitYield(hFuncSerializer), HQ_SUCCESS);
+
+		// Finalize the serializer and add it to the module.
+		Util::FinalizeFunctionSerializer(hFuncSerializer, hModuleWriter, Function::main);
+	};
+
+	auto getSlabTotals = [](size_t& outSlabCount, size_t& outBlocksInUse)
+	{
+		outSlabCount = 0;
+		outBlocksInUse = 0;
+
+		for(size_t i = 0; i < HqMemGetSlabSizeClassCount(); ++i)
+		{
+			HqMemSlabStats stats;
+			ASSERT_EQ(HqMemGetSlabStats(i, &stats), HQ_SUCCESS);
+
+			outSlabCount += stats.slabCount;
+			outBlocksInUse += stats.blocksInUse;
+		}
+	};
+
+	std::vector<uint8_t> bytecode;
+
+	// Construct the module bytecode for the test.
+	Util::CompileBytecode(bytecode, compilerCallback);
+	ASSERT_GT(bytecode.size(), 0u);
+
+	HqVmInit init = GetDefaultHqVmInit(nullptr, nullptr, HQ_MESSAGE_TYPE_FATAL);
+	init.gcEnableThread = true;
+	init.gcTimeWaitMs = 0;
+	init.useSlabAllocator = true;
+
+	HqVmHandle hVm = HQ_VM_HANDLE_NULL;
+	HqExecutionHandle hExecs[2] = { HQ_EXECUTION_HANDLE_NULL, HQ_EXECUTION_HANDLE_NULL };
+	_CreateScript(hVm, hExecs[0], init, bytecode);
+
+	HqFunctionHandle hFunction = HQ_FUNCTION_HANDLE_NULL;
+	ASSERT_EQ(HqVmGetFunction(hVm, &hFunction, Function::main), HQ_SUCCESS);
+	ASSERT_EQ(HqExecutionCreate(&hExecs[1], hVm), HQ_SUCCESS);
+	ASSERT_EQ(HqExecutionInitialize(hExecs[1], hFunction), HQ_SUCCESS);
+
+	// Each execution allocates from its own slab cache on its own thread.
+	int runResults[2] = { HQ_SUCCESS, HQ_SUCCESS };
+	std::thread workers[2];
+
+	for(size_t i = 0; i < 2; ++i)
+	{
+		HqExecutionHandle hExec = hExecs[i];
+		int* const pRunResult = &runResults[i];
+
+		workers[i] = std::thread(
+			[hExec, pRunResult]()
+			{
+				*pRunResult = HqExecutionRun(hExec, HQ_RUN_FULL);
+			}
+		);
+	}
+
+	for(size_t i = 0; i < 2; ++i)
+	{
+		workers[i].join();
+
+		ASSERT_EQ(runResults[i], HQ_SUCCESS);
+
+		ExecStatus status;
+		Util::GetExecutionStatus(status, hExecs[i]);
+		ASSERT_TRUE(status.yield);
+		ASSERT_FALSE(status.exception);
+
+		HqValueHandle hCount = HQ_VALUE_HANDLE_NULL;
+		Util::GetGpRegister(hCount, hExecs[i], 0);
+		ASSERT_TRUE(HqValueIsInt32(hCount));
+		EXPECT_EQ(HqValueGetInt32(hCount), iterationCount);
+
+		// The arrays from the last iteration are still held by the registers.
+		HqValueHandle hOuter = HQ_VALUE_HANDLE_NULL;
+		Util::GetGpRegister(hOuter, hExecs[i], 3);
+		ASSERT_TRUE(HqValueIsArray(hOuter));
+		ASSERT_EQ(HqValueGetArrayLength(hOuter), 4u);
+
+		HqValueHandle hInner = HqValueGetArrayElement(hOuter, 0);
+		ASSERT_TRUE(HqValueIsArray(hInner));
+		ASSERT_EQ(HqValueGetArrayLength(hInner), 1u);
+		EXPECT_TRUE(HqValueIsInt32(HqValueGetArrayElement(hInner, 0)));
+	}
+
+	size_t slabCount = 0;
+	size_t blocksInUse = 0;
+	getSlabTotals(slabCount, blocksInUse);
+	EXPECT_GT(slabCount, 0u);
+	EXPECT_GT(blocksInUse, 0u);
+
+	ASSERT_EQ(HqExecutionDispose(&hExecs[1]), HQ_SUCCESS);
+	_DisposeScript(hVm, hExecs[0]);
+
+	// Blocks cached by the executions and the collector must all have made it back to the slabs.
+	getSlabTotals(slabCount, blocksInUse);
+	EXPECT_EQ(slabCount, 0u);
+	EXPECT_EQ(blocksInUse, 0u);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
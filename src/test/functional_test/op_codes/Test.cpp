@@ -23,6 +23,13 @@
 #include <gtest/gtest.h>
 
 #include <math.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <string>
+#include <thread>
 
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -564,6 +571,132 @@ TEST_F(_HQ_TEST_NAME(TestOpCodes), LoadGlobal_StoreGlobal)
 
 //----------------------------------------------------------------------------------------------------------------------
 
+TEST_F(_HQ_TEST_NAME(TestOpCodes), LoadGlobal_StoreGlobal$LateLoadedModule)
+{
+	static constexpr const char* const globalName = "lateValue";
+	static constexpr int32_t testValueData = 24681357;
+
+	// The module running the script only references the global variable by name without declaring it.
+	auto consumerCallback = [](HqModuleWriterHandle hModuleWriter, int endianness)
+	{
+		HqSerializerHandle hFuncSerializer = HQ_SERIALIZER_HANDLE_NULL;
+
+		// Add the string value to the module string table.
+		uint32_t stringIndex = 0;
+		const int addStringResult = HqModuleWriterAddString(hModuleWriter, globalName, &stringIndex);
+		ASSERT_EQ(addStringResult, HQ_SUCCESS);
+
+		// Set the function serializer.
+		Util::SetupFunctionSerializer(hFuncSerializer, endianness);
+
+		// Write the LOAD_GLOBAL instruction to a GP register so we can see what the script reads.
+		const int writeLoadGlobalInstrResult = HqBytecodeEmitLoadGlobal(hFuncSerializer, 1, stringIndex);
+		ASSERT_EQ(writeLoadGlobalInstrResult, HQ_SUCCESS);
+
+		// Write a LOAD_IMM instruction so we have data to put in the global variable.
+		const int writeLoadImmInstrResult = HqBytecodeEmitLoadImmI32(hFuncSerializer, 0, testValueData);
+		ASSERT_EQ(writeLoadImmInstrResult, HQ_SUCCESS);
+
+		// Write the STORE_GLOBAL instruction to give the global variable some data.
+		const int writeStoreInstrResult = HqBytecodeEmitStoreGlobal(hFuncSerializer, stringIndex, 0);
+		ASSERT_EQ(writeStoreInstrResult, HQ_SUCCESS);
+
+		// Write a YIELD instruction so we can examine the values.
+		const int writeYieldInstrResult = HqBytecodeEmitYield(hFuncSerializer);
+		ASSERT_EQ(writeYieldInstrResult, HQ_SUCCESS);
+
+		// Finalize the serializer and add it to the module.
+		Util::FinalizeFunctionSerializer(hFuncSerializer, hModuleWriter, Function::main);
+	};
+
+	// The module declaring the global variable is loaded only after the script has already been decoded.
+	auto providerCallback = [](HqModuleWriterHandle hModuleWriter, int endianness)
+	{
+		(void) endianness;
+
+		// Add the global variable to the module.
+		const int addGlobalResult = HqModuleWriterAddGlobal(hModuleWriter, globalName);
+		ASSERT_EQ(addGlobalResult, HQ_SUCCESS);
+	};
+
+	std::vector<uint8_t> consumerBytecode;
+	std::vector<uint8_t> providerBytecode;
+
+	// Construct the module bytecode for the test.
+	Util::CompileBytecode(consumerBytecode, consumerCallback);
+	Util::CompileBytecode(providerBytecode, providerCallback);
+	ASSERT_GT(consumerBytecode.size(), 0u);
+	ASSERT_GT(providerBytecode.size(), 0u);
+
+	Memory::Instance.SetContext("runtime");
+
+	const HqVmInit init = GetDefaultHqVmInit(nullptr, nullptr, HQ_MESSAGE_TYPE_FATAL);
+
+	HqVmHandle hVm = HQ_VM_HANDLE_NULL;
+	ASSERT_EQ(HqVmCreate(&hVm, init), HQ_SUCCESS);
+	ASSERT_EQ(HqVmLoadModule(hVm, "TestConsumer", consumerBytecode.data(), consumerBytecode.size()), HQ_SUCCESS);
+
+	HqExecutionHandle hExec = HQ_EXECUTION_HANDLE_NULL;
+	ASSERT_EQ(HqVmInitializeModules(hVm, &hExec), HQ_SUCCESS);
+
+	HqFunctionHandle hFunction = HQ_FUNCTION_HANDLE_NULL;
+	ASSERT_EQ(HqVmGetFunction(hVm, &hFunction, Function::main), HQ_SUCCESS);
+
+	hExec = HQ_EXECUTION_HANDLE_NULL;
+	ASSERT_EQ(HqExecutionCreate(&hExec, hVm), HQ_SUCCESS);
+	ASSERT_EQ(HqExecutionInitialize(hExec, hFunction), HQ_SUCCESS);
+
+	ExecStatus status;
+
+	// The global variable doesn't exist yet, so the script must fail on it.
+	ASSERT_EQ(HqExecutionRun(hExec, HQ_RUN_FULL), HQ_SUCCESS);
+	Util::GetExecutionStatus(status, hExec);
+	ASSERT_TRUE(status.exception);
+
+	// Load the module that declares the global variable.
+	ASSERT_EQ(HqVmLoadModule(hVm, "TestProvider", providerBytecode.data(), providerBytecode.size()), HQ_SUCCESS);
+
+	HqExecutionHandle hInitExec = HQ_EXECUTION_HANDLE_NULL;
+	ASSERT_EQ(HqVmInitializeModules(hVm, &hInitExec), HQ_SUCCESS);
+
+	// Running the script again resolves the global variable on first use from the already decoded instructions.
+	ASSERT_EQ(HqExecutionReset(hExec), HQ_SUCCESS);
+	ASSERT_EQ(HqExecutionRun(hExec, HQ_RUN_FULL), HQ_SUCCESS);
+	Util::GetExecutionStatus(status, hExec);
+	ASSERT_TRUE(status.yield);
+	ASSERT_FALSE(status.exception);
+
+	HqValueHandle hValue = HQ_VALUE_HANDLE_NULL;
+	ASSERT_EQ(HqVmGetGlobalVariable(hVm, &hValue, globalName), HQ_SUCCESS);
+	ASSERT_TRUE(HqValueIsInt32(hValue));
+	EXPECT_EQ(HqValueGetInt32(hValue), testValueData);
+
+	// The resolved slot is now cached on the instructions, so a value set through the name-based API must be
+	// the one the script reads the next time it runs.
+	ASSERT_EQ(HqVmSetGlobalVariable(hVm, HqValueCreateInt32(hVm, -1), globalName), HQ_SUCCESS);
+
+	ASSERT_EQ(HqExecutionReset(hExec), HQ_SUCCESS);
+	ASSERT_EQ(HqExecutionRun(hExec, HQ_RUN_FULL), HQ_SUCCESS);
+	Util::GetExecutionStatus(status, hExec);
+	ASSERT_TRUE(status.yield);
+
+	Util::GetGpRegister(hValue, hExec, 1);
+	ASSERT_TRUE(HqValueIsInt32(hValue));
+	EXPECT_EQ(HqValueGetInt32(hValue), -1);
+
+	ASSERT_EQ(HqVmGetGlobalVariable(hVm, &hValue, globalName), HQ_SUCCESS);
+	ASSERT_TRUE(HqValueIsInt32(hValue));
+	EXPECT_EQ(HqValueGetInt32(hValue), testValueData);
+
+	ASSERT_EQ(HqExecutionDispose(&hExec), HQ_SUCCESS);
+	ASSERT_EQ(HqVmDispose(&hVm), HQ_SUCCESS);
+
+	// Verify all memory has been freed.
+	Memory::Instance.Validate();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 TEST_F(_HQ_TEST_NAME(TestOpCodes), LoadParam_StoreParam)
 {
 	static constexpr int32_t testValueData = 12345678;
@@ -1121,6 +1254,226 @@ TEST_F(_HQ_TEST_NAME(TestOpCodes), Call$Script)
 
 //----------------------------------------------------------------------------------------------------------------------
 
+TEST_F(_HQ_TEST_NAME(TestOpCodes), Call$ScriptRepeated)
+{
+	static constexpr const char* const functionName = "void increment()";
+
+	auto compilerCallback = [](HqModuleWriterHandle hModuleWriter, int endianness)
+	{
+		HqSerializerHandle hFuncSerializer = HQ_SERIALIZER_HANDLE_NULL;
+
+		// Add the function name to the module string table.
+		uint32_t stringIndex = 0;
+		const int addStringResult = HqModuleWriterAddString(hModuleWriter, functionName, &stringIndex);
+		ASSERT_EQ(addStringResult, HQ_SUCCESS);
+
+		// Main function
+		{
+			// Set the function serializer.
+			Util::SetupFunctionSerializer(hFuncSerializer, endianness);
+
+			// Initialize the counter that will be passed to the function.
+			ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 0, 0), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitStoreParam(hFuncSerializer, 0, 0), HQ_SUCCESS);
+
+			const size_t loopStart = HqSerializerGetStreamPosition(hFuncSerializer);
+
+			// Call the function from the same call site on each iteration, yielding after each call so we can examine the counter.
+			ASSERT_EQ(HqBytecodeEmitCall(hFuncSerializer, stringIndex), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitYield(hFuncSerializer), HQ_SUCCESS);
+
+			const size_t loopEnd = HqSerializerGetStreamPosition(hFuncSerializer);
+
+			// Jump back to the call site.
+			ASSERT_EQ(HqBytecodeEmitJump(hFuncSerializer, int32_t(loopStart) - int32_t(loopEnd)), HQ_SUCCESS);
+
+			// Finalize the serializer and add it to the module.
+			Util::FinalizeFunctionSerializer(hFuncSerializer, hModuleWriter, Function::main);
+		}
+
+		// Sub-function
+		{
+			// Set the function serializer.
+			Util::SetupFunctionSerializer(hFuncSerializer, endianness);
+
+			// Increment the counter in the I/O register.
+			ASSERT_EQ(HqBytecodeEmitLoadParam(hFuncSerializer, 0, 0), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 1, 1), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitAdd(hFuncSerializer, 0, 0, 1), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitStoreParam(hFuncSerializer, 0, 0), HQ_SUCCESS);
+
+			// Finalize the serializer and add it to the module.
+			Util::FinalizeFunctionSerializer(hFuncSerializer, hModuleWriter, functionName);
+		}
+	};
+
+	auto runtimeCallback = [](HqVmHandle hVm, HqExecutionHandle hExec)
+	{
+		(void) hVm;
+
+		for(int32_t expectedValue = 1; expectedValue <= 3; ++expectedValue)
+		{
+			// Run the execution context.
+			const int execRunResult = HqExecutionRun(hExec, HQ_RUN_FULL);
+			ASSERT_EQ(execRunResult, HQ_SUCCESS);
+
+			// Get the status of the execution context.
+			ExecStatus status;
+			Util::GetExecutionStatus(status, hExec);
+			ASSERT_TRUE(status.yield);
+			ASSERT_TRUE(status.running);
+			ASSERT_FALSE(status.complete);
+			ASSERT_FALSE(status.exception);
+			ASSERT_FALSE(status.abort);
+
+			// Get the register value we want to inspect.
+			HqValueHandle hValue = HQ_VALUE_HANDLE_NULL;
+			Util::GetIoRegister(hValue, hExec, 0);
+
+			// Validate the register value.
+			ASSERT_NE(hValue, HQ_VALUE_HANDLE_NULL);
+			ASSERT_TRUE(HqValueIsInt32(hValue));
+			ASSERT_EQ(HqValueGetInt32(hValue), expectedValue);
+		}
+	};
+
+	std::vector<uint8_t> bytecode;
+
+	// Construct the module bytecode for the test.
+	Util::CompileBytecode(bytecode, compilerCallback);
+	ASSERT_GT(bytecode.size(), 0u);
+
+	// Run the module bytecode.
+	Util::ProcessBytecode("TestOpCodes", Function::main, runtimeCallback, bytecode);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_F(_HQ_TEST_NAME(TestOpCodes), Call$ScriptConcurrent)
+{
+	static constexpr const char* const functionName = "void increment()";
+	static constexpr int32_t callCount = 2000;
+	static constexpr size_t threadCount = 4;
+
+	auto compilerCallback = [](HqModuleWriterHandle hModuleWriter, int endianness)
+	{
+		HqSerializerHandle hFuncSerializer = HQ_SERIALIZER_HANDLE_NULL;
+
+		// Add the function name to the module string table.
+		uint32_t stringIndex = 0;
+		const int addStringResult = HqModuleWriterAddString(hModuleWriter, functionName, &stringIndex);
+		ASSERT_EQ(addStringResult, HQ_SUCCESS);
+
+		// Main function
+		{
+			// Set the function serializer.
+			Util::SetupFunctionSerializer(hFuncSerializer, endianness);
+
+			// Initialize the counter that will be passed to the function.
+			ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 0, 0), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitStoreParam(hFuncSerializer, 0, 0), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 1, callCount), HQ_SUCCESS);
+
+			const size_t loopStart = HqSerializerGetStreamPosition(hFuncSerializer);
+
+			// Call the function from the same call site until the counter reaches the call count.
+			ASSERT_EQ(HqBytecodeEmitCall(hFuncSerializer, stringIndex), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitLoadParam(hFuncSerializer, 0, 0), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitCompareLess(hFuncSerializer, 2, 0, 1), HQ_SUCCESS);
+
+			const size_t loopEnd = HqSerializerGetStreamPosition(hFuncSerializer);
+
+			// Jump back to the call site.
+			ASSERT_EQ(HqBytecodeEmitJumpIfTrue(hFuncSerializer, 2, int32_t(loopStart) - int32_t(loopEnd)), HQ_SUCCESS);
+
+			// Finalize the serializer and add it to the module.
+			Util::FinalizeFunctionSerializer(hFuncSerializer, hModuleWriter, Function::main);
+		}
+
+		// Sub-function
+		{
+			// Set the function serializer.
+			Util::SetupFunctionSerializer(hFuncSerializer, endianness);
+
+			// Increment the counter in the I/O register.
+			ASSERT_EQ(HqBytecodeEmitLoadParam(hFuncSerializer, 0, 0), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 1, 1), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitAdd(hFuncSerializer, 0, 0, 1), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitStoreParam(hFuncSerializer, 0, 0), HQ_SUCCESS);
+
+			// Finalize the serializer and add it to the module.
+			Util::FinalizeFunctionSerializer(hFuncSerializer, hModuleWriter, functionName);
+		}
+	};
+
+	auto runtimeCallback = [](HqVmHandle hVm, HqExecutionHandle hExec)
+	{
+		HqFunctionHandle hFunction = HQ_FUNCTION_HANDLE_NULL;
+		ASSERT_EQ(HqVmGetFunction(hVm, &hFunction, Function::main), HQ_SUCCESS);
+
+		// Every execution context shares the same decoded call site, so running them
+		// at the same time will have them filling in and reading its cache concurrently.
+		HqExecutionHandle hExecs[threadCount] = { hExec };
+		for(size_t i = 1; i < threadCount; ++i)
+		{
+			ASSERT_EQ(HqExecutionCreate(&hExecs[i], hVm), HQ_SUCCESS);
+			ASSERT_EQ(HqExecutionInitialize(hExecs[i], hFunction), HQ_SUCCESS);
+		}
+
+		int runResults[threadCount];
+		std::thread threads[threadCount];
+
+		for(size_t i = 0; i < threadCount; ++i)
+		{
+			threads[i] = std::thread([i, &hExecs, &runResults]() { runResults[i] = HqExecutionRun(hExecs[i], HQ_RUN_FULL); });
+		}
+
+		for(size_t i = 0; i < threadCount; ++i)
+		{
+			threads[i].join();
+		}
+
+		for(size_t i = 0; i < threadCount; ++i)
+		{
+			ASSERT_EQ(runResults[i], HQ_SUCCESS);
+
+			// Get the status of the execution context.
+			ExecStatus status;
+			Util::GetExecutionStatus(status, hExecs[i]);
+			ASSERT_FALSE(status.yield);
+			ASSERT_FALSE(status.running);
+			ASSERT_TRUE(status.complete);
+			ASSERT_FALSE(status.exception);
+			ASSERT_FALSE(status.abort);
+
+			// Get the register value we want to inspect.
+			HqValueHandle hValue = HQ_VALUE_HANDLE_NULL;
+			Util::GetIoRegister(hValue, hExecs[i], 0);
+
+			// Validate the register value.
+			ASSERT_NE(hValue, HQ_VALUE_HANDLE_NULL);
+			ASSERT_TRUE(HqValueIsInt32(hValue));
+			ASSERT_EQ(HqValueGetInt32(hValue), callCount);
+		}
+
+		for(size_t i = 1; i < threadCount; ++i)
+		{
+			ASSERT_EQ(HqExecutionDispose(&hExecs[i]), HQ_SUCCESS);
+		}
+	};
+
+	std::vector<uint8_t> bytecode;
+
+	// Construct the module bytecode for the test.
+	Util::CompileBytecode(bytecode, compilerCallback);
+	ASSERT_GT(bytecode.size(), 0u);
+
+	// Run the module bytecode.
+	Util::ProcessBytecode("TestOpCodes", Function::main, runtimeCallback, bytecode);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
 TEST_F(_HQ_TEST_NAME(TestOpCodes), Call$Native)
 {
 	static constexpr const char* const functionName = "int32_t testCallNative(int32_t)";
@@ -1511,44 +1864,431 @@ TEST_F(_HQ_TEST_NAME(TestOpCodes), CallValue$NativeNonExistent)
 
 //----------------------------------------------------------------------------------------------------------------------
 
-TEST_F(_HQ_TEST_NAME(TestOpCodes), Raise)
+TEST_F(_HQ_TEST_NAME(TestOpCodes), CallWindow)
 {
-	static constexpr const char* const objTypeName = "TestObj";
-	static constexpr int32_t testValueData = 12345;
+	static constexpr const char* const scriptFunctionName = "int32_t add(int32_t, int32_t)";
+	static constexpr const char* const nativeFunctionName = "int32_t testCallNative(int32_t)";
 
 	auto compilerCallback = [](HqModuleWriterHandle hModuleWriter, int endianness)
 	{
 		HqSerializerHandle hFuncSerializer = HQ_SERIALIZER_HANDLE_NULL;
 
-		// Add an object type to use for testing to the module.
-		const int addObjTypeResult = HqModuleWriterAddObjectType(hModuleWriter, objTypeName);
-		ASSERT_EQ(addObjTypeResult, HQ_SUCCESS);
-
-		// Add the object type name to the module's string table.
-		uint32_t objStringIndex = 0;
-		const int addObjStringResult = HqModuleWriterAddString(hModuleWriter, objTypeName, &objStringIndex);
-		ASSERT_EQ(addObjStringResult, HQ_SUCCESS);
+		// Every script function in this module takes its parameters in its leading GP registers.
+		ASSERT_EQ(HqModuleWriterSetCallingConvention(hModuleWriter, HQ_CALLING_CONVENTION__COUNT), HQ_ERROR_INVALID_ARG);
+		ASSERT_EQ(HqModuleWriterSetCallingConvention(hModuleWriter, HQ_CALLING_CONVENTION_REGISTER_WINDOW), HQ_SUCCESS);
 
-		// Set the function serializer.
-		Util::SetupFunctionSerializer(hFuncSerializer, endianness);
+		// Add the function names to the module string table.
+		uint32_t scriptStringIndex = 0;
+		uint32_t nativeStringIndex = 0;
+		ASSERT_EQ(HqModuleWriterAddString(hModuleWriter, scriptFunctionName, &scriptStringIndex), HQ_SUCCESS);
+		ASSERT_EQ(HqModuleWriterAddString(hModuleWriter, nativeFunctionName, &nativeStringIndex), HQ_SUCCESS);
 
-		const size_t guardOffsetStart = HqSerializerGetStreamPosition(hFuncSerializer);
+		// Native functions always use the I/O registers.
+		ASSERT_EQ(HqModuleWriterAddNativeFunction(hModuleWriter, nativeFunctionName, 1, 1), HQ_SUCCESS);
 
-		// Write the INIT_OBJECT instruction so we have a value to raise for the exception.
-		const int writeLoadObjInstrResult = HqBytecodeEmitInitObject(hFuncSerializer, 0, objStringIndex);
-		ASSERT_EQ(writeLoadObjInstrResult, HQ_SUCCESS);
+		// Main function
+		{
+			// Set the function serializer.
+			Util::SetupFunctionSerializer(hFuncSerializer, endianness);
 
-		// Write the RAISE instruction to test a handled exception.
-		const int writeRaiseHandledInstrResult = HqBytecodeEmitRaise(hFuncSerializer, 0);
-		ASSERT_EQ(writeRaiseHandledInstrResult, HQ_SUCCESS);
+			// Call the script function through a window starting at r(1). The value in r(0) sits below the window.
+			ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 0, 1000), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 1, 7), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 2, 5), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitCallWindow(hFuncSerializer, scriptStringIndex, 1), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitStoreParam(hFuncSerializer, 2, 1), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitStoreParam(hFuncSerializer, 3, 0), HQ_SUCCESS);
+
+			// Call the native function through a window. The native function copies p(0) to p(1).
+			ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 1, 99), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitCallWindow(hFuncSerializer, nativeStringIndex, 1), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitLoadParam(hFuncSerializer, 3, 1), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitStoreParam(hFuncSerializer, 4, 3), HQ_SUCCESS);
+
+			// Call the script function the old way with its arguments in the I/O registers.
+			ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 1, 20), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 2, 22), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitStoreParam(hFuncSerializer, 0, 1), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitStoreParam(hFuncSerializer, 1, 2), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitCall(hFuncSerializer, scriptStringIndex), HQ_SUCCESS);
 
-		const size_t guardOffsetEnd = HqSerializerGetStreamPosition(hFuncSerializer);
+			// Write a YIELD instruction so we can examine the registers.
+			ASSERT_EQ(HqBytecodeEmitYield(hFuncSerializer), HQ_SUCCESS);
 
-		// Write an ABORT instruction that should never get called.
-		const int writeAbortInstrResult = HqBytecodeEmitAbort(hFuncSerializer);
-		ASSERT_EQ(writeAbortInstrResult, HQ_SUCCESS);
+			// Finalize the serializer and add it to the module.
+			Util::FinalizeFunctionSerializer(hFuncSerializer, hModuleWriter, Function::main);
+		}
 
-		const size_t handlerOffset = HqSerializerGetStreamPosition(hFuncSerializer);
+		// Sub-function
+		{
+			// Set the function serializer.
+			Util::SetupFunctionSerializer(hFuncSerializer, endianness);
+
+			// Add the parameters together, leaving the result in the first register of the window.
+			ASSERT_EQ(HqBytecodeEmitAdd(hFuncSerializer, 0, 0, 1), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitReturn(hFuncSerializer), HQ_SUCCESS);
+
+			const void* const pFuncData = HqSerializerGetRawStreamPointer(hFuncSerializer);
+			const size_t funcLength = HqSerializerGetStreamLength(hFuncSerializer);
+
+			// The function needs to declare its parameters and return values so they can be moved between register sets.
+			ASSERT_EQ(HqModuleWriterAddFunction(hModuleWriter, scriptFunctionName, pFuncData, funcLength, 2, 1), HQ_SUCCESS);
+			ASSERT_EQ(HqSerializerDispose(&hFuncSerializer), HQ_SUCCESS);
+		}
+	};
+
+	auto runtimeCallback = [](HqVmHandle hVm, HqExecutionHandle hExec)
+	{
+		(void) hVm;
+
+		// Run the execution context.
+		const int execRunResult = HqExecutionRun(hExec, HQ_RUN_FULL);
+		ASSERT_EQ(execRunResult, HQ_SUCCESS);
+
+		// Get the status of the execution context.
+		ExecStatus status;
+		Util::GetExecutionStatus(status, hExec);
+		ASSERT_TRUE(status.yield);
+		ASSERT_TRUE(status.running);
+		ASSERT_FALSE(status.complete);
+		ASSERT_FALSE(status.exception);
+		ASSERT_FALSE(status.abort);
+
+		auto checkIoRegister = [&hExec](const uint32_t ioRegIndex, const int32_t expectedValue)
+		{
+			HqValueHandle hValue = HQ_VALUE_HANDLE_NULL;
+			Util::GetIoRegister(hValue, hExec, ioRegIndex);
+
+			ASSERT_NE(hValue, HQ_VALUE_HANDLE_NULL);
+			ASSERT_TRUE(HqValueIsInt32(hValue));
+			EXPECT_EQ(HqValueGetInt32(hValue), expectedValue);
+		};
+
+		// Result of the register window call.
+		checkIoRegister(2, 12);
+
+		// Registers below the window are left alone by the call.
+		checkIoRegister(3, 1000);
+
+		// Argument passed from the window to the native function's I/O registers.
+		checkIoRegister(4, 99);
+
+		// Result of the I/O register call into the register window function.
+		checkIoRegister(0, 42);
+	};
+
+	std::vector<uint8_t> bytecode;
+
+	// Construct the module bytecode for the test.
+	Util::CompileBytecode(bytecode, compilerCallback);
+	ASSERT_GT(bytecode.size(), 0u);
+
+	// Run the module bytecode.
+	Util::ProcessBytecode("TestOpCodes", Function::main, runtimeCallback, bytecode);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_F(_HQ_TEST_NAME(TestOpCodes), CallWindow_UntouchedReturnRegisters)
+{
+	static constexpr const char* const sevenFunctionName = "int32_t seven()";
+	static constexpr const char* const nothingFunctionName = "int32_t nothing()";
+
+	auto compilerCallback = [](HqModuleWriterHandle hModuleWriter, int endianness)
+	{
+		HqSerializerHandle hFuncSerializer = HQ_SERIALIZER_HANDLE_NULL;
+
+		ASSERT_EQ(HqModuleWriterSetCallingConvention(hModuleWriter, HQ_CALLING_CONVENTION_REGISTER_WINDOW), HQ_SUCCESS);
+
+		// Add the function names to the module string table.
+		uint32_t sevenStringIndex = 0;
+		uint32_t nothingStringIndex = 0;
+		ASSERT_EQ(HqModuleWriterAddString(hModuleWriter, sevenFunctionName, &sevenStringIndex), HQ_SUCCESS);
+		ASSERT_EQ(HqModuleWriterAddString(hModuleWriter, nothingFunctionName, &nothingStringIndex), HQ_SUCCESS);
+
+		// Main function
+		{
+			// Set the function serializer.
+			Util::SetupFunctionSerializer(hFuncSerializer, endianness);
+
+			// Only r(0) is touched before the calls, so both windows start well above the high-water mark.
+			ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 0, 1000), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitCallWindow(hFuncSerializer, sevenStringIndex, 5), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitCallWindow(hFuncSerializer, nothingStringIndex, 10), HQ_SUCCESS);
+
+			ASSERT_EQ(HqBytecodeEmitStoreParam(hFuncSerializer, 0, 0), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitStoreParam(hFuncSerializer, 1, 5), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitStoreParam(hFuncSerializer, 2, 10), HQ_SUCCESS);
+
+			// Write a YIELD instruction so we can examine the registers.
+			ASSERT_EQ(HqBytecodeEmitYield(hFuncSerializer), HQ_SUCCESS);
+
+			// Finalize the serializer and add it to the module.
+			Util::FinalizeFunctionSerializer(hFuncSerializer, hModuleWriter, Function::main);
+		}
+
+		auto addSubFunction = [&hFuncSerializer, &hModuleWriter, &endianness](
+			const char* const functionName,
+			const bool writeReturnValue
+		)
+		{
+			// Set the function serializer.
+			Util::SetupFunctionSerializer(hFuncSerializer, endianness);
+
+			if(writeReturnValue)
+			{
+				ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 0, 7), HQ_SUCCESS);
+			}
+
+			ASSERT_EQ(HqBytecodeEmitReturn(hFuncSerializer), HQ_SUCCESS);
+
+			const void* const pFuncData = HqSerializerGetRawStreamPointer(hFuncSerializer);
+			const size_t funcLength = HqSerializerGetStreamLength(hFuncSerializer);
+
+			ASSERT_EQ(HqModuleWriterAddFunction(hModuleWriter, functionName, pFuncData, funcLength, 0, 1), HQ_SUCCESS);
+			ASSERT_EQ(HqSerializerDispose(&hFuncSerializer), HQ_SUCCESS);
+		};
+
+		addSubFunction(sevenFunctionName, true);
+		addSubFunction(nothingFunctionName, false);
+	};
+
+	auto runtimeCallback = [](HqVmHandle hVm, HqExecutionHandle hExec)
+	{
+		(void) hVm;
+
+		// Run the execution context.
+		const int execRunResult = HqExecutionRun(hExec, HQ_RUN_FULL);
+		ASSERT_EQ(execRunResult, HQ_SUCCESS);
+
+		// Get the status of the execution context.
+		ExecStatus status;
+		Util::GetExecutionStatus(status, hExec);
+		ASSERT_TRUE(status.yield);
+		ASSERT_TRUE(status.running);
+		ASSERT_FALSE(status.complete);
+		ASSERT_FALSE(status.exception);
+		ASSERT_FALSE(status.abort);
+
+		auto checkIoRegister = [&hExec](const uint32_t ioRegIndex, const int32_t expectedValue)
+		{
+			HqValueHandle hValue = HQ_VALUE_HANDLE_NULL;
+			Util::GetIoRegister(hValue, hExec, ioRegIndex);
+
+			ASSERT_NE(hValue, HQ_VALUE_HANDLE_NULL);
+			ASSERT_TRUE(HqValueIsInt32(hValue));
+			EXPECT_EQ(HqValueGetInt32(hValue), expectedValue);
+		};
+
+		checkIoRegister(0, 1000);
+
+		// The return value must survive the caller touching the window register for the first time.
+		checkIoRegister(1, 7);
+
+		// A return register the callee never wrote is cleared rather than left with whatever was in the arena.
+		HqValueHandle hUnwrittenValue = HQ_VALUE_HANDLE_NULL;
+		Util::GetIoRegister(hUnwrittenValue, hExec, 2);
+		EXPECT_EQ(hUnwrittenValue, HQ_VALUE_HANDLE_NULL);
+	};
+
+	std::vector<uint8_t> bytecode;
+
+	// Construct the module bytecode for the test.
+	Util::CompileBytecode(bytecode, compilerCallback);
+	ASSERT_GT(bytecode.size(), 0u);
+
+	// Run the module bytecode.
+	Util::ProcessBytecode("TestOpCodes", Function::main, runtimeCallback, bytecode);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_F(_HQ_TEST_NAME(TestOpCodes), TailCall)
+{
+	static constexpr const char* const countdownName = "void countdown()";
+	static constexpr const char* const countdownValueName = "void countdownValue()";
+
+	// Both counts are deeper than the frame stack, so they only complete if tail calls reuse the current frame.
+	static constexpr int32_t countdownDepth = HQ_VM_FRAME_STACK_SIZE * 5;
+	static constexpr int32_t countdownValueDepth = HQ_VM_FRAME_STACK_SIZE * 3;
+
+	auto compilerCallback = [](HqModuleWriterHandle hModuleWriter, int endianness)
+	{
+		HqSerializerHandle hFuncSerializer = HQ_SERIALIZER_HANDLE_NULL;
+
+		// Add the function names to the module string table.
+		uint32_t countdownStringIndex = 0;
+		uint32_t countdownValueStringIndex = 0;
+		ASSERT_EQ(HqModuleWriterAddString(hModuleWriter, countdownName, &countdownStringIndex), HQ_SUCCESS);
+		ASSERT_EQ(HqModuleWriterAddString(hModuleWriter, countdownValueName, &countdownValueStringIndex), HQ_SUCCESS);
+
+		// Main function
+		{
+			// Set the function serializer.
+			Util::SetupFunctionSerializer(hFuncSerializer, endianness);
+
+			// This register must be untouched once the tail calls finally return.
+			ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 5, 77), HQ_SUCCESS);
+
+			// Count down by name.
+			ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 0, countdownDepth), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitStoreParam(hFuncSerializer, 0, 0), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 0, 0), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitStoreParam(hFuncSerializer, 1, 0), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitCall(hFuncSerializer, countdownStringIndex), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitLoadParam(hFuncSerializer, 0, 1), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitStoreParam(hFuncSerializer, 2, 0), HQ_SUCCESS);
+
+			// Count down by function value.
+			ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 0, countdownValueDepth), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitStoreParam(hFuncSerializer, 0, 0), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 0, 0), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitStoreParam(hFuncSerializer, 1, 0), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitCall(hFuncSerializer, countdownValueStringIndex), HQ_SUCCESS);
+
+			ASSERT_EQ(HqBytecodeEmitStoreParam(hFuncSerializer, 3, 5), HQ_SUCCESS);
+
+			// Write a YIELD instruction so we can examine the registers.
+			ASSERT_EQ(HqBytecodeEmitYield(hFuncSerializer), HQ_SUCCESS);
+
+			// Finalize the serializer and add it to the module.
+			Util::FinalizeFunctionSerializer(hFuncSerializer, hModuleWriter, Function::main);
+		}
+
+		// Decrement p(0) and increment p(1) until p(0) reaches zero, tail calling the same function each time.
+		auto writeCountdown = [&hFuncSerializer, &hModuleWriter, &endianness](
+			const char* const functionName,
+			const uint32_t stringIndex,
+			const bool callByValue
+		)
+		{
+			// Set the function serializer.
+			Util::SetupFunctionSerializer(hFuncSerializer, endianness);
+
+			ASSERT_EQ(HqBytecodeEmitLoadParam(hFuncSerializer, 0, 0), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitLoadParam(hFuncSerializer, 3, 1), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 1, 0), HQ_SUCCESS);
+			ASSERT_EQ(HqBytecodeEmitCompareEqual(hFuncSerializer, 2, 0, 1), HQ_SUCCESS);
+
+			ControlFlow ctrl;
+
+			// Skip to the RETURN once the count reaches zero.
+			ctrl.Begin(hFuncSerializer, ControlFlow::Behavior::If, ControlFlow::Condition::True, 2);
+			{
+				ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 1, 1), HQ_SUCCESS);
+				ASSERT_EQ(HqBytecodeEmitSub(hFuncSerializer, 0, 0, 1), HQ_SUCCESS);
+				ASSERT_EQ(HqBytecodeEmitAdd(hFuncSerializer, 3, 3, 1), HQ_SUCCESS);
+				ASSERT_EQ(HqBytecodeEmitStoreParam(hFuncSerializer, 0, 0), HQ_SUCCESS);
+				ASSERT_EQ(HqBytecodeEmitStoreParam(hFuncSerializer, 1, 3), HQ_SUCCESS);
+
+				if(callByValue)
+				{
+					ASSERT_EQ(HqBytecodeEmitInitFunction(hFuncSerializer, 4, stringIndex), HQ_SUCCESS);
+					ASSERT_EQ(HqBytecodeEmitTailCallValue(hFuncSerializer, 4), HQ_SUCCESS);
+				}
+				else
+				{
+					ASSERT_EQ(HqBytecodeEmitTailCall(hFuncSerializer, stringIndex), HQ_SUCCESS);
+				}
+			}
+			ctrl.End();
+
+			// Finalize the serializer and add it to the module.
+			Util::FinalizeFunctionSerializer(hFuncSerializer, hModuleWriter, functionName);
+		};
+
+		writeCountdown(countdownName, countdownStringIndex, false);
+		writeCountdown(countdownValueName, countdownValueStringIndex, true);
+	};
+
+	auto runtimeCallback = [](HqVmHandle hVm, HqExecutionHandle hExec)
+	{
+		(void) hVm;
+
+		// Run the execution context.
+		const int execRunResult = HqExecutionRun(hExec, HQ_RUN_FULL);
+		ASSERT_EQ(execRunResult, HQ_SUCCESS);
+
+		// Get the status of the execution context.
+		ExecStatus status;
+		Util::GetExecutionStatus(status, hExec);
+		ASSERT_TRUE(status.yield);
+		ASSERT_TRUE(status.running);
+		ASSERT_FALSE(status.complete);
+		ASSERT_FALSE(status.exception);
+		ASSERT_FALSE(status.abort);
+
+		// Only the main function's frame should be left.
+		size_t frameCount = 0;
+		ASSERT_EQ(HqExecutionGetFrameStackDepth(hExec, &frameCount), HQ_SUCCESS);
+		EXPECT_EQ(frameCount, 1u);
+
+		auto checkIoRegister = [&hExec](const uint32_t ioRegIndex, const int32_t expectedValue)
+		{
+			HqValueHandle hValue = HQ_VALUE_HANDLE_NULL;
+			Util::GetIoRegister(hValue, hExec, ioRegIndex);
+
+			ASSERT_NE(hValue, HQ_VALUE_HANDLE_NULL);
+			ASSERT_TRUE(HqValueIsInt32(hValue));
+			EXPECT_EQ(HqValueGetInt32(hValue), expectedValue);
+		};
+
+		checkIoRegister(0, 0);
+		checkIoRegister(1, countdownValueDepth);
+		checkIoRegister(2, countdownDepth);
+		checkIoRegister(3, 77);
+	};
+
+	std::vector<uint8_t> bytecode;
+
+	// Construct the module bytecode for the test.
+	Util::CompileBytecode(bytecode, compilerCallback);
+	ASSERT_GT(bytecode.size(), 0u);
+
+	// Run the module bytecode.
+	Util::ProcessBytecode("TestOpCodes", Function::main, runtimeCallback, bytecode);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_F(_HQ_TEST_NAME(TestOpCodes), Raise)
+{
+	static constexpr const char* const objTypeName = "TestObj";
+	static constexpr int32_t testValueData = 12345;
+
+	auto compilerCallback = [](HqModuleWriterHandle hModuleWriter, int endianness)
+	{
+		HqSerializerHandle hFuncSerializer = HQ_SERIALIZER_HANDLE_NULL;
+
+		// Add an object type to use for testing to the module.
+		const int addObjTypeResult = HqModuleWriterAddObjectType(hModuleWriter, objTypeName);
+		ASSERT_EQ(addObjTypeResult, HQ_SUCCESS);
+
+		// Add the object type name to the module's string table.
+		uint32_t objStringIndex = 0;
+		const int addObjStringResult = HqModuleWriterAddString(hModuleWriter, objTypeName, &objStringIndex);
+		ASSERT_EQ(addObjStringResult, HQ_SUCCESS);
+
+		// Set the function serializer.
+		Util::SetupFunctionSerializer(hFuncSerializer, endianness);
+
+		const size_t guardOffsetStart = HqSerializerGetStreamPosition(hFuncSerializer);
+
+		// Write the INIT_OBJECT instruction so we have a value to raise for the exception.
+		const int writeLoadObjInstrResult = HqBytecodeEmitInitObject(hFuncSerializer, 0, objStringIndex);
+		ASSERT_EQ(writeLoadObjInstrResult, HQ_SUCCESS);
+
+		// Write the RAISE instruction to test a handled exception.
+		const int writeRaiseHandledInstrResult = HqBytecodeEmitRaise(hFuncSerializer, 0);
+		ASSERT_EQ(writeRaiseHandledInstrResult, HQ_SUCCESS);
+
+		const size_t guardOffsetEnd = HqSerializerGetStreamPosition(hFuncSerializer);
+
+		// Write an ABORT instruction that should never get called.
+		const int writeAbortInstrResult = HqBytecodeEmitAbort(hFuncSerializer);
+		ASSERT_EQ(writeAbortInstrResult, HQ_SUCCESS);
+
+		const size_t handlerOffset = HqSerializerGetStreamPosition(hFuncSerializer);
 
 		// Write a YIELD instruction so we can examine the exception value.
 		const int writeYieldInstrResult = HqBytecodeEmitYield(hFuncSerializer);
@@ -1623,22 +2363,186 @@ TEST_F(_HQ_TEST_NAME(TestOpCodes), Raise)
 
 		// Get the status of the execution context.
 		Util::GetExecutionStatus(status, hExec);
-		ASSERT_FALSE(status.yield);
-		ASSERT_FALSE(status.running);
+		ASSERT_FALSE(status.yield);
+		ASSERT_FALSE(status.running);
+		ASSERT_FALSE(status.complete);
+		ASSERT_TRUE(status.exception);
+		ASSERT_FALSE(status.abort);
+
+		// Verify the handled exception value.
+		{
+			// Get the register value we want to inspect.
+			HqValueHandle hValue = HQ_VALUE_HANDLE_NULL;
+			Util::GetIoRegister(hValue, hExec, 0);
+
+			// Validate the register value.
+			ASSERT_NE(hValue, HQ_VALUE_HANDLE_NULL);
+			ASSERT_TRUE(HqValueIsInt32(hValue));
+			ASSERT_EQ(HqValueGetInt32(hValue), testValueData);
+		}
+	};
+
+	std::vector<uint8_t> bytecode;
+
+	// Construct the module bytecode for the test.
+	Util::CompileBytecode(bytecode, compilerCallback);
+	ASSERT_GT(bytecode.size(), 0u);
+
+	// Run the module bytecode.
+	Util::ProcessBytecode("TestOpCodes", Function::main, runtimeCallback, bytecode);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_F(_HQ_TEST_NAME(TestOpCodes), Raise_NestedGuardedBlocks)
+{
+	static constexpr const char* const innerObjTypeName = "InnerObj";
+	static constexpr const char* const outerObjTypeName = "OuterObj";
+
+	auto compilerCallback = [](HqModuleWriterHandle hModuleWriter, int endianness)
+	{
+		HqSerializerHandle hFuncSerializer = HQ_SERIALIZER_HANDLE_NULL;
+
+		// Add the object types that will be raised to the module.
+		ASSERT_EQ(HqModuleWriterAddObjectType(hModuleWriter, innerObjTypeName), HQ_SUCCESS);
+		ASSERT_EQ(HqModuleWriterAddObjectType(hModuleWriter, outerObjTypeName), HQ_SUCCESS);
+
+		// Add the object type names to the module's string table.
+		uint32_t innerObjStringIndex = 0;
+		uint32_t outerObjStringIndex = 0;
+		ASSERT_EQ(HqModuleWriterAddString(hModuleWriter, innerObjTypeName, &innerObjStringIndex), HQ_SUCCESS);
+		ASSERT_EQ(HqModuleWriterAddString(hModuleWriter, outerObjTypeName, &outerObjStringIndex), HQ_SUCCESS);
+
+		// Set the function serializer.
+		Util::SetupFunctionSerializer(hFuncSerializer, endianness);
+
+		const size_t outerGuardOffsetStart = HqSerializerGetStreamPosition(hFuncSerializer);
+
+		// Raise an object that both the first inner block and the outer block can handle. Both blocks
+		// start at the same offset, so the shorter one is the innermost.
+		const size_t firstInnerGuardOffsetStart = HqSerializerGetStreamPosition(hFuncSerializer);
+		ASSERT_EQ(HqBytecodeEmitInitObject(hFuncSerializer, 0, innerObjStringIndex), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitRaise(hFuncSerializer, 0), HQ_SUCCESS);
+		const size_t firstInnerGuardOffsetEnd = HqSerializerGetStreamPosition(hFuncSerializer);
+
+		// Write an ABORT instruction that should never get called. This also acts as the target
+		// for each of the exception handlers that should never be selected.
+		const size_t abortOffset = HqSerializerGetStreamPosition(hFuncSerializer);
+		ASSERT_EQ(HqBytecodeEmitAbort(hFuncSerializer), HQ_SUCCESS);
+
+		// The innermost block's handler should be selected for the first exception.
+		const size_t firstInnerHandlerOffset = HqSerializerGetStreamPosition(hFuncSerializer);
+		ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 1, 1), HQ_SUCCESS);
+
+		// Raise the same object type from a block that starts after the outer block.
+		const size_t secondInnerGuardOffsetStart = HqSerializerGetStreamPosition(hFuncSerializer);
+		ASSERT_EQ(HqBytecodeEmitInitObject(hFuncSerializer, 0, innerObjStringIndex), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitRaise(hFuncSerializer, 0), HQ_SUCCESS);
+		const size_t secondInnerGuardOffsetEnd = HqSerializerGetStreamPosition(hFuncSerializer);
+
+		ASSERT_EQ(HqBytecodeEmitAbort(hFuncSerializer), HQ_SUCCESS);
+
+		// The second inner block's handler should be selected for the second exception.
+		const size_t secondInnerHandlerOffset = HqSerializerGetStreamPosition(hFuncSerializer);
+		ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 2, 2), HQ_SUCCESS);
+
+		// Raise an object that only the outer block can handle.
+		ASSERT_EQ(HqBytecodeEmitInitObject(hFuncSerializer, 0, outerObjStringIndex), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitRaise(hFuncSerializer, 0), HQ_SUCCESS);
+
+		ASSERT_EQ(HqBytecodeEmitAbort(hFuncSerializer), HQ_SUCCESS);
+
+		const size_t outerGuardOffsetEnd = HqSerializerGetStreamPosition(hFuncSerializer);
+
+		// The outer block's handler should be selected for the last exception.
+		const size_t outerHandlerOffset = HqSerializerGetStreamPosition(hFuncSerializer);
+		ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 3, 3), HQ_SUCCESS);
+
+		// Write a YIELD instruction so we can examine the registers.
+		ASSERT_EQ(HqBytecodeEmitYield(hFuncSerializer), HQ_SUCCESS);
+
+		// Finalize the serializer and add it to the module.
+		Util::FinalizeFunctionSerializer(hFuncSerializer, hModuleWriter, Function::main);
+
+		auto addGuardedBlock = [&hModuleWriter](const size_t offsetStart, const size_t offsetEnd, uint32_t& outBlockId)
+		{
+			ASSERT_EQ(
+				HqModuleWriterAddGuardedBlock(
+					hModuleWriter,
+					Function::main,
+					offsetStart,
+					offsetEnd - offsetStart,
+					&outBlockId
+				),
+				HQ_SUCCESS
+			);
+		};
+
+		auto addExceptionHandler = [&hModuleWriter](const uint32_t blockId, const size_t handlerOffset, const char* const className)
+		{
+			ASSERT_EQ(
+				HqModuleWriterAddExceptionHandler(
+					hModuleWriter,
+					Function::main,
+					blockId,
+					handlerOffset,
+					HQ_VALUE_TYPE_OBJECT,
+					className
+				),
+				HQ_SUCCESS
+			);
+		};
+
+		// Add the outer block first so the inner blocks are not already in nesting order.
+		uint32_t outerBlockId = 0;
+		uint32_t firstInnerBlockId = 0;
+		uint32_t secondInnerBlockId = 0;
+		addGuardedBlock(outerGuardOffsetStart, outerGuardOffsetEnd, outerBlockId);
+		addGuardedBlock(firstInnerGuardOffsetStart, firstInnerGuardOffsetEnd, firstInnerBlockId);
+		addGuardedBlock(secondInnerGuardOffsetStart, secondInnerGuardOffsetEnd, secondInnerBlockId);
+
+		addExceptionHandler(outerBlockId, abortOffset, innerObjTypeName);
+		addExceptionHandler(outerBlockId, outerHandlerOffset, outerObjTypeName);
+		addExceptionHandler(firstInnerBlockId, firstInnerHandlerOffset, innerObjTypeName);
+		addExceptionHandler(secondInnerBlockId, secondInnerHandlerOffset, innerObjTypeName);
+	};
+
+	auto runtimeCallback = [](HqVmHandle hVm, HqExecutionHandle hExec)
+	{
+		(void) hVm;
+
+		// Run the execution context.
+		const int execRunResult = HqExecutionRun(hExec, HQ_RUN_FULL);
+		ASSERT_EQ(execRunResult, HQ_SUCCESS);
+
+		// Get the status of the execution context.
+		ExecStatus status;
+		Util::GetExecutionStatus(status, hExec);
+		ASSERT_TRUE(status.yield);
+		ASSERT_TRUE(status.running);
 		ASSERT_FALSE(status.complete);
-		ASSERT_TRUE(status.exception);
+		ASSERT_FALSE(status.exception);
 		ASSERT_FALSE(status.abort);
 
-		// Verify the handled exception value.
+		// Verify each of the expected exception handlers was run.
+		for(uint32_t gpRegIndex = 1; gpRegIndex <= 3; ++gpRegIndex)
 		{
-			// Get the register value we want to inspect.
 			HqValueHandle hValue = HQ_VALUE_HANDLE_NULL;
-			Util::GetIoRegister(hValue, hExec, 0);
+			Util::GetGpRegister(hValue, hExec, gpRegIndex);
 
-			// Validate the register value.
 			ASSERT_NE(hValue, HQ_VALUE_HANDLE_NULL);
 			ASSERT_TRUE(HqValueIsInt32(hValue));
-			ASSERT_EQ(HqValueGetInt32(hValue), testValueData);
+			EXPECT_EQ(HqValueGetInt32(hValue), int32_t(gpRegIndex));
+		}
+
+		// Verify the last handled exception value.
+		{
+			HqValueHandle hValue = HQ_VALUE_HANDLE_NULL;
+			Util::GetIoRegister(hValue, hExec, 0);
+
+			ASSERT_NE(hValue, HQ_VALUE_HANDLE_NULL);
+			ASSERT_TRUE(HqValueIsObject(hValue));
+			ASSERT_STREQ(HqValueGetObjectTypeName(hValue), outerObjTypeName);
 		}
 	};
 
@@ -13699,10 +14603,14 @@ TEST_F(_HQ_TEST_NAME(TestOpCodes), Move)
 		Util::GetGpRegister(hOriginalValue, hExec, 0);
 		Util::GetGpRegister(hMovedValue, hExec, 1);
 
-		// Validate the register values.
+		// Validate the register values. Primitives are copied rather than shared,
+		// so the registers only need to hold equal values.
 		ASSERT_NE(hOriginalValue, HQ_VALUE_HANDLE_NULL);
 		ASSERT_NE(hMovedValue, HQ_VALUE_HANDLE_NULL);
-		ASSERT_EQ(hOriginalValue, hMovedValue);
+		ASSERT_TRUE(HqValueIsInt8(hOriginalValue));
+		ASSERT_TRUE(HqValueIsInt8(hMovedValue));
+		ASSERT_EQ(HqValueGetInt8(hOriginalValue), 123);
+		ASSERT_EQ(HqValueGetInt8(hMovedValue), 123);
 	};
 
 	std::vector<uint8_t> bytecode;
@@ -14544,3 +15452,399 @@ TEST_F(_HQ_TEST_NAME(TestOpCodes), Copy)
 }
 
 //----------------------------------------------------------------------------------------------------------------------
+
+TEST_F(_HQ_TEST_NAME(TestOpCodes), Profile)
+{
+	static constexpr size_t nopCount = 10;
+
+	auto compilerCallback = [](HqModuleWriterHandle hModuleWriter, int endianness)
+	{
+		HqSerializerHandle hFuncSerializer = HQ_SERIALIZER_HANDLE_NULL;
+
+		// Set the function serializer.
+		Util::SetupFunctionSerializer(hFuncSerializer, endianness);
+
+		// Write a known number of instructions so we can check how many times they were counted.
+		for(size_t i = 0; i < nopCount; ++i)
+		{
+			const int writeNopInstrResult = HqBytecodeEmitNop(hFuncSerializer);
+			ASSERT_EQ(writeNopInstrResult, HQ_SUCCESS);
+		}
+
+		// Finalize the serializer and add it to the module.
+		Util::FinalizeFunctionSerializer(hFuncSerializer, hModuleWriter, Function::main);
+	};
+
+	auto runtimeCallback = [](HqVmHandle hVm, HqExecutionHandle hExec)
+	{
+		(void) hVm;
+
+		struct ProfileData
+		{
+			uint64_t nopCount;
+			uint64_t returnCount;
+			uint64_t mainCount;
+			size_t functionCount;
+		};
+
+		auto onOpCode = [](void* const pUserData, const char* const name, const HqProfileCounter* const pCounter) -> bool
+		{
+			ProfileData& data = *reinterpret_cast<ProfileData*>(pUserData);
+
+			if(strcmp(name, "NOP") == 0)
+			{
+				data.nopCount = pCounter->count;
+			}
+			else if(strcmp(name, "RETURN") == 0)
+			{
+				data.returnCount = pCounter->count;
+			}
+
+			return true;
+		};
+
+		auto onFunction = [](void* const pUserData, HqFunctionHandle hFunction, const HqProfileCounter* const pCounter) -> bool
+		{
+			ProfileData& data = *reinterpret_cast<ProfileData*>(pUserData);
+
+			const char* signature = nullptr;
+			HqFunctionGetSignature(hFunction, &signature);
+
+			if(signature && strcmp(signature, Function::main) == 0)
+			{
+				data.mainCount = pCounter->count;
+			}
+
+			++data.functionCount;
+			return true;
+		};
+
+		ASSERT_EQ(HqExecutionSetProfilingEnabled(HQ_EXECUTION_HANDLE_NULL, true), HQ_ERROR_INVALID_ARG);
+		ASSERT_EQ(HqExecutionSetProfilingEnabled(hExec, true), HQ_SUCCESS);
+
+		// Run the execution context.
+		const int execRunResult = HqExecutionRun(hExec, HQ_RUN_FULL);
+		ASSERT_EQ(execRunResult, HQ_SUCCESS);
+
+		// Get the status of the execution context.
+		ExecStatus status;
+		Util::GetExecutionStatus(status, hExec);
+		ASSERT_TRUE(status.complete);
+
+		ProfileData data = {};
+
+		ASSERT_EQ(HqExecutionGetProfile(hExec, nullptr, nullptr, &data), HQ_ERROR_INVALID_ARG);
+		ASSERT_EQ(HqExecutionGetProfile(hExec, onOpCode, onFunction, &data), HQ_SUCCESS);
+		EXPECT_EQ(data.nopCount, nopCount);
+		EXPECT_EQ(data.returnCount, 1u);
+		EXPECT_EQ(data.mainCount, nopCount + 1);
+		EXPECT_EQ(data.functionCount, 1u);
+
+		// Resetting the profile should clear everything that was recorded.
+		ASSERT_EQ(HqExecutionResetProfile(hExec), HQ_SUCCESS);
+
+		data = {};
+
+		ASSERT_EQ(HqExecutionGetProfile(hExec, onOpCode, onFunction, &data), HQ_SUCCESS);
+		EXPECT_EQ(data.nopCount, 0u);
+		EXPECT_EQ(data.functionCount, 0u);
+
+		ASSERT_EQ(HqExecutionSetProfilingEnabled(hExec, false), HQ_SUCCESS);
+	};
+
+	std::vector<uint8_t> bytecode;
+
+	// Construct the module bytecode for the test.
+	Util::CompileBytecode(bytecode, compilerCallback);
+	ASSERT_GT(bytecode.size(), 0u);
+
+	// Run the module bytecode.
+	Util::ProcessBytecode("TestOpCodes", Function::main, runtimeCallback, bytecode);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_F(_HQ_TEST_NAME(TestOpCodes), Profile_YieldExcludesSuspendedTime)
+{
+	auto compilerCallback = [](HqModuleWriterHandle hModuleWriter, int endianness)
+	{
+		HqSerializerHandle hFuncSerializer = HQ_SERIALIZER_HANDLE_NULL;
+
+		// Set the function serializer.
+		Util::SetupFunctionSerializer(hFuncSerializer, endianness);
+
+		// Write the instruction that we're going to test.
+		const int writeYieldInstrResult = HqBytecodeEmitYield(hFuncSerializer);
+		ASSERT_EQ(writeYieldInstrResult, HQ_SUCCESS);
+
+		// Finalize the serializer and add it to the module.
+		Util::FinalizeFunctionSerializer(hFuncSerializer, hModuleWriter, Function::main);
+	};
+
+	auto runtimeCallback = [](HqVmHandle hVm, HqExecutionHandle hExec)
+	{
+		(void) hVm;
+
+		static constexpr uint32_t suspendTimeMs = 100;
+
+		auto onOpCode = [](void* const pUserData, const char* const name, const HqProfileCounter* const pCounter) -> bool
+		{
+			if(strcmp(name, "YIELD") == 0)
+			{
+				(*reinterpret_cast<HqProfileCounter*>(pUserData)) = (*pCounter);
+			}
+
+			return true;
+		};
+
+		auto onFunction = [](void*, HqFunctionHandle, const HqProfileCounter*) -> bool
+		{
+			return true;
+		};
+
+		ASSERT_EQ(HqExecutionSetProfilingEnabled(hExec, true), HQ_SUCCESS);
+
+		// Run the execution context up to the yield.
+		ASSERT_EQ(HqExecutionRun(hExec, HQ_RUN_FULL), HQ_SUCCESS);
+
+		ExecStatus status;
+		Util::GetExecutionStatus(status, hExec);
+		ASSERT_TRUE(status.yield);
+
+		// Leave the script suspended for a while before resuming it.
+		std::this_thread::sleep_for(std::chrono::milliseconds(suspendTimeMs));
+
+		ASSERT_EQ(HqExecutionRun(hExec, HQ_RUN_FULL), HQ_SUCCESS);
+
+		Util::GetExecutionStatus(status, hExec);
+		ASSERT_TRUE(status.complete);
+
+		HqProfileCounter yieldCounter = {};
+		ASSERT_EQ(HqExecutionGetProfile(hExec, onOpCode, onFunction, &yieldCounter), HQ_SUCCESS);
+
+		// The time the script spent suspended should not be charged to the YIELD instruction.
+		const uint64_t suspendTime = (HqClockGetFrequency() * suspendTimeMs) / 1000;
+
+		EXPECT_EQ(yieldCounter.count, 1u);
+		EXPECT_LT(yieldCounter.time, suspendTime / 2);
+
+		ASSERT_EQ(HqExecutionSetProfilingEnabled(hExec, false), HQ_SUCCESS);
+	};
+
+	std::vector<uint8_t> bytecode;
+
+	// Construct the module bytecode for the test.
+	Util::CompileBytecode(bytecode, compilerCallback);
+	ASSERT_GT(bytecode.size(), 0u);
+
+	// Run the module bytecode.
+	Util::ProcessBytecode("TestOpCodes", Function::main, runtimeCallback, bytecode);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_F(_HQ_TEST_NAME(TestOpCodes), SampleProfiler_RunningScript)
+{
+	static constexpr int32_t iterationCount = 10000;
+	static constexpr size_t addCount = 8;
+
+	auto compilerCallback = [](HqModuleWriterHandle hModuleWriter, int endianness)
+	{
+		HqSerializerHandle hFuncSerializer = HQ_SERIALIZER_HANDLE_NULL;
+
+		// Set the function serializer.
+		Util::SetupFunctionSerializer(hFuncSerializer, endianness);
+
+		ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 0, 0), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 1, 1), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 2, iterationCount), HQ_SUCCESS);
+
+		const size_t loopStart = HqSerializerGetStreamPosition(hFuncSerializer);
+
+		// The backward jump is the only safepoint in the loop, so sampling at safepoints would only ever see that.
+		for(size_t i = 0; i < addCount; ++i)
+		{
+			ASSERT_EQ(HqBytecodeEmitAdd(hFuncSerializer, 3, 3, 1), HQ_SUCCESS);
+		}
+
+		ASSERT_EQ(HqBytecodeEmitAdd(hFuncSerializer, 0, 0, 1), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitCompareLess(hFuncSerializer, 4, 0, 2), HQ_SUCCESS);
+
+		const size_t loopEnd = HqSerializerGetStreamPosition(hFuncSerializer);
+
+		ASSERT_EQ(HqBytecodeEmitJumpIfTrue(hFuncSerializer, 4, int32_t(loopStart) - int32_t(loopEnd)), HQ_SUCCESS);
+
+		// Finalize the serializer and add it to the module.
+		Util::FinalizeFunctionSerializer(hFuncSerializer, hModuleWriter, Function::main);
+	};
+
+	auto runtimeCallback = [](HqVmHandle hVm, HqExecutionHandle hExec)
+	{
+		auto onLine = [](void* const pUserData, const char* const line) -> bool
+		{
+			std::set<std::string>& offsets = *reinterpret_cast<std::set<std::string>*>(pUserData);
+
+			// Each line is the folded stack followed by its sample count.
+			const std::string stack(line, strrchr(line, ' '));
+			if(stack.find("void main()+") == 0)
+			{
+				offsets.insert(stack);
+			}
+
+			return true;
+		};
+
+		// The sampler doesn't need scripts to stop at safepoints, so it works without the GC thread.
+		ASSERT_EQ(HqVmStartSampleProfiler(hVm, 1, true), HQ_SUCCESS);
+
+		std::atomic<bool> stop(false);
+		int runResult = HQ_SUCCESS;
+
+		// Keep running the script on another thread until the sampler has seen enough of it.
+		std::thread worker(
+			[hExec, &stop, &runResult]()
+			{
+				while(!stop && runResult == HQ_SUCCESS)
+				{
+					runResult = HqExecutionRun(hExec, HQ_RUN_FULL);
+					if(runResult == HQ_SUCCESS)
+					{
+						runResult = HqExecutionReset(hExec);
+					}
+				}
+			}
+		);
+
+		std::set<std::string> offsets;
+
+		for(int i = 0; i < 1000 && offsets.size() < 3; ++i)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+			ASSERT_EQ(HqVmWriteSampleProfile(hVm, onLine, &offsets), HQ_SUCCESS);
+		}
+
+		stop = true;
+		worker.join();
+
+		ASSERT_EQ(HqVmStopSampleProfiler(hVm), HQ_SUCCESS);
+		ASSERT_EQ(runResult, HQ_SUCCESS);
+
+		// Samples should land on whichever instruction the script happened to be running.
+		EXPECT_GE(offsets.size(), 3u);
+	};
+
+	std::vector<uint8_t> bytecode;
+
+	// Construct the module bytecode for the test.
+	Util::CompileBytecode(bytecode, compilerCallback);
+	ASSERT_GT(bytecode.size(), 0u);
+
+	// Run the module bytecode.
+	Util::ProcessBytecode("TestOpCodes", Function::main, runtimeCallback, bytecode);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static void _ExpectMalformedFunctionRejected(const std::vector<uint8_t>& funcBytecode)
+{
+	auto compilerCallback = [&funcBytecode](HqModuleWriterHandle hModuleWriter, int endianness)
+	{
+		(void) endianness;
+
+		ASSERT_EQ(HqModuleWriterSetBytecodeEncoding(hModuleWriter, HQ_BYTECODE_ENCODING_COMPACT), HQ_SUCCESS);
+
+		// Add the function bytecode as-is since it can't be finalized with a RETURN at the end.
+		ASSERT_EQ(
+			HqModuleWriterAddFunction(hModuleWriter, Function::main, funcBytecode.data(), funcBytecode.size(), 0, 0),
+			HQ_SUCCESS
+		);
+	};
+
+	std::vector<uint8_t> bytecode;
+
+	// Construct the module bytecode for the test.
+	Util::CompileBytecode(bytecode, compilerCallback);
+	ASSERT_GT(bytecode.size(), 0u);
+
+	Memory::Instance.SetContext("runtime");
+
+	const HqVmInit init = GetDefaultHqVmInit(nullptr, nullptr, HQ_MESSAGE_TYPE_FATAL);
+
+	HqVmHandle hVm = HQ_VM_HANDLE_NULL;
+	ASSERT_EQ(HqVmCreate(&hVm, init), HQ_SUCCESS);
+
+	// The module must be rejected before anything is read from outside the function.
+	EXPECT_NE(HqVmLoadModule(hVm, "TestOpCodes", bytecode.data(), bytecode.size()), HQ_SUCCESS);
+
+	HqFunctionHandle hFunction = HQ_FUNCTION_HANDLE_NULL;
+	EXPECT_NE(HqVmGetFunction(hVm, &hFunction, Function::main), HQ_SUCCESS);
+
+	ASSERT_EQ(HqVmDispose(&hVm), HQ_SUCCESS);
+
+	// Verify all memory has been freed.
+	Memory::Instance.Validate();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static void _EmitCompactLoadImmI32(std::vector<uint8_t>& output, const int32_t value)
+{
+	HqSerializerHandle hFuncSerializer = HQ_SERIALIZER_HANDLE_NULL;
+	Util::SetupFunctionSerializer(hFuncSerializer, HQ_ENDIAN_ORDER_NATIVE);
+	ASSERT_EQ(HqBytecodeSetEncoding(hFuncSerializer, HQ_BYTECODE_ENCODING_COMPACT), HQ_SUCCESS);
+
+	ASSERT_EQ(HqBytecodeEmitLoadImmI32(hFuncSerializer, 0, value), HQ_SUCCESS);
+
+	const uint8_t* const pData = reinterpret_cast<const uint8_t*>(HqSerializerGetRawStreamPointer(hFuncSerializer));
+	output.assign(pData, pData + HqSerializerGetStreamLength(hFuncSerializer));
+
+	ASSERT_EQ(HqSerializerDispose(&hFuncSerializer), HQ_SUCCESS);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_F(_HQ_TEST_NAME(TestOpCodes), LoadModule$TruncatedOperand)
+{
+	std::vector<uint8_t> funcBytecode;
+
+	// The smallest int32 needs every byte of its variable-width encoding.
+	_EmitCompactLoadImmI32(funcBytecode, INT32_MIN);
+	ASSERT_GT(funcBytecode.size(), 2u);
+
+	// Drop the final byte of the operand so it would continue into whatever follows the function.
+	funcBytecode.pop_back();
+
+	_ExpectMalformedFunctionRejected(funcBytecode);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_F(_HQ_TEST_NAME(TestOpCodes), LoadModule$OverlongOperand)
+{
+	std::vector<uint8_t> funcBytecode;
+
+	_EmitCompactLoadImmI32(funcBytecode, INT32_MIN);
+	ASSERT_GT(funcBytecode.size(), 2u);
+
+	// Extend the operand by one more byte than a 32-bit value can use. The function still
+	// ends with a valid RETURN, so only the operand length is wrong.
+	funcBytecode.back() |= 0x80;
+	funcBytecode.push_back(0x00);
+
+	{
+		HqSerializerHandle hFuncSerializer = HQ_SERIALIZER_HANDLE_NULL;
+		Util::SetupFunctionSerializer(hFuncSerializer, HQ_ENDIAN_ORDER_NATIVE);
+		ASSERT_EQ(HqBytecodeSetEncoding(hFuncSerializer, HQ_BYTECODE_ENCODING_COMPACT), HQ_SUCCESS);
+		ASSERT_EQ(HqBytecodeEmitReturn(hFuncSerializer), HQ_SUCCESS);
+
+		const uint8_t* const pData = reinterpret_cast<const uint8_t*>(HqSerializerGetRawStreamPointer(hFuncSerializer));
+		funcBytecode.insert(funcBytecode.end(), pData, pData + HqSerializerGetStreamLength(hFuncSerializer));
+
+		ASSERT_EQ(HqSerializerDispose(&hFuncSerializer), HQ_SUCCESS);
+	}
+
+	_ExpectMalformedFunctionRejected(funcBytecode);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -38,7 +38,7 @@ public:
 
 //----------------------------------------------------------------------------------------------------------------------
 
-TEST_F(_HQ_TEST_NAME(TestSamples), ComputeCovarianceMatrix)
+static void _RunComputeCovarianceMatrix(const int bytecodeEncoding)
 {
 	enum
 	{
@@ -94,7 +94,7 @@ TEST_F(_HQ_TEST_NAME(TestSamples), ComputeCovarianceMatrix)
 		"z",
 	};
 
-	auto compilerCallback = [](HqModuleWriterHandle hModuleWriter, int endianness)
+	auto compilerCallback = [bytecodeEncoding](HqModuleWriterHandle hModuleWriter, int endianness)
 	{
 		HqSerializerHandle hFuncSerializer = HQ_SERIALIZER_HANDLE_NULL;
 
@@ -107,6 +107,8 @@ TEST_F(_HQ_TEST_NAME(TestSamples), ComputeCovarianceMatrix)
 		uint32_t matVarIdx[MATRIX__COUNT];
 		uint32_t vecVarIdx[VECTOR__COUNT];
 
+		ASSERT_EQ(HqModuleWriterSetBytecodeEncoding(hModuleWriter, bytecodeEncoding), HQ_SUCCESS);
+
 		// Add our custom object types to the module.
 		for(size_t i = 0; i < TYPE__COUNT; ++i)
 		{
@@ -154,6 +156,7 @@ TEST_F(_HQ_TEST_NAME(TestSamples), ComputeCovarianceMatrix)
 
 		// Set the function serializer.
 		Util::SetupFunctionSerializer(hFuncSerializer, endianness);
+		ASSERT_EQ(HqBytecodeSetEncoding(hFuncSerializer, bytecodeEncoding), HQ_SUCCESS);
 		{
 			// Initialize our output values.
 			const uint32_t outMatrixReg = gpRegStart++;
@@ -474,3 +477,17 @@ TEST_F(_HQ_TEST_NAME(TestSamples), ComputeCovarianceMatrix)
 }
 
 //----------------------------------------------------------------------------------------------------------------------
+
+TEST_F(_HQ_TEST_NAME(TestSamples), ComputeCovarianceMatrix)
+{
+	_RunComputeCovarianceMatrix(HQ_BYTECODE_ENCODING_STANDARD);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST_F(_HQ_TEST_NAME(TestSamples), ComputeCovarianceMatrixCompact)
+{
+	_RunComputeCovarianceMatrix(HQ_BYTECODE_ENCODING_COMPACT);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -128,3 +128,106 @@ TEST(_HQ_TEST_NAME(TestAllocator), AllocReallocThenFree)
 }
 
 //----------------------------------------------------------------------------------------------------------------------
+
+TEST(_HQ_TEST_NAME(TestAllocator), SlabAllocatorOccupancy)
+{
+	const size_t sizeClassCount = HqMemGetSlabSizeClassCount();
+	ASSERT_GT(sizeClassCount, 0u);
+
+	HqMemSlabStats stats;
+
+	// Verify invalid arguments are rejected.
+	EXPECT_EQ(HqMemGetSlabStats(0, nullptr), HQ_ERROR_INVALID_ARG);
+	EXPECT_EQ(HqMemGetSlabStats(sizeClassCount, &stats), HQ_ERROR_INDEX_OUT_OF_RANGE);
+
+	HqVmInit init = GetDefaultHqVmInit(nullptr, nullptr, HQ_MESSAGE_TYPE_FATAL);
+	init.useSlabAllocator = true;
+
+	HqVmHandle hVm = HQ_VM_HANDLE_NULL;
+	ASSERT_EQ(HqVmCreate(&hVm, init), HQ_SUCCESS);
+
+	HqValueHandle hValue = HqValueCreateInt32(hVm, 123);
+	ASSERT_NE(hValue, HQ_VALUE_HANDLE_NULL);
+
+	size_t slabCount = 0;
+	size_t blocksInUse = 0;
+
+	for(size_t i = 0; i < sizeClassCount; ++i)
+	{
+		ASSERT_EQ(HqMemGetSlabStats(i, &stats), HQ_SUCCESS);
+		EXPECT_LE(stats.blocksInUse, stats.blockCapacity);
+
+		slabCount += stats.slabCount;
+		blocksInUse += stats.blocksInUse;
+	}
+
+	// The value object should have been allocated from a slab.
+	EXPECT_GT(slabCount, 0u);
+	EXPECT_GT(blocksInUse, 0u);
+
+	EXPECT_EQ(HqVmDispose(&hVm), HQ_SUCCESS);
+
+	// All slabs should be released once the last VM using them is gone.
+	for(size_t i = 0; i < sizeClassCount; ++i)
+	{
+		ASSERT_EQ(HqMemGetSlabStats(i, &stats), HQ_SUCCESS);
+		EXPECT_EQ(stats.slabCount, 0u);
+		EXPECT_EQ(stats.blocksInUse, 0u);
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST(_HQ_TEST_NAME(TestAllocator), SlabAllocatorIsPerVm)
+{
+	auto getBlocksInUse = []() -> size_t
+	{
+		size_t total = 0;
+
+		for(size_t i = 0; i < HqMemGetSlabSizeClassCount(); ++i)
+		{
+			HqMemSlabStats stats;
+			HqMemGetSlabStats(i, &stats);
+
+			total += stats.blocksInUse;
+		}
+
+		return total;
+	};
+
+	HqVmInit heapInit = GetDefaultHqVmInit(nullptr, nullptr, HQ_MESSAGE_TYPE_FATAL);
+	heapInit.useSlabAllocator = false;
+
+	HqVmInit slabInit = GetDefaultHqVmInit(nullptr, nullptr, HQ_MESSAGE_TYPE_FATAL);
+	slabInit.useSlabAllocator = true;
+
+	HqVmHandle hHeapVm = HQ_VM_HANDLE_NULL;
+	ASSERT_EQ(HqVmCreate(&hHeapVm, heapInit), HQ_SUCCESS);
+
+	HqVmHandle hSlabVm = HQ_VM_HANDLE_NULL;
+	ASSERT_EQ(HqVmCreate(&hSlabVm, slabInit), HQ_SUCCESS);
+
+	const size_t baseBlocksInUse = getBlocksInUse();
+
+	// Values created by the VM without slabs should not come from the other VM's slabs.
+	HqValueHandle hHeapValue = HqValueCreateInt32(hHeapVm, 123);
+	ASSERT_NE(hHeapValue, HQ_VALUE_HANDLE_NULL);
+	EXPECT_EQ(getBlocksInUse(), baseBlocksInUse);
+
+	HqValueHandle hSlabValue = HqValueCreateInt32(hSlabVm, 456);
+	ASSERT_NE(hSlabValue, HQ_VALUE_HANDLE_NULL);
+	EXPECT_EQ(getBlocksInUse(), baseBlocksInUse + 1);
+
+	ASSERT_EQ(HqValueGcExpose(hSlabValue), HQ_SUCCESS);
+	EXPECT_EQ(HqVmDispose(&hSlabVm), HQ_SUCCESS);
+
+	// Disposing of the VM with slabs releases all of them while the other VM carries on as before.
+	EXPECT_EQ(getBlocksInUse(), 0u);
+	EXPECT_EQ(HqValueGetInt32(hHeapValue), 123);
+
+	ASSERT_EQ(HqValueGcExpose(hHeapValue), HQ_SUCCESS);
+	ASSERT_EQ(HqVmRunGarbageCollector(hHeapVm, HQ_RUN_FULL), HQ_SUCCESS);
+	EXPECT_EQ(HqVmDispose(&hHeapVm), HQ_SUCCESS);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
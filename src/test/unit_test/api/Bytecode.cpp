@@ -0,0 +1,204 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include "../../common/Util.h"
+
+#include <gtest/gtest.h>
+
+#include <string.h>
+#include <vector>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static HqSerializerHandle _CreateBytecodeWriter(const int encoding)
+{
+	HqSerializerHandle hSerializer = HQ_SERIALIZER_HANDLE_NULL;
+
+	EXPECT_EQ(HqSerializerCreate(&hSerializer, HQ_SERIALIZER_MODE_WRITER), HQ_SUCCESS);
+	EXPECT_EQ(HqBytecodeSetEncoding(hSerializer, encoding), HQ_SUCCESS);
+
+	return hSerializer;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static std::vector<uint8_t> _GetStreamBytes(HqSerializerHandle hSerializer, const size_t skipLength)
+{
+	const uint8_t* const pStream = reinterpret_cast<const uint8_t*>(HqSerializerGetRawStreamPointer(hSerializer));
+	const size_t streamLength = HqSerializerGetStreamLength(hSerializer);
+
+	if(!pStream || streamLength < skipLength)
+	{
+		return std::vector<uint8_t>();
+	}
+
+	return std::vector<uint8_t>(pStream + skipLength, pStream + streamLength);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST(_HQ_TEST_NAME(TestBytecode), CompactUnsignedVarInt)
+{
+	struct TestCase
+	{
+		uint32_t value;
+		std::vector<uint8_t> expected;
+	};
+
+	const TestCase testCases[] =
+	{
+		{ 0,          { 0x00 } },
+		{ 127,        { 0x7F } },
+		{ 128,        { 0x80, 0x01 } },
+		{ 16383,      { 0xFF, 0x7F } },
+		{ 16384,      { 0x80, 0x80, 0x01 } },
+		{ UINT32_MAX, { 0xFF, 0xFF, 0xFF, 0xFF, 0x0F } },
+	};
+
+	for(const TestCase& testCase : testCases)
+	{
+		HqSerializerHandle hSerializer = _CreateBytecodeWriter(HQ_BYTECODE_ENCODING_COMPACT);
+		ASSERT_NE(hSerializer, HQ_SERIALIZER_HANDLE_NULL);
+
+		// String indices are written as unsigned varints after the 1-byte opcode.
+		EXPECT_EQ(HqBytecodeEmitCall(hSerializer, testCase.value), HQ_SUCCESS);
+		EXPECT_EQ(_GetStreamBytes(hSerializer, 1), testCase.expected) << "value=" << testCase.value;
+
+		EXPECT_EQ(HqSerializerDispose(&hSerializer), HQ_SUCCESS);
+	}
+
+	// 64-bit immediates use the full 10 byte encoding at their maximum.
+	HqSerializerHandle hSerializer = _CreateBytecodeWriter(HQ_BYTECODE_ENCODING_COMPACT);
+	ASSERT_NE(hSerializer, HQ_SERIALIZER_HANDLE_NULL);
+
+	const std::vector<uint8_t> expected = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01 };
+
+	EXPECT_EQ(HqBytecodeEmitLoadImmU64(hSerializer, 0, UINT64_MAX), HQ_SUCCESS);
+	EXPECT_EQ(_GetStreamBytes(hSerializer, 2), expected);
+
+	EXPECT_EQ(HqSerializerDispose(&hSerializer), HQ_SUCCESS);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST(_HQ_TEST_NAME(TestBytecode), CompactSignedVarInt)
+{
+	struct TestCase
+	{
+		int64_t value;
+		std::vector<uint8_t> expected;
+	};
+
+	// Signed values are zigzag encoded before being written as unsigned varints.
+	const TestCase testCases[] =
+	{
+		{ 0,         { 0x00 } },
+		{ -1,        { 0x01 } },
+		{ 63,        { 0x7E } },
+		{ -64,       { 0x7F } },
+		{ 64,        { 0x80, 0x01 } },
+		{ -65,       { 0x81, 0x01 } },
+		{ INT64_MAX, { 0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01 } },
+		{ INT64_MIN, { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01 } },
+	};
+
+	for(const TestCase& testCase : testCases)
+	{
+		HqSerializerHandle hSerializer = _CreateBytecodeWriter(HQ_BYTECODE_ENCODING_COMPACT);
+		ASSERT_NE(hSerializer, HQ_SERIALIZER_HANDLE_NULL);
+
+		// Skip the 1-byte opcode and the 1-byte register.
+		EXPECT_EQ(HqBytecodeEmitLoadImmI64(hSerializer, 0, testCase.value), HQ_SUCCESS);
+		EXPECT_EQ(_GetStreamBytes(hSerializer, 2), testCase.expected) << "value=" << testCase.value;
+
+		EXPECT_EQ(HqSerializerDispose(&hSerializer), HQ_SUCCESS);
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST(_HQ_TEST_NAME(TestBytecode), NegativeJumpOffset)
+{
+	const int encodings[] =
+	{
+		HQ_BYTECODE_ENCODING_STANDARD,
+		HQ_BYTECODE_ENCODING_COMPACT,
+	};
+
+	const int32_t offsets[] =
+	{
+		-1,
+		-128,
+		-129,
+		INT32_MIN,
+	};
+
+	for(const int encoding : encodings)
+	{
+		const size_t opCodeLength = (encoding == HQ_BYTECODE_ENCODING_COMPACT) ? 1 : 4;
+
+		for(const int32_t offset : offsets)
+		{
+			HqSerializerHandle hSerializer = _CreateBytecodeWriter(encoding);
+			ASSERT_NE(hSerializer, HQ_SERIALIZER_HANDLE_NULL);
+
+			// Jump offsets are always written as a full 32-bit value.
+			EXPECT_EQ(HqBytecodeEmitJump(hSerializer, offset), HQ_SUCCESS);
+
+			const std::vector<uint8_t> bytes = _GetStreamBytes(hSerializer, opCodeLength);
+			ASSERT_EQ(bytes.size(), sizeof(int32_t));
+
+			int32_t decodedOffset = 0;
+			memcpy(&decodedOffset, bytes.data(), sizeof(int32_t));
+			EXPECT_EQ(decodedOffset, offset);
+
+			EXPECT_EQ(HqSerializerDispose(&hSerializer), HQ_SUCCESS);
+		}
+	}
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST(_HQ_TEST_NAME(TestBytecode), CompactRegisterOutOfRange)
+{
+	HqSerializerHandle hSerializer = _CreateBytecodeWriter(HQ_BYTECODE_ENCODING_COMPACT);
+	ASSERT_NE(hSerializer, HQ_SERIALIZER_HANDLE_NULL);
+
+	// Compact registers are a single byte, so a larger index must be rejected without writing any part of the instruction.
+	EXPECT_EQ(HqBytecodeEmitLoadImmI32(hSerializer, UINT8_MAX + 1, 0), HQ_ERROR_INVALID_ARG);
+	EXPECT_EQ(HqBytecodeEmitAdd(hSerializer, 0, 1, UINT8_MAX + 1), HQ_ERROR_INVALID_ARG);
+	EXPECT_EQ(HqBytecodeEmitStoreVariable(hSerializer, 0, UINT8_MAX + 1), HQ_ERROR_INVALID_ARG);
+	EXPECT_EQ(HqSerializerGetStreamLength(hSerializer), 0u);
+
+	// The largest single byte index is still valid.
+	EXPECT_EQ(HqBytecodeEmitAdd(hSerializer, 0, 1, UINT8_MAX), HQ_SUCCESS);
+	EXPECT_EQ(HqSerializerGetStreamLength(hSerializer), 4u);
+
+	EXPECT_EQ(HqSerializerDispose(&hSerializer), HQ_SUCCESS);
+
+	// The standard encoding has room for full 32-bit register indices.
+	hSerializer = _CreateBytecodeWriter(HQ_BYTECODE_ENCODING_STANDARD);
+	ASSERT_NE(hSerializer, HQ_SERIALIZER_HANDLE_NULL);
+
+	EXPECT_EQ(HqBytecodeEmitAdd(hSerializer, 0, 1, UINT8_MAX + 1), HQ_SUCCESS);
+	EXPECT_EQ(HqSerializerGetStreamLength(hSerializer), 16u);
+
+	EXPECT_EQ(HqSerializerDispose(&hSerializer), HQ_SUCCESS);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
@@ -20,7 +20,9 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
 #include <string>
+#include <thread>
 #include <vector>
 
 //----------------------------------------------------------------------------------------------------------------------
@@ -247,3 +249,392 @@ TEST(_HQ_TEST_NAME(TestVm), EmptyExecutionContext)
 }
 
 //----------------------------------------------------------------------------------------------------------------------
+
+TEST(_HQ_TEST_NAME(TestVm), GenerationalGarbageCollection)
+{
+	auto getBlocksInUse = []() -> size_t
+	{
+		size_t total = 0;
+
+		for(size_t i = 0; i < HqMemGetSlabSizeClassCount(); ++i)
+		{
+			HqMemSlabStats stats;
+			HqMemGetSlabStats(i, &stats);
+
+			total += stats.blocksInUse;
+		}
+
+		return total;
+	};
+
+	// Use the slab allocator so we can observe when values are released.
+	HqVmInit init = GetDefaultHqVmInit(nullptr, nullptr, HQ_MESSAGE_TYPE_FATAL);
+	init.useSlabAllocator = true;
+
+	HqVmHandle hVm = HQ_VM_HANDLE_NULL;
+	ASSERT_EQ(HqVmCreate(&hVm, init), HQ_SUCCESS);
+
+	// Create an array, then run a minor collection so it gets promoted to the old generation.
+	HqValueHandle hArray = HqValueCreateArray(hVm, 1);
+	ASSERT_NE(hArray, HQ_VALUE_HANDLE_NULL);
+	ASSERT_EQ(HqVmRunGarbageCollector(hVm, HQ_RUN_STEP), HQ_SUCCESS);
+
+	const size_t baseBlocksInUse = getBlocksInUse();
+
+	// Create some young values that nothing references.
+	for(int32_t i = 0; i < 10; ++i)
+	{
+		HqValueHandle hTempValue = HqValueCreateInt32(hVm, i);
+		ASSERT_EQ(HqValueGcExpose(hTempValue), HQ_SUCCESS);
+	}
+
+	EXPECT_EQ(getBlocksInUse(), baseBlocksInUse + 10);
+
+	// Store a young value in the old array, then give up our own reference to it.
+	HqValueHandle hElement = HqValueCreateInt32(hVm, 123);
+	ASSERT_EQ(HqValueSetArrayElement(hArray, 0, hElement), HQ_SUCCESS);
+	ASSERT_EQ(HqValueGcExpose(hElement), HQ_SUCCESS);
+
+	// A minor collection should release the unreferenced values while the array
+	// element is kept alive through the write barrier on the old array.
+	ASSERT_EQ(HqVmRunGarbageCollector(hVm, HQ_RUN_STEP), HQ_SUCCESS);
+	EXPECT_EQ(getBlocksInUse(), baseBlocksInUse + 1);
+
+	// Keep the collector cycling through both generations, allocating along the way so any
+	// memory incorrectly released for the array element would end up getting reused.
+	for(int32_t i = 0; i < 20; ++i)
+	{
+		HqValueHandle hTempValue = HqValueCreateInt32(hVm, -1);
+		ASSERT_EQ(HqValueGcExpose(hTempValue), HQ_SUCCESS);
+		ASSERT_EQ(HqVmRunGarbageCollector(hVm, HQ_RUN_STEP), HQ_SUCCESS);
+	}
+
+	HqValueHandle hLoadedElement = HqValueGetArrayElement(hArray, 0);
+	ASSERT_EQ(hLoadedElement, hElement);
+	EXPECT_EQ(HqValueGetInt32(hLoadedElement), 123);
+
+	ASSERT_EQ(HqValueGcExpose(hArray), HQ_SUCCESS);
+	EXPECT_EQ(HqVmDispose(&hVm), HQ_SUCCESS);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST(_HQ_TEST_NAME(TestVm), ParallelGarbageCollection)
+{
+	auto getBlocksInUse = []() -> size_t
+	{
+		size_t total = 0;
+
+		for(size_t i = 0; i < HqMemGetSlabSizeClassCount(); ++i)
+		{
+			HqMemSlabStats stats;
+			HqMemGetSlabStats(i, &stats);
+
+			total += stats.blocksInUse;
+		}
+
+		return total;
+	};
+
+	const size_t subArrayCount = 8;
+	const size_t elementCount = 64;
+
+	HqVmInit init = GetDefaultHqVmInit(nullptr, nullptr, HQ_MESSAGE_TYPE_FATAL);
+	init.gcMarkThreadCount = 3;
+	init.useSlabAllocator = true;
+
+	HqVmHandle hVm = HQ_VM_HANDLE_NULL;
+	ASSERT_EQ(HqVmCreate(&hVm, init), HQ_SUCCESS);
+
+	// Build a tree of values where only the root array is held by us. Everything
+	// else can only be kept alive by the mark workers discovering it.
+	HqValueHandle hRoot = HqValueCreateArray(hVm, subArrayCount);
+	ASSERT_NE(hRoot, HQ_VALUE_HANDLE_NULL);
+
+	for(size_t i = 0; i < subArrayCount; ++i)
+	{
+		HqValueHandle hSubArray = HqValueCreateArray(hVm, elementCount);
+		ASSERT_NE(hSubArray, HQ_VALUE_HANDLE_NULL);
+
+		for(size_t j = 0; j < elementCount; ++j)
+		{
+			HqValueHandle hElement = HqValueCreateInt32(hVm, int32_t(i * elementCount + j));
+			ASSERT_EQ(HqValueSetArrayElement(hSubArray, j, hElement), HQ_SUCCESS);
+			ASSERT_EQ(HqValueGcExpose(hElement), HQ_SUCCESS);
+		}
+
+		ASSERT_EQ(HqValueSetArrayElement(hRoot, i, hSubArray), HQ_SUCCESS);
+		ASSERT_EQ(HqValueGcExpose(hSubArray), HQ_SUCCESS);
+	}
+
+	const size_t liveBlocksInUse = getBlocksInUse();
+
+	// Create some garbage that nothing references.
+	for(int32_t i = 0; i < 100; ++i)
+	{
+		HqValueHandle hTempValue = HqValueCreateInt32(hVm, i);
+		ASSERT_EQ(HqValueGcExpose(hTempValue), HQ_SUCCESS);
+	}
+
+	EXPECT_EQ(getBlocksInUse(), liveBlocksInUse + 100);
+
+	// Run enough full collections to make sure objects marked by the workers are
+	// correctly sorted back into the collector's lists after each cycle.
+	for(int32_t i = 0; i < 3; ++i)
+	{
+		ASSERT_EQ(HqVmRunGarbageCollector(hVm, HQ_RUN_FULL), HQ_SUCCESS);
+		EXPECT_EQ(getBlocksInUse(), liveBlocksInUse);
+	}
+
+	for(size_t i = 0; i < subArrayCount; ++i)
+	{
+		HqValueHandle hSubArray = HqValueGetArrayElement(hRoot, i);
+		ASSERT_NE(hSubArray, HQ_VALUE_HANDLE_NULL);
+
+		for(size_t j = 0; j < elementCount; ++j)
+		{
+			HqValueHandle hElement = HqValueGetArrayElement(hSubArray, j);
+			ASSERT_NE(hElement, HQ_VALUE_HANDLE_NULL);
+			EXPECT_EQ(HqValueGetInt32(hElement), int32_t(i * elementCount + j));
+		}
+	}
+
+	ASSERT_EQ(HqValueGcExpose(hRoot), HQ_SUCCESS);
+	EXPECT_EQ(HqVmDispose(&hVm), HQ_SUCCESS);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST(_HQ_TEST_NAME(TestVm), GarbageCollectorStats)
+{
+	HqVmInit init = GetDefaultHqVmInit(nullptr, nullptr, HQ_MESSAGE_TYPE_FATAL);
+
+	HqVmHandle hVm = HQ_VM_HANDLE_NULL;
+	ASSERT_EQ(HqVmCreate(&hVm, init), HQ_SUCCESS);
+
+	HqGcStats stats;
+	EXPECT_EQ(HqVmGetGcStats(HQ_VM_HANDLE_NULL, &stats), HQ_ERROR_INVALID_ARG);
+	EXPECT_EQ(HqVmGetGcStats(hVm, nullptr), HQ_ERROR_INVALID_ARG);
+
+	HqGcStats baseStats;
+	ASSERT_EQ(HqVmGetGcStats(hVm, &baseStats), HQ_SUCCESS);
+
+	// Create some garbage that nothing references.
+	for(int32_t i = 0; i < 100; ++i)
+	{
+		HqValueHandle hTempValue = HqValueCreateInt32(hVm, i);
+		ASSERT_EQ(HqValueGcExpose(hTempValue), HQ_SUCCESS);
+	}
+
+	ASSERT_EQ(HqVmGetGcStats(hVm, &stats), HQ_SUCCESS);
+	EXPECT_EQ(stats.linkedObjectCount, baseStats.linkedObjectCount + 100);
+	EXPECT_EQ(stats.pendingObjectCount, baseStats.pendingObjectCount + 100);
+	EXPECT_EQ(stats.heapObjectCount, baseStats.heapObjectCount + 100);
+	EXPECT_GT(stats.linkedSize, baseStats.linkedSize);
+
+	ASSERT_EQ(HqVmRunGarbageCollector(hVm, HQ_RUN_FULL), HQ_SUCCESS);
+	ASSERT_EQ(HqVmGetGcStats(hVm, &stats), HQ_SUCCESS);
+
+	// Everything we created should have been collected by the full cycle.
+	EXPECT_EQ(stats.cycleCount, baseStats.cycleCount + 1);
+	EXPECT_EQ(stats.majorCycleCount, baseStats.majorCycleCount + 1);
+	EXPECT_EQ(stats.pauseCount, baseStats.pauseCount + 1);
+	EXPECT_EQ(stats.pendingObjectCount, 0u);
+	EXPECT_GE(stats.disposedObjectCount, baseStats.disposedObjectCount + 100);
+	EXPECT_EQ(stats.heapObjectCount, stats.linkedObjectCount - stats.disposedObjectCount);
+	EXPECT_EQ(stats.heapSize, stats.linkedSize - stats.disposedSize);
+	EXPECT_LE(stats.maxPauseTime, stats.totalPauseTime);
+
+	EXPECT_EQ(HqVmDispose(&hVm), HQ_SUCCESS);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST(_HQ_TEST_NAME(TestVm), GarbageCollectorTypeSizes)
+{
+	HqVmInit init = GetDefaultHqVmInit(nullptr, nullptr, HQ_MESSAGE_TYPE_FATAL);
+
+	HqVmHandle hVm = HQ_VM_HANDLE_NULL;
+	ASSERT_EQ(HqVmCreate(&hVm, init), HQ_SUCCESS);
+
+	// Start from a clean heap so nothing else gets collected along with the objects created below.
+	ASSERT_EQ(HqVmRunGarbageCollector(hVm, HQ_RUN_FULL), HQ_SUCCESS);
+
+	HqGcStats baseStats;
+	ASSERT_EQ(HqVmGetGcStats(hVm, &baseStats), HQ_SUCCESS);
+
+	HqGcStats stats;
+
+	// Each type of object is counted with its own size from the collector's type table.
+	HqExecutionHandle hExec = HQ_EXECUTION_HANDLE_NULL;
+	ASSERT_EQ(HqExecutionCreate(&hExec, hVm), HQ_SUCCESS);
+	ASSERT_EQ(HqVmGetGcStats(hVm, &stats), HQ_SUCCESS);
+	EXPECT_EQ(stats.heapObjectCount, baseStats.heapObjectCount + 1);
+
+	const uint64_t execSize = stats.heapSize - baseStats.heapSize;
+
+	HqValueHandle hValue = HqValueCreateInt32(hVm, 1);
+	ASSERT_NE(hValue, HQ_VALUE_HANDLE_NULL);
+	ASSERT_EQ(HqVmGetGcStats(hVm, &stats), HQ_SUCCESS);
+	EXPECT_EQ(stats.heapObjectCount, baseStats.heapObjectCount + 2);
+
+	const uint64_t valueSize = stats.heapSize - baseStats.heapSize - execSize;
+
+	EXPECT_GT(valueSize, 0u);
+	EXPECT_GT(execSize, valueSize);
+
+	// Both objects are released through the type table and the heap goes back to where it started.
+	ASSERT_EQ(HqValueGcExpose(hValue), HQ_SUCCESS);
+	ASSERT_EQ(HqExecutionDispose(&hExec), HQ_SUCCESS);
+	ASSERT_EQ(HqVmRunGarbageCollector(hVm, HQ_RUN_FULL), HQ_SUCCESS);
+	ASSERT_EQ(HqVmGetGcStats(hVm, &stats), HQ_SUCCESS);
+
+	EXPECT_EQ(stats.heapObjectCount, baseStats.heapObjectCount);
+	EXPECT_EQ(stats.heapSize, baseStats.heapSize);
+	EXPECT_EQ(stats.disposedObjectCount, baseStats.disposedObjectCount + 2);
+	EXPECT_EQ(stats.disposedSize, baseStats.disposedSize + execSize + valueSize);
+
+	EXPECT_EQ(HqVmDispose(&hVm), HQ_SUCCESS);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST(_HQ_TEST_NAME(TestVm), GarbageCollectorContainerStorage)
+{
+	static constexpr size_t elementCount = 1000;
+
+	HqVmInit init = GetDefaultHqVmInit(nullptr, nullptr, HQ_MESSAGE_TYPE_FATAL);
+
+	HqVmHandle hVm = HQ_VM_HANDLE_NULL;
+	ASSERT_EQ(HqVmCreate(&hVm, init), HQ_SUCCESS);
+
+	HqGcStats baseStats;
+	ASSERT_EQ(HqVmGetGcStats(hVm, &baseStats), HQ_SUCCESS);
+
+	// The element storage of a container counts toward the heap, not just the value holding it.
+	HqValueHandle hArray = HqValueCreateArray(hVm, elementCount);
+	ASSERT_NE(hArray, HQ_VALUE_HANDLE_NULL);
+
+	HqGcStats stats;
+	ASSERT_EQ(HqVmGetGcStats(hVm, &stats), HQ_SUCCESS);
+	EXPECT_GE(stats.heapSize - baseStats.heapSize, elementCount * sizeof(HqValueHandle));
+
+	const uint64_t arraySize = stats.heapSize - baseStats.heapSize;
+
+	// Copies own their own storage, so they're counted the same way.
+	HqValueHandle hCopy = HqValueCopy(hVm, hArray);
+	ASSERT_NE(hCopy, HQ_VALUE_HANDLE_NULL);
+	ASSERT_EQ(HqVmGetGcStats(hVm, &stats), HQ_SUCCESS);
+	EXPECT_EQ(stats.heapSize - baseStats.heapSize, arraySize * 2);
+
+	// Collecting the containers takes their storage back off the heap.
+	ASSERT_EQ(HqValueGcExpose(hArray), HQ_SUCCESS);
+	ASSERT_EQ(HqValueGcExpose(hCopy), HQ_SUCCESS);
+	ASSERT_EQ(HqVmRunGarbageCollector(hVm, HQ_RUN_FULL), HQ_SUCCESS);
+	ASSERT_EQ(HqVmGetGcStats(hVm, &stats), HQ_SUCCESS);
+
+	EXPECT_LE(stats.heapSize, baseStats.heapSize);
+	EXPECT_EQ(stats.heapSize, stats.linkedSize - stats.disposedSize);
+
+	EXPECT_EQ(HqVmDispose(&hVm), HQ_SUCCESS);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST(_HQ_TEST_NAME(TestVm), GarbageCollectorPacing)
+{
+	static constexpr uint32_t minTriggerHeapSize = 256 * 1024;
+
+	HqVmInit init = GetDefaultHqVmInit(nullptr, nullptr, HQ_MESSAGE_TYPE_FATAL);
+	init.gcEnableThread = true;
+	init.gcTimeWaitMs = 1;
+	init.gcHeapGrowthPercent = 100;
+	init.gcMinTriggerHeapSize = minTriggerHeapSize;
+
+	HqVmHandle hVm = HQ_VM_HANDLE_NULL;
+	ASSERT_EQ(HqVmCreate(&hVm, init), HQ_SUCCESS);
+
+	// Finishing a collection sets the size the heap needs to grow to before the next one starts.
+	ASSERT_EQ(HqVmRunGarbageCollector(hVm, HQ_RUN_FULL), HQ_SUCCESS);
+
+	HqGcStats baseStats;
+	ASSERT_EQ(HqVmGetGcStats(hVm, &baseStats), HQ_SUCCESS);
+	ASSERT_LT(baseStats.heapSize, minTriggerHeapSize);
+
+	// Nothing is being allocated, so the GC thread has no reason to start a cycle.
+	std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+	HqGcStats stats;
+	ASSERT_EQ(HqVmGetGcStats(hVm, &stats), HQ_SUCCESS);
+	EXPECT_EQ(stats.cycleCount, baseStats.cycleCount);
+
+	// A single large array is enough to reach the trigger since its element storage is counted.
+	HqValueHandle hArray = HqValueCreateArray(hVm, (minTriggerHeapSize * 2) / sizeof(HqValueHandle));
+	ASSERT_NE(hArray, HQ_VALUE_HANDLE_NULL);
+
+	for(int i = 0; i < 500 && stats.cycleCount == baseStats.cycleCount; ++i)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		ASSERT_EQ(HqVmGetGcStats(hVm, &stats), HQ_SUCCESS);
+	}
+
+	EXPECT_GT(stats.cycleCount, baseStats.cycleCount);
+
+	ASSERT_EQ(HqValueGcExpose(hArray), HQ_SUCCESS);
+	EXPECT_EQ(HqVmDispose(&hVm), HQ_SUCCESS);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST(_HQ_TEST_NAME(TestVm), SampleProfiler)
+{
+	auto onLine = [](void* const pUserData, const char* const line) -> bool
+	{
+		(void) line;
+
+		++(*reinterpret_cast<size_t*>(pUserData));
+		return true;
+	};
+
+	// The sampler reads scripts without stopping them at safepoints, so it doesn't need the GC thread.
+	{
+		HqVmInit init = GetDefaultHqVmInit(nullptr, nullptr, HQ_MESSAGE_TYPE_FATAL);
+		init.gcEnableThread = false;
+
+		HqVmHandle hVm = HQ_VM_HANDLE_NULL;
+		ASSERT_EQ(HqVmCreate(&hVm, init), HQ_SUCCESS);
+
+		EXPECT_EQ(HqVmStartSampleProfiler(hVm, 1, false), HQ_SUCCESS);
+		EXPECT_EQ(HqVmStopSampleProfiler(hVm), HQ_SUCCESS);
+		EXPECT_EQ(HqVmDispose(&hVm), HQ_SUCCESS);
+	}
+
+	HqVmInit init = GetDefaultHqVmInit(nullptr, nullptr, HQ_MESSAGE_TYPE_FATAL);
+	init.gcEnableThread = true;
+
+	HqVmHandle hVm = HQ_VM_HANDLE_NULL;
+	ASSERT_EQ(HqVmCreate(&hVm, init), HQ_SUCCESS);
+
+	EXPECT_EQ(HqVmStartSampleProfiler(HQ_VM_HANDLE_NULL, 1, false), HQ_ERROR_INVALID_ARG);
+	EXPECT_EQ(HqVmStartSampleProfiler(hVm, 0, false), HQ_ERROR_INVALID_ARG);
+	EXPECT_EQ(HqVmWriteSampleProfile(hVm, nullptr, nullptr), HQ_ERROR_INVALID_ARG);
+
+	ASSERT_EQ(HqVmStartSampleProfiler(hVm, 1, true), HQ_SUCCESS);
+	EXPECT_EQ(HqVmStartSampleProfiler(hVm, 1, true), HQ_ERROR_INVALID_OPERATION);
+
+	// Give the sampler a chance to run a few times. Nothing is running, so it shouldn't record anything.
+	std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+	ASSERT_EQ(HqVmStopSampleProfiler(hVm), HQ_SUCCESS);
+	ASSERT_EQ(HqVmStopSampleProfiler(hVm), HQ_SUCCESS);
+
+	size_t lineCount = 0;
+	ASSERT_EQ(HqVmWriteSampleProfile(hVm, onLine, &lineCount), HQ_SUCCESS);
+	EXPECT_EQ(lineCount, 0u);
+
+	EXPECT_EQ(HqVmClearSampleProfile(hVm), HQ_SUCCESS);
+
+	// Leave the sampler running to make sure it's stopped when the VM is disposed.
+	ASSERT_EQ(HqVmStartSampleProfiler(hVm, 1, false), HQ_SUCCESS);
+	EXPECT_EQ(HqVmDispose(&hVm), HQ_SUCCESS);
+}
@@ -0,0 +1,139 @@
+//
+// Copyright (c) 2023, Zoe J. Bare
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated
+// documentation files (the "Software"), to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+// and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all copies or substantial portions
+// of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED
+// TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+// CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+//
+
+#include "../../common/Util.h"
+
+#include <base/Fiber.hpp>
+
+#include <gtest/gtest.h>
+
+#include <stdint.h>
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static void _testFiberMain(void* const pArg)
+{
+	int* const pCounter = reinterpret_cast<int*>(pArg);
+
+	// Use some of the stack so the pages of a stack handed back to the pool have actually been touched.
+	volatile uint8_t scratch[2048];
+	for(size_t i = 0; i < sizeof(scratch); ++i)
+	{
+		scratch[i] = uint8_t(i);
+	}
+
+	++(*pCounter);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static HqFiberConfig _getTestFiberConfig(int* const pCounter, const size_t stackSize)
+{
+	HqFiberConfig config;
+	config.mainFn = _testFiberMain;
+	config.pArg = pCounter;
+	config.stackSize = stackSize;
+	config.name[0] = '\0';
+
+	return config;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST(_HQ_TEST_NAME(TestHqFiber), CreateRunDispose)
+{
+	int counter = 0;
+
+	HqFiber fiber;
+	ASSERT_TRUE(HqFiber::Create(fiber, _getTestFiberConfig(&counter, 64 * 1024)));
+	EXPECT_FALSE(HqFiber::IsRunning(fiber));
+	EXPECT_FALSE(HqFiber::IsComplete(fiber));
+
+	EXPECT_TRUE(HqFiber::Run(fiber));
+	EXPECT_TRUE(HqFiber::IsComplete(fiber));
+	EXPECT_EQ(counter, 1);
+
+	// A completed fiber can't be run again.
+	EXPECT_FALSE(HqFiber::Run(fiber));
+	EXPECT_EQ(counter, 1);
+
+	HqFiber::Dispose(fiber);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+TEST(_HQ_TEST_NAME(TestHqFiber), CreateFailure)
+{
+	int counter = 0;
+
+	// No platform can reserve a stack this large, so creating the fiber must fail rather than crash.
+	HqFiber fiber;
+	EXPECT_FALSE(HqFiber::Create(fiber, _getTestFiberConfig(&counter, SIZE_MAX / 2)));
+	EXPECT_FALSE(HqFiber::IsRunning(fiber));
+	EXPECT_FALSE(HqFiber::IsComplete(fiber));
+
+	// The same fiber object can still be created normally after the failure.
+	ASSERT_TRUE(HqFiber::Create(fiber, _getTestFiberConfig(&counter, 64 * 1024)));
+	EXPECT_TRUE(HqFiber::Run(fiber));
+	EXPECT_EQ(counter, 1);
+
+	HqFiber::Dispose(fiber);
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+#if !defined(HQ_PLATFORM_WINDOWS)
+
+TEST(_HQ_TEST_NAME(TestHqFiber), PooledStackReuse)
+{
+	// Use a stack size that nothing else in the tests uses so the pool can only hand back our own stack.
+	const size_t stackSize = 200 * 1024;
+
+	int counter = 0;
+
+	HqFiber firstFiber;
+	ASSERT_TRUE(HqFiber::Create(firstFiber, _getTestFiberConfig(&counter, stackSize)));
+	EXPECT_TRUE(HqFiber::Run(firstFiber));
+
+	void* const pFirstStack = firstFiber.obj.pStack;
+	ASSERT_NE(pFirstStack, nullptr);
+
+	HqFiber::Dispose(firstFiber);
+
+	// Fibers of the same size get the released stack back instead of mapping a new one.
+	HqFiber secondFiber;
+	ASSERT_TRUE(HqFiber::Create(secondFiber, _getTestFiberConfig(&counter, stackSize)));
+	EXPECT_EQ(secondFiber.obj.pStack, pFirstStack);
+
+	// Fibers of a different size never get it.
+	HqFiber otherFiber;
+	ASSERT_TRUE(HqFiber::Create(otherFiber, _getTestFiberConfig(&counter, stackSize * 2)));
+	EXPECT_NE(otherFiber.obj.pStack, pFirstStack);
+
+	// The reused stack still works after its pages were given back to the OS.
+	EXPECT_TRUE(HqFiber::Run(secondFiber));
+	EXPECT_TRUE(HqFiber::Run(otherFiber));
+	EXPECT_EQ(counter, 3);
+
+	HqFiber::Dispose(otherFiber);
+	HqFiber::Dispose(secondFiber);
+}
+
+#endif
+
+//----------------------------------------------------------------------------------------------------------------------